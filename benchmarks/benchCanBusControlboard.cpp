@@ -0,0 +1,107 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+
+#include <memory>
+#include <vector>
+
+#include "BusLoadMonitor.hpp"
+#include "CanRxTxThreads.hpp"
+#include "ICanBusSharer.hpp"
+
+namespace roboticslab
+{
+
+namespace bench
+{
+
+/**
+ * @ingroup yarp_devices_benchmarks
+ * @defgroup benchCanBusControlboard
+ * @brief Microbenchmarks related to @ref CanBusControlboard.
+ */
+
+/**
+ * @ingroup benchCanBusControlboard
+ * @brief CAN node that only counts incoming messages.
+ */
+class CountingCanNode : public ICanBusSharer
+{
+public:
+    CountingCanNode(unsigned int id) : id(id), received(0)
+    { }
+
+    virtual unsigned int getId() override
+    { return id; }
+
+    virtual bool initialize() override
+    { return true; }
+
+    virtual bool finalize() override
+    { return true; }
+
+    virtual bool registerSender(CanSenderDelegate * sender) override
+    { return true; }
+
+    virtual bool synchronize() override
+    { return true; }
+
+    virtual bool notifyMessage(const can_message & msg) override
+    {
+        received++;
+        benchmark::DoNotOptimize(msg.data);
+        return true;
+    }
+
+    std::uint64_t getReceived() const
+    { return received; }
+
+private:
+    unsigned int id;
+    std::uint64_t received;
+};
+
+// args: number of CAN nodes, whether to attach a bus load monitor
+static void BM_CanReaderThreadDispatch(benchmark::State & state)
+{
+    const int n = state.range(0);
+    const std::uint8_t data[8] = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08};
+
+    CanReaderThread reader("bench", 0.0, 1); // never started
+    std::vector<std::unique_ptr<CountingCanNode>> nodes;
+    OneWayMonitor monitor;
+
+    if (state.range(1) != 0)
+    {
+        reader.attachBusLoadMonitor(&monitor);
+    }
+
+    // traffic of a single SYNC cycle: TPDO1 and TPDO2 from each node
+    std::vector<can_message> cycle;
+
+    for (int i = 0; i < n; i++)
+    {
+        nodes.push_back(std::make_unique<CountingCanNode>(i + 1));
+        reader.registerHandle(nodes.back().get());
+        cycle.push_back({0x180u + i + 1, 8, data});
+        cycle.push_back({0x280u + i + 1, 6, data});
+    }
+
+    for (auto _ : state)
+    {
+        for (const auto & msg : cycle)
+        {
+            reader.dispatch(msg);
+        }
+    }
+
+    benchmark::DoNotOptimize(monitor.reset());
+    state.SetItemsProcessed(state.iterations() * cycle.size());
+}
+
+BENCHMARK(BM_CanReaderThreadDispatch)
+    ->ArgNames({"nodes", "busLoad"})
+    ->ArgsProduct({{1, 6, 24}, {0, 1}});
+
+} // namespace bench
+} // namespace roboticslab
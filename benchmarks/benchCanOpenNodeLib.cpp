@@ -0,0 +1,300 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <cstring>
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+
+#include "CanSenderDelegate.hpp"
+#include "PdoProtocol.hpp"
+#include "SdoClient.hpp"
+
+namespace roboticslab
+{
+
+namespace bench
+{
+
+/**
+ * @ingroup yarp_devices_benchmarks
+ * @defgroup benchCanOpenNodeLib
+ * @brief Microbenchmarks related to @ref CanOpenNodeLib.
+ */
+
+/**
+ * @ingroup benchCanOpenNodeLib
+ * @brief CAN sender that discards all messages, as a fast CAN writer would.
+ */
+class NullCanSenderDelegate : public CanSenderDelegate
+{
+public:
+    virtual bool prepareMessage(const can_message & msg) override
+    {
+        benchmark::DoNotOptimize(msg.data);
+        return true;
+    }
+};
+
+/**
+ * @ingroup benchCanOpenNodeLib
+ * @brief In-process SDO server, answers requests of a SdoClient from another thread.
+ *
+ * Serves any expedited or segmented transfer on a single object whose value
+ * is a string of configurable length. Requests are handed over through the
+ * sender delegate interface, responses are posted via @ref SdoClient::notify
+ * until the client issues its next request (notifications that arrive before
+ * the client starts waiting are dropped by design, hence the retry loop).
+ * Call @ref finish once a transfer is done.
+ */
+class SdoResponder : public CanSenderDelegate
+{
+public:
+    //! Constructor, launches the server thread.
+    SdoResponder(std::uint8_t id, std::size_t objectSize)
+        : sdo(id, 0x600, 0x580, 1.0, this),
+          object(objectSize, 'x'),
+          thread(&SdoResponder::serve, this)
+    { }
+
+    //! Destructor, joins the server thread.
+    ~SdoResponder()
+    {
+        finish();
+        stopping = true;
+        thread.join();
+    }
+
+    //! Retrieve the client.
+    SdoClient & getClient()
+    { return sdo; }
+
+    //! Stop answering the current request.
+    void finish()
+    {
+        cancel = true;
+
+        while (!idle)
+        {
+            std::this_thread::yield();
+        }
+
+        cancel = false;
+    }
+
+    //! Receive a request from the client.
+    virtual bool prepareMessage(const can_message & msg) override
+    {
+        finish(); // the response to the previous request was consumed, otherwise the client wouldn't be here
+        std::memcpy(request, msg.data, sizeof(request));
+        idle = false;
+        pending = true;
+        return true;
+    }
+
+private:
+    void serve()
+    {
+        while (!stopping)
+        {
+            if (!pending.exchange(false))
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            std::uint8_t response[8] = {0};
+            respond(response);
+
+            while (!cancel)
+            {
+                sdo.notify(response);
+                std::this_thread::yield(); // don't starve the client on few cores
+            }
+
+            idle = true;
+        }
+    }
+
+    void respond(std::uint8_t * response)
+    {
+        const std::uint8_t command = request[0] >> 5;
+
+        switch (command)
+        {
+        case 2: // initiate upload
+            std::memcpy(response + 1, request + 1, 3);
+
+            if (object.size() <= 4)
+            {
+                response[0] = 0x43 | ((4 - object.size()) << 2);
+                std::memcpy(response + 4, object.data(), object.size());
+            }
+            else
+            {
+                const std::uint32_t size = object.size();
+                response[0] = 0x41;
+                std::memcpy(response + 4, &size, sizeof(size));
+                offset = 0;
+            }
+            break;
+        case 3: // upload segment
+        {
+            const std::size_t n = std::min<std::size_t>(7, object.size() - offset);
+            const bool last = offset + n == object.size();
+            response[0] = (request[0] & 0x10) | ((7 - n) << 1) | (last ? 0x01 : 0x00);
+            std::memcpy(response + 1, object.data() + offset, n);
+            offset += n;
+            break;
+        }
+        case 1: // initiate download
+            response[0] = 0x60;
+            std::memcpy(response + 1, request + 1, 3);
+            break;
+        case 0: // download segment
+            response[0] = 0x20 | (request[0] & 0x10);
+            break;
+        }
+    }
+
+    SdoClient sdo;
+    std::string object;
+    std::size_t offset {0};
+    std::uint8_t request[8] {0};
+
+    std::atomic<bool> pending {false};
+    std::atomic<bool> idle {true};
+    std::atomic<bool> cancel {false};
+    std::atomic<bool> stopping {false};
+
+    std::thread thread;
+};
+
+static void BM_ReceivePdoWrite(benchmark::State & state)
+{
+    NullCanSenderDelegate sender;
+    ReceivePdo rpdo(0x05, 0x200, 1, nullptr, &sender);
+    std::int32_t position = 0;
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(rpdo.write<std::int32_t, std::int16_t>(position++, 0x0F));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_ReceivePdoWrite);
+
+static void BM_TransmitPdoAccept(benchmark::State & state)
+{
+    TransmitPdo tpdo(0x05, 0x180, 1, nullptr);
+    std::int32_t position = 0;
+    std::uint16_t statusword = 0;
+
+    tpdo.registerHandler<std::int32_t, std::uint16_t>([&](std::int32_t p, std::uint16_t s)
+        { position = p; statusword = s; });
+
+    std::uint8_t raw[6] = {0x78, 0x56, 0x34, 0x12, 0x37, 0x06};
+
+    for (auto _ : state)
+    {
+        raw[0]++;
+        benchmark::DoNotOptimize(tpdo.accept(raw, sizeof(raw)));
+        benchmark::DoNotOptimize(position);
+        benchmark::DoNotOptimize(statusword);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_TransmitPdoAccept);
+
+static void BM_SdoExpeditedUpload(benchmark::State & state)
+{
+    SdoResponder responder(0x05, 4);
+    std::uint32_t value;
+
+    for (auto _ : state)
+    {
+        if (!responder.getClient().upload("Benchmark", &value, 0x1234, 0x56))
+        {
+            state.SkipWithError("SDO upload failed");
+            break;
+        }
+
+        responder.finish();
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_SdoExpeditedUpload)->UseRealTime();
+
+static void BM_SdoExpeditedDownload(benchmark::State & state)
+{
+    SdoResponder responder(0x05, 4);
+    std::uint32_t value = 0;
+
+    for (auto _ : state)
+    {
+        if (!responder.getClient().download("Benchmark", value++, 0x1234, 0x56))
+        {
+            state.SkipWithError("SDO download failed");
+            break;
+        }
+
+        responder.finish();
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_SdoExpeditedDownload)->UseRealTime();
+
+static void BM_SdoSegmentedUpload(benchmark::State & state)
+{
+    SdoResponder responder(0x05, state.range(0));
+    std::string value;
+
+    for (auto _ : state)
+    {
+        if (!responder.getClient().upload("Benchmark", value, 0x1234, 0x56) || static_cast<std::int64_t>(value.size()) != state.range(0))
+        {
+            state.SkipWithError("SDO upload failed");
+            break;
+        }
+
+        responder.finish();
+    }
+
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_SdoSegmentedUpload)->Arg(15)->Arg(64)->Arg(98)->UseRealTime(); // string uploads are capped at 100 bytes
+
+static void BM_SdoSegmentedDownload(benchmark::State & state)
+{
+    SdoResponder responder(0x05, 0);
+    const std::string value(state.range(0), 'y');
+
+    for (auto _ : state)
+    {
+        if (!responder.getClient().download("Benchmark", value, 0x1234, 0x56))
+        {
+            state.SkipWithError("SDO download failed");
+            break;
+        }
+
+        responder.finish();
+    }
+
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_SdoSegmentedDownload)->Arg(15)->Arg(64)->Arg(256)->UseRealTime();
+
+} // namespace bench
+} // namespace roboticslab
@@ -0,0 +1,88 @@
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <thread>
+
+#include "StateObserver.hpp"
+
+namespace roboticslab
+{
+
+namespace bench
+{
+
+/**
+ * @ingroup yarp_devices_benchmarks
+ * @defgroup benchStateObserverLib
+ * @brief Microbenchmarks related to @ref StateObserverLib.
+ */
+
+namespace
+{
+    StateObserverBackend toBackend(const benchmark::State & state)
+    {
+        return state.range(0) == 0 ? StateObserverBackend::FUTEX : StateObserverBackend::CONDITION_VARIABLE;
+    }
+}
+
+// unsolicited notification, e.g. a late SDO response nobody waits for anymore
+static void BM_StateObserverNotifyIdle(benchmark::State & state)
+{
+    StateObserver observer(1.0, toBackend(state));
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(observer.notify());
+    }
+
+    state.SetLabel(state.range(0) == 0 ? "futex" : "condition_variable");
+}
+
+BENCHMARK(BM_StateObserverNotifyIdle)->Arg(0)->Arg(1);
+
+// a notifier thread wakes up the waiting thread, as the CAN reader does with SDO clients
+static void BM_StateObserverRoundTrip(benchmark::State & state)
+{
+    StateObserver observer(1.0, toBackend(state));
+    std::atomic<unsigned int> requested {0};
+    std::atomic<unsigned int> acknowledged {0};
+    std::atomic<bool> stopping {false};
+
+    std::thread notifier([&]
+        {
+            while (!stopping)
+            {
+                const unsigned int request = requested.load();
+
+                // notifications are dropped until the waiter is ready, retry until it's done
+                while (acknowledged.load() != request && !stopping)
+                {
+                    observer.notify();
+                    std::this_thread::yield(); // don't starve the waiter on few cores
+                }
+            }
+        });
+
+    for (auto _ : state)
+    {
+        requested++;
+
+        if (!observer.await())
+        {
+            state.SkipWithError("await timed out");
+            break;
+        }
+
+        acknowledged++;
+    }
+
+    stopping = true;
+    notifier.join();
+
+    state.SetLabel(state.range(0) == 0 ? "futex" : "condition_variable");
+}
+
+BENCHMARK(BM_StateObserverRoundTrip)->Arg(0)->Arg(1)->UseRealTime();
+
+} // namespace bench
+} // namespace roboticslab
@@ -0,0 +1,79 @@
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <memory>
+
+#include "InterpolatedPositionBuffer.hpp"
+#include "StateVariables.hpp"
+
+namespace roboticslab
+{
+
+namespace bench
+{
+
+/**
+ * @ingroup yarp_devices_benchmarks
+ * @defgroup benchTechnosoftIpos
+ * @brief Microbenchmarks related to @ref TechnosoftIpos.
+ */
+
+namespace
+{
+    std::unique_ptr<InterpolatedPositionBuffer> makeBuffer(const benchmark::State & state, const StateVariables & vars)
+    {
+        if (state.range(0) == 0)
+        {
+            return std::make_unique<PtBuffer>(vars, 1);
+        }
+        else
+        {
+            return std::make_unique<PvtBuffer>(vars, 1);
+        }
+    }
+}
+
+// args: buffer type (0: PT, 1: PVT), whether to fill the whole buffer
+static void BM_InterpolatedPositionBufferPopBatch(benchmark::State & state)
+{
+    StateVariables vars;
+    vars.tr = 1.0;
+    vars.encoderPulses = 360; // internal units are degrees
+    vars.samplingPeriod = 0.001;
+    vars.updateConversionFactors();
+
+    auto buffer = makeBuffer(state, vars);
+    buffer->setInitial(0.0);
+
+    const bool fullBuffer = state.range(1) != 0;
+    double target = 0.0;
+    std::size_t points = 0;
+
+    for (auto _ : state)
+    {
+        // keep the queue stocked, as client threads would (not timed)
+        while (buffer->getQueueSize() < 2 * buffer->getBufferSize())
+        {
+            buffer->addSetpoint(target += 0.1);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        const auto & batch = buffer->popBatch(fullBuffer);
+        auto elapsed = std::chrono::steady_clock::now() - start;
+
+        benchmark::DoNotOptimize(batch.data());
+        points += batch.size();
+        state.SetIterationTime(std::chrono::duration<double>(elapsed).count());
+    }
+
+    state.SetLabel(buffer->getType());
+    state.SetItemsProcessed(points);
+}
+
+BENCHMARK(BM_InterpolatedPositionBufferPopBatch)
+    ->ArgNames({"pvt", "full"})
+    ->ArgsProduct({{0, 1}, {0, 1}})
+    ->UseManualTime();
+
+} // namespace bench
+} // namespace roboticslab
@@ -0,0 +1,251 @@
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <yarp/os/Property.h>
+#include <yarp/dev/DeviceDriver.h>
+#include <yarp/dev/Drivers.h>
+#include <yarp/dev/IPositionDirect.h>
+#include <yarp/dev/PolyDriver.h>
+
+#include "DeviceMapper.hpp"
+#include "FutureTask.hpp"
+
+namespace roboticslab
+{
+
+namespace bench
+{
+
+/**
+ * @ingroup yarp_devices_benchmarks
+ * @defgroup benchYarpDeviceMapperLib
+ * @brief Microbenchmarks related to @ref YarpDeviceMapperLib.
+ */
+
+/**
+ * @ingroup benchYarpDeviceMapperLib
+ * @brief Single-axis position-direct device with configurable per-call cost.
+ *
+ * Each full-joint command busy-waits for the configured amount of time, which
+ * mimics the cost of a real node (e.g. queueing CAN messages, taking locks).
+ */
+class BenchJointDriver : public yarp::dev::DeviceDriver,
+                         public yarp::dev::IPositionDirectRaw
+{
+public:
+    static constexpr const char * NAME = "BenchJointDriver";
+
+    //! Busy-wait time per call (nanoseconds).
+    static long workNs;
+
+    virtual bool getAxes(int * axes) override
+    { *axes = 1; return true; }
+
+    virtual bool setPositionRaw(int j, double ref) override
+    { return true; }
+
+    virtual bool setPositionsRaw(int n_joint, const int * joints, const double * refs) override
+    { return work(), true; }
+
+    virtual bool setPositionsRaw(const double * refs) override
+    { return work(), true; }
+
+    virtual bool getRefPositionRaw(int joint, double * ref) override
+    { *ref = target; return true; }
+
+    virtual bool getRefPositionsRaw(double * refs) override
+    { *refs = target; return true; }
+
+    virtual bool getRefPositionsRaw(int n_joint, const int * joints, double * refs) override
+    { *refs = target; return true; }
+
+private:
+    static void work()
+    {
+        if (workNs > 0)
+        {
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::nanoseconds(workNs);
+            while (std::chrono::steady_clock::now() < deadline) {}
+        }
+    }
+
+    double target {0.0};
+};
+
+constexpr const char * BenchJointDriver::NAME;
+long BenchJointDriver::workNs = 0;
+
+/**
+ * @ingroup benchYarpDeviceMapperLib
+ * @brief Executor under test.
+ */
+enum class executor { SEQUENTIAL, PARALLEL, FORK_JOIN, AFFINE, INLINED };
+
+namespace
+{
+    constexpr int THREADS = 4; // size of thread pools, number of affinity groups
+
+    const char * toString(executor e)
+    {
+        switch (e)
+        {
+        case executor::SEQUENTIAL: return "sequential";
+        case executor::PARALLEL: return "parallel";
+        case executor::FORK_JOIN: return "forkJoin";
+        case executor::AFFINE: return "affine";
+        default: return "inlined";
+        }
+    }
+
+    std::unique_ptr<yarp::dev::PolyDriver> openDriver()
+    {
+        static const bool registered = (yarp::dev::Drivers::factory().add(
+            new yarp::dev::DriverCreatorOf<BenchJointDriver>(BenchJointDriver::NAME, "", BenchJointDriver::NAME)), true);
+
+        yarp::os::Property config;
+        config.put("device", BenchJointDriver::NAME);
+        return registered ? std::make_unique<yarp::dev::PolyDriver>(config) : nullptr;
+    }
+}
+
+/**
+ * @ingroup benchYarpDeviceMapperLib
+ * @brief Owns a DeviceMapper instance and its registered devices.
+ */
+class MapperSetup
+{
+public:
+    MapperSetup(executor e, int devices)
+    {
+        for (int i = 0; i < devices; i++)
+        {
+            drivers.push_back(openDriver());
+            mapper.registerDevice(drivers.back().get(), i % THREADS); // as if spread across several CAN buses
+        }
+
+        if (e == executor::PARALLEL)
+        {
+            mapper.enableParallelization(THREADS);
+        }
+        else if (e == executor::AFFINE)
+        {
+            mapper.enableAffinity(THREADS);
+        }
+    }
+
+    ~MapperSetup()
+    {
+        mapper.clear();
+    }
+
+    DeviceMapper mapper;
+
+private:
+    std::vector<std::unique_ptr<yarp::dev::PolyDriver>> drivers;
+};
+
+// args: executor, number of devices, busy-wait per device (ns)
+static void BM_DeviceMapperMapAllJoints(benchmark::State & state)
+{
+    const auto e = static_cast<executor>(state.range(0));
+    const int devices = state.range(1);
+    BenchJointDriver::workNs = state.range(2);
+
+    MapperSetup setup(e, devices);
+    std::vector<double> refs(devices, 0.0);
+
+    for (auto _ : state)
+    {
+        bool ok;
+
+        if (e == executor::INLINED)
+        {
+            ok = setup.mapper.mapAllJoints(DeviceMapper::inlined, &yarp::dev::IPositionDirectRaw::setPositionsRaw,
+                                           const_cast<const double *>(refs.data()));
+        }
+        else
+        {
+            ok = setup.mapper.mapAllJoints(&yarp::dev::IPositionDirectRaw::setPositionsRaw,
+                                           const_cast<const double *>(refs.data()));
+        }
+
+        benchmark::DoNotOptimize(ok);
+    }
+
+    state.SetLabel(toString(e));
+    state.SetItemsProcessed(state.iterations() * devices);
+}
+
+BENCHMARK(BM_DeviceMapperMapAllJoints)
+    ->ArgNames({"executor", "devices", "workNs"})
+    ->ArgsProduct({{0, 1, 3, 4}, {1, 6, 24}, {0, 20000}}) // DeviceMapper does not support fork-join tasks
+    ->UseRealTime();
+
+// args: executor, number of callbacks
+static void BM_FutureTaskDispatch(benchmark::State & state)
+{
+    const auto e = static_cast<executor>(state.range(0));
+    const int n = state.range(1);
+
+    std::unique_ptr<FutureTaskFactory> factory;
+
+    switch (e)
+    {
+    case executor::PARALLEL: factory = std::make_unique<ParallelTaskFactory>(THREADS); break;
+    case executor::FORK_JOIN: factory = std::make_unique<ForkJoinTaskFactory>(THREADS); break;
+    case executor::AFFINE: factory = std::make_unique<AffineTaskFactory>(THREADS); break;
+    default: factory = std::make_unique<SequentialTaskFactory>(); break;
+    }
+
+    std::vector<BenchJointDriver> nodes(n);
+    std::vector<double> refs(n, 0.0);
+    auto task = factory->createTask(); // reused, as the SYNC thread does
+
+    for (int i = 0; i < n; i++)
+    {
+        yarp::dev::IPositionDirectRaw * p = &nodes[i];
+        task->addAffine(i % THREADS, p, &yarp::dev::IPositionDirectRaw::getRefPositionRaw, 0, &refs[i]);
+    }
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(task->dispatch());
+    }
+
+    state.SetLabel(toString(e));
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK(BM_FutureTaskDispatch)
+    ->ArgNames({"executor", "callbacks"})
+    ->ArgsProduct({{0, 1, 2, 3}, {1, 4, 16, 64}})
+    ->UseRealTime();
+
+// joint-group commands on a fixed subset, served from the plan cache
+static void BM_DeviceMapperMapJointGroup(benchmark::State & state)
+{
+    const int devices = 24;
+    const int joints[] = {0, 1, 2, 6, 7, 8, 12, 13, 14};
+    const int n = sizeof(joints) / sizeof(joints[0]);
+
+    BenchJointDriver::workNs = 0;
+    MapperSetup setup(executor::INLINED, devices);
+    double refs[n] = {0.0};
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(setup.mapper.mapJointGroup(DeviceMapper::inlined,
+                &yarp::dev::IPositionDirectRaw::getRefPositionsRaw, n, joints, refs));
+    }
+
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK(BM_DeviceMapperMapJointGroup);
+
+} // namespace bench
+} // namespace roboticslab
@@ -0,0 +1,229 @@
+# Copyright: Universidad Carlos III de Madrid (C) 2020;
+# CopyPolicy: Released under the terms of the GNU GPL v2.0.
+
+#.rst:
+# RoboticslabObjectDictionary
+# ---------------------------
+#
+# Generates a C++ header of compile-time CAN dictionary object descriptors
+# (see ``ObjectDictionary.hpp`` in CanOpenNodeLib) from an EDS/DCF file.
+#
+# .. command:: roboticslab_generate_object_dictionary
+#
+#   roboticslab_generate_object_dictionary(<target>
+#                                          EDS <file>
+#                                          HEADER <name>
+#                                          NAMESPACE <namespace>)
+#
+# Parses ``<file>`` at build time and writes ``<name>`` to the current binary
+# directory, which is appended to the private include directories of
+# ``<target>``. Each VAR object and each non-zero subindex of ARRAY/RECORD
+# objects translates into a ``roboticslab::<namespace>::<Name>`` descriptor,
+# where ``<Name>`` is the CamelCase form of the ``ParameterName`` key.
+# Objects of unsupported data types are skipped.
+
+if(NOT CMAKE_SCRIPT_MODE_FILE STREQUAL CMAKE_CURRENT_LIST_FILE)
+
+    set(_roboticslab_od_script ${CMAKE_CURRENT_LIST_FILE})
+
+    function(roboticslab_generate_object_dictionary target)
+        set(_one_value_args EDS HEADER NAMESPACE)
+        cmake_parse_arguments(_od "" "${_one_value_args}" "" ${ARGN})
+
+        foreach(_arg ${_one_value_args})
+            if(NOT _od_${_arg})
+                message(FATAL_ERROR "roboticslab_generate_object_dictionary: missing ${_arg} argument.")
+            endif()
+        endforeach()
+
+        get_filename_component(_eds ${_od_EDS} ABSOLUTE)
+        set(_output ${CMAKE_CURRENT_BINARY_DIR}/${_od_HEADER})
+
+        add_custom_command(OUTPUT ${_output}
+                           COMMAND ${CMAKE_COMMAND} -DEDS_FILE=${_eds}
+                                                    -DOUTPUT_FILE=${_output}
+                                                    -DNAMESPACE=${_od_NAMESPACE}
+                                                    -P ${_roboticslab_od_script}
+                           DEPENDS ${_eds} ${_roboticslab_od_script}
+                           COMMENT "Generating object dictionary ${_od_HEADER}"
+                           VERBATIM)
+
+        target_sources(${target} PRIVATE ${_output})
+        target_include_directories(${target} PRIVATE ${CMAKE_CURRENT_BINARY_DIR})
+    endfunction()
+
+    return()
+
+endif()
+
+# Script mode: parse EDS_FILE, write OUTPUT_FILE.
+
+cmake_minimum_required(VERSION 3.12)
+
+foreach(_var EDS_FILE OUTPUT_FILE NAMESPACE)
+    if(NOT ${_var})
+        message(FATAL_ERROR "Missing ${_var} definition.")
+    endif()
+endforeach()
+
+# Maps EDS data types (CiA 306) to C++ types.
+set(_type_2 "std::int8_t")
+set(_type_3 "std::int16_t")
+set(_type_4 "std::int32_t")
+set(_type_5 "std::uint8_t")
+set(_type_6 "std::uint16_t")
+set(_type_7 "std::uint32_t")
+set(_type_9 "std::string")
+set(_type_15 "std::int64_t")
+set(_type_1b "std::uint64_t")
+
+set(_access_ro "RO")
+set(_access_wo "WO")
+set(_access_rw "RW")
+set(_access_rwr "RW")
+set(_access_rww "RW")
+set(_access_const "CONST")
+
+# Strips the "0x" prefix and leading zeros from a hex string, e.g. 0x0007 -> 7.
+macro(_od_normalize_hex _out _in)
+    string(TOLOWER "${_in}" ${_out})
+
+    if(${_out} MATCHES "^(0x)?0*([0-9a-f]+)$")
+        set(${_out} ${CMAKE_MATCH_2})
+    else()
+        set(${_out} 0)
+    endif()
+endmacro()
+
+file(STRINGS ${EDS_FILE} _lines)
+
+set(_sections)
+set(_current)
+
+foreach(_line ${_lines})
+    string(STRIP "${_line}" _line)
+
+    if(_line MATCHES "^\\[([0-9A-Fa-f]+)sub([0-9A-Fa-f]+)\\]$")
+        string(TOUPPER "${CMAKE_MATCH_1}" _index)
+        _od_normalize_hex(_sub "${CMAKE_MATCH_2}")
+        set(_current "${_index}_${_sub}")
+        list(APPEND _sections ${_current})
+    elseif(_line MATCHES "^\\[([0-9A-Fa-f]+)\\]$")
+        string(TOUPPER "${CMAKE_MATCH_1}" _current)
+        list(APPEND _sections ${_current})
+    elseif(_line MATCHES "^\\[")
+        set(_current) # not an object section
+    elseif(_current AND _line MATCHES "^([A-Za-z]+)[ \t]*=[ \t]*(.*)$")
+        set(_sec_${_current}_${CMAKE_MATCH_1} "${CMAKE_MATCH_2}")
+    endif()
+endforeach()
+
+set(_entries)
+set(_identifiers)
+
+foreach(_section ${_sections})
+    if(_section MATCHES "^([0-9A-F]+)_([0-9a-f]+)$")
+        set(_index ${CMAKE_MATCH_1})
+        set(_sub ${CMAKE_MATCH_2})
+
+        if(_sub STREQUAL "0")
+            continue() # number of entries
+        endif()
+    else()
+        set(_index ${_section})
+        set(_sub 0)
+        _od_normalize_hex(_object_type "${_sec_${_section}_ObjectType}")
+
+        if(NOT _object_type STREQUAL "0" AND NOT _object_type STREQUAL "7")
+            continue() # ARRAY or RECORD, handled through subindex sections
+        endif()
+    endif()
+
+    set(_name "${_sec_${_section}_ParameterName}")
+    _od_normalize_hex(_data_type "${_sec_${_section}_DataType}")
+    string(TOLOWER "${_sec_${_section}_AccessType}" _access_type)
+
+    if(NOT DEFINED _type_${_data_type})
+        message(STATUS "Skipping object ${_index}:${_sub} (${_name}), unsupported data type")
+        continue()
+    endif()
+
+    if(NOT DEFINED _access_${_access_type})
+        message(FATAL_ERROR "Object ${_index}:${_sub} (${_name}) has unknown access type: ${_access_type}")
+    endif()
+
+    set(_identifier)
+    string(REGEX REPLACE "[^A-Za-z0-9]+" ";" _words "${_name}")
+
+    foreach(_word ${_words})
+        string(SUBSTRING "${_word}" 0 1 _head)
+        string(SUBSTRING "${_word}" 1 -1 _tail)
+        string(TOUPPER "${_head}" _head)
+        set(_identifier "${_identifier}${_head}${_tail}")
+    endforeach()
+
+    if(_identifier STREQUAL "" OR _identifier MATCHES "^[0-9]")
+        set(_identifier "Object${_index}_${_sub}${_identifier}")
+    endif()
+
+    if(_identifier IN_LIST _identifiers)
+        message(FATAL_ERROR "Duplicate descriptor name ${_identifier} (object ${_index}:${_sub}), rename it in the EDS file")
+    endif()
+
+    list(APPEND _identifiers ${_identifier})
+
+    string(TOLOWER "${_sec_${_section}_PDOMapping}" _pdo_mapping)
+
+    if(_pdo_mapping STREQUAL "1" AND NOT _data_type STREQUAL "9")
+        set(_mappable true)
+    else()
+        set(_mappable false)
+    endif()
+
+    string(LENGTH "${_sub}" _sub_length)
+
+    if(_sub_length EQUAL 1)
+        set(_sub "0${_sub}")
+    endif()
+
+    string(TOUPPER "${_sub}" _sub)
+    string(REPLACE "\"" "\\\"" _name "${_name}")
+
+    string(APPEND _entries
+           "\n"
+           "//! ${_name} (0x${_index}:${_sub})\n"
+           "struct ${_identifier} : ObjectEntry<${_type_${_data_type}}, 0x${_index}, 0x${_sub}, ObjectAccess::${_access_${_access_type}}, ${_mappable}>\n"
+           "{ static constexpr const char * name() { return \"${_name}\"; } };\n")
+endforeach()
+
+get_filename_component(_eds_name ${EDS_FILE} NAME)
+get_filename_component(_guard ${OUTPUT_FILE} NAME)
+string(TOUPPER "${_guard}" _guard)
+string(REGEX REPLACE "[^A-Z0-9]" "_" _guard "${_guard}")
+
+file(WRITE ${OUTPUT_FILE}
+     "// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-\n"
+     "\n"
+     "// Generated from ${_eds_name} by roboticslab_generate_object_dictionary(), do not edit.\n"
+     "\n"
+     "#ifndef __${_guard}__\n"
+     "#define __${_guard}__\n"
+     "\n"
+     "#include <cstdint>\n"
+     "\n"
+     "#include <string>\n"
+     "\n"
+     "#include \"ObjectDictionary.hpp\"\n"
+     "\n"
+     "namespace roboticslab\n"
+     "{\n"
+     "\n"
+     "namespace ${NAMESPACE}\n"
+     "{\n"
+     "${_entries}"
+     "\n"
+     "} // namespace ${NAMESPACE}\n"
+     "\n"
+     "} // namespace roboticslab\n"
+     "\n"
+     "#endif // __${_guard}__\n")
@@ -3,10 +3,13 @@
 #ifndef __I_CAN_BUS_SHARER_HPP__
 #define __I_CAN_BUS_SHARER_HPP__
 
+#include <cstdint>
+
 #include <vector>
 
 #include "CanMessageNotifier.hpp"
 #include "CanSenderDelegate.hpp"
+#include "JointStateSink.hpp"
 
 namespace roboticslab
 {
@@ -43,8 +46,28 @@ public:
     //! Pass a handle to a CAN sender delegate instance.
     virtual bool registerSender(CanSenderDelegate * sender) = 0;
 
+    //! Pass a handle to the joint state buffer of the CAN master, returns false if not fed by this node.
+    virtual bool registerJointStateSink(JointStateSink *)
+    { return false; }
+
     //! Perform synchronized action on CAN master's request.
     virtual bool synchronize() = 0;
+
+    //! Invoked by the CAN master right after a SYNC message is sent, the cycle number increases monotonically.
+    virtual void onSync(std::uint64_t)
+    { }
+
+    //! Retrieve heartbeat consumer timeout (seconds), zero disables node supervision.
+    virtual double getHeartbeatTimeout()
+    { return 0.0; }
+
+    //! Invoked by the CAN master if no heartbeat was received within the timeout, passing the elapsed time (seconds).
+    virtual void onHeartbeatLost(double)
+    { }
+
+    //! Invoked by the CAN master upon a boot-up message, outside the CAN read thread.
+    virtual void onBootUp()
+    { }
 };
 
 } // namespace roboticslab
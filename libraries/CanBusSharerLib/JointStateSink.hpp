@@ -0,0 +1,47 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __JOINT_STATE_SINK_HPP__
+#define __JOINT_STATE_SINK_HPP__
+
+#include <cstdint>
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup CanBusSharerLib
+ * @brief State of a single joint, as received in a SYNC cycle.
+ */
+struct joint_state
+{
+    double position;          ///< joint position (degrees)
+    double velocity;          ///< joint velocity (degrees/second)
+    double acceleration;      ///< joint acceleration (degrees/second^2)
+    double motorPosition;     ///< motor encoder position (counts)
+    double motorVelocity;     ///< motor encoder velocity (counts/sample)
+    double motorAcceleration; ///< motor encoder acceleration (counts/sample^2)
+    double current;           ///< motor current (amperes)
+    double timestamp;         ///< time of the last position read (seconds)
+    std::int32_t mode;        ///< control mode vocab
+};
+
+/**
+ * @ingroup CanBusSharerLib
+ * @brief Collects joint states from CAN nodes on behalf of the CAN master.
+ *
+ * Nodes report once per SYNC cycle, usually from the CAN reader thread right
+ * after the synchronous TPDO that carries the joint position has been parsed.
+ */
+class JointStateSink
+{
+public:
+    //! Virtual destructor.
+    virtual ~JointStateSink() = default;
+
+    //! Store the state of a joint received in the given SYNC cycle.
+    virtual void store(std::uint64_t cycle, const joint_state & state) = 0;
+};
+
+} // namespace roboticslab
+
+#endif // __JOINT_STATE_SINK_HPP__
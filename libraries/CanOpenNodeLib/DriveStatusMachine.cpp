@@ -2,7 +2,9 @@
 
 #include "DriveStatusMachine.hpp"
 
+#include <algorithm>
 #include <bitset>
+#include <chrono>
 #include <functional>
 #include <unordered_map>
 #include <vector>
@@ -248,3 +250,96 @@ DriveState DriveStatusMachine::parseStatusword(std::uint16_t statusword)
 {
     return parseDriveState(statusword);
 }
+
+bool DriveStatusMachine::awaitState(DriveState goalState, std::chrono::steady_clock::time_point deadline)
+{
+    if (goalState == getCurrentState())
+    {
+        return true;
+    }
+
+    std::chrono::duration<double> remaining = deadline - std::chrono::steady_clock::now();
+    return remaining.count() > 0.0 && stateObserver.awaitFor(remaining.count()) && goalState == getCurrentState();
+}
+
+bool DriveStatusMachine::requestStates(const std::vector<request_t> & requests)
+{
+    struct pending_t
+    {
+        DriveStatusMachine * machine;
+        DriveState goalState;
+        DriveState nextState;
+    };
+
+    std::vector<pending_t> pending;
+    pending.reserve(requests.size());
+
+    double timeout = 0.0;
+    bool ok = true;
+
+    for (const auto & request : requests)
+    {
+        pending.push_back({request.first, request.second, request.second});
+        timeout = std::max(timeout, request.first->stateObserver.getTimeout());
+    }
+
+    while (!pending.empty())
+    {
+        // send all controlwords first, they will be dispatched within the same CAN write batch
+        auto it = pending.begin();
+
+        while (it != pending.end())
+        {
+            DriveState initialState = it->machine->getCurrentState();
+
+            if (initialState == it->goalState)
+            {
+                it = pending.erase(it);
+                continue;
+            }
+
+            auto path = shortestPaths.find({initialState, it->goalState});
+
+            if (path == shortestPaths.cend())
+            {
+                ok = false;
+                it = pending.erase(it);
+                continue;
+            }
+
+            DriveTransition transition = path->second.front();
+            word_t requested = updateStateBits(it->machine->controlword(), static_cast<std::uint16_t>(transition));
+
+            if (!it->machine->controlword(requested))
+            {
+                ok = false;
+                it = pending.erase(it);
+                continue;
+            }
+
+            it->nextState = nextStateOnTransition.at({initialState, transition});
+            ++it;
+        }
+
+        // then await all drives, a single deadline applies to this transition step
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double>(timeout));
+
+        it = pending.begin();
+
+        while (it != pending.end())
+        {
+            if (!it->machine->awaitState(it->nextState, deadline))
+            {
+                ok = false;
+                it = pending.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+    return ok;
+}
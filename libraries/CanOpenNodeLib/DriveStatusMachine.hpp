@@ -6,7 +6,10 @@
 #include <cstdint>
 
 #include <bitset>
+#include <chrono>
 #include <mutex>
+#include <utility>
+#include <vector>
 
 #include "PdoProtocol.hpp"
 #include "StateObserver.hpp"
@@ -56,11 +59,16 @@ enum class DriveTransition : std::uint16_t
  * to @ref DriveState::OPERATION_ENABLED chain in both directions, and
  * @ref DriveState::QUICK_STOP_ACTIVE to @ref DriveState::SWITCH_ON_DISABLED.
  * Fault resets as well as quick stop transitions must be requested individually.
+ *
+ * Several drives can be driven towards their goal states at once via
+ * @ref requestStates, which issues each step's controlwords back-to-back (thus
+ * sharing a CAN write batch) and awaits all confirmations with a single timeout.
  */
 class DriveStatusMachine
 {
 public:
     typedef std::bitset<16> word_t; ///< Fixed-size sequence of 16 bits
+    typedef std::pair<DriveStatusMachine *, DriveState> request_t; ///< Pair of a drive and its goal state
 
     //! Constructor, registers RPDO handle.
     DriveStatusMachine(ReceivePdo * rpdo, double timeout)
@@ -101,7 +109,12 @@ public:
     //! Parse bit representation into a @ref DriveState enumerator.
     static DriveState parseStatusword(std::uint16_t statusword);
 
+    //! Request given drive states on several drives at once, each transition step awaited concurrently.
+    static bool requestStates(const std::vector<request_t> & requests);
+
 private:
+    bool awaitState(DriveState goalState, std::chrono::steady_clock::time_point deadline);
+
     word_t _controlword;
     word_t _statusword;
     ReceivePdo * rpdo;
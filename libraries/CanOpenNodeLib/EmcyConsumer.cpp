@@ -4,8 +4,15 @@
 
 #include <cstring>
 
+#include <algorithm> // std::max
+
+#include <yarp/os/Time.h>
+
 using namespace roboticslab;
 
+constexpr unsigned int EmcyConsumer::HISTORY_SIZE;
+constexpr unsigned int EmcyConsumer::RECORD_WORDS;
+
 std::string EmcyCodeRegistry::codeToMessage(std::uint16_t code)
 {
     switch (code)
@@ -87,21 +94,80 @@ std::string EmcyCodeRegistry::codeToMessage(std::uint16_t code)
 
 bool EmcyConsumer::accept(const std::uint8_t * data)
 {
-    if (!callback)
+    if (!data)
     {
         return false;
     }
 
-    std::uint16_t code;
-    std::uint8_t reg;
-    std::uint8_t msef[5];
+    record_t record;
+    std::memset(&record, 0, sizeof(record_t)); // clear padding
+
+    std::memcpy(&record.code, data, 2);
+    std::memcpy(&record.reg, data + 2, 1);
+    std::memcpy(record.msef, data + 3, 5);
+
+    // single writer (CAN read thread), seqlock-like protocol per slot
+    std::uint64_t seq = written.load(std::memory_order_relaxed) + 1;
+    record.seq = seq;
+    record.timestamp = yarp::os::Time::now();
+
+    std::uint64_t words[RECORD_WORDS];
+    std::memcpy(words, &record, sizeof(record_t));
+
+    slot_t & slot = history[(seq - 1) % HISTORY_SIZE];
 
-    std::memcpy(&code, data, 2);
-    std::memcpy(&reg, data + 2, 1);
-    std::memcpy(msef, data + 3, 5);
+    slot.seq.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
 
-    code_t codeToMsg = std::make_pair(code, codeRegistry->codeToMessage(code));
+    for (unsigned int i = 0; i < RECORD_WORDS; i++)
+    {
+        slot.words[i].store(words[i], std::memory_order_relaxed);
+    }
+
+    slot.seq.store(seq, std::memory_order_release);
+    written.store(seq, std::memory_order_release);
+
+    if (callback)
+    {
+        callback(record.code, record.reg, record.msef);
+    }
 
-    callback(codeToMsg, reg, msef);
     return true;
 }
+
+std::vector<EmcyConsumer::record_t> EmcyConsumer::getHistory(std::uint64_t since) const
+{
+    std::uint64_t last = written.load(std::memory_order_acquire);
+    std::uint64_t first = std::max<std::uint64_t>(since, last > HISTORY_SIZE ? last - HISTORY_SIZE : 0) + 1;
+
+    std::vector<record_t> records;
+    records.reserve(last >= first ? last - first + 1 : 0);
+
+    for (std::uint64_t seq = first; seq <= last; seq++)
+    {
+        const slot_t & slot = history[(seq - 1) % HISTORY_SIZE];
+
+        if (slot.seq.load(std::memory_order_acquire) != seq)
+        {
+            continue; // overwritten in the meantime
+        }
+
+        std::uint64_t words[RECORD_WORDS];
+
+        for (unsigned int i = 0; i < RECORD_WORDS; i++)
+        {
+            words[i] = slot.words[i].load(std::memory_order_relaxed);
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if (slot.seq.load(std::memory_order_relaxed) == seq)
+        {
+            record_t record;
+            std::memcpy(&record, words, sizeof(record_t));
+            records.push_back(record);
+        }
+    }
+
+    return records;
+}
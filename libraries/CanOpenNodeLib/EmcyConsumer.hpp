@@ -5,8 +5,13 @@
 
 #include <cstdint>
 
-#include <functional>
+#include <array>
+#include <atomic>
 #include <string>
+#include <utility>
+#include <vector>
+
+#include "InplaceFunction.hpp"
 
 namespace roboticslab
 {
@@ -28,23 +33,53 @@ public:
 /**
  * @ingroup CanOpenNodeLib
  * @brief Representation of CAN EMCY protocol.
+ *
+ * Keeps a fixed-size history of timestamped emergency messages, filled by
+ * @ref accept without allocating memory nor locking, whether a callback has
+ * been registered or not. Older records are overwritten once the history is
+ * full. Readers may query it concurrently
+ * from any other thread, and are expected to translate error codes into
+ * human-readable strings there, i.e. not in the CAN read thread.
  */
 class EmcyConsumer final
 {
 public:
     typedef std::pair<std::uint16_t, std::string> code_t; ///< Emergency error code
 
+    //! Timestamped emergency message.
+    struct record_t
+    {
+        std::uint64_t seq; ///< sequence number, starting at 1
+        double timestamp; ///< reception time (seconds)
+        std::uint16_t code; ///< emergency error code
+        std::uint8_t reg; ///< error register
+        std::uint8_t msef[5]; ///< manufacturer-specific error field
+    };
+
+    static constexpr unsigned int HISTORY_SIZE = 32; ///< Number of stored records
+
     //! Constructor.
-    EmcyConsumer() : codeRegistry(new EmcyCodeRegistry)
+    EmcyConsumer() : codeRegistry(new EmcyCodeRegistry), written(0)
     { }
 
     //! Destructor.
     ~EmcyConsumer()
     { delete codeRegistry; }
 
-    //! Invoke callback on parsed CAN message data.
+    //! Store parsed CAN message data and invoke callback, if any.
     bool accept(const std::uint8_t * data);
 
+    //! Retrieve stored records with sequence number greater than the given one, oldest first.
+    std::vector<record_t> getHistory(std::uint64_t since = 0) const;
+
+    //! Sequence number of the last stored record, zero if none.
+    std::uint64_t getLastSequence() const
+    { return written.load(std::memory_order_acquire); }
+
+    //! Obtain string representation of an EMCY code and its message.
+    code_t codeToMessage(std::uint16_t code) const
+    { return std::make_pair(code, codeRegistry->codeToMessage(code)); }
+
     //! Instantiate a non-default EMCY message parser.
     template<typename T>
     void setErrorCodeRegistry()
@@ -54,17 +89,28 @@ public:
     //! Register callback.
     template<typename Fn>
     void registerHandler(Fn && fn)
-    { callback = fn; }
+    { callback = std::forward<Fn>(fn); }
 
     //! Unregister callback.
     void unregisterHandler()
-    { callback = HandlerFn(); }
+    { callback.reset(); }
 
 private:
-    typedef std::function<void(code_t, std::uint8_t, const std::uint8_t *)> HandlerFn;
+    typedef InplaceFunction<void(std::uint16_t, std::uint8_t, const std::uint8_t *)> HandlerFn;
+
+    static constexpr unsigned int RECORD_WORDS = (sizeof(record_t) + 7) / 8;
+
+    struct slot_t
+    {
+        std::atomic<std::uint64_t> seq {0}; // zero while being written
+        std::array<std::atomic<std::uint64_t>, RECORD_WORDS> words; // record_t, bitwise
+    };
 
     HandlerFn callback;
     EmcyCodeRegistry * codeRegistry;
+
+    std::array<slot_t, HISTORY_SIZE> history;
+    std::atomic<std::uint64_t> written;
 };
 
 } // namespace roboticslab
@@ -0,0 +1,42 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __I_CIA402_DRIVE_HPP__
+#define __I_CIA402_DRIVE_HPP__
+
+#include "DriveStatusMachine.hpp"
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup CanOpenNodeLib
+ * @brief Abstract base for a CAN node that implements a CiA 402 drive.
+ *
+ * Allows a CAN master to transition the state machines of several drives at
+ * once via @ref DriveStatusMachine::requestStates. The node decides whether
+ * and which drive state the requested control mode entails, the remaining
+ * mode-specific setup is performed in the ensuing call to
+ * `IControlModeRaw::setControlModeRaw`.
+ */
+class ICiA402Drive
+{
+public:
+    //! Destructor.
+    virtual ~ICiA402Drive() = default;
+
+    //! Retrieve a handle to the drive state machine.
+    virtual DriveStatusMachine * getDriveStatusMachine() = 0;
+
+    /**
+     * @brief Prepare a control mode switch, to be completed by setControlModeRaw.
+     * @param mode Requested control mode (YARP vocab).
+     * @param state Drive state to be requested by the master.
+     * @return False if the node handles the switch on its own, e.g. the mode
+     * is unchanged, the drive is faulted or preparation failed.
+     */
+    virtual bool prepareControlModeRaw(int mode, DriveState * state) = 0;
+};
+
+} // namespace roboticslab
+
+#endif // __I_CIA402_DRIVE_HPP__
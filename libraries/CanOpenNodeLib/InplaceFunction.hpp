@@ -0,0 +1,187 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __INPLACE_FUNCTION_HPP__
+#define __INPLACE_FUNCTION_HPP__
+
+#include <cstddef>
+
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace roboticslab
+{
+
+template<typename Signature, std::size_t Capacity = 64>
+class InplaceFunction;
+
+/**
+ * @ingroup CanOpenNodeLib
+ * @brief Small-buffer, non-allocating replacement of std::function.
+ *
+ * Stores the callable object in an internal buffer of fixed size, therefore
+ * registering or invoking a callback never allocates memory. Callables that
+ * don't fit in said buffer are rejected at compile time. Invocation resolves
+ * to a single indirect call through a function pointer.
+ *
+ * @tparam R Return type.
+ * @tparam Args Argument types.
+ * @tparam Capacity Size of the internal buffer (bytes).
+ */
+template<typename R, typename... Args, std::size_t Capacity>
+class InplaceFunction<R(Args...), Capacity> final
+{
+public:
+    //! Constructor, creates an empty instance.
+    InplaceFunction() noexcept
+        : invoker(nullptr), manager(nullptr)
+    { }
+
+    //! Constructor, stores a copy of the callable object.
+    template<typename Fn, typename = typename std::enable_if<
+            !std::is_same<typename std::decay<Fn>::type, InplaceFunction>::value>::type>
+    InplaceFunction(Fn && fn)
+        : invoker(nullptr), manager(nullptr)
+    { emplace(std::forward<Fn>(fn)); }
+
+    //! Copy constructor.
+    InplaceFunction(const InplaceFunction & other)
+        : invoker(other.invoker), manager(other.manager)
+    {
+        if (manager)
+        {
+            manager(Operation::COPY, &storage, &other.storage);
+        }
+    }
+
+    //! Move constructor, leaves the other instance empty.
+    InplaceFunction(InplaceFunction && other) noexcept
+        : invoker(other.invoker), manager(other.manager)
+    {
+        if (manager)
+        {
+            manager(Operation::MOVE, &storage, &other.storage);
+            other.reset();
+        }
+    }
+
+    //! Destructor.
+    ~InplaceFunction()
+    { reset(); }
+
+    //! Copy assignment operator.
+    InplaceFunction & operator=(const InplaceFunction & other)
+    {
+        if (this != &other)
+        {
+            reset();
+
+            if (other.manager)
+            {
+                other.manager(Operation::COPY, &storage, &other.storage);
+            }
+
+            invoker = other.invoker;
+            manager = other.manager;
+        }
+
+        return *this;
+    }
+
+    //! Move assignment operator, leaves the other instance empty.
+    InplaceFunction & operator=(InplaceFunction && other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+
+            if (other.manager)
+            {
+                other.manager(Operation::MOVE, &storage, &other.storage);
+            }
+
+            invoker = other.invoker;
+            manager = other.manager;
+            other.reset();
+        }
+
+        return *this;
+    }
+
+    //! Assignment operator, replaces the stored callable object.
+    template<typename Fn, typename = typename std::enable_if<
+            !std::is_same<typename std::decay<Fn>::type, InplaceFunction>::value>::type>
+    InplaceFunction & operator=(Fn && fn)
+    {
+        emplace(std::forward<Fn>(fn));
+        return *this;
+    }
+
+    //! Check whether a callable object is stored.
+    explicit operator bool() const noexcept
+    { return invoker != nullptr; }
+
+    //! Invoke the stored callable object, must not be empty.
+    R operator()(Args... args) const
+    { return invoker(&storage, std::forward<Args>(args)...); }
+
+    //! Destroy the stored callable object, if any.
+    void reset() noexcept
+    {
+        if (manager)
+        {
+            manager(Operation::DESTROY, &storage, nullptr);
+        }
+
+        invoker = nullptr;
+        manager = nullptr;
+    }
+
+private:
+    enum class Operation { COPY, MOVE, DESTROY };
+
+    using storage_t = typename std::aligned_storage<Capacity, alignof(std::max_align_t)>::type;
+    using invoker_t = R (*)(storage_t *, Args...);
+    using manager_t = void (*)(Operation, storage_t *, storage_t *);
+
+    template<typename Fn>
+    void emplace(Fn && fn)
+    {
+        using F = typename std::decay<Fn>::type;
+        static_assert(sizeof(F) <= Capacity, "Callable object exceeds inplace storage capacity.");
+        static_assert(alignof(F) <= alignof(storage_t), "Callable object is overaligned.");
+        reset();
+        new (&storage) F(std::forward<Fn>(fn));
+        invoker = &invoke<F>;
+        manager = &manage<F>;
+    }
+
+    template<typename F>
+    static R invoke(storage_t * storage, Args... args)
+    { return (*reinterpret_cast<F *>(storage))(std::forward<Args>(args)...); }
+
+    template<typename F>
+    static void manage(Operation op, storage_t * dst, storage_t * src)
+    {
+        switch (op)
+        {
+        case Operation::COPY:
+            new (dst) F(*reinterpret_cast<const F *>(src));
+            break;
+        case Operation::MOVE:
+            new (dst) F(std::move(*reinterpret_cast<F *>(src)));
+            break;
+        case Operation::DESTROY:
+            reinterpret_cast<F *>(dst)->~F();
+            break;
+        }
+    }
+
+    mutable storage_t storage;
+    invoker_t invoker;
+    manager_t manager;
+};
+
+} // namespace roboticslab
+
+#endif // __INPLACE_FUNCTION_HPP__
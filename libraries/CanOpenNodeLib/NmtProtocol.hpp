@@ -5,9 +5,10 @@
 
 #include <cstdint>
 
-#include <functional>
+#include <utility>
 
 #include "CanSenderDelegate.hpp"
+#include "InplaceFunction.hpp"
 
 namespace roboticslab
 {
@@ -64,14 +65,14 @@ public:
     //! Register callback.
     template<typename Fn>
     void registerHandler(Fn && fn)
-    { callback = fn; }
+    { callback = std::forward<Fn>(fn); }
 
     //! Unregister callback.
     void unregisterHandler()
-    { callback = HandlerFn(); }
+    { callback.reset(); }
 
 private:
-    typedef std::function<void(NmtState)> HandlerFn;
+    typedef InplaceFunction<void(NmtState)> HandlerFn;
 
     std::uint8_t id;
     CanSenderDelegate * sender;
@@ -0,0 +1,75 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __OBJECT_DICTIONARY_HPP__
+#define __OBJECT_DICTIONARY_HPP__
+
+#include <cstdint>
+
+#include <string>
+#include <type_traits>
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup CanOpenNodeLib
+ * @brief Access type of a CAN dictionary object, as stated in EDS files.
+ */
+enum class ObjectAccess
+{
+    RO, ///< Read only
+    WO, ///< Write only
+    RW, ///< Read and write
+    CONST ///< Read only, constant value
+};
+
+//! Common base of all CAN dictionary object descriptors.
+struct ObjectEntryBase
+{};
+
+/**
+ * @ingroup CanOpenNodeLib
+ * @brief Compile-time descriptor of a CAN dictionary object.
+ *
+ * Carries the data type, index, subindex, access type and PDO mappability of a
+ * single entry of the object dictionary. Concrete descriptors derive from this
+ * class and provide a static `name()` member function, usually generated from
+ * an EDS file (see `roboticslab_generate_object_dictionary()` in CMake). Used
+ * by @ref SdoClient and @ref PdoConfiguration to reject mismatched data types,
+ * forbidden accesses and non-mappable objects at compile time.
+ *
+ * @tparam T Data type of the object, either integral or `std::string`.
+ * @tparam Index Index of the object.
+ * @tparam Subindex Subindex of the object.
+ * @tparam Access Access type of the object.
+ * @tparam PdoMappable Whether the object can be mapped into a PDO.
+ */
+template<typename T, std::uint16_t Index, std::uint8_t Subindex, ObjectAccess Access, bool PdoMappable>
+struct ObjectEntry : ObjectEntryBase
+{
+    static_assert(std::is_integral<T>::value || std::is_same<T, std::string>::value, "Integral or string required.");
+
+    using type = T;
+
+    static constexpr std::uint16_t index = Index;
+    static constexpr std::uint8_t subindex = Subindex;
+    static constexpr ObjectAccess access = Access;
+    static constexpr bool pdoMappable = PdoMappable;
+    static constexpr bool readable = Access != ObjectAccess::WO;
+    static constexpr bool writable = Access == ObjectAccess::RW || Access == ObjectAccess::WO;
+};
+
+template<typename T, std::uint16_t Index, std::uint8_t Subindex, ObjectAccess Access, bool PdoMappable>
+constexpr std::uint16_t ObjectEntry<T, Index, Subindex, Access, PdoMappable>::index;
+
+template<typename T, std::uint16_t Index, std::uint8_t Subindex, ObjectAccess Access, bool PdoMappable>
+constexpr std::uint8_t ObjectEntry<T, Index, Subindex, Access, PdoMappable>::subindex;
+
+//! Type trait, evaluates to true if the template parameter is an object descriptor.
+template<typename T>
+struct is_object_entry : std::is_base_of<ObjectEntryBase, T>
+{};
+
+} // namespace roboticslab
+
+#endif // __OBJECT_DICTIONARY_HPP__
@@ -19,6 +19,36 @@ using std::optional;
 
 using namespace roboticslab;
 
+bool PdoTransmissionType::fromByte(std::uint8_t n, PdoTransmissionType * type)
+{
+    switch (n)
+    {
+    case SYNCHRONOUS_ACYCLIC:
+        *type = SYNCHRONOUS_ACYCLIC;
+        return true;
+    case RTR_SYNCHRONOUS:
+        *type = RTR_SYNCHRONOUS;
+        return true;
+    case RTR_EVENT_DRIVEN:
+        *type = RTR_EVENT_DRIVEN;
+        return true;
+    case EVENT_DRIVEN_MANUFACTURER:
+        *type = EVENT_DRIVEN_MANUFACTURER;
+        return true;
+    case EVENT_DRIVEN_DEVICE_APP_PROFILE:
+        *type = EVENT_DRIVEN_DEVICE_APP_PROFILE;
+        return true;
+    default:
+        if (n <= 0xF0) // synchronous cyclic, every n-th SYNC
+        {
+            *type = SYNCHRONOUS_CYCLIC_N(n);
+            return true;
+        }
+
+        return false; // reserved
+    }
+}
+
 struct PdoConfiguration::Private
 {
     optional<bool> valid;
@@ -221,8 +251,3 @@ bool ReceivePdo::writeInternal(const std::uint8_t * data, unsigned int size)
 {
     return sender && sender->prepareMessage({getCobId(), size, data});
 }
-
-void TransmitPdo::unpackInternal(void * data, const std::uint8_t * buff, unsigned int size)
-{
-    std::memcpy(data, buff, size);
-}
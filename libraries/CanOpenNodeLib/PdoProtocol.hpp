@@ -5,12 +5,14 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 
-#include <functional>
 #include <type_traits>
 #include <utility> // std::forward
 
 #include "CanSenderDelegate.hpp"
+#include "InplaceFunction.hpp"
+#include "ObjectDictionary.hpp"
 #include "SdoClient.hpp"
 
 namespace roboticslab
@@ -51,6 +53,9 @@ public:
     static constexpr PdoTransmissionType SYNCHRONOUS_CYCLIC_N(std::uint8_t n)
     { return static_cast<transmission_type>(n); }
 
+    //! Convert input byte to a @ref PdoTransmissionType, returns false if reserved [0xF1-0xFB].
+    static bool fromByte(std::uint8_t n, PdoTransmissionType * type);
+
     //! Cast input byte to an @ref PdoTransmissionType enumerator, performs static check on range [0x01-0xF0].
     template<std::uint8_t n>
     static constexpr PdoTransmissionType SYNCHRONOUS_CYCLIC_N()
@@ -121,6 +126,18 @@ public:
         return *this;
     }
 
+    /**
+     * @brief Map a CAN dictionary object, typed object descriptor.
+     * @tparam Obj Object descriptor type, see @ref ObjectEntry.
+     * @return A reference to itself.
+     */
+    template<typename Obj, typename = typename std::enable_if<is_object_entry<Obj>::value>::type>
+    PdoConfiguration & addMapping(Obj)
+    {
+        static_assert(Obj::pdoMappable, "Object is not PDO-mappable.");
+        return addMapping<typename Obj::type>(Obj::index, Obj::subindex);
+    }
+
 private:
     void addMappingInternal(std::uint32_t value);
 
@@ -254,16 +271,26 @@ public:
               return size<Ts...>() == len && (ordered_call{fn, unpack<Ts>(raw, &count)...}, true); };
     }
 
+    /**
+     * @brief Register callback that parses raw CAN message data.
+     *
+     * Aimed for mappings that are only known at runtime. The callback must
+     * check the incoming message length and unpack the mapped objects itself.
+     */
+    template<typename Fn>
+    void registerRawHandler(Fn && fn)
+    { callback = std::forward<Fn>(fn); }
+
     //! Unregister callback.
     void unregisterHandler()
-    { callback = HandlerFn(); }
+    { callback.reset(); }
 
 protected:
     virtual PdoType getType() const override
     { return PdoType::TPDO; }
 
 private:
-    typedef std::function<bool(const std::uint8_t * data, unsigned int size)> HandlerFn;
+    typedef InplaceFunction<bool(const std::uint8_t * data, unsigned int size)> HandlerFn;
 
     // https://stackoverflow.com/a/14058638
     struct ordered_call
@@ -278,13 +305,11 @@ private:
     {
         static_assert(std::is_integral<T>::value, "Integral required.");
         T data;
-        unpackInternal(&data, buff + *count, sizeof(T));
+        std::memcpy(&data, buff + *count, sizeof(T));
         *count += sizeof(T);
         return data;
     }
 
-    void unpackInternal(void * data, const std::uint8_t * buff, unsigned int size);
-
     HandlerFn callback;
 };
 
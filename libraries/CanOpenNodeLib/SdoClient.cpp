@@ -2,9 +2,12 @@
 
 #include "SdoClient.hpp"
 
+#include <cmath>
 #include <cstring>
 
+#include <algorithm>
 #include <bitset>
+#include <chrono>
 #include <string>
 
 #include <yarp/os/Log.h>
@@ -106,7 +109,85 @@ bool SdoClient::ping()
     return send(requestMsg) && stateObserver.await(responseMsg);
 }
 
+void SdoClient::enableAdaptiveTimeout(const adaptive_policy & _policy)
+{
+    policy = _policy;
+    estimatedTimeout = std::min(std::max(stateObserver.getTimeout(), policy.minTimeout), policy.maxTimeout);
+    smoothedRtt = 0.0;
+    rttVariance = 0.0;
+    adaptive = true;
+}
+
+void SdoClient::updateTimeout(double rtt)
+{
+    // RFC 6298
+    if (smoothedRtt == 0.0)
+    {
+        smoothedRtt = rtt;
+        rttVariance = rtt / 2.0;
+    }
+    else
+    {
+        rttVariance = 0.75 * rttVariance + 0.25 * std::abs(smoothedRtt - rtt);
+        smoothedRtt = 0.875 * smoothedRtt + 0.125 * rtt;
+    }
+
+    estimatedTimeout = std::min(std::max(smoothedRtt + 4.0 * rttVariance, policy.minTimeout), policy.maxTimeout);
+}
+
 bool SdoClient::uploadInternal(const std::string & name, void * data, std::uint32_t size, std::uint16_t index, std::uint8_t subindex)
+{
+    auto start = std::chrono::steady_clock::now();
+    bool ok = performUpload(name, data, size, index, subindex);
+
+    // uploads are idempotent, retry on timeouts only (the drive did answer on aborts)
+    while (!ok && adaptive && lastStatus == transfer_status::TIMEOUT && attempt < policy.retries)
+    {
+        attempt++;
+        statistics.addRetry(index, subindex);
+        yWarning("SDO client request (\"%s\") retry %u/%u (id %d)", name.c_str(), attempt, policy.retries, id);
+        start = std::chrono::steady_clock::now(); // Karn's algorithm: only time the last attempt
+        ok = performUpload(name, data, size, index, subindex);
+    }
+
+    attempt = 0;
+    std::chrono::duration<double> rtt = std::chrono::steady_clock::now() - start;
+    registerTransfer(index, subindex, ok, rtt.count());
+    return ok;
+}
+
+bool SdoClient::downloadInternal(const std::string & name, const void * data, std::uint32_t size, std::uint16_t index, std::uint8_t subindex)
+{
+    auto start = std::chrono::steady_clock::now();
+    bool ok = performDownload(name, data, size, index, subindex);
+    std::chrono::duration<double> rtt = std::chrono::steady_clock::now() - start;
+    registerTransfer(index, subindex, ok, rtt.count());
+    return ok;
+}
+
+void SdoClient::registerTransfer(std::uint16_t index, std::uint8_t subindex, bool ok, double rtt)
+{
+    if (ok)
+    {
+        statistics.addSample(index, subindex, rtt);
+        return;
+    }
+
+    switch (lastStatus)
+    {
+    case transfer_status::TIMEOUT:
+        statistics.addTimeout(index, subindex);
+        break;
+    case transfer_status::ABORT:
+        statistics.addAbort(index, subindex, lastAbortCode);
+        break;
+    default: // also when the last frame was confirmed, but the payload was wrong
+        statistics.addError(index, subindex);
+        break;
+    }
+}
+
+bool SdoClient::performUpload(const std::string & name, void * data, std::uint32_t size, std::uint16_t index, std::uint8_t subindex)
 {
     std::uint8_t requestMsg[8] = {0};
 
@@ -203,7 +284,7 @@ bool SdoClient::uploadInternal(const std::string & name, void * data, std::uint3
     return true;
 }
 
-bool SdoClient::downloadInternal(const std::string & name, const void * data, std::uint32_t size, std::uint16_t index, std::uint8_t subindex)
+bool SdoClient::performDownload(const std::string & name, const void * data, std::uint32_t size, std::uint16_t index, std::uint8_t subindex)
 {
     std::uint8_t indicationMsg[8] = {0};
     std::memcpy(indicationMsg + 1, &index, 2);
@@ -335,26 +416,53 @@ bool SdoClient::performTransfer(const std::string & name, const std::uint8_t * r
 {
     yInfo("SDO client transfer (\"%s\") %s", name.c_str(), msgToStr(cobRx, req).c_str());
 
+    lastStatus = transfer_status::ERROR;
+
+    bool isAdaptive = adaptive;
+    auto start = std::chrono::steady_clock::now();
+
     if (!send(req))
     {
         yError("SDO client request/indication (\"%s\") unable to send packet (id %d)", name.c_str(), id);
         return false;
     }
 
-    if (!stateObserver.await(resp))
+    if (isAdaptive)
+    {
+        // exponential backoff on retries
+        double timeout = std::min(estimatedTimeout * std::exp2(attempt), policy.maxTimeout);
+
+        if (!stateObserver.awaitFor(resp, timeout))
+        {
+            yError("SDO client request/indication (\"%s\") inactive/timeout after %f seconds (id %d)", name.c_str(), timeout, id);
+            lastStatus = transfer_status::TIMEOUT;
+            return false;
+        }
+
+        // Karn's algorithm: a response to a retried request is ambiguous, don't sample it
+        if (attempt == 0)
+        {
+            std::chrono::duration<double> rtt = std::chrono::steady_clock::now() - start;
+            updateTimeout(rtt.count());
+        }
+    }
+    else if (!stateObserver.await(resp))
     {
         yError("SDO client request/indication (\"%s\") inactive/timeout (id %d)", name.c_str(), id);
+        lastStatus = transfer_status::TIMEOUT;
         return false;
     }
 
     if (resp[0] == 0x80) // SDO abort transfer (ccs)
     {
-        std::uint32_t code;
-        std::memcpy(&code, resp + 4, sizeof(code));
-        yError("SDO transfer abort (\"%s\"): %s (id %d)", name.c_str(), parseAbortCode(code).c_str(), id);
+        std::memcpy(&lastAbortCode, resp + 4, sizeof(lastAbortCode));
+        yError("SDO transfer abort (\"%s\"): %s (id %d)", name.c_str(), parseAbortCode(lastAbortCode).c_str(), id);
+        lastStatus = transfer_status::ABORT;
         return false;
     }
 
+    lastStatus = transfer_status::OK;
+
     yInfo("SDO server transfer (\"%s\") %s", name.c_str(), msgToStr(cobTx, resp).c_str());
     return true;
 }
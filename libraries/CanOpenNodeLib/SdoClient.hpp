@@ -5,11 +5,14 @@
 
 #include <cstdint>
 
+#include <atomic>
 #include <string>
 #include <type_traits>
 #include <utility>
 
 #include "CanSenderDelegate.hpp"
+#include "ObjectDictionary.hpp"
+#include "SdoStatistics.hpp"
 #include "StateObserver.hpp"
 
 namespace roboticslab
@@ -26,11 +29,26 @@ namespace roboticslab
  * the upload/download data type and takes care of managing the handshake.
  * SDO transfers block with timeout and always wait for the response or confirm
  * message from the drive, signalizing failures accordingly. Also supports SDO
- * abort protocol.
+ * abort protocol. Latency and failures of each transfer are accounted for in
+ * @ref SdoStatistics, see @ref getStatistics.
+ *
+ * An optional adaptive policy replaces the fixed timeout with an estimate
+ * derived from measured round-trip times (smoothed mean plus four times the
+ * mean deviation, as in TCP), and retries timed-out uploads with an exponential
+ * backoff of the timeout. Downloads are never retried since they might not be
+ * idempotent.
  */
 class SdoClient final
 {
 public:
+    //! Adaptive timeout and retry policy.
+    struct adaptive_policy
+    {
+        double minTimeout; ///< Lower bound of the estimated timeout (seconds)
+        double maxTimeout; ///< Upper bound of the estimated timeout, also of retries (seconds)
+        unsigned int retries; ///< Maximum number of retries of a timed-out upload
+    };
+
     //! Constructor, registers CAN sender handle.
     SdoClient(std::uint8_t id, std::uint16_t cobRx, std::uint16_t cobTx, double timeout, CanSenderDelegate * sender = nullptr)
         : id(id), cobRx(cobRx), cobTx(cobTx), sender(sender), stateObserver(timeout)
@@ -55,6 +73,29 @@ public:
     //! Test whether the node is available or not.
     bool ping();
 
+    //! Retrieve transfer statistics of this client.
+    const SdoStatistics & getStatistics() const
+    { return statistics; }
+
+    //! Clear transfer statistics of this client.
+    void resetStatistics()
+    { statistics.reset(); }
+
+    //! Derive timeouts from measured round-trip times and retry timed-out uploads.
+    void enableAdaptiveTimeout(const adaptive_policy & policy);
+
+    //! Revert to the fixed timeout passed on construction.
+    void disableAdaptiveTimeout()
+    { adaptive = false; }
+
+    //! Retrieve the timeout applied to the next transfer (seconds).
+    double getTimeout() const
+    { return adaptive ? estimatedTimeout.load() : stateObserver.getTimeout(); }
+
+    //! Retrieve the smoothed round-trip time (seconds), zero if there are no samples.
+    double getSmoothedRtt() const
+    { return smoothedRtt; }
+
     /**
      * @brief Request an SDO package from the drive, only integral types.
      * @tparam T Integral data type.
@@ -147,13 +188,72 @@ public:
     bool download(const std::string & name, const char * s, std::uint16_t index, std::uint8_t subindex = 0x00)
     { return download(name, std::string(s), index, subindex); }
 
+    /**
+     * @brief Request an SDO package from the drive, typed object descriptor.
+     * @tparam Obj Object descriptor type, see @ref ObjectEntry.
+     * @param data Pointer to an external storage, will be populated with
+     * received CAN data.
+     * @return True on success, false on timeout.
+     */
+    template<typename Obj, typename = typename std::enable_if<is_object_entry<Obj>::value>::type>
+    bool upload(Obj, typename Obj::type * data)
+    {
+        static_assert(Obj::readable, "Object is not readable.");
+        return uploadEntry(Obj::name(), data, Obj::index, Obj::subindex);
+    }
+
+    /**
+     * @brief Request an SDO package from the drive with callback, typed object descriptor.
+     * @tparam Obj Object descriptor type, see @ref ObjectEntry.
+     * @tparam Fn Function object type.
+     * @param obj Descriptor of the targeted CAN dictionary object.
+     * @param fn Callback function, will be invoked with the received CAN data
+     * as input parameter.
+     * @return True on success, false on timeout.
+     */
+    template<typename Obj, typename Fn, typename = typename std::enable_if<is_object_entry<Obj>::value
+            && !std::is_pointer<typename std::decay<Fn>::type>::value>::type>
+    bool upload(Obj obj, Fn && fn)
+    {
+        typename Obj::type data;
+        return upload(obj, &data) && (std::forward<Fn>(fn)(data), true);
+    }
+
+    /**
+     * @brief Send an SDO package to the drive, typed object descriptor.
+     * @tparam Obj Object descriptor type, see @ref ObjectEntry.
+     * @tparam T Data type, must match the one of the object (cast beforehand).
+     * @param data Value to be sent.
+     * @return True on success, false on timeout.
+     */
+    template<typename Obj, typename T, typename = typename std::enable_if<is_object_entry<Obj>::value>::type>
+    bool download(Obj, const T & data)
+    {
+        static_assert(Obj::writable, "Object is not writable.");
+        static_assert(std::is_same<T, typename Obj::type>::value, "Data type does not match the object.");
+        return download(Obj::name(), data, Obj::index, Obj::subindex);
+    }
+
 private:
     bool send(const std::uint8_t * msg);
     std::string msgToStr(std::uint16_t cob, const std::uint8_t * msgData);
 
+    enum class transfer_status { OK, TIMEOUT, ABORT, ERROR };
+
     bool uploadInternal(const std::string & name, void * data, std::uint32_t size, std::uint16_t index, std::uint8_t subindex);
     bool downloadInternal(const std::string & name, const void * data, std::uint32_t size, std::uint16_t index, std::uint8_t subindex);
+    bool performUpload(const std::string & name, void * data, std::uint32_t size, std::uint16_t index, std::uint8_t subindex);
+    bool performDownload(const std::string & name, const void * data, std::uint32_t size, std::uint16_t index, std::uint8_t subindex);
     bool performTransfer(const std::string & name, const std::uint8_t * req, std::uint8_t * resp);
+    void registerTransfer(std::uint16_t index, std::uint8_t subindex, bool ok, double rtt);
+    void updateTimeout(double rtt);
+
+    template<typename T>
+    bool uploadEntry(const std::string & name, T * data, std::uint16_t index, std::uint8_t subindex)
+    { return upload(name, data, index, subindex); }
+
+    bool uploadEntry(const std::string & name, std::string * s, std::uint16_t index, std::uint8_t subindex)
+    { return upload(name, *s, index, subindex); }
 
     std::uint8_t id;
     std::uint16_t cobRx;
@@ -161,6 +261,17 @@ private:
 
     CanSenderDelegate * sender;
     TypedStateObserver<std::uint8_t[]> stateObserver;
+
+    SdoStatistics statistics;
+    transfer_status lastStatus = transfer_status::OK;
+    std::uint32_t lastAbortCode = 0;
+
+    std::atomic<bool> adaptive {false};
+    adaptive_policy policy {};
+    unsigned int attempt = 0;
+    std::atomic<double> estimatedTimeout {0.0};
+    std::atomic<double> smoothedRtt {0.0};
+    double rttVariance = 0.0;
 };
 
 } // namespace roboticslab
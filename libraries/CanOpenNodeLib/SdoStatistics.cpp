@@ -0,0 +1,162 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#include "SdoStatistics.hpp"
+
+#include <cmath>
+
+#include <algorithm>
+
+using namespace roboticslab;
+
+namespace
+{
+    constexpr double HISTOGRAM_BASE = 10e-6; // [s]
+    constexpr double BUCKETS_PER_OCTAVE = 4.0;
+
+    unsigned int rttToBucket(double rtt)
+    {
+        if (rtt <= HISTOGRAM_BASE)
+        {
+            return 0;
+        }
+
+        double bucket = std::ceil(BUCKETS_PER_OCTAVE * std::log2(rtt / HISTOGRAM_BASE));
+        return std::min<double>(bucket, SdoStatistics::HISTOGRAM_BUCKETS - 1);
+    }
+
+    double bucketToRtt(unsigned int bucket)
+    {
+        return HISTOGRAM_BASE * std::exp2(bucket / BUCKETS_PER_OCTAVE); // upper bound
+    }
+
+    template<typename T>
+    double percentile(const T & histogram, std::uint64_t count, double max, double q)
+    {
+        if (count == 0)
+        {
+            return 0.0;
+        }
+
+        std::uint64_t target = std::ceil(q * count);
+        std::uint64_t accumulated = 0;
+
+        for (unsigned int i = 0; i < histogram.size(); i++)
+        {
+            accumulated += histogram[i];
+
+            if (accumulated >= target)
+            {
+                return std::min(bucketToRtt(i), max);
+            }
+        }
+
+        return max;
+    }
+}
+
+constexpr unsigned int SdoStatistics::HISTOGRAM_BUCKETS;
+
+void SdoStatistics::entry::merge(const entry & other)
+{
+    for (unsigned int i = 0; i < histogram.size(); i++)
+    {
+        histogram[i] += other.histogram[i];
+    }
+
+    count += other.count;
+    timeouts += other.timeouts;
+    aborts += other.aborts;
+    errors += other.errors;
+    retries += other.retries;
+    max = std::max(max, other.max);
+
+    for (const auto & code : other.abortCodes)
+    {
+        abortCodes[code.first] += code.second;
+    }
+}
+
+SdoStatistics::object_stats SdoStatistics::entry::toStats(std::uint16_t index, std::uint8_t subindex) const
+{
+    object_stats stats;
+    stats.index = index;
+    stats.subindex = subindex;
+    stats.count = count;
+    stats.timeouts = timeouts;
+    stats.aborts = aborts;
+    stats.errors = errors;
+    stats.retries = retries;
+    stats.p50 = percentile(histogram, count, max, 0.5);
+    stats.p99 = percentile(histogram, count, max, 0.99);
+    stats.max = max;
+    stats.abortCodes.assign(abortCodes.cbegin(), abortCodes.cend());
+    return stats;
+}
+
+void SdoStatistics::addSample(std::uint16_t index, std::uint8_t subindex, double rtt)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto & e = entries[makeKey(index, subindex)];
+    e.histogram[rttToBucket(rtt)]++;
+    e.count++;
+    e.max = std::max(e.max, rtt);
+}
+
+void SdoStatistics::addTimeout(std::uint16_t index, std::uint8_t subindex)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    entries[makeKey(index, subindex)].timeouts++;
+}
+
+void SdoStatistics::addAbort(std::uint16_t index, std::uint8_t subindex, std::uint32_t code)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto & e = entries[makeKey(index, subindex)];
+    e.aborts++;
+    e.abortCodes[code]++;
+}
+
+void SdoStatistics::addError(std::uint16_t index, std::uint8_t subindex)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    entries[makeKey(index, subindex)].errors++;
+}
+
+void SdoStatistics::addRetry(std::uint16_t index, std::uint8_t subindex)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    entries[makeKey(index, subindex)].retries++;
+}
+
+std::vector<SdoStatistics::object_stats> SdoStatistics::getObjectStats() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<object_stats> stats;
+    stats.reserve(entries.size());
+
+    for (const auto & e : entries)
+    {
+        stats.push_back(e.second.toStats(e.first >> 8, e.first & 0xFF));
+    }
+
+    return stats;
+}
+
+SdoStatistics::object_stats SdoStatistics::getSummary() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    entry summary;
+
+    for (const auto & e : entries)
+    {
+        summary.merge(e.second);
+    }
+
+    return summary.toStats(0, 0);
+}
+
+void SdoStatistics::reset()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+}
@@ -0,0 +1,97 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __SDO_STATISTICS_HPP__
+#define __SDO_STATISTICS_HPP__
+
+#include <cstdint>
+
+#include <array>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup CanOpenNodeLib
+ * @brief Latency and failure statistics of SDO transfers, keyed by object.
+ *
+ * Round-trip times of confirmed transfers are stored in a fixed log-scale
+ * histogram (four buckets per octave, starting at 10 microseconds), hence
+ * percentiles are approximations bounded by a relative error of about 19%.
+ * Timeouts, aborts (along with their abort codes), retries and other protocol
+ * errors are counted separately.
+ */
+class SdoStatistics final
+{
+public:
+    static constexpr unsigned int HISTOGRAM_BUCKETS = 64;
+
+    //! Snapshot of the statistics of a single object (or an aggregate of them).
+    struct object_stats
+    {
+        std::uint16_t index;
+        std::uint8_t subindex;
+        std::uint64_t count; ///< number of successful transfers
+        std::uint64_t timeouts;
+        std::uint64_t aborts;
+        std::uint64_t errors; ///< send failures and protocol errors other than aborts
+        std::uint64_t retries; ///< repeated requests after a timeout
+        double p50; ///< median round-trip time (seconds)
+        double p99; ///< 99th percentile of round-trip time (seconds)
+        double max; ///< maximum round-trip time (seconds)
+        std::vector<std::pair<std::uint32_t, std::uint64_t>> abortCodes; ///< occurrences per abort code
+    };
+
+    //! Register a confirmed transfer and its round-trip time (seconds).
+    void addSample(std::uint16_t index, std::uint8_t subindex, double rtt);
+
+    //! Register a timed-out transfer.
+    void addTimeout(std::uint16_t index, std::uint8_t subindex);
+
+    //! Register a transfer aborted by either side.
+    void addAbort(std::uint16_t index, std::uint8_t subindex, std::uint32_t code);
+
+    //! Register a transfer that failed for any other reason.
+    void addError(std::uint16_t index, std::uint8_t subindex);
+
+    //! Register a repeated request following a timeout.
+    void addRetry(std::uint16_t index, std::uint8_t subindex);
+
+    //! Retrieve statistics per object, sorted by index and subindex.
+    std::vector<object_stats> getObjectStats() const;
+
+    //! Retrieve statistics of all objects combined, index and subindex are zero.
+    object_stats getSummary() const;
+
+    //! Clear all stored data.
+    void reset();
+
+private:
+    struct entry
+    {
+        std::array<std::uint32_t, HISTOGRAM_BUCKETS> histogram {};
+        std::uint64_t count {0};
+        std::uint64_t timeouts {0};
+        std::uint64_t aborts {0};
+        std::uint64_t errors {0};
+        std::uint64_t retries {0};
+        double max {0.0};
+        std::map<std::uint32_t, std::uint64_t> abortCodes;
+
+        void merge(const entry & other);
+        object_stats toStats(std::uint16_t index, std::uint8_t subindex) const;
+    };
+
+    static std::uint32_t makeKey(std::uint16_t index, std::uint8_t subindex)
+    { return (index << 8) + subindex; }
+
+    std::map<std::uint32_t, entry> entries;
+    mutable std::mutex mutex;
+};
+
+} // namespace roboticslab
+
+#endif // __SDO_STATISTICS_HPP__
@@ -0,0 +1,77 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#include "SyncCycleMonitor.hpp"
+
+#include <bitset>
+
+using namespace roboticslab;
+
+constexpr unsigned int SyncCycleMonitor::MAX_TPDOS;
+
+namespace
+{
+    constexpr std::uint64_t MASK = (1 << SyncCycleMonitor::MAX_TPDOS) - 1;
+}
+
+void SyncCycleMonitor::expect(unsigned int n)
+{
+    if (n >= 1 && n <= MAX_TPDOS)
+    {
+        expected |= 1 << (n - 1);
+    }
+}
+
+bool SyncCycleMonitor::beginCycle(std::uint64_t cycle, bool check)
+{
+    std::uint64_t previous = state.exchange(cycle << MAX_TPDOS);
+    std::uint64_t previousCycle = previous >> MAX_TPDOS;
+    unsigned int missing = expected & ~(previous & MASK);
+
+    if (previousCycle == 0 || !check)
+    {
+        return true;
+    }
+
+    if (missing == 0)
+    {
+        lastComplete = previousCycle;
+        return true;
+    }
+
+    lost += std::bitset<MAX_TPDOS>(missing).count();
+    return false;
+}
+
+bool SyncCycleMonitor::accept(unsigned int n, std::uint64_t * cycle)
+{
+    if (n < 1 || n > MAX_TPDOS || (expected & (1 << (n - 1))) == 0)
+    {
+        return false;
+    }
+
+    const std::uint64_t bit = 1 << (n - 1);
+    std::uint64_t current = state.load();
+
+    do
+    {
+        if (current & bit)
+        {
+            late++;
+            return false;
+        }
+    }
+    while (!state.compare_exchange_weak(current, current | bit));
+
+    if (cycle)
+    {
+        *cycle = current >> MAX_TPDOS;
+    }
+
+    return true;
+}
+
+void SyncCycleMonitor::resetCounters()
+{
+    lost = 0;
+    late = 0;
+}
@@ -0,0 +1,85 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __SYNC_CYCLE_MONITOR_HPP__
+#define __SYNC_CYCLE_MONITOR_HPP__
+
+#include <cstdint>
+
+#include <atomic>
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup CanOpenNodeLib
+ * @brief Tags synchronous TPDOs with the SYNC cycle they belong to.
+ *
+ * The CAN master announces each SYNC message via @ref beginCycle, right after
+ * it is sent. Synchronous TPDOs received thereafter are attributed to the new
+ * cycle in @ref accept. Expected TPDOs that did not arrive before the next
+ * SYNC are accounted for as lost, a second TPDO of the same kind within a single
+ * cycle is deemed a late response to the previous SYNC and discarded.
+ *
+ * Cycle numbers and the bitmask of received TPDOs share a single atomic word,
+ * hence this class is lock-free and safe to use from the SYNC and CAN reader
+ * threads at once.
+ */
+class SyncCycleMonitor final
+{
+public:
+    //! Maximum number of tracked TPDOs.
+    static constexpr unsigned int MAX_TPDOS = 8;
+
+    //! Track TPDO number @p n (starting at 1), must be called prior to @ref beginCycle.
+    void expect(unsigned int n);
+
+    //! Retrieve whether any TPDO is being tracked.
+    bool isEnabled() const
+    { return expected != 0; }
+
+    /**
+     * @brief Start a new SYNC cycle and check the previous one.
+     * @param cycle Host-side cycle number, increases monotonically (non-zero).
+     * @param check Whether missing TPDOs of the previous cycle should be accounted for.
+     * @return False if any expected TPDO of the previous cycle was lost.
+     */
+    bool beginCycle(std::uint64_t cycle, bool check = true);
+
+    /**
+     * @brief Register a synchronous TPDO.
+     * @param n TPDO number (starting at 1).
+     * @param cycle Number of the cycle this TPDO belongs to (output parameter).
+     * @return False if this TPDO arrived late or is not being tracked.
+     */
+    bool accept(unsigned int n, std::uint64_t * cycle = nullptr);
+
+    //! Retrieve number of the current cycle (zero if none has started yet).
+    std::uint64_t getCycle() const
+    { return state.load() >> MAX_TPDOS; }
+
+    //! Retrieve number of the last cycle in which all expected TPDOs were received.
+    std::uint64_t getLastCompleteCycle() const
+    { return lastComplete; }
+
+    //! Retrieve count of lost TPDOs.
+    std::uint64_t getLostCount() const
+    { return lost; }
+
+    //! Retrieve count of late TPDOs.
+    std::uint64_t getLateCount() const
+    { return late; }
+
+    //! Clear lost and late counters.
+    void resetCounters();
+
+private:
+    unsigned int expected {0};
+    std::atomic<std::uint64_t> state {0}; // cycle number followed by the bitmask of received TPDOs
+    std::atomic<std::uint64_t> lastComplete {0};
+    std::atomic<std::uint64_t> lost {0};
+    std::atomic<std::uint64_t> late {0};
+};
+
+} // namespace roboticslab
+
+#endif // __SYNC_CYCLE_MONITOR_HPP__
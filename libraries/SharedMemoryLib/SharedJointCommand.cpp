@@ -0,0 +1,224 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#include "SharedJointCommand.hpp"
+
+#include <cerrno>
+
+#include <new>
+
+#include "SharedMemoryLayout.hpp"
+
+using namespace roboticslab;
+
+// -----------------------------------------------------------------------------
+
+namespace
+{
+    constexpr int READ_ATTEMPTS = 3;
+
+    inline shm::header * getHeader(const SharedMemorySegment & segment)
+    {
+        return static_cast<shm::header *>(segment.data());
+    }
+
+    inline shm::command_slot * getSlots(const SharedMemorySegment & segment)
+    {
+        return reinterpret_cast<shm::command_slot *>(static_cast<char *>(segment.data()) + shm::alignUp(sizeof(shm::header)));
+    }
+
+    inline std::size_t getTotalSize(std::uint32_t axes)
+    {
+        return shm::alignUp(sizeof(shm::header)) + axes * sizeof(shm::command_slot);
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+bool SharedJointCommandWriter::open(const std::string & name)
+{
+    close();
+
+    if (!segment.open(name, true))
+    {
+        return false;
+    }
+
+    const auto * h = getHeader(segment);
+
+    if (segment.size() < sizeof(shm::header) || h->magic.load(std::memory_order_acquire) != shm::JOINT_COMMAND_MAGIC)
+    {
+        segment.close();
+        errno = EAGAIN; // not initialized yet, or not a set of command mailboxes
+        return false;
+    }
+
+    if (h->version != shm::VERSION || h->axes == 0 || h->recordSize != sizeof(shm::command_slot)
+        || segment.size() < getTotalSize(h->axes))
+    {
+        segment.close();
+        errno = EPROTO;
+        return false;
+    }
+
+    axes = h->axes;
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+void SharedJointCommandWriter::close()
+{
+    segment.close();
+    axes = 0;
+}
+
+// -----------------------------------------------------------------------------
+
+bool SharedJointCommandWriter::isAlive() const
+{
+    return segment.isOpen() && getHeader(segment)->closed.load(std::memory_order_acquire) == 0;
+}
+
+// -----------------------------------------------------------------------------
+
+bool SharedJointCommandWriter::write(int joint, shared_command type, double value)
+{
+    if (joint < 0 || joint >= axes)
+    {
+        return false;
+    }
+
+    auto & slot = getSlots(segment)[joint];
+    std::uint64_t sequence = slot.sequence.load(std::memory_order_relaxed);
+
+    if (sequence % 2 != 0)
+    {
+        sequence--; // a previous producer died while writing, resume from there
+    }
+
+    slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.type.store(static_cast<std::int32_t>(type), std::memory_order_relaxed);
+    slot.value.store(value, std::memory_order_relaxed);
+
+    slot.sequence.store(sequence + 2, std::memory_order_release);
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+bool SharedJointCommandWriter::setPositions(const double * refs)
+{
+    bool ok = isOpen();
+
+    for (int j = 0; j < axes; j++)
+    {
+        ok &= write(j, shared_command::POSITION_DIRECT, refs[j]);
+    }
+
+    return ok;
+}
+
+// -----------------------------------------------------------------------------
+
+bool SharedJointCommandWriter::velocityMove(const double * sp)
+{
+    bool ok = isOpen();
+
+    for (int j = 0; j < axes; j++)
+    {
+        ok &= write(j, shared_command::VELOCITY, sp[j]);
+    }
+
+    return ok;
+}
+
+// -----------------------------------------------------------------------------
+
+bool SharedJointCommandReader::open(const std::string & name, int _axes)
+{
+    close();
+
+    if (_axes <= 0)
+    {
+        errno = EINVAL;
+        return false;
+    }
+
+    if (!segment.create(name, getTotalSize(_axes)))
+    {
+        return false;
+    }
+
+    auto * h = new (segment.data()) shm::header;
+    h->version = shm::VERSION;
+    h->axes = _axes;
+    h->depth = 1;
+    h->recordSize = sizeof(shm::command_slot);
+    h->closed = 0;
+    h->head = 0;
+
+    auto * slots = getSlots(segment);
+
+    for (int j = 0; j < _axes; j++)
+    {
+        new (slots + j) shm::command_slot {{0}, {static_cast<std::int32_t>(shared_command::NONE)}, {0.0}};
+    }
+
+    axes = _axes;
+    h->magic.store(shm::JOINT_COMMAND_MAGIC, std::memory_order_release);
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+void SharedJointCommandReader::close()
+{
+    if (segment.isOpen())
+    {
+        getHeader(segment)->closed.store(1, std::memory_order_release);
+        segment.close(); // producers keep their mappings
+    }
+
+    axes = 0;
+}
+
+// -----------------------------------------------------------------------------
+
+bool SharedJointCommandReader::read(int joint, shared_joint_command & command) const
+{
+    if (joint < 0 || joint >= axes)
+    {
+        return false;
+    }
+
+    const auto & slot = getSlots(segment)[joint];
+
+    for (int i = 0; i < READ_ATTEMPTS; i++)
+    {
+        std::uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+
+        if (sequence % 2 != 0)
+        {
+            continue;
+        }
+
+        auto type = slot.type.load(std::memory_order_relaxed);
+        double value = slot.value.load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if (slot.sequence.load(std::memory_order_relaxed) == sequence)
+        {
+            command.sequence = sequence / 2;
+            command.type = static_cast<shared_command>(type);
+            command.value = value;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// -----------------------------------------------------------------------------
@@ -0,0 +1,125 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __SHARED_JOINT_COMMAND_HPP__
+#define __SHARED_JOINT_COMMAND_HPP__
+
+#include <cstdint>
+
+#include <string>
+
+#include "SharedMemorySegment.hpp"
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup SharedMemoryLib
+ * @brief Kind of setpoint carried by a joint command.
+ */
+enum class shared_command : std::int32_t
+{
+    NONE,            ///< nothing was commanded yet
+    POSITION_DIRECT, ///< position setpoint (degrees)
+    VELOCITY         ///< velocity setpoint (degrees/second)
+};
+
+/**
+ * @ingroup SharedMemoryLib
+ * @brief Last command of a single joint, as read from shared memory.
+ */
+struct shared_joint_command
+{
+    std::uint64_t sequence {0};                 ///< number of commands sent to this joint so far
+    shared_command type {shared_command::NONE}; ///< kind of setpoint
+    double value {0.0};                         ///< setpoint
+};
+
+/**
+ * @ingroup SharedMemoryLib
+ * @brief Producer of joint commands in shared memory.
+ *
+ * Each joint has a mailbox that holds its last command, guarded by a sequence
+ * lock whose value also counts the commands sent to said joint. Sending a
+ * command involves no system calls, locks nor allocations. There must be at
+ * most one producer per joint, although distinct processes may command
+ * disjoint sets of joints. Commands that target several joints are not atomic
+ * as a whole, each joint is updated in turn.
+ */
+class SharedJointCommandWriter final
+{
+public:
+    //! Attach to the mailboxes created by the consumer, fails if not created yet.
+    bool open(const std::string & name);
+
+    //! Detach from the mailboxes.
+    void close();
+
+    //! Whether mailboxes are mapped.
+    bool isOpen() const
+    { return segment.isOpen(); }
+
+    //! False if the consumer has closed the mailboxes, reopen to attach to new ones.
+    bool isAlive() const;
+
+    //! Retrieve number of joints.
+    int getAxes() const
+    { return axes; }
+
+    //! Command a joint in position direct mode (degrees).
+    bool setPosition(int joint, double ref)
+    { return write(joint, shared_command::POSITION_DIRECT, ref); }
+
+    //! Command all joints in position direct mode (degrees).
+    bool setPositions(const double * refs);
+
+    //! Command a joint in velocity mode (degrees/second).
+    bool velocityMove(int joint, double sp)
+    { return write(joint, shared_command::VELOCITY, sp); }
+
+    //! Command all joints in velocity mode (degrees/second).
+    bool velocityMove(const double * sp);
+
+    //! Store a command in the mailbox of a joint.
+    bool write(int joint, shared_command type, double value);
+
+private:
+    SharedMemorySegment segment;
+    int axes {0};
+};
+
+/**
+ * @ingroup SharedMemoryLib
+ * @brief Consumer of joint commands in shared memory, creates the mailboxes.
+ *
+ * Reads never block the producers and perform no system calls. A new command
+ * is told apart from the previous one by its sequence number, commands that
+ * were overwritten before being read are lost.
+ */
+class SharedJointCommandReader final
+{
+public:
+    //! Create zeroed mailboxes for the given number of joints.
+    bool open(const std::string & name, int axes);
+
+    //! Mark the mailboxes as closed for producers and remove the shared memory object.
+    void close();
+
+    //! Whether the shared memory object was created.
+    bool isOpen() const
+    { return segment.isOpen(); }
+
+    //! Retrieve number of joints.
+    int getAxes() const
+    { return axes; }
+
+    //! Read the last command of a joint, false if the producer was caught writing it (retry later).
+    bool read(int joint, shared_joint_command & command) const;
+
+private:
+    SharedMemorySegment segment;
+    int axes {0};
+};
+
+} // namespace roboticslab
+
+#endif // __SHARED_JOINT_COMMAND_HPP__
@@ -0,0 +1,325 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#include "SharedJointState.hpp"
+
+#include <cerrno>
+
+#include <new>
+
+#include "SharedMemoryLayout.hpp"
+
+using namespace roboticslab;
+
+// -----------------------------------------------------------------------------
+
+namespace
+{
+    inline shm::header * getHeader(const SharedMemorySegment & segment)
+    {
+        return static_cast<shm::header *>(segment.data());
+    }
+
+    inline char * getRecord(const SharedMemorySegment & segment, std::uint64_t index)
+    {
+        const auto * h = getHeader(segment);
+        return static_cast<char *>(segment.data()) + shm::alignUp(sizeof(shm::header)) + (index % h->depth) * h->recordSize;
+    }
+
+    inline std::atomic<double> * getValues(char * record, const shm::state_layout & layout, shm::state_layout::array a)
+    {
+        return reinterpret_cast<std::atomic<double> *>(record + layout.values(a));
+    }
+
+    inline std::atomic<std::int32_t> * getModes(char * record, const shm::state_layout & layout)
+    {
+        return reinterpret_cast<std::atomic<std::int32_t> *>(record + layout.modes);
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+bool SharedJointStateWriter::open(const std::string & name, int _axes, int _depth)
+{
+    close();
+
+    if (_axes <= 0 || _depth < 2)
+    {
+        errno = EINVAL;
+        return false;
+    }
+
+    const shm::state_layout layout(_axes);
+
+    if (!segment.create(name, layout.total(_depth)))
+    {
+        return false;
+    }
+
+    auto * h = new (segment.data()) shm::header;
+    h->version = shm::VERSION;
+    h->axes = _axes;
+    h->depth = _depth;
+    h->recordSize = layout.record;
+    h->closed = 0;
+    h->head = 0;
+
+    axes = _axes;
+    depth = _depth;
+    head = 0;
+
+    for (int i = 0; i < depth; i++)
+    {
+        char * r = getRecord(segment, i);
+        new (r) shm::state_record {{0}, {0}, {0.0}};
+
+        for (int a = 0; a < shm::state_layout::ARRAYS; a++)
+        {
+            auto * values = getValues(r, layout, static_cast<shm::state_layout::array>(a));
+
+            for (int j = 0; j < axes; j++)
+            {
+                new (values + j) std::atomic<double>(0.0);
+            }
+        }
+
+        auto * modes = getModes(r, layout);
+
+        for (int j = 0; j < axes; j++)
+        {
+            new (modes + j) std::atomic<std::int32_t>(0);
+        }
+    }
+
+    h->magic.store(shm::JOINT_STATE_MAGIC, std::memory_order_release);
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+void SharedJointStateWriter::close()
+{
+    if (segment.isOpen())
+    {
+        getHeader(segment)->closed.store(1, std::memory_order_release);
+        segment.close(); // readers keep their mappings
+    }
+
+    record = nullptr;
+}
+
+// -----------------------------------------------------------------------------
+
+void SharedJointStateWriter::beginRecord(std::uint64_t cycle, double stamp)
+{
+    record = getRecord(segment, head);
+
+    auto * r = reinterpret_cast<shm::state_record *>(record);
+    r->sequence.store(shm::expectedSequence(head, depth) - 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    r->cycle.store(cycle, std::memory_order_relaxed);
+    r->stamp.store(stamp, std::memory_order_relaxed);
+}
+
+// -----------------------------------------------------------------------------
+
+bool SharedJointStateWriter::setJoint(int joint, double position, double velocity, double current, std::int32_t mode, double timestamp)
+{
+    if (!record || joint < 0 || joint >= axes)
+    {
+        return false;
+    }
+
+    const shm::state_layout layout(axes);
+
+    getValues(record, layout, shm::state_layout::POSITION)[joint].store(position, std::memory_order_relaxed);
+    getValues(record, layout, shm::state_layout::VELOCITY)[joint].store(velocity, std::memory_order_relaxed);
+    getValues(record, layout, shm::state_layout::CURRENT)[joint].store(current, std::memory_order_relaxed);
+    getValues(record, layout, shm::state_layout::TIMESTAMP)[joint].store(timestamp, std::memory_order_relaxed);
+    getModes(record, layout)[joint].store(mode, std::memory_order_relaxed);
+
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+void SharedJointStateWriter::endRecord()
+{
+    if (!record)
+    {
+        return;
+    }
+
+    auto * r = reinterpret_cast<shm::state_record *>(record);
+    r->sequence.store(shm::expectedSequence(head, depth), std::memory_order_release);
+    getHeader(segment)->head.store(++head, std::memory_order_release);
+    record = nullptr;
+}
+
+// -----------------------------------------------------------------------------
+
+bool SharedJointStateReader::open(const std::string & name)
+{
+    close();
+
+    if (!segment.open(name, false))
+    {
+        return false;
+    }
+
+    const auto * h = getHeader(segment);
+
+    if (segment.size() < sizeof(shm::header) || h->magic.load(std::memory_order_acquire) != shm::JOINT_STATE_MAGIC)
+    {
+        segment.close();
+        errno = EAGAIN; // not initialized yet, or not a joint state ring
+        return false;
+    }
+
+    if (h->version != shm::VERSION || h->axes == 0 || h->depth < 2
+        || h->recordSize != shm::state_layout(h->axes).record
+        || segment.size() < shm::state_layout(h->axes).total(h->depth))
+    {
+        segment.close();
+        errno = EPROTO;
+        return false;
+    }
+
+    axes = h->axes;
+    depth = h->depth;
+    missed = 0;
+
+    std::uint64_t published = getPublished();
+    next = published != 0 ? published - 1 : 0; // start with the latest record
+
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+void SharedJointStateReader::close()
+{
+    segment.close();
+    axes = depth = 0;
+}
+
+// -----------------------------------------------------------------------------
+
+bool SharedJointStateReader::isAlive() const
+{
+    return segment.isOpen() && getHeader(segment)->closed.load(std::memory_order_acquire) == 0;
+}
+
+// -----------------------------------------------------------------------------
+
+std::uint64_t SharedJointStateReader::getPublished() const
+{
+    return segment.isOpen() ? getHeader(segment)->head.load(std::memory_order_acquire) : 0;
+}
+
+// -----------------------------------------------------------------------------
+
+bool SharedJointStateReader::readRecord(std::uint64_t index, shared_joint_state & state) const
+{
+    const std::uint64_t expected = shm::expectedSequence(index, depth);
+    char * record = getRecord(segment, index);
+    const auto * r = reinterpret_cast<const shm::state_record *>(record);
+
+    if (r->sequence.load(std::memory_order_acquire) != expected)
+    {
+        return false; // overwritten
+    }
+
+    const shm::state_layout layout(axes);
+
+    state.positions.resize(axes);
+    state.velocities.resize(axes);
+    state.currents.resize(axes);
+    state.timestamps.resize(axes);
+    state.modes.resize(axes);
+
+    state.cycle = r->cycle.load(std::memory_order_relaxed);
+    state.stamp = r->stamp.load(std::memory_order_relaxed);
+
+    const auto * positions = getValues(record, layout, shm::state_layout::POSITION);
+    const auto * velocities = getValues(record, layout, shm::state_layout::VELOCITY);
+    const auto * currents = getValues(record, layout, shm::state_layout::CURRENT);
+    const auto * timestamps = getValues(record, layout, shm::state_layout::TIMESTAMP);
+    const auto * modes = getModes(record, layout);
+
+    for (int j = 0; j < axes; j++)
+    {
+        state.positions[j] = positions[j].load(std::memory_order_relaxed);
+        state.velocities[j] = velocities[j].load(std::memory_order_relaxed);
+        state.currents[j] = currents[j].load(std::memory_order_relaxed);
+        state.timestamps[j] = timestamps[j].load(std::memory_order_relaxed);
+        state.modes[j] = modes[j].load(std::memory_order_relaxed);
+    }
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return r->sequence.load(std::memory_order_relaxed) == expected;
+}
+
+// -----------------------------------------------------------------------------
+
+bool SharedJointStateReader::readLatest(shared_joint_state & state)
+{
+    if (!segment.isOpen())
+    {
+        return false;
+    }
+
+    while (true)
+    {
+        std::uint64_t published = getPublished();
+
+        if (published == 0)
+        {
+            return false;
+        }
+
+        if (readRecord(published - 1, state))
+        {
+            return true;
+        }
+
+        // the writer has lapped the whole ring meanwhile, pick the new latest record
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+bool SharedJointStateReader::readNext(shared_joint_state & state)
+{
+    if (!segment.isOpen())
+    {
+        return false;
+    }
+
+    while (true)
+    {
+        std::uint64_t published = getPublished();
+
+        if (next >= published)
+        {
+            return false;
+        }
+
+        // the slot of the oldest record is the one being rewritten next
+        std::uint64_t oldest = published >= static_cast<std::uint64_t>(depth) ? published - depth + 1 : 0;
+
+        if (next < oldest)
+        {
+            missed += oldest - next;
+            next = oldest;
+        }
+
+        if (readRecord(next, state))
+        {
+            next++;
+            return true;
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
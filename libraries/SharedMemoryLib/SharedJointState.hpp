@@ -0,0 +1,134 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __SHARED_JOINT_STATE_HPP__
+#define __SHARED_JOINT_STATE_HPP__
+
+#include <cstdint>
+
+#include <string>
+#include <vector>
+
+#include "SharedMemorySegment.hpp"
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup yarp_devices_libraries
+ * @defgroup SharedMemoryLib
+ * @brief Exchange of joint data with co-located processes via POSIX shared memory.
+ */
+
+/**
+ * @ingroup SharedMemoryLib
+ * @brief State of all joints in a SYNC cycle, as read from shared memory.
+ */
+struct shared_joint_state
+{
+    std::uint64_t cycle {0};         ///< SYNC cycle
+    double stamp {0.0};              ///< time of publication (seconds)
+    std::vector<double> positions;   ///< joint positions (degrees)
+    std::vector<double> velocities;  ///< joint velocities (degrees/second)
+    std::vector<double> currents;    ///< motor currents (amperes)
+    std::vector<double> timestamps;  ///< time of the last position read of each joint (seconds)
+    std::vector<std::int32_t> modes; ///< control mode vocabs, zero if the joint has never reported
+};
+
+/**
+ * @ingroup SharedMemoryLib
+ * @brief Producer of a joint state ring in shared memory.
+ *
+ * Records are published in order into a ring of fixed depth, each one guarded
+ * by a sequence lock. There must be a single writer. Publishing involves no
+ * system calls, locks nor allocations.
+ */
+class SharedJointStateWriter final
+{
+public:
+    //! Create the shared memory object with room for @p depth records (two or more).
+    bool open(const std::string & name, int axes, int depth);
+
+    //! Mark the ring as closed for readers and remove the shared memory object.
+    void close();
+
+    //! Whether the shared memory object was created.
+    bool isOpen() const
+    { return segment.isOpen(); }
+
+    //! Retrieve number of joints per record.
+    int getAxes() const
+    { return axes; }
+
+    //! Start writing the next record.
+    void beginRecord(std::uint64_t cycle, double stamp);
+
+    //! Store the state of a joint in the current record.
+    bool setJoint(int joint, double position, double velocity, double current, std::int32_t mode, double timestamp);
+
+    //! Publish the current record.
+    void endRecord();
+
+private:
+    SharedMemorySegment segment;
+    int axes {0};
+    int depth {0};
+    std::uint64_t head {0};
+    char * record {nullptr}; // being written
+};
+
+/**
+ * @ingroup SharedMemoryLib
+ * @brief Consumer of a joint state ring in shared memory.
+ *
+ * Any number of readers may attach to the same ring. Except for @ref open and
+ * @ref close, methods are wait-free with regard to the writer and perform no
+ * system calls; reads retry in the unlikely event of a record being overwritten
+ * meanwhile. The only copy involved is the one into the caller's snapshot,
+ * whose vectors are resized on the first read.
+ */
+class SharedJointStateReader final
+{
+public:
+    //! Map an existing joint state ring, fails if not created yet.
+    bool open(const std::string & name);
+
+    //! Unmap the ring.
+    void close();
+
+    //! Whether a ring is mapped.
+    bool isOpen() const
+    { return segment.isOpen(); }
+
+    //! False if the writer has closed the ring, reopen to attach to a new one.
+    bool isAlive() const;
+
+    //! Retrieve number of joints per record.
+    int getAxes() const
+    { return axes; }
+
+    //! Retrieve number of records published so far.
+    std::uint64_t getPublished() const;
+
+    //! Read the latest record, false if none was published yet.
+    bool readLatest(shared_joint_state & state);
+
+    //! Read the oldest record not yet read by this method, false if none is available.
+    bool readNext(shared_joint_state & state);
+
+    //! Retrieve number of records overwritten before @ref readNext could read them.
+    std::uint64_t getMissed() const
+    { return missed; }
+
+private:
+    bool readRecord(std::uint64_t index, shared_joint_state & state) const;
+
+    SharedMemorySegment segment;
+    int axes {0};
+    int depth {0};
+    std::uint64_t next {0};
+    std::uint64_t missed {0};
+};
+
+} // namespace roboticslab
+
+#endif // __SHARED_JOINT_STATE_HPP__
@@ -0,0 +1,106 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __SHARED_MEMORY_LAYOUT_HPP__
+#define __SHARED_MEMORY_LAYOUT_HPP__
+
+#include <cstddef>
+#include <cstdint>
+
+#include <atomic>
+
+// Private header, describes the contents of shared memory objects. Producers
+// and consumers may live in different processes, hence only lock-free atomics
+// of fixed size are laid out there.
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "64-bit atomics must be lock-free");
+static_assert(sizeof(std::atomic<std::uint64_t>) == sizeof(std::uint64_t), "unexpected atomic layout");
+static_assert(sizeof(std::atomic<double>) == sizeof(double), "unexpected atomic layout");
+
+namespace roboticslab
+{
+
+namespace shm
+{
+
+constexpr std::size_t CACHE_LINE = 64;
+constexpr std::uint32_t VERSION = 1;
+constexpr std::uint32_t JOINT_STATE_MAGIC = 0x534A4C52; // "RLJS" in memory (little-endian)
+constexpr std::uint32_t JOINT_COMMAND_MAGIC = 0x434A4C52; // "RLJC" in memory (little-endian)
+
+constexpr std::size_t alignUp(std::size_t n)
+{
+    return (n + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE;
+}
+
+/*
+ * Found at offset zero. The creator writes the magic number last, processes
+ * that attach must check it (acquire) before trusting anything else.
+ */
+struct header
+{
+    std::atomic<std::uint32_t> magic;
+    std::uint32_t version;
+    std::uint32_t axes;
+    std::uint32_t depth; // number of records
+    std::uint64_t recordSize; // bytes, multiple of CACHE_LINE
+    std::atomic<std::uint32_t> closed; // set by the creator on exit
+    alignas(CACHE_LINE) std::atomic<std::uint64_t> head; // records published so far
+};
+
+/*
+ * Joint state ring: depth records follow the header, record r lives in slot
+ * r % depth. Each slot starts with a sequence lock, odd while being written.
+ * Slots are rewritten in order, hence record r is intact as long as the
+ * sequence of its slot equals 2 * (r / depth + 1).
+ */
+struct state_record
+{
+    std::atomic<std::uint64_t> sequence;
+    std::atomic<std::uint64_t> cycle;
+    std::atomic<double> stamp;
+};
+
+struct state_layout
+{
+    enum array { POSITION, VELOCITY, CURRENT, TIMESTAMP, ARRAYS };
+
+    explicit state_layout(std::uint32_t axes)
+        : arraySize(alignUp(axes * sizeof(double))),
+          modes(alignUp(sizeof(state_record)) + ARRAYS * arraySize),
+          record(alignUp(modes + axes * sizeof(std::int32_t)))
+    { }
+
+    std::size_t values(array a) const
+    { return alignUp(sizeof(state_record)) + a * arraySize; }
+
+    std::size_t total(std::uint32_t depth) const
+    { return alignUp(sizeof(header)) + depth * record; }
+
+    const std::size_t arraySize; // bytes per array of doubles
+    const std::size_t modes; // offset of the array of modes within a record
+    const std::size_t record; // bytes per record
+};
+
+/*
+ * Joint command mailboxes: one cache line-sized slot per joint follows the
+ * header (depth is one). Producers overwrite the slot of a joint with each new
+ * command, the sequence lock doubles as a per-joint command counter (half of
+ * its value once written).
+ */
+struct alignas(CACHE_LINE) command_slot
+{
+    std::atomic<std::uint64_t> sequence;
+    std::atomic<std::int32_t> type;
+    std::atomic<double> value;
+};
+
+inline std::uint64_t expectedSequence(std::uint64_t record, std::uint32_t depth)
+{
+    return 2 * (record / depth + 1);
+}
+
+} // namespace shm
+
+} // namespace roboticslab
+
+#endif // __SHARED_MEMORY_LAYOUT_HPP__
@@ -0,0 +1,144 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#include "SharedMemorySegment.hpp"
+
+#include <fcntl.h> // O_* constants
+#include <sys/mman.h> // shm_open, mmap
+#include <sys/stat.h> // fstat
+#include <unistd.h> // ftruncate, close
+
+#include <cerrno>
+
+using namespace roboticslab;
+
+// -----------------------------------------------------------------------------
+
+namespace
+{
+    // keep errno of the failed call across cleanup
+    void closePreservingErrno(int fd)
+    {
+        int error = errno;
+        ::close(fd);
+        errno = error;
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+bool SharedMemorySegment::create(const std::string & _name, std::size_t size)
+{
+    close();
+
+    if (size == 0)
+    {
+        errno = EINVAL;
+        return false;
+    }
+
+    ::shm_unlink(_name.c_str()); // left behind by a process that didn't exit cleanly
+
+    int fd = ::shm_open(_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0666);
+
+    if (fd == -1)
+    {
+        return false;
+    }
+
+    if (::ftruncate(fd, size) == -1 || !map(fd, size, true))
+    {
+        closePreservingErrno(fd);
+        ::shm_unlink(_name.c_str());
+        return false;
+    }
+
+    ::close(fd); // the mapping stays valid
+    name = _name;
+    owner = true;
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+bool SharedMemorySegment::open(const std::string & _name, bool writable)
+{
+    close();
+
+    int fd = ::shm_open(_name.c_str(), writable ? O_RDWR : O_RDONLY, 0);
+
+    if (fd == -1)
+    {
+        return false;
+    }
+
+    struct stat st;
+
+    if (::fstat(fd, &st) == -1)
+    {
+        closePreservingErrno(fd);
+        return false;
+    }
+
+    if (st.st_size <= 0)
+    {
+        ::close(fd);
+        errno = ENODATA; // not sized by its creator yet
+        return false;
+    }
+
+    if (!map(fd, st.st_size, writable))
+    {
+        closePreservingErrno(fd);
+        return false;
+    }
+
+    ::close(fd);
+    name = _name;
+    owner = false;
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+bool SharedMemorySegment::map(int fd, std::size_t size, bool writable)
+{
+    int prot = writable ? PROT_READ | PROT_WRITE : PROT_READ;
+    int flags = MAP_SHARED;
+
+#ifdef MAP_POPULATE
+    flags |= MAP_POPULATE; // avoid page faults on first access
+#endif
+
+    void * ptr = ::mmap(nullptr, size, prot, flags, fd, 0);
+
+    if (ptr == MAP_FAILED)
+    {
+        return false;
+    }
+
+    address = ptr;
+    length = size;
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+void SharedMemorySegment::close()
+{
+    if (address)
+    {
+        ::munmap(address, length);
+        address = nullptr;
+        length = 0;
+    }
+
+    if (owner)
+    {
+        ::shm_unlink(name.c_str());
+        owner = false;
+    }
+
+    name.clear();
+}
+
+// -----------------------------------------------------------------------------
@@ -0,0 +1,70 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __SHARED_MEMORY_SEGMENT_HPP__
+#define __SHARED_MEMORY_SEGMENT_HPP__
+
+#include <cstddef>
+
+#include <string>
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup SharedMemoryLib
+ * @brief Memory mapping of a POSIX shared memory object.
+ *
+ * The creator of an object owns its name, which is removed on @ref close.
+ * Pages are prefaulted on mapping where supported, subsequent accesses involve
+ * no system calls. On failure, methods return false and leave the cause in
+ * <code>errno</code>.
+ */
+class SharedMemorySegment final
+{
+public:
+    //! Constructor.
+    SharedMemorySegment() = default;
+
+    //! Destructor, calls @ref close.
+    ~SharedMemorySegment()
+    { close(); }
+
+    //! Deleted copy constructor.
+    SharedMemorySegment(const SharedMemorySegment &) = delete;
+
+    //! Deleted copy assignment operator.
+    SharedMemorySegment & operator=(const SharedMemorySegment &) = delete;
+
+    //! Create a zero-filled object of the given size and map it, replaces stale objects of the same name.
+    bool create(const std::string & name, std::size_t size);
+
+    //! Map an existing object.
+    bool open(const std::string & name, bool writable);
+
+    //! Unmap the object, also remove its name if created by this instance.
+    void close();
+
+    //! Whether an object is currently mapped.
+    bool isOpen() const
+    { return address != nullptr; }
+
+    //! Retrieve start address of the mapping.
+    void * data() const
+    { return address; }
+
+    //! Retrieve size of the mapping (bytes).
+    std::size_t size() const
+    { return length; }
+
+private:
+    bool map(int fd, std::size_t size, bool writable);
+
+    std::string name;
+    void * address {nullptr};
+    std::size_t length {0};
+    bool owner {false};
+};
+
+} // namespace roboticslab
+
+#endif // __SHARED_MEMORY_SEGMENT_HPP__
@@ -5,8 +5,17 @@
 #include <cstring>
 
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <mutex>
+#include <thread>
+
+#ifdef __linux__
+# include <linux/futex.h>
+# include <sys/syscall.h>
+# include <time.h>
+# include <unistd.h>
+#endif
 
 using namespace roboticslab;
 
@@ -62,32 +71,146 @@ namespace
         std::mutex mutex;
         std::condition_variable cond;
     };
+
+#ifdef __linux__
+    // https://man7.org/linux/man-pages/man2/futex.2.html
+    class Futex
+    {
+    public:
+        enum state : int { IDLE, PREPARING, WAITING, NOTIFYING, NOTIFIED };
+
+        Futex() : word(IDLE)
+        { }
+
+        //! Transition from IDLE to PREPARING, return false if another thread waits.
+        bool acquire()
+        {
+            int expected = IDLE;
+            return word.compare_exchange_strong(expected, PREPARING, std::memory_order_acquire);
+        }
+
+        //! Transition from PREPARING to WAITING, must be followed by wait().
+        void prepare()
+        {
+            word.store(WAITING, std::memory_order_seq_cst);
+        }
+
+        //! Wait for a NOTIFIED state, return false on timeout.
+        bool wait(double timeout)
+        {
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(timeout);
+
+            while (word.load(std::memory_order_acquire) == WAITING)
+            {
+                auto remaining = deadline - std::chrono::steady_clock::now();
+
+                if (remaining <= std::chrono::steady_clock::duration::zero())
+                {
+                    int expected = WAITING;
+
+                    if (word.compare_exchange_strong(expected, IDLE, std::memory_order_acq_rel))
+                    {
+                        return false; // nobody will touch the remote storage anymore
+                    }
+
+                    break; // lost the race against a notifier
+                }
+
+                auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(remaining).count();
+                timespec ts {static_cast<time_t>(ns / 1000000000), static_cast<long>(ns % 1000000000)};
+                syscall(SYS_futex, reinterpret_cast<int *>(&word), FUTEX_WAIT_PRIVATE, WAITING, &ts, nullptr, 0);
+            }
+
+            // the notifier is copying data or returning from FUTEX_WAKE, back off until it's done
+            for (unsigned int spin = 0; word.load(std::memory_order_acquire) != NOTIFIED; spin++)
+            {
+                if (spin < 64)
+                {
+                    relax();
+                }
+                else
+                {
+                    std::this_thread::yield();
+                }
+            }
+
+            word.store(IDLE, std::memory_order_relaxed);
+            return true;
+        }
+
+        //! Claim the waiter, return false if there is none.
+        bool claim()
+        {
+            int expected = WAITING;
+            return word.compare_exchange_strong(expected, NOTIFYING, std::memory_order_acq_rel);
+        }
+
+        //! Wake up a claimed waiter.
+        void post()
+        {
+            // wake up first, the waiter may release this object right after observing NOTIFIED
+            syscall(SYS_futex, reinterpret_cast<int *>(&word), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+            word.store(NOTIFIED, std::memory_order_release); // last access
+        }
+
+    private:
+        static void relax()
+        {
+#if defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();
+#elif defined(__aarch64__)
+            asm volatile("yield");
+#endif
+        }
+
+        std::atomic<int> word;
+        static_assert(sizeof(word) == sizeof(int), "Futex word must be a plain int.");
+    };
+#endif
 }
 
 class StateObserverBase::Private
 {
 public:
-    Private(StateObserverBase & _owner)
-        : owner(_owner), semaphore(nullptr), remoteStorage(nullptr), active(true)
-    { }
+    Private(StateObserverBase & _owner, StateObserverBackend _backend)
+        : owner(_owner), backend(_backend), semaphore(nullptr), remoteStorage(nullptr), active(true)
+    {
+#ifndef __linux__
+        backend = StateObserverBackend::CONDITION_VARIABLE;
+#endif
+    }
 
     ~Private()
     {
         interrupt();
     }
 
-    bool await(void * raw)
+    bool await(void * raw, double timeout)
     {
-        std::lock_guard<std::mutex> awaitLock(awaitMutex);
+        std::lock_guard<std::mutex> awaitLock(awaitMutex); // concurrent waiters take turns
 
         if (!active)
         {
             return false;
         }
 
+#ifdef __linux__
+        if (backend == StateObserverBackend::FUTEX)
+        {
+            if (!futex.acquire())
+            {
+                return false; // unreachable, the previous waiter left it idle
+            }
+
+            remoteStorage = raw;
+            futex.prepare();
+            return futex.wait(timeout);
+        }
+#endif
+
         {
             std::lock_guard<std::mutex> registryLock(registryMutex);
-            semaphore = new BinaryTimedSemaphore(owner.getTimeout());
+            semaphore = new BinaryTimedSemaphore(timeout);
             remoteStorage = raw;
         }
 
@@ -109,6 +232,23 @@ public:
             return false;
         }
 
+#ifdef __linux__
+        if (backend == StateObserverBackend::FUTEX)
+        {
+            if (futex.claim())
+            {
+                if (raw != nullptr)
+                {
+                    owner.setRemoteStorage(raw, len);
+                }
+
+                futex.post();
+            }
+
+            return true;
+        }
+#endif
+
         std::lock_guard<std::mutex> lock(registryMutex);
 
         if (semaphore != nullptr)
@@ -127,6 +267,19 @@ public:
     void interrupt()
     {
         active = false;
+
+#ifdef __linux__
+        if (backend == StateObserverBackend::FUTEX)
+        {
+            if (futex.claim())
+            {
+                futex.post();
+            }
+
+            return;
+        }
+#endif
+
         std::lock_guard<std::mutex> lock(registryMutex);
 
         if (semaphore != nullptr)
@@ -147,17 +300,22 @@ public:
 
 private:
     StateObserverBase & owner;
+    StateObserverBackend backend;
 
     BinaryTimedSemaphore * semaphore;
     void * remoteStorage;
 
+#ifdef __linux__
+    Futex futex;
+#endif
+
     std::atomic_bool active;
     std::mutex registryMutex;
     std::mutex awaitMutex;
 };
 
-StateObserverBase::StateObserverBase(double _timeout)
-    : timeout(_timeout), impl(new Private(*this))
+StateObserverBase::StateObserverBase(double _timeout, StateObserverBackend backend)
+    : timeout(_timeout), impl(new Private(*this, backend))
 { }
 
 StateObserverBase::~StateObserverBase()
@@ -182,7 +340,12 @@ void StateObserverBase::setRemoteStorage(const void * raw, std::size_t len)
 
 bool StateObserverBase::await(void * raw)
 {
-    return impl->await(raw);
+    return impl->await(raw, timeout);
+}
+
+bool StateObserverBase::awaitFor(double _timeout, void * raw)
+{
+    return impl->await(raw, _timeout);
 }
 
 bool StateObserverBase::notify(const void * raw, std::size_t len)
@@ -17,6 +17,16 @@ namespace roboticslab
  * @brief Collection of state observers.
  */
 
+/**
+ * @ingroup StateObserverLib
+ * @brief Synchronization mechanism behind a state observer.
+ */
+enum class StateObserverBackend
+{
+    CONDITION_VARIABLE, ///< Semaphore allocated per wait (mutex and condition variable)
+    FUTEX ///< Preallocated futex word; falls back to CONDITION_VARIABLE on non-Linux systems
+};
+
 /**
  * @ingroup StateObserverLib
  * @brief Base class for a state observer.
@@ -24,12 +34,17 @@ namespace roboticslab
  * This monitor class provides a synchronized timeout mechanism for clients to
  * wait for a specific event to happen. A call to @ref await blocks the caller
  * until @ref notify is invoked by another thread or the timeout has elapsed.
+ *
+ * The @ref StateObserverBackend::FUTEX backend (default) never allocates
+ * memory and @ref notify takes no lock, the waiting thread is woken up via a
+ * single system call. Concurrent calls to @ref await take turns regardless of
+ * the backend.
  */
 class StateObserverBase
 {
 public:
     //! Constructor, configure with timeout in seconds.
-    StateObserverBase(double timeout);
+    StateObserverBase(double timeout, StateObserverBackend backend = StateObserverBackend::FUTEX);
 
     //! Virtual destructor.
     virtual ~StateObserverBase() = 0;
@@ -47,6 +62,9 @@ public:
     //! Causes the current thread to wait until @ref notify is invoked or the timeout elapses.
     bool await(void * raw = nullptr);
 
+    //! Same as @ref await, but waits for the given timeout (in seconds) instead of the configured one.
+    bool awaitFor(double timeout, void * raw = nullptr);
+
     //! Wake up a thread that waits on this object's monitor.
     bool notify(const void * raw = nullptr, std::size_t len = 0);
 
@@ -75,11 +93,16 @@ class StateObserver final : private StateObserverBase
 {
 public:
     using StateObserverBase::StateObserverBase;
+    using StateObserverBase::getTimeout;
 
     //! Wait with timeout until another thread invokes @ref notify.
     bool await()
     { return StateObserverBase::await(); }
 
+    //! Wait with the given timeout (in seconds) until another thread invokes @ref notify.
+    bool awaitFor(double timeout)
+    { return StateObserverBase::awaitFor(timeout); }
+
     //! Wakes up a waiting thread.
     bool notify()
     { return StateObserverBase::notify(); }
@@ -95,11 +118,16 @@ class TypedStateObserver final : private StateObserverBase
 {
 public:
     using StateObserverBase::StateObserverBase;
+    using StateObserverBase::getTimeout;
 
     //! Wait with timeout until another thread invokes @ref notify.
     bool await(T & remote)
     { return StateObserverBase::await(&remote); }
 
+    //! Wait with the given timeout (in seconds) until another thread invokes @ref notify.
+    bool awaitFor(T & remote, double timeout)
+    { return StateObserverBase::awaitFor(timeout, &remote); }
+
     //! Wakes up a waiting thread.
     bool notify(const T & remote)
     { return StateObserverBase::notify(&remote); }
@@ -119,11 +147,16 @@ class TypedStateObserver<T, typename std::enable_if_t<std::is_arithmetic<T>::val
 {
 public:
     using StateObserverBase::StateObserverBase;
+    using StateObserverBase::getTimeout;
 
     //! Wait with timeout until another thread invokes @ref notify.
     bool await(T * raw)
     { return StateObserverBase::await(raw); }
 
+    //! Wait with the given timeout (in seconds) until another thread invokes @ref notify.
+    bool awaitFor(T * raw, double timeout)
+    { return StateObserverBase::awaitFor(timeout, raw); }
+
     //! Wakes up a waiting thread.
     bool notify(T raw)
     { return StateObserverBase::notify(&raw, sizeof(T)); }
@@ -142,11 +175,16 @@ class TypedStateObserver<std::uint8_t[]> final : private StateObserverBase
 {
 public:
     using StateObserverBase::StateObserverBase;
+    using StateObserverBase::getTimeout;
 
     //! Wait with timeout until another thread invokes @ref notify.
     bool await(std::uint8_t * raw)
     { return StateObserverBase::await(raw); }
 
+    //! Wait with the given timeout (in seconds) until another thread invokes @ref notify.
+    bool awaitFor(std::uint8_t * raw, double timeout)
+    { return StateObserverBase::awaitFor(timeout, raw); }
+
     //! Wakes up a waiting thread.
     bool notify(const std::uint8_t * raw, std::size_t len)
     { return StateObserverBase::notify(raw, len); }
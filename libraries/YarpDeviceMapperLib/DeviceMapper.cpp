@@ -2,13 +2,20 @@
 
 #include "DeviceMapper.hpp"
 
+#include <algorithm>
+#include <atomic>
+
 #include <yarp/os/LogStream.h>
 #include <yarp/dev/ControlBoardInterfaces.h>
 
 using namespace roboticslab;
 
+constexpr DeviceMapper::inline_tag DeviceMapper::inlined;
+
 namespace
 {
+    constexpr std::size_t PLAN_CACHE_SIZE = 8; // distinct joint groups whose dispatch plans are kept
+
     bool queryControlledAxes(const RawDevice * rd, int * axes, bool * ret)
     {
         if (rd->getHandle<yarp::dev::ICurrentControlRaw>())
@@ -61,7 +68,7 @@ namespace
 }
 
 DeviceMapper::DeviceMapper()
-    : totalAxes(0), taskFactory(new SequentialTaskFactory)
+    : totalAxes(0), planCache(PLAN_CACHE_SIZE), planCacheClock(0), taskFactory(new SequentialTaskFactory)
 { }
 
 DeviceMapper::~DeviceMapper()
@@ -74,9 +81,14 @@ void DeviceMapper::enableParallelization(unsigned int concurrentTasks)
     taskFactory = std::make_unique<ParallelTaskFactory>(concurrentTasks);
 }
 
-bool DeviceMapper::registerDevice(yarp::dev::PolyDriver * driver)
+void DeviceMapper::enableAffinity(unsigned int groups)
 {
-    RawDevice * rd = new RawDevice(driver);
+    taskFactory = std::make_unique<AffineTaskFactory>(groups);
+}
+
+bool DeviceMapper::registerDevice(yarp::dev::PolyDriver * driver, int affinity)
+{
+    RawDevice * rd = new RawDevice(driver, affinity);
 
     int axes;
     bool ret;
@@ -93,6 +105,7 @@ bool DeviceMapper::registerDevice(yarp::dev::PolyDriver * driver)
         rawDeviceIndexAtGlobalAxisIndex.insert(rawDeviceIndexAtGlobalAxisIndex.end(), axes, rawDevicesWithOffsets.size());
         rawDevicesWithOffsets.push_back(std::make_tuple(rd, totalAxes));
         totalAxes += axes;
+        resetPlanCache();
         return true;
     }
     else
@@ -115,9 +128,43 @@ const std::vector<DeviceMapper::dev_index_t> & DeviceMapper::getDevicesWithOffse
     return rawDevicesWithOffsets;
 }
 
-std::vector<DeviceMapper::dev_group_t> DeviceMapper::getDevices(int globalAxesCount, const int * globalAxes) const
+DeviceMapper::GroupPlan DeviceMapper::getDevices(int globalAxesCount, const int * globalAxes) const
+{
+    const std::size_t count = std::max(globalAxesCount, 0);
+    std::lock_guard<std::mutex> lock(planCacheMutex);
+
+    for (auto & entry : planCache)
+    {
+        if (entry.plan && entry.globalAxes.size() == count && std::equal(globalAxes, globalAxes + count, entry.globalAxes.begin()))
+        {
+            entry.lastUse = ++planCacheClock;
+            return GroupPlan(entry.plan);
+        }
+    }
+
+    // evict the least recently used plan (unused slots come first)
+    auto & entry = *std::min_element(planCache.begin(), planCache.end(),
+                                     [](const auto & a, const auto & b) { return a.lastUse < b.lastUse; });
+
+    if (!entry.plan || entry.plan.use_count() != 1)
+    {
+        entry.plan = std::make_shared<std::vector<dev_group_t>>(); // still referenced elsewhere, don't touch it
+    }
+    else
+    {
+        std::atomic_thread_fence(std::memory_order_acquire); // pairs with the release of the last external reference
+    }
+
+    entry.globalAxes.assign(globalAxes, globalAxes + count);
+    entry.lastUse = ++planCacheClock;
+    buildPlan(count, globalAxes, *entry.plan);
+    return GroupPlan(entry.plan);
+}
+
+void DeviceMapper::buildPlan(int globalAxesCount, const int * globalAxes, std::vector<dev_group_t> & plan) const
 {
-    std::vector<dev_group_t> vec;
+    // recycle storage of the previous plan, if any
+    std::size_t groups = 0;
     int previousDeviceIndex = -1;
 
     for (int i = 0; i < globalAxesCount; i++)
@@ -129,16 +176,36 @@ std::vector<DeviceMapper::dev_group_t> DeviceMapper::getDevices(int globalAxesCo
 
         if (deviceIndex != previousDeviceIndex)
         {
-            vec.push_back(std::make_tuple(std::get<0>(t), std::vector<int>{localIndex}, i));
+            if (groups == plan.size())
+            {
+                plan.emplace_back();
+            }
+
+            auto & group = plan[groups++];
+            std::get<0>(group) = std::get<0>(t);
+            std::get<1>(group).assign(1, localIndex);
+            std::get<2>(group) = i;
             previousDeviceIndex = deviceIndex;
         }
         else
         {
-            std::get<1>(vec.back()).push_back(localIndex);
+            std::get<1>(plan[groups - 1]).push_back(localIndex);
         }
     }
 
-    return vec;
+    plan.resize(groups);
+}
+
+void DeviceMapper::resetPlanCache()
+{
+    std::lock_guard<std::mutex> lock(planCacheMutex);
+
+    for (auto & entry : planCache)
+    {
+        entry.globalAxes.clear();
+        entry.plan.reset();
+        entry.lastUse = 0;
+    }
 }
 
 void DeviceMapper::clear()
@@ -151,4 +218,5 @@ void DeviceMapper::clear()
     rawDevicesWithOffsets.clear();
     rawDeviceIndexAtGlobalAxisIndex.clear();
     totalAxes = 0;
+    resetPlanCache();
 }
@@ -3,7 +3,11 @@
 #ifndef __DEVICE_MAPPER_HPP__
 #define __DEVICE_MAPPER_HPP__
 
+#include <cstddef>
+#include <cstdint>
+
 #include <memory>
+#include <mutex>
 #include <tuple>
 #include <vector>
 
@@ -31,7 +35,7 @@ class RawDevice final
 {
 public:
     //! Constructor, extracts all interface handles of the supplied driver.
-    explicit RawDevice(yarp::dev::PolyDriver * driver);
+    explicit RawDevice(yarp::dev::PolyDriver * driver, int affinity = FutureTask::NO_AFFINITY);
 
     //! Destructor.
     ~RawDevice();
@@ -51,11 +55,16 @@ public:
     T * castToType() const
     { return dynamic_cast<T *>(driver); }
 
+    //! Retrieve the affinity group of this device (see @ref FutureTask::addAffine).
+    int getAffinity() const
+    { return affinity; }
+
 private:
     class Private;
     std::unique_ptr<Private> priv;
 
     yarp::dev::DeviceDriver * driver;
+    int affinity;
 };
 
 /**
@@ -92,10 +101,28 @@ private:
  * - <b>full-joint</b> mapping: `command(type * values)`
  *
  * - <b>joint-group</b> mapping: `command(int n, const int * globalIds, type * values)`
+ *
+ * Full-joint and joint-group commands are dispatched through a @ref FutureTask,
+ * hence in parallel if enabled. Commands that merely read or store state cached
+ * by the raw subdevices should rather be tagged with @ref inlined, in which case
+ * per-device calls are executed sequentially in the caller thread: they are
+ * cheaper than the task itself and gain nothing from concurrency.
+ *
+ * Subdevices may be registered along with an affinity group, e.g. the CAN bus
+ * they are attached to. If affinity is enabled, all commands forwarded to the
+ * subdevices of a group are run by a dedicated thread (see @ref AffineTaskFactory):
+ * different groups are served concurrently, subdevices of the same group are
+ * never accessed from two threads at once.
  */
 class DeviceMapper final
 {
 public:
+    //! Tag type of commands that should be always executed in the caller thread.
+    struct inline_tag {};
+
+    //! Tag for cheap commands (no CAN I/O), see class description.
+    static constexpr inline_tag inlined {};
+
     //! Constructor.
     DeviceMapper();
 
@@ -105,8 +132,11 @@ public:
     //! Whether to enable parallel mappings on how many concurrent threads.
     void enableParallelization(unsigned int concurrentTasks);
 
-    //! Extract interface handles and perform sanity checks.
-    bool registerDevice(yarp::dev::PolyDriver * driver);
+    //! Dispatch commands on one thread per affinity group, see class description.
+    void enableAffinity(unsigned int groups);
+
+    //! Extract interface handles and perform sanity checks, optionally bind to an affinity group.
+    bool registerDevice(yarp::dev::PolyDriver * driver, int affinity = FutureTask::NO_AFFINITY);
 
     //! Tuple of a raw device pointer and either an offset or a local index.
     using dev_index_t = std::tuple<const RawDevice *, int>;
@@ -114,6 +144,44 @@ public:
     //! Tuple of a raw device pointer, its local indices and the global index.
     using dev_group_t = std::tuple<const RawDevice *, std::vector<int>, int>;
 
+    /**
+     * @brief Read-only list of subdevices targeted by a joint-group command.
+     *
+     * Behaves like a constant `std::vector<dev_group_t>`. Its contents are
+     * shared with the cache of dispatch plans (see @ref getDevices), hence
+     * copies are cheap and remain valid even if evicted from said cache.
+     */
+    class GroupPlan final
+    {
+    public:
+        //! Iterator type.
+        using const_iterator = std::vector<dev_group_t>::const_iterator;
+
+        //! Constructor, wraps a shared list of subdevices.
+        explicit GroupPlan(std::shared_ptr<const std::vector<dev_group_t>> _groups)
+            : groups(std::move(_groups))
+        { }
+
+        //! Retrieve number of targeted subdevices.
+        std::size_t size() const
+        { return groups->size(); }
+
+        //! Access the i-th targeted subdevice.
+        const dev_group_t & operator[](std::size_t i) const
+        { return (*groups)[i]; }
+
+        //! Iterator to the first targeted subdevice.
+        const_iterator begin() const
+        { return groups->begin(); }
+
+        //! Iterator past the last targeted subdevice.
+        const_iterator end() const
+        { return groups->end(); }
+
+    private:
+        std::shared_ptr<const std::vector<dev_group_t>> groups;
+    };
+
     /**
      * @brief Retrieve a device handle and its local index given a global index.
      * @param globalAxis The requested global axis index.
@@ -138,11 +206,13 @@ public:
       * @brief Retrieve subdevices that map to the specified global axes.
       *
       * Aimed for joint-group commands. See example and terminology in class description.
+      * Plans are cached per joint list (up to a few of them, least recently used ones
+      * are evicted first), thus repeated queries on the same joints do not allocate.
       *
-      * @return A vector of packs of subdevices, their requested local indices,
+      * @return A list of packs of subdevices, their requested local indices,
       * and the associated parameter offsets.
       */
-    std::vector<dev_group_t> getDevices(int globalAxesCount, const int * globalAxes) const;
+    GroupPlan getDevices(int globalAxesCount, const int * globalAxes) const;
 
     //! Clear all internal handles.
     void clear();
@@ -182,13 +252,33 @@ public:
         for (const auto & t : getDevicesWithOffsets())
         {
             T * p = std::get<0>(t)->getHandle<T>();
-            ok |= p && (task->add(p, fn, refs + std::get<1>(t)...), true);
+            ok |= p && (task->addAffine(std::get<0>(t)->getAffinity(), p, fn, refs + std::get<1>(t)...), true);
         }
 
         // at least one targeted device must implement the 'T' iface
         return ok && task->dispatch();
     }
 
+    //! Full-joint command mapping, executed in the caller thread. See class description.
+    template<typename T, typename... T_refs>
+    bool mapAllJoints(inline_tag, full_mapping_fn<T, T_refs...> fn, T_refs *... refs)
+    {
+        bool ok = false;
+        bool ret = true;
+
+        for (const auto & t : getDevicesWithOffsets())
+        {
+            if (T * p = std::get<0>(t)->getHandle<T>())
+            {
+                ok = true;
+                ret = (p->*fn)(refs + std::get<1>(t)...) && ret;
+            }
+        }
+
+        // at least one targeted device must implement the 'T' iface
+        return ok && ret;
+    }
+
     //! Alias for a joint-group command. See class description.
     template<typename T, typename... T_refs>
     using multi_mapping_fn = bool (T::*)(int, const int *, T_refs *...);
@@ -204,18 +294,58 @@ public:
         for (const auto & t : devices)
         {
             T * p = std::get<0>(t)->getHandle<T>();
-            ok &= p && (task->add(p, fn, std::get<1>(t).size(), std::get<1>(t).data(), refs + std::get<2>(t)...), true);
+            ok &= p && (task->addAffine(std::get<0>(t)->getAffinity(), p, fn, std::get<1>(t).size(), std::get<1>(t).data(), refs + std::get<2>(t)...), true);
         }
 
         // all targeted devices must implement the 'T' iface
         return ok && task->dispatch();
     }
 
+    //! Joint-group command mapping, executed in the caller thread. See class description.
+    template<typename T, typename... T_refs>
+    bool mapJointGroup(inline_tag, multi_mapping_fn<T, T_refs...> fn, int n_joint, const int * joints, T_refs *... refs)
+    {
+        auto devices = getDevices(n_joint, joints);
+
+        // all targeted devices must implement the 'T' iface
+        for (const auto & t : devices)
+        {
+            if (!std::get<0>(t)->getHandle<T>())
+            {
+                return false;
+            }
+        }
+
+        bool ret = true;
+
+        for (const auto & t : devices)
+        {
+            T * p = std::get<0>(t)->getHandle<T>();
+            ret = (p->*fn)(std::get<1>(t).size(), std::get<1>(t).data(), refs + std::get<2>(t)...) && ret;
+        }
+
+        return ret;
+    }
+
 private:
+    struct plan_cache_entry
+    {
+        std::vector<int> globalAxes;
+        std::shared_ptr<std::vector<dev_group_t>> plan;
+        std::uint64_t lastUse;
+    };
+
+    void buildPlan(int globalAxesCount, const int * globalAxes, std::vector<dev_group_t> & plan) const;
+    void resetPlanCache();
+
     std::vector<dev_index_t> rawDevicesWithOffsets;
     std::vector<int> rawDeviceIndexAtGlobalAxisIndex;
     int totalAxes;
 
+    mutable std::vector<plan_cache_entry> planCache;
+    mutable std::uint64_t planCacheClock;
+    mutable std::mutex planCacheMutex;
+
     std::unique_ptr<FutureTaskFactory> taskFactory;
 };
 
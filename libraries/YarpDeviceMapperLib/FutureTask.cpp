@@ -2,15 +2,73 @@
 
 #include "FutureTask.hpp"
 
+#include <cstdint>
+
 #include <algorithm>
+#include <atomic>
 #include <iterator>
+#include <limits>
+#include <memory>
 #include <numeric>
-#include <utility> // std::move
+#include <thread>
+
+#ifdef __linux__
+# include <linux/futex.h>
+# include <sys/syscall.h>
+# include <unistd.h>
+#endif
 
 #include "ctpl/ctpl_stl.h"
 
 using namespace roboticslab;
 
+constexpr std::size_t DeferredCallback::CAPACITY;
+constexpr int FutureTask::NO_AFFINITY;
+
+namespace
+{
+    constexpr int SPIN_ITERATIONS = 1000; // busy-wait rounds prior to sleeping
+    constexpr std::uint32_t MAX_FORK_JOIN_TASKS = 0xFFFF; // see cursor layout
+
+    static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t), "futex word must be 32 bits long");
+
+    inline void cpuRelax()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#endif
+    }
+
+    // sleep as long as the word holds the expected value, might wake up spuriously
+    inline void futexWait(std::atomic<std::uint32_t> & word, std::uint32_t expected)
+    {
+#ifdef __linux__
+        syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(&word), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+#else
+        std::this_thread::yield();
+#endif
+    }
+
+    inline void futexWake(std::atomic<std::uint32_t> & word, int count)
+    {
+#ifdef __linux__
+        syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(&word), FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0);
+#endif
+    }
+
+    bool runSequentially(const DeferredCallback * calls, std::size_t count)
+    {
+        bool ok = true;
+
+        for (std::size_t i = 0; i < count; i++)
+        {
+            ok = calls[i](0) && ok;
+        }
+
+        return ok;
+    }
+}
+
 namespace roboticslab // make doxygen group these classes in the rl namespace
 {
 
@@ -23,9 +81,7 @@ class SequentialTask : public FutureTask
 public:
     virtual bool dispatch() override
     {
-        return std::accumulate(deferreds.begin(), deferreds.end(), true,
-                [](bool acc, const std::function<bool(int)> & fn)
-                { return acc &= fn(0); });
+        return runSequentially(deferreds.data(), deferreds.size());
     }
 };
 
@@ -42,11 +98,16 @@ public:
 
     virtual bool dispatch() override
     {
+        if (deferreds.size() == 1)
+        {
+            return deferreds[0](0); // not worth a round trip to the pool
+        }
+
         std::vector<std::future<bool>> futures;
 
         std::transform(deferreds.begin(), deferreds.end(), std::back_inserter(futures),
-                [this](std::function<bool(int)> & fn)
-                { return pool.push(std::move(fn)); });
+                [this](const DeferredCallback & fn)
+                { return pool.push([&fn](int id) { return fn(id); }); }); // outlived by this call
 
         return std::accumulate(futures.begin(), futures.end(), true,
                 [](bool acc, std::future<bool> & f)
@@ -57,6 +118,381 @@ private:
     ctpl::thread_pool & pool;
 };
 
+/**
+ * @ingroup YarpDeviceMapperLib
+ * @brief Worker threads and shared state of @ref ForkJoinTask instances.
+ */
+class ForkJoinExecutor
+{
+public:
+    ForkJoinExecutor(int threads)
+    {
+        for (int i = 1; i < threads; i++) // the dispatching thread counts as one
+        {
+            workers.emplace_back(&ForkJoinExecutor::work, this);
+        }
+    }
+
+    ~ForkJoinExecutor()
+    {
+        stopping = true;
+        generation++;
+        futexWake(generation, std::numeric_limits<int>::max());
+
+        for (auto & worker : workers)
+        {
+            worker.join();
+        }
+    }
+
+    bool dispatch(const DeferredCallback * _calls, std::size_t count)
+    {
+        if (workers.empty() || count <= 1 || count > MAX_FORK_JOIN_TASKS || busy.exchange(true, std::memory_order_acquire))
+        {
+            // nothing to share, or this is a concurrent/nested dispatch
+            return runSequentially(_calls, count);
+        }
+
+        calls.store(_calls, std::memory_order_relaxed);
+        result.store(true, std::memory_order_relaxed);
+        pending.store(count, std::memory_order_relaxed);
+
+        const std::uint32_t gen = generation.load(std::memory_order_relaxed) + 1;
+        cursor.store(static_cast<std::uint64_t>(gen) << 32 | count << 16, std::memory_order_release);
+        generation.store(gen);
+
+        if (sleepingWorkers.load() != 0)
+        {
+            futexWake(generation, std::numeric_limits<int>::max());
+        }
+
+        runSlice(gen);
+
+        for (int i = 0; pending.load(std::memory_order_acquire) != 0; i++)
+        {
+            if (i < SPIN_ITERATIONS)
+            {
+                cpuRelax();
+                continue;
+            }
+
+            const std::uint32_t remaining = pending.load();
+
+            if (remaining != 0)
+            {
+                callerSleeping.store(true);
+                futexWait(pending, remaining);
+                callerSleeping.store(false);
+            }
+        }
+
+        const bool ok = result.load(std::memory_order_relaxed);
+        busy.store(false, std::memory_order_release);
+        return ok;
+    }
+
+private:
+    // claim and run callbacks of the given dispatch until none is left
+    void runSlice(std::uint32_t gen)
+    {
+        std::uint64_t current = cursor.load(std::memory_order_acquire);
+
+        while ((current >> 32) == gen && (current & 0xFFFF) < ((current >> 16) & 0xFFFF))
+        {
+            if (!cursor.compare_exchange_weak(current, current + 1, std::memory_order_acquire))
+            {
+                continue;
+            }
+
+            // the dispatch cannot complete until this callback is accounted for, thus 'calls' is valid
+            if (!calls.load(std::memory_order_relaxed)[current & 0xFFFF](0))
+            {
+                result.store(false, std::memory_order_relaxed);
+            }
+
+            if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1 && callerSleeping.load())
+            {
+                futexWake(pending, 1);
+            }
+
+            current++;
+        }
+    }
+
+    void work()
+    {
+        std::uint32_t seen = 0;
+
+        while (true)
+        {
+            std::uint32_t gen;
+
+            for (int i = 0; (gen = generation.load(std::memory_order_acquire)) == seen; i++)
+            {
+                if (i < SPIN_ITERATIONS)
+                {
+                    cpuRelax();
+                    continue;
+                }
+
+                sleepingWorkers++;
+
+                if (generation.load() == seen)
+                {
+                    futexWait(generation, seen);
+                }
+
+                sleepingWorkers--;
+            }
+
+            if (stopping)
+            {
+                return;
+            }
+
+            seen = gen;
+            runSlice(gen);
+        }
+    }
+
+    std::vector<std::thread> workers;
+
+    // generation (32 bits), number of callbacks (16 bits) and next unclaimed callback (16 bits)
+    std::atomic<std::uint64_t> cursor {0};
+    std::atomic<const DeferredCallback *> calls {nullptr};
+    std::atomic<std::uint32_t> generation {0}; // futex word of workers
+    std::atomic<std::uint32_t> pending {0}; // futex word of the dispatching thread
+    std::atomic<std::uint32_t> sleepingWorkers {0};
+    std::atomic<bool> callerSleeping {false};
+    std::atomic<bool> result {true};
+    std::atomic<bool> busy {false};
+    std::atomic<bool> stopping {false};
+};
+
+/**
+ * @ingroup YarpDeviceMapperLib
+ * @brief An implementation of a fork-join deferred callback executor.
+ */
+class ForkJoinTask : public FutureTask
+{
+public:
+    ForkJoinTask(ForkJoinExecutor & _executor)
+        : executor(_executor)
+    { }
+
+    virtual bool dispatch() override
+    { return executor.dispatch(deferreds.data(), deferreds.size()); }
+
+private:
+    ForkJoinExecutor & executor;
+};
+
+/**
+ * @ingroup YarpDeviceMapperLib
+ * @brief Worker threads and shared state of @ref AffineTask instances.
+ */
+class AffineExecutor
+{
+public:
+    AffineExecutor(int groups)
+    {
+        for (int i = 0; i < groups; i++)
+        {
+            workers.push_back(std::make_unique<Worker>());
+        }
+
+        for (int i = 0; i < groups; i++)
+        {
+            workers[i]->thread = std::thread(&AffineExecutor::work, this, i);
+        }
+    }
+
+    ~AffineExecutor()
+    {
+        stopping = true;
+
+        for (auto & worker : workers)
+        {
+            worker->generation++;
+            futexWake(worker->generation, 1);
+        }
+
+        for (auto & worker : workers)
+        {
+            worker->thread.join();
+        }
+    }
+
+    bool dispatch(const DeferredCallback * _calls, const int * _affinities, std::size_t _affinityCount, std::size_t _count)
+    {
+        if (workers.empty() || busy.exchange(true, std::memory_order_acquire))
+        {
+            // no workers, or this is a concurrent/nested dispatch
+            return runSequentially(_calls, _count);
+        }
+
+        calls = _calls;
+        affinities = _affinities;
+        affinityCount = std::min(_affinityCount, _count);
+        count = _count;
+        result.store(true, std::memory_order_relaxed);
+
+        for (auto & worker : workers)
+        {
+            worker->assigned = false;
+        }
+
+        for (std::size_t i = 0; i < affinityCount; i++)
+        {
+            if (affinities[i] >= 0)
+            {
+                workers[getWorker(affinities[i])]->assigned = true;
+            }
+        }
+
+        pending.store(std::count_if(workers.begin(), workers.end(), [](const auto & w) { return w->assigned; }),
+                      std::memory_order_relaxed);
+
+        for (auto & worker : workers)
+        {
+            if (worker->assigned)
+            {
+                worker->generation.fetch_add(1); // publishes the above to this worker
+
+                if (worker->sleeping.load())
+                {
+                    futexWake(worker->generation, 1);
+                }
+            }
+        }
+
+        // meanwhile, take care of callbacks not bound to any group
+        for (std::size_t i = 0; i < count; i++)
+        {
+            if ((i >= affinityCount || affinities[i] < 0) && !calls[i](0))
+            {
+                result.store(false, std::memory_order_relaxed);
+            }
+        }
+
+        for (int i = 0; pending.load(std::memory_order_acquire) != 0; i++)
+        {
+            if (i < SPIN_ITERATIONS)
+            {
+                cpuRelax();
+                continue;
+            }
+
+            const std::uint32_t remaining = pending.load();
+
+            if (remaining != 0)
+            {
+                callerSleeping.store(true);
+                futexWait(pending, remaining);
+                callerSleeping.store(false);
+            }
+        }
+
+        const bool ok = result.load(std::memory_order_relaxed);
+        busy.store(false, std::memory_order_release);
+        return ok;
+    }
+
+private:
+    struct Worker
+    {
+        std::atomic<std::uint32_t> generation {0}; // futex word, bumped on each dispatch that involves this worker
+        std::atomic<bool> sleeping {false};
+        bool assigned {false}; // only accessed by the dispatching thread
+        std::thread thread;
+    };
+
+    int getWorker(int affinity) const
+    { return affinity % static_cast<int>(workers.size()); }
+
+    void work(int index)
+    {
+        Worker & self = *workers[index];
+        std::uint32_t seen = 0;
+
+        while (true)
+        {
+            std::uint32_t gen;
+
+            for (int i = 0; (gen = self.generation.load(std::memory_order_acquire)) == seen; i++)
+            {
+                if (i < SPIN_ITERATIONS)
+                {
+                    cpuRelax();
+                    continue;
+                }
+
+                self.sleeping.store(true);
+
+                if (self.generation.load() == seen)
+                {
+                    futexWait(self.generation, seen);
+                }
+
+                self.sleeping.store(false);
+            }
+
+            if (stopping)
+            {
+                return;
+            }
+
+            seen = gen;
+
+            // the dispatch cannot complete until this worker reports back, thus all pointers are valid
+            for (std::size_t i = 0; i < affinityCount; i++)
+            {
+                if (affinities[i] >= 0 && getWorker(affinities[i]) == index && !calls[i](0))
+                {
+                    result.store(false, std::memory_order_relaxed);
+                }
+            }
+
+            if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1 && callerSleeping.load())
+            {
+                futexWake(pending, 1);
+            }
+        }
+    }
+
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    // written by the dispatching thread prior to waking up the workers
+    const DeferredCallback * calls {nullptr};
+    const int * affinities {nullptr};
+    std::size_t affinityCount {0};
+    std::size_t count {0};
+
+    std::atomic<std::uint32_t> pending {0}; // futex word of the dispatching thread
+    std::atomic<bool> callerSleeping {false};
+    std::atomic<bool> result {true};
+    std::atomic<bool> busy {false};
+    std::atomic<bool> stopping {false};
+};
+
+/**
+ * @ingroup YarpDeviceMapperLib
+ * @brief An implementation of a deferred callback executor with per-group worker threads.
+ */
+class AffineTask : public FutureTask
+{
+public:
+    AffineTask(AffineExecutor & _executor)
+        : executor(_executor)
+    { }
+
+    virtual bool dispatch() override
+    { return executor.dispatch(deferreds.data(), affinities.data(), affinities.size(), deferreds.size()); }
+
+private:
+    AffineExecutor & executor;
+};
+
 } // namespace roboticslab
 
 class ParallelTaskFactory::Private
@@ -88,3 +524,53 @@ std::unique_ptr<FutureTask> ParallelTaskFactory::createTask()
 {
     return std::make_unique<ParallelTask>(priv->getPool());
 }
+
+class ForkJoinTaskFactory::Private
+{
+public:
+    Private(int threads)
+        : executor(threads)
+    { }
+
+    ForkJoinExecutor & getExecutor()
+    { return executor; }
+
+private:
+    ForkJoinExecutor executor;
+};
+
+ForkJoinTaskFactory::ForkJoinTaskFactory(int threads)
+    : priv(new Private(threads))
+{ }
+
+ForkJoinTaskFactory::~ForkJoinTaskFactory() = default;
+
+std::unique_ptr<FutureTask> ForkJoinTaskFactory::createTask()
+{
+    return std::make_unique<ForkJoinTask>(priv->getExecutor());
+}
+
+class AffineTaskFactory::Private
+{
+public:
+    Private(int groups)
+        : executor(groups)
+    { }
+
+    AffineExecutor & getExecutor()
+    { return executor; }
+
+private:
+    AffineExecutor executor;
+};
+
+AffineTaskFactory::AffineTaskFactory(int groups)
+    : priv(new Private(groups))
+{ }
+
+AffineTaskFactory::~AffineTaskFactory() = default;
+
+std::unique_ptr<FutureTask> AffineTaskFactory::createTask()
+{
+    return std::make_unique<AffineTask>(priv->getExecutor());
+}
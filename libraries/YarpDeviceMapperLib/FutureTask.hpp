@@ -3,13 +3,118 @@
 #ifndef __FUTURE_TASK_HPP__
 #define __FUTURE_TASK_HPP__
 
-#include <functional>
+#include <cstddef>
+
 #include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace roboticslab
 {
 
+/**
+ * @ingroup YarpDeviceMapperLib
+ * @brief Type-erased callback that stores small callables in place.
+ *
+ * Similar to `std::function<bool(int)>`, except that callables no larger
+ * than @ref CAPACITY bytes are constructed in an internal buffer, thus their
+ * registration does not allocate memory. Bigger ones fall back to the heap.
+ * This type is movable, but not copyable.
+ */
+class DeferredCallback final
+{
+public:
+    //! Size of the inline storage (bytes).
+    static constexpr std::size_t CAPACITY = 64;
+
+    //! Constructor, wraps any callable with signature `bool(int)`.
+    template<typename Fn, typename = std::enable_if_t<!std::is_same<std::decay_t<Fn>, DeferredCallback>::value>>
+    DeferredCallback(Fn && fn)
+        : table(&getTable<std::decay_t<Fn>>())
+    { construct<std::decay_t<Fn>>(std::forward<Fn>(fn), IsInline<std::decay_t<Fn>>()); }
+
+    //! Move constructor.
+    DeferredCallback(DeferredCallback && other) noexcept
+        : table(other.table)
+    {
+        if (table)
+        {
+            table->move(storage, other.storage);
+            other.table = nullptr;
+        }
+    }
+
+    DeferredCallback(const DeferredCallback &) = delete;
+    DeferredCallback & operator=(const DeferredCallback &) = delete;
+    DeferredCallback & operator=(DeferredCallback &&) = delete;
+
+    //! Destructor.
+    ~DeferredCallback()
+    {
+        if (table)
+        {
+            table->destroy(storage);
+        }
+    }
+
+    //! Invoke the stored callable.
+    bool operator()(int id) const
+    { return table->invoke(storage, id); }
+
+private:
+    template<typename Fn>
+    using IsInline = std::integral_constant<bool, sizeof(Fn) <= CAPACITY
+        && alignof(Fn) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible<Fn>::value>;
+
+    struct operations
+    {
+        bool (*invoke)(void * storage, int id);
+        void (*move)(void * dst, void * src);
+        void (*destroy)(void * storage);
+    };
+
+    template<typename Fn, typename Arg>
+    void construct(Arg && fn, std::true_type)
+    { new (storage) Fn(std::forward<Arg>(fn)); }
+
+    template<typename Fn, typename Arg>
+    void construct(Arg && fn, std::false_type)
+    { new (storage) Fn *(new Fn(std::forward<Arg>(fn))); }
+
+    template<typename Fn>
+    static const operations & getTable()
+    { return getTable<Fn>(IsInline<Fn>()); }
+
+    template<typename Fn>
+    static const operations & getTable(std::true_type)
+    {
+        static const operations ops {
+            [](void * storage, int id) { return static_cast<bool>((*static_cast<Fn *>(storage))(id)); },
+            [](void * dst, void * src) { new (dst) Fn(std::move(*static_cast<Fn *>(src))); static_cast<Fn *>(src)->~Fn(); },
+            [](void * storage) { static_cast<Fn *>(storage)->~Fn(); }
+        };
+
+        return ops;
+    }
+
+    template<typename Fn>
+    static const operations & getTable(std::false_type)
+    {
+        static const operations ops {
+            [](void * storage, int id) { return static_cast<bool>((**static_cast<Fn **>(storage))(id)); },
+            [](void * dst, void * src) { new (dst) Fn *(*static_cast<Fn **>(src)); },
+            [](void * storage) { delete *static_cast<Fn **>(storage); }
+        };
+
+        return ops;
+    }
+
+    const operations * table;
+    alignas(std::max_align_t) mutable unsigned char storage[CAPACITY];
+};
+
 /**
  * @ingroup YarpDeviceMapperLib
  * @brief Base class for a deferred task executor.
@@ -26,12 +131,34 @@ public:
     //! Register a deferred callback given a free function.
     template<typename Fn, typename... Args>
     void add(Fn && fn, Args &&... args)
-    { deferreds.push_back([=](int) { return fn(args...); }); }
+    { deferreds.emplace_back([=](int) { return fn(args...); }); }
 
     //! Register a deferred callback given a generic class instance.
     template<typename T, typename Fn, typename... Args>
     void add(T * p, Fn && fn, Args &&... args)
-    { deferreds.push_back([=](int) { return (p->*fn)(args...); }); }
+    { deferreds.emplace_back([=](int) { return (p->*fn)(args...); }); }
+
+    /**
+     * @brief Register a deferred callback bound to an affinity group.
+     *
+     * Callbacks of the same group are always run by the same thread if the
+     * executor honors affinities (see @ref AffineTaskFactory), other executors
+     * ignore them. Use @ref NO_AFFINITY for a callback not bound to any group.
+     */
+    template<typename T, typename Fn, typename... Args>
+    void addAffine(int group, T * p, Fn && fn, Args &&... args)
+    {
+        add(p, std::forward<Fn>(fn), std::forward<Args>(args)...);
+        bindLast(group);
+    }
+
+    //! Register a deferred callback bound to an affinity group given a free function.
+    template<typename Fn, typename... Args>
+    void addAffine(int group, Fn && fn, Args &&... args)
+    {
+        add(std::forward<Fn>(fn), std::forward<Args>(args)...);
+        bindLast(group);
+    }
 
     //! Dispatch the registered callbacks and returns their joint result.
     virtual bool dispatch() = 0;
@@ -40,12 +167,25 @@ public:
     unsigned int size() const
     { return deferreds.size(); }
 
-    //! Clear internal list of deferred callbacks.
+    //! Clear internal list of deferred callbacks, storage is kept for reuse.
     void clear()
-    { deferreds.clear(); }
+    { deferreds.clear(); affinities.clear(); }
+
+    //! Affinity group of callbacks not bound to any group.
+    static constexpr int NO_AFFINITY = -1;
 
 protected:
-    std::vector<std::function<bool(int)>> deferreds;
+    std::vector<DeferredCallback> deferreds;
+
+    //! Affinity group per callback, might be shorter than the list of callbacks if trailing ones have none.
+    std::vector<int> affinities;
+
+private:
+    void bindLast(int group)
+    {
+        affinities.resize(deferreds.size(), NO_AFFINITY);
+        affinities.back() = group;
+    }
 };
 
 /**
@@ -91,6 +231,66 @@ private:
     std::unique_ptr<Private> priv;
 };
 
+/**
+ * @ingroup YarpDeviceMapperLib
+ * @brief Abstract factory of @ref ForkJoinTask.
+ *
+ * Owns a fixed set of worker threads that take part in each dispatch along
+ * with the calling thread. Callbacks are claimed through a single atomic
+ * cursor and completion is tracked by a single atomic counter. Idle threads
+ * spin for a short while, then sleep on a futex. Dispatching a task involves
+ * no memory allocation and no locks. Tasks are meant to be reused (see
+ * @ref FutureTask::clear) in periodic loops.
+ *
+ * Only one task is served at a time: concurrent or nested dispatches are
+ * executed sequentially in their calling thread.
+ */
+class ForkJoinTaskFactory : public FutureTaskFactory
+{
+public:
+    //! Constructor, @p threads is the maximum concurrency including the calling thread.
+    ForkJoinTaskFactory(int threads);
+
+    virtual ~ForkJoinTaskFactory();
+
+    virtual std::unique_ptr<FutureTask> createTask() override;
+
+private:
+    class Private;
+    std::unique_ptr<Private> priv;
+};
+
+/**
+ * @ingroup YarpDeviceMapperLib
+ * @brief Abstract factory of @ref AffineTask.
+ *
+ * Owns one worker thread per affinity group, e.g. one per CAN bus. Callbacks
+ * registered through @ref FutureTask::addAffine are run by the worker of their
+ * group (modulo the number of groups), thus callbacks of the same group are
+ * executed sequentially by the same thread and concurrency only arises among
+ * distinct groups. Callbacks not bound to any group are run by the calling
+ * thread while the workers are busy. Dispatching a task involves no memory
+ * allocation and no locks, idle workers spin for a short while, then sleep
+ * on a futex.
+ *
+ * Only one task is served at a time: concurrent or nested dispatches are
+ * executed sequentially in their calling thread.
+ */
+class AffineTaskFactory : public FutureTaskFactory
+{
+public:
+    //! Constructor, creates @p groups worker threads.
+    AffineTaskFactory(int groups);
+
+    virtual ~AffineTaskFactory();
+
+    virtual std::unique_ptr<FutureTask> createTask() override;
+
+private:
+    class Private;
+    std::unique_ptr<Private> priv;
+};
+
 } // namespace roboticslab
 
 #endif // __FUTURE_TASK_HPP__
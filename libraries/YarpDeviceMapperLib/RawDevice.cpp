@@ -29,9 +29,10 @@ struct RawDevice::Private
     yarp::dev::ITorqueControlRaw * iTorqueControlRaw;
 };
 
-RawDevice::RawDevice(yarp::dev::PolyDriver * _driver)
+RawDevice::RawDevice(yarp::dev::PolyDriver * _driver, int _affinity)
     : priv(new Private),
-      driver(_driver->getImplementation())
+      driver(_driver->getImplementation()),
+      affinity(_affinity)
 {
     driver->view(priv->iAmplifierControlRaw);
     driver->view(priv->iAxisInfoRaw);
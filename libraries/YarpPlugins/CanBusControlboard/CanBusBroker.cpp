@@ -19,7 +19,10 @@ CanBusBroker::CanBusBroker(const std::string & _name)
       iCanBus(nullptr),
       iCanBusErrors(nullptr),
       iCanBufferFactory(nullptr),
-      busLoadMonitor(nullptr)
+      busLoadMonitor(nullptr),
+      heartbeatSupervisor(nullptr),
+      emcyMonitor(nullptr),
+      sdoStatisticsMonitor(nullptr)
 { }
 
 // -----------------------------------------------------------------------------
@@ -32,8 +35,13 @@ CanBusBroker::~CanBusBroker()
     sendPort.close();
     sdoPort.close();
     busLoadPort.close();
+    emcyPort.close();
+    sdoStatisticsPort.close();
 
     delete busLoadMonitor;
+    delete heartbeatSupervisor;
+    delete emcyMonitor;
+    delete sdoStatisticsMonitor;
     delete readerThread;
     delete writerThread;
 }
@@ -67,7 +75,46 @@ bool CanBusBroker::configure(const yarp::os::Searchable & config)
         busLoadMonitor = new BusLoadMonitor(busLoadPeriod);
     }
 
+    double heartbeatResolution = config.check("heartbeatResolution", yarp::os::Value(0.01), "CAN bus heartbeat supervisor tick (seconds)").asFloat64();
+
+    if (heartbeatResolution <= 0.0)
+    {
+        yWarning() << "Illegal CAN bus heartbeat supervisor option tick:" << heartbeatResolution;
+        return false;
+    }
+
+    heartbeatSupervisor = new HeartbeatSupervisor(heartbeatResolution);
+
+    if (config.check("emcyPeriod", "CAN bus EMCY monitor period (seconds)"))
+    {
+        double emcyPeriod = config.find("emcyPeriod").asFloat64();
+
+        if (emcyPeriod <= 0.0)
+        {
+            yWarning() << "Illegal CAN bus EMCY monitor option period:" << emcyPeriod;
+            return false;
+        }
+
+        emcyMonitor = new EmcyMonitor(emcyPeriod);
+    }
+
+    if (config.check("sdoStatisticsPeriod", "CAN bus SDO statistics monitor period (seconds)"))
+    {
+        double sdoStatisticsPeriod = config.find("sdoStatisticsPeriod").asFloat64();
+
+        if (sdoStatisticsPeriod <= 0.0)
+        {
+            yWarning() << "Illegal CAN bus SDO statistics monitor option period:" << sdoStatisticsPeriod;
+            return false;
+        }
+
+        sdoStatisticsMonitor = new SdoStatisticsMonitor(sdoStatisticsPeriod);
+    }
+
     readerThread = new CanReaderThread(name, rxDelay, rxBufferSize);
+    readerThread->attachHeartbeatSupervisor(heartbeatSupervisor);
+    readerThread->attachEmcyMonitor(emcyMonitor);
+
     writerThread = new CanWriterThread(name, txDelay, txBufferSize);
 
     if (config.check("name", "YARP port prefix for remote CAN interface"))
@@ -154,6 +201,18 @@ bool CanBusBroker::createPorts(const std::string & prefix)
         return false;
     }
 
+    if (emcyMonitor && !emcyPort.open(prefix + "/emcy:o"))
+    {
+        yWarning() << "Cannot open EMCY port";
+        return false;
+    }
+
+    if (sdoStatisticsMonitor && !sdoStatisticsPort.open(prefix + "/sdoStats:o"))
+    {
+        yWarning() << "Cannot open SDO statistics port";
+        return false;
+    }
+
     if (readerThread)
     {
         readerThread->attachDumpWriter(&dumpPort, &dumpWriter, &dumpMutex);
@@ -183,6 +242,19 @@ bool CanBusBroker::createPorts(const std::string & prefix)
         busLoadMonitor->attach(busLoadPort);
     }
 
+    if (emcyMonitor)
+    {
+        emcyPort.setInputMode(false);
+        emcyMonitor->attach(emcyPort);
+        emcyMonitor->enableStreaming();
+    }
+
+    if (sdoStatisticsMonitor)
+    {
+        sdoStatisticsPort.setInputMode(false);
+        sdoStatisticsMonitor->attach(sdoStatisticsPort);
+    }
+
     return true;
 }
 
@@ -254,6 +326,24 @@ bool CanBusBroker::startThreads()
         return false;
     }
 
+    if (heartbeatSupervisor && heartbeatSupervisor->hasNodes() && !heartbeatSupervisor->start())
+    {
+        yWarning() << "Cannot start heartbeat supervisor thread";
+        return false;
+    }
+
+    if (emcyMonitor && emcyMonitor->hasNodes() && !emcyMonitor->start())
+    {
+        yWarning() << "Cannot start EMCY monitor thread";
+        return false;
+    }
+
+    if (sdoStatisticsMonitor && sdoStatisticsMonitor->hasNodes() && !sdoStatisticsMonitor->start())
+    {
+        yWarning() << "Cannot start SDO statistics monitor thread";
+        return false;
+    }
+
     return true;
 }
 
@@ -265,11 +355,23 @@ bool CanBusBroker::stopThreads()
     commandReader.disableCallback();
     sdoPort.interrupt();
 
+    stopSupervisor();
+
     if (busLoadMonitor && busLoadMonitor->isRunning())
     {
         busLoadMonitor->stop();
     }
 
+    if (emcyMonitor && emcyMonitor->isRunning())
+    {
+        emcyMonitor->stop();
+    }
+
+    if (sdoStatisticsMonitor && sdoStatisticsMonitor->isRunning())
+    {
+        sdoStatisticsMonitor->stop();
+    }
+
     bool ok = true;
 
     if (readerThread && readerThread->isRunning() && !readerThread->stop())
@@ -287,12 +389,24 @@ bool CanBusBroker::stopThreads()
     // keep out ports last to avoid deadlock (happened sometimes with dumpPort)
     dumpPort.interrupt();
     busLoadPort.interrupt();
+    emcyPort.interrupt();
+    sdoStatisticsPort.interrupt();
 
     return ok;
 }
 
 // -----------------------------------------------------------------------------
 
+void CanBusBroker::stopSupervisor()
+{
+    if (heartbeatSupervisor && heartbeatSupervisor->isRunning())
+    {
+        heartbeatSupervisor->stop();
+    }
+}
+
+// -----------------------------------------------------------------------------
+
 void CanBusBroker::onRead(yarp::os::Bottle & b)
 {
     if (b.size() != 1 && b.size() != 2)
@@ -20,6 +20,9 @@
 #include "CanRxTxThreads.hpp"
 #include "SdoReplier.hpp"
 #include "BusLoadMonitor.hpp"
+#include "HeartbeatSupervisor.hpp"
+#include "EmcyMonitor.hpp"
+#include "SdoStatisticsMonitor.hpp"
 
 namespace roboticslab
 {
@@ -34,7 +37,8 @@ namespace roboticslab
  *
  * CAN traffic is interfaced via optional YARP ports to allow remote access.
  * This includes an output dump port, an input command port, and an RPC service
- * for confirmed SDO transfers.
+ * for confirmed SDO transfers. Statistics of SDO transfers performed by each
+ * node can be streamed as well.
  */
 class CanBusBroker final : public yarp::os::TypedReaderCallback<yarp::os::Bottle>
 {
@@ -63,6 +67,9 @@ public:
     //! Stop CAN read/write threads.
     bool stopThreads();
 
+    //! Stop NMT heartbeat supervision.
+    void stopSupervisor();
+
     //! Get handle of the CAN RX thread.
     CanReaderThread * getReader() const
     { return readerThread; }
@@ -71,6 +78,18 @@ public:
     CanWriterThread * getWriter() const
     { return writerThread; }
 
+    //! Get handle of the NMT heartbeat supervisor.
+    HeartbeatSupervisor * getHeartbeatSupervisor() const
+    { return heartbeatSupervisor; }
+
+    //! Get handle of the EMCY monitor.
+    EmcyMonitor * getEmcyMonitor() const
+    { return emcyMonitor; }
+
+    //! Get handle of the SDO statistics monitor, if enabled.
+    SdoStatisticsMonitor * getSdoStatisticsMonitor() const
+    { return sdoStatisticsMonitor; }
+
     //! Retrieve string identifier for this CAN bus.
     std::string getName() const
     { return name; }
@@ -103,6 +122,14 @@ private:
 
     yarp::os::Port busLoadPort;
     BusLoadMonitor * busLoadMonitor;
+
+    HeartbeatSupervisor * heartbeatSupervisor;
+
+    yarp::os::Port emcyPort;
+    EmcyMonitor * emcyMonitor;
+
+    yarp::os::Port sdoStatisticsPort;
+    SdoStatisticsMonitor * sdoStatisticsMonitor;
 };
 
 } // namespace roboticslab
@@ -9,6 +9,7 @@
 
 #include "DeviceMapper.hpp"
 #include "CanBusBroker.hpp"
+#include "JointStateSnapshot.hpp"
 #include "SyncPeriodicThread.hpp"
 
 #define CHECK_JOINT(j) do { int n = deviceMapper.getControlledAxes(); if ((j) < 0 || (j) > n - 1) return false; } while (0)
@@ -312,6 +313,10 @@ private:
     std::vector<CanBusBroker *> canBusBrokers;
 
     SyncPeriodicThread * syncThread {nullptr};
+    JointStateSnapshot * jointState {nullptr};
+    JointStateSnapshot::Listener * sharedJointState {nullptr};
+    SyncPeriodicThread::CommandSource * sharedJointCommands {nullptr};
+    FutureTaskFactory * controlModeTaskFactory {nullptr}; // null if the executor of deviceMapper is used
 };
 
 } // namespace roboticslab
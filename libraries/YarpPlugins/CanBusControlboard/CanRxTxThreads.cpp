@@ -50,7 +50,9 @@ void CanReaderWriterThread::dumpMessage(const can_message & msg, yarp::os::Bottl
 
 CanReaderThread::CanReaderThread(const std::string & id, double delay, unsigned int bufferSize)
     : CanReaderWriterThread("read", id, delay, bufferSize),
-      canMessageNotifier(nullptr)
+      canMessageNotifier(nullptr),
+      heartbeatSupervisor(nullptr),
+      emcyMonitor(nullptr)
 { }
 
 // -----------------------------------------------------------------------------
@@ -68,6 +70,38 @@ void CanReaderThread::registerHandle(ICanBusSharer * p)
 
 // -----------------------------------------------------------------------------
 
+void CanReaderThread::dispatch(const can_message & msg)
+{
+    auto it = canIdToHandle.find(msg.id & 0x7F);
+
+    if (it != canIdToHandle.end())
+    {
+        it->second->notifyMessage(msg);
+    }
+
+    if (heartbeatSupervisor)
+    {
+        heartbeatSupervisor->notifyMessage(msg);
+    }
+
+    if (emcyMonitor)
+    {
+        emcyMonitor->notifyMessage(msg);
+    }
+
+    if (canMessageNotifier)
+    {
+        canMessageNotifier->notifyMessage(msg);
+    }
+
+    if (busLoadMonitor)
+    {
+        busLoadMonitor->notifyMessage(msg);
+    }
+}
+
+// -----------------------------------------------------------------------------
+
 void CanReaderThread::run()
 {
     unsigned int read;
@@ -94,27 +128,12 @@ void CanReaderThread::run()
         for (int i = 0; i < read; i++)
         {
             can_message msg {canBuffer[i].getId(), canBuffer[i].getLen(), canBuffer[i].getData()};
-            auto it = canIdToHandle.find(msg.id & 0x7F);
-
-            if (it != canIdToHandle.end())
-            {
-                it->second->notifyMessage(msg);
-            }
+            dispatch(msg);
 
             if (dumpWriter)
             {
                 dumpMessage(msg, dump.addList());
             }
-
-            if (canMessageNotifier)
-            {
-                canMessageNotifier->notifyMessage(msg);
-            }
-
-            if (busLoadMonitor)
-            {
-                busLoadMonitor->notifyMessage(msg);
-            }
         }
 
         if (dumpWriter && dump.size() != 0)
@@ -129,12 +129,25 @@ public:
     void attachCanNotifier(CanMessageNotifier * canMessageNotifier)
     { this->canMessageNotifier = canMessageNotifier; }
 
+    //! Attach NMT heartbeat supervisor.
+    void attachHeartbeatSupervisor(CanMessageNotifier * heartbeatSupervisor)
+    { this->heartbeatSupervisor = heartbeatSupervisor; }
+
+    //! Attach EMCY monitor.
+    void attachEmcyMonitor(CanMessageNotifier * emcyMonitor)
+    { this->emcyMonitor = emcyMonitor; }
+
+    //! Forward a received CAN message to its handle and all attached notifiers.
+    void dispatch(const can_message & msg);
+
     virtual void run() override;
 
 private:
     std::vector<ICanBusSharer *> handles;
     std::unordered_map<unsigned int, ICanBusSharer *> canIdToHandle;
     CanMessageNotifier * canMessageNotifier;
+    CanMessageNotifier * heartbeatSupervisor;
+    CanMessageNotifier * emcyMonitor;
 };
 
 /**
@@ -2,12 +2,27 @@
 
 #include "CanBusControlboard.hpp"
 
+#include <algorithm> // std::max, std::min
+#include <cmath> // std::lround
+
 #include <yarp/os/LogStream.h>
 #include <yarp/os/Property.h>
 #include <yarp/os/Value.h>
 
 #include "ICanBusSharer.hpp"
 
+#ifdef USE_SHARED_MEMORY
+# include "SharedJointCommandConsumer.hpp"
+# include "SharedJointStatePublisher.hpp"
+#endif
+
+namespace
+{
+    constexpr int DEFAULT_SHARED_JOINT_STATE_DEPTH = 16;
+    constexpr double DEFAULT_SHARED_JOINT_COMMANDS_TIMEOUT = 0.02; // [s]
+    constexpr std::size_t MAX_CONTROL_MODE_THREADS = 4;
+}
+
 using namespace roboticslab;
 
 // -----------------------------------------------------------------------------
@@ -139,7 +154,8 @@ bool CanBusControlboard::open(yarp::os::Searchable & config)
                 return false;
             }
 
-            if (!deviceMapper.registerDevice(device))
+            // bind to the bus, see 'busAffinity'
+            if (!deviceMapper.registerDevice(device, busDevices.size() - 1))
             {
                 yError() << "Unable to register CAN node device" << node;
                 return false;
@@ -156,6 +172,23 @@ bool CanBusControlboard::open(yarp::os::Searchable & config)
                 }
 
                 canBusBrokers.back()->getReader()->registerHandle(iCanBusSharer);
+                canBusBrokers.back()->getHeartbeatSupervisor()->registerHandle(iCanBusSharer);
+
+                yarp::dev::IRemoteVariablesRaw * iRemoteVariablesRaw;
+
+                if (device->view(iRemoteVariablesRaw))
+                {
+                    if (canBusBrokers.back()->getEmcyMonitor())
+                    {
+                        canBusBrokers.back()->getEmcyMonitor()->registerHandle(iCanBusSharer->getId(), iRemoteVariablesRaw);
+                    }
+
+                    if (canBusBrokers.back()->getSdoStatisticsMonitor())
+                    {
+                        canBusBrokers.back()->getSdoStatisticsMonitor()->registerHandle(iCanBusSharer->getId(), iRemoteVariablesRaw);
+                    }
+                }
+
                 iCanBusSharer->registerSender(canBusBrokers.back()->getWriter()->getDelegate());
             }
         }
@@ -170,6 +203,52 @@ bool CanBusControlboard::open(yarp::os::Searchable & config)
         }
     }
 
+    if (config.check("syncPeriod"))
+    {
+        // nodes feed it from the CAN read threads, register them before those start
+        jointState = new JointStateSnapshot(deviceMapper.getControlledAxes());
+
+        for (const auto & t : deviceMapper.getDevicesWithOffsets())
+        {
+            auto * iCanBusSharer = std::get<0>(t)->castToType<ICanBusSharer>();
+            int offset = std::get<1>(t);
+
+            if (iCanBusSharer && iCanBusSharer->registerJointStateSink(jointState->getSink(offset)))
+            {
+                yDebug() << "Node device id" << iCanBusSharer->getId() << "reports joint state on each SYNC";
+            }
+        }
+
+        auto sharedName = config.check("sharedJointState", yarp::os::Value(""),
+                "POSIX shared memory object to publish joint state into, e.g. /roboticslab-joint-state").asString();
+
+        if (!sharedName.empty())
+        {
+#ifdef USE_SHARED_MEMORY
+            int depth = config.check("sharedJointStateDepth", yarp::os::Value(DEFAULT_SHARED_JOINT_STATE_DEPTH),
+                    "number of cycles kept in the shared joint state ring").asInt32();
+
+            auto * publisher = new SharedJointStatePublisher;
+            sharedJointState = publisher;
+
+            if (!publisher->open(sharedName, deviceMapper.getControlledAxes(), depth))
+            {
+                return false;
+            }
+
+            jointState->setListener(publisher);
+#else
+            yError() << "Shared memory support not available, unable to publish joint state in" << sharedName;
+            return false;
+#endif
+        }
+    }
+    else if (config.check("sharedJointState") || config.check("sharedJointCommands"))
+    {
+        yError() << "Shared memory options require \"syncPeriod\"";
+        return false;
+    }
+
     for (auto * canBusBroker : canBusBrokers)
     {
         if (!canBusBroker->startThreads())
@@ -179,6 +258,19 @@ bool CanBusControlboard::open(yarp::os::Searchable & config)
         }
     }
 
+    bool busAffinity = config.check("busAffinity", yarp::os::Value(false), "forward commands to nodes through one worker thread per CAN bus").asBool();
+
+    if (busAffinity)
+    {
+        yInfo() << "Commands will be dispatched on" << busDevices.size() << "bus-affine worker threads";
+        deviceMapper.enableAffinity(busDevices.size());
+    }
+    else if (nodeDevices.size() > 1)
+    {
+        // control mode switches entail several SDO round trips per node, overlap them on a few threads
+        controlModeTaskFactory = new ParallelTaskFactory(std::min(nodeDevices.size(), MAX_CONTROL_MODE_THREADS));
+    }
+
     for (const auto & t : deviceMapper.getDevicesWithOffsets())
     {
         auto * iCanBusSharer = std::get<0>(t)->castToType<ICanBusSharer>();
@@ -195,7 +287,7 @@ bool CanBusControlboard::open(yarp::os::Searchable & config)
 
         if (busDevices.size() > 1)
         {
-            taskFactory = new ParallelTaskFactory(busDevices.size());
+            taskFactory = new ForkJoinTaskFactory(busDevices.size());
         }
         else
         {
@@ -204,6 +296,44 @@ bool CanBusControlboard::open(yarp::os::Searchable & config)
 
         syncThread = new SyncPeriodicThread(canBusBrokers, taskFactory);
         syncThread->setPeriod(config.find("syncPeriod").asFloat64());
+        syncThread->setJointStateSnapshot(jointState);
+
+        auto commandsName = config.check("sharedJointCommands", yarp::os::Value(""),
+                "POSIX shared memory object to accept setpoints from, e.g. /roboticslab-joint-commands").asString();
+
+        if (!commandsName.empty())
+        {
+#ifdef USE_SHARED_MEMORY
+            double timeout = config.check("sharedJointCommandsTimeout", yarp::os::Value(DEFAULT_SHARED_JOINT_COMMANDS_TIMEOUT),
+                    "hold or stop joints whose shared memory commands stall for longer than this (seconds)").asFloat64();
+
+            if (timeout <= 0.0)
+            {
+                yError() << "Illegal shared memory commands timeout:" << timeout;
+                return false;
+            }
+
+            auto cycles = std::max(1L, std::lround(timeout / syncThread->getPeriod()));
+            auto * consumer = new SharedJointCommandConsumer;
+            sharedJointCommands = consumer;
+
+            if (!consumer->open(commandsName, deviceMapper, cycles))
+            {
+                return false;
+            }
+
+            syncThread->setCommandSource(consumer);
+#else
+            yError() << "Shared memory support not available, unable to accept commands from" << commandsName;
+            return false;
+#endif
+        }
+
+        if (!syncThread->setCounterOverflow(config.check("syncCounterOverflow", yarp::os::Value(0),
+                "SYNC counter overflow value [2-240], zero disables the counter").asInt32()))
+        {
+            return false;
+        }
 
         if (!syncThread->openPort("/sync:o"))
         {
@@ -237,6 +367,15 @@ bool CanBusControlboard::close()
     delete syncThread;
     syncThread = nullptr;
 
+    delete sharedJointCommands; // producers keep their mappings, but are told the mailboxes are closed
+    sharedJointCommands = nullptr;
+
+    for (auto * canBusBroker : canBusBrokers)
+    {
+        // Don't let heartbeat events interfere with node finalization.
+        canBusBroker->stopSupervisor();
+    }
+
     for (const auto & t : deviceMapper.getDevicesWithOffsets())
     {
         auto * iCanBusSharer = std::get<0>(t)->castToType<ICanBusSharer>();
@@ -250,6 +389,9 @@ bool CanBusControlboard::close()
 
     deviceMapper.clear();
 
+    delete controlModeTaskFactory;
+    controlModeTaskFactory = nullptr;
+
     for (auto * canBusBroker : canBusBrokers)
     {
         ok &= canBusBroker->stopThreads();
@@ -259,6 +401,13 @@ bool CanBusControlboard::close()
 
     canBusBrokers.clear();
 
+    // no CAN read thread may feed it anymore
+    delete jointState;
+    jointState = nullptr;
+
+    delete sharedJointState; // readers keep their mappings, but are told the ring is closed
+    sharedJointState = nullptr;
+
     for (auto * device : nodeDevices)
     {
         // CAN read threads must not live beyond this point.
@@ -0,0 +1,149 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#include "EmcyMonitor.hpp"
+
+#include <string>
+
+#include <yarp/os/LogStream.h>
+
+using namespace roboticslab;
+
+// -----------------------------------------------------------------------------
+
+constexpr unsigned int EmcyMonitor::MAX_NODES;
+
+// -----------------------------------------------------------------------------
+
+EmcyMonitor::EmcyMonitor(double period)
+    : yarp::os::PeriodicThread(period),
+      streaming(false)
+{
+    handles.fill(nullptr);
+    lastReported.fill(0);
+
+    for (auto & mask : pending)
+    {
+        mask = 0;
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+bool EmcyMonitor::registerHandle(unsigned int id, yarp::dev::IRemoteVariablesRaw * p)
+{
+    if (id == 0 || id >= MAX_NODES)
+    {
+        yWarning() << "Illegal node id for EMCY monitoring:" << id;
+        return false;
+    }
+
+    yarp::os::Bottle keys;
+
+    if (!p->getRemoteVariablesListRaw(&keys))
+    {
+        return false;
+    }
+
+    for (int i = 0; i < keys.size(); i++)
+    {
+        if (keys.get(i).asString() == "emcy")
+        {
+            handles[id] = p;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// -----------------------------------------------------------------------------
+
+bool EmcyMonitor::hasNodes() const
+{
+    for (const auto * p : handles)
+    {
+        if (p)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// -----------------------------------------------------------------------------
+
+bool EmcyMonitor::notifyMessage(const can_message & msg)
+{
+    unsigned int id = msg.id & 0x7F;
+
+    if ((msg.id & 0x780) != 0x080 || id == 0 || !handles[id])
+    {
+        return false;
+    }
+
+    pending[id / 64] |= std::uint64_t(1) << (id % 64);
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+void EmcyMonitor::poll()
+{
+    for (unsigned int i = 0; i < pending.size(); i++)
+    {
+        std::uint64_t mask = pending[i].exchange(0);
+
+        for (unsigned int bit = 0; mask != 0; bit++, mask >>= 1)
+        {
+            if (!(mask & 1))
+            {
+                continue;
+            }
+
+            unsigned int id = i * 64 + bit;
+            yarp::os::Bottle val;
+
+            if (!handles[id]->getRemoteVariableRaw("emcy", val) || !val.get(1).isList())
+            {
+                yWarning() << "Unable to retrieve EMCY history of node" << id;
+                continue;
+            }
+
+            const auto * records = val.get(1).asList();
+
+            // each record: (seq timestamp code message reg (msef...)), oldest first
+            for (int j = 0; j < records->size(); j++)
+            {
+                const auto * record = records->get(j).asList();
+
+                if (!record || record->size() < 5)
+                {
+                    continue;
+                }
+
+                std::uint64_t seq = record->get(0).asInt64();
+
+                if (seq <= lastReported[id])
+                {
+                    continue; // already logged and streamed
+                }
+
+                lastReported[id] = seq;
+
+                yWarning("EMCY 0x%04X: %s (canId %d)", record->get(2).asInt32(), record->get(3).asString().c_str(), id);
+
+                if (streaming)
+                {
+                    auto & b = prepare();
+                    b.clear();
+                    b.addString("id" + std::to_string(id));
+                    b.append(*record);
+                    write(true);
+                }
+            }
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
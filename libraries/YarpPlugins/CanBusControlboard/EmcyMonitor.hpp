@@ -0,0 +1,76 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __EMCY_MONITOR_HPP__
+#define __EMCY_MONITOR_HPP__
+
+#include <cstdint>
+
+#include <array>
+#include <atomic>
+
+#include <yarp/os/Bottle.h>
+#include <yarp/os/PeriodicThread.h>
+#include <yarp/os/PortWriterBuffer.h>
+
+#include <yarp/dev/IRemoteVariables.h>
+
+#include "CanMessageNotifier.hpp"
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup CanBusControlboard
+ * @brief Reports EMCY messages of a single CAN bus outside the CAN read thread.
+ *
+ * The CAN read thread merely flags nodes that sent an emergency message. On
+ * each step, the EMCY history of flagged nodes is retrieved via the "emcy"
+ * remote variable of the raw subdevice, new records are logged and, if a
+ * port has been attached, streamed through it.
+ */
+class EmcyMonitor final : public yarp::os::PeriodicThread,
+                          public yarp::os::PortWriterBuffer<yarp::os::Bottle>,
+                          public CanMessageNotifier
+{
+public:
+    //! Constructor.
+    EmcyMonitor(double period);
+
+    //! Register a node, ignored if it doesn't provide the "emcy" remote variable.
+    bool registerHandle(unsigned int id, yarp::dev::IRemoteVariablesRaw * p);
+
+    //! Whether any node has been registered.
+    bool hasNodes() const;
+
+    //! Enable streaming through the attached port.
+    void enableStreaming()
+    { streaming = true; }
+
+    //! Flag nodes upon EMCY messages, invoked by the CAN read thread.
+    virtual bool notifyMessage(const can_message & msg) override;
+
+    //! Report new records of flagged nodes, invoked on each thread step.
+    void poll();
+
+    //! Sequence number of the last reported record of a node, zero if none.
+    std::uint64_t getLastReported(unsigned int id) const
+    { return id < MAX_NODES ? lastReported[id] : 0; }
+
+protected:
+    //! The thread will invoke this periodically.
+    virtual void run() override
+    { poll(); }
+
+private:
+    static constexpr unsigned int MAX_NODES = 128;
+
+    std::array<yarp::dev::IRemoteVariablesRaw *, MAX_NODES> handles;
+    std::array<std::uint64_t, MAX_NODES> lastReported;
+    std::array<std::atomic<std::uint64_t>, MAX_NODES / 64> pending; // one bit per node id
+
+    bool streaming;
+};
+
+} // namespace roboticslab
+
+#endif // __EMCY_MONITOR_HPP__
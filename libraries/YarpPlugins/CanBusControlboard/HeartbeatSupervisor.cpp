@@ -0,0 +1,251 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#include "HeartbeatSupervisor.hpp"
+
+#include <cmath>
+
+#include <utility>
+
+#include <yarp/os/LogStream.h>
+#include <yarp/os/Time.h>
+
+using namespace roboticslab;
+
+// -----------------------------------------------------------------------------
+
+constexpr unsigned int HeartbeatSupervisor::WHEEL_SLOTS;
+constexpr unsigned int HeartbeatSupervisor::MAX_NODES;
+
+// -----------------------------------------------------------------------------
+
+HeartbeatSupervisor::HeartbeatSupervisor(double period)
+    : yarp::os::PeriodicThread(period),
+      startTime(0.0),
+      currentTick(0)
+{
+    slots.fill(-1);
+
+    for (auto & mask : pendingBootUps)
+    {
+        mask = 0;
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+void HeartbeatSupervisor::registerHandle(ICanBusSharer * p)
+{
+    double timeout = p->getHeartbeatTimeout();
+    unsigned int id = p->getId();
+
+    if (timeout <= 0.0)
+    {
+        return;
+    }
+
+    if (id >= MAX_NODES || nodes[id])
+    {
+        yWarning() << "Illegal or duplicated node id for heartbeat supervision:" << id;
+        return;
+    }
+
+    auto * node = new node_entry;
+    node->handle = p;
+    node->timeoutTicks = std::ceil(timeout / getPeriod());
+
+    nodes[id].reset(node);
+    ids.push_back(id);
+}
+
+// -----------------------------------------------------------------------------
+
+bool HeartbeatSupervisor::notifyMessage(const can_message & msg)
+{
+    if ((msg.id & 0x780) != 0x700 || msg.len != 1)
+    {
+        return false;
+    }
+
+    const auto & node = nodes[msg.id & 0x7F];
+
+    if (!node)
+    {
+        return false;
+    }
+
+    node->lastSeen = yarp::os::Time::now();
+    node->state = msg.data[0] & 0x7F; // mask toggle bit (node guarding)
+    node->deadline = currentTick + node->timeoutTicks + 1; // the current tick may be almost over
+
+    if (msg.data[0] == static_cast<std::uint8_t>(NmtState::BOOTUP))
+    {
+        unsigned int id = msg.id & 0x7F;
+        pendingBootUps[id / 64] |= std::uint64_t(1) << (id % 64);
+    }
+
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+std::vector<HeartbeatSupervisor::node_status> HeartbeatSupervisor::getNodeStates() const
+{
+    std::vector<node_status> states;
+    states.reserve(ids.size());
+
+    for (auto id : ids)
+    {
+        const auto & node = nodes[id];
+        double lastSeen = node->lastSeen;
+        bool alive = lastSeen != 0.0 && node->deadline > currentTick;
+        states.push_back({id, static_cast<NmtState>(node->state.load()), lastSeen, alive});
+    }
+
+    return states;
+}
+
+// -----------------------------------------------------------------------------
+
+bool HeartbeatSupervisor::threadInit()
+{
+    arm(yarp::os::Time::now());
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+void HeartbeatSupervisor::run()
+{
+    advance(yarp::os::Time::now());
+}
+
+// -----------------------------------------------------------------------------
+
+void HeartbeatSupervisor::threadRelease()
+{
+    waitForEvents();
+}
+
+// -----------------------------------------------------------------------------
+
+void HeartbeatSupervisor::arm(double now)
+{
+    startTime = now;
+    currentTick = 0;
+    slots.fill(-1);
+
+    for (auto id : ids)
+    {
+        nodes[id]->deadline = nodes[id]->timeoutTicks;
+        nodes[id]->lost = false;
+        schedule(id, nodes[id]->timeoutTicks);
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+void HeartbeatSupervisor::schedule(unsigned int id, std::uint64_t deadline)
+{
+    auto & head = slots[deadline % WHEEL_SLOTS];
+    nodes[id]->next = head;
+    head = id;
+}
+
+// -----------------------------------------------------------------------------
+
+void HeartbeatSupervisor::advance(double now)
+{
+    // ticks follow the clock, not the number of steps
+    std::uint64_t target = now > startTime ? static_cast<std::uint64_t>((now - startTime) / getPeriod()) : 0;
+
+    // boot-up events don't wait for the node's slot
+    for (unsigned int i = 0; i < pendingBootUps.size(); i++)
+    {
+        std::uint64_t mask = pendingBootUps[i].exchange(0);
+
+        for (unsigned int bit = 0; mask != 0; bit++, mask >>= 1)
+        {
+            if (mask & 1)
+            {
+                unsigned int id = i * 64 + bit;
+                auto * handle = nodes[id]->handle;
+                nodes[id]->lost = false;
+                dispatch(id, [handle] { handle->onBootUp(); });
+            }
+        }
+    }
+
+    // catch up with every tick due since the last step
+    for (std::uint64_t tick = currentTick + 1; tick <= target; tick++)
+    {
+        currentTick = tick;
+        expire(tick);
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+void HeartbeatSupervisor::expire(std::uint64_t tick)
+{
+    auto & head = slots[tick % WHEEL_SLOTS];
+    int id = head;
+    head = -1; // detach, expired or rescheduled nodes are reinserted below
+
+    while (id != -1)
+    {
+        auto & node = nodes[id];
+        int next = node->next;
+
+        std::uint64_t deadline = node->deadline;
+
+        if (deadline > tick)
+        {
+            // heartbeat received since last check, or not yet due (next wheel round)
+            node->lost = false;
+            schedule(id, deadline);
+        }
+        else
+        {
+            if (!node->lost)
+            {
+                node->lost = true;
+                double lastSeen = node->lastSeen;
+                double elapsed = lastSeen != 0.0 ? yarp::os::Time::now() - lastSeen : (tick * getPeriod());
+                auto * handle = node->handle;
+                dispatch(id, [handle, elapsed] { handle->onHeartbeatLost(elapsed); });
+            }
+
+            // keep polling at timeout granularity until the node is back
+            schedule(id, tick + node->timeoutTicks);
+        }
+
+        id = next;
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+void HeartbeatSupervisor::dispatch(unsigned int id, std::function<void()> && fn)
+{
+    if (!workers[id])
+    {
+        workers[id].reset(new NodeWorker);
+    }
+
+    workers[id]->post(std::move(fn));
+}
+
+// -----------------------------------------------------------------------------
+
+void HeartbeatSupervisor::waitForEvents()
+{
+    for (auto id : ids)
+    {
+        if (workers[id])
+        {
+            workers[id]->wait();
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
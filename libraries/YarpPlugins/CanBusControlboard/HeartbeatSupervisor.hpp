@@ -0,0 +1,117 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __HEARTBEAT_SUPERVISOR_HPP__
+#define __HEARTBEAT_SUPERVISOR_HPP__
+
+#include <cstdint>
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <yarp/os/PeriodicThread.h>
+
+#include "CanMessageNotifier.hpp"
+#include "ICanBusSharer.hpp"
+#include "NmtProtocol.hpp"
+#include "NodeWorker.hpp"
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup CanBusControlboard
+ * @brief Per-bus NMT heartbeat consumer.
+ *
+ * Listens to heartbeat frames of all nodes on a single CAN bus and tracks
+ * per-node deadlines in a hashed timer wheel advanced by one periodic thread.
+ * Ticks are derived from the time elapsed since the wheel was armed, hence a
+ * late step catches up with all ticks due meanwhile. Heartbeat loss and boot-up
+ * events are handed to a worker thread of the affected node, spawned on its
+ * first event, since the handlers of @ref ICanBusSharer may block for long
+ * (e.g. reinitialization). Neither the CAN read thread nor the wheel thread
+ * ever wait for them. Detection latency is bounded by the node's timeout plus
+ * one wheel tick.
+ */
+class HeartbeatSupervisor final : public yarp::os::PeriodicThread,
+                                  public CanMessageNotifier
+{
+public:
+    //! Snapshot of the supervision state of a single node.
+    struct node_status
+    {
+        unsigned int id;
+        NmtState state;
+        double lastSeen; ///< timestamp of the last heartbeat, zero if none
+        bool alive;
+    };
+
+    //! Constructor, the period sets the tick resolution of the timer wheel.
+    HeartbeatSupervisor(double period);
+
+    //! Register a node, ignored if it doesn't request supervision.
+    void registerHandle(ICanBusSharer * p);
+
+    //! Whether any registered node is supervised.
+    bool hasNodes() const
+    { return !ids.empty(); }
+
+    //! Consume heartbeat frames, invoked by the CAN read thread.
+    virtual bool notifyMessage(const can_message & msg) override;
+
+    //! Retrieve current state of all supervised nodes.
+    std::vector<node_status> getNodeStates() const;
+
+    //! Arm timers of all supervised nodes at the given time, invoked on thread start.
+    void arm(double now);
+
+    //! Advance the timer wheel up to the given time, invoked on each thread step.
+    void advance(double now);
+
+    //! Block until all events dispatched so far have been handled.
+    void waitForEvents();
+
+protected:
+    //! Arm timers of all supervised nodes.
+    virtual bool threadInit() override;
+
+    //! Advance the timer wheel to the current time.
+    virtual void run() override;
+
+    //! Wait for pending events.
+    virtual void threadRelease() override;
+
+private:
+    static constexpr unsigned int WHEEL_SLOTS = 64;
+    static constexpr unsigned int MAX_NODES = 128;
+
+    struct node_entry
+    {
+        ICanBusSharer * handle;
+        std::uint64_t timeoutTicks;
+        std::atomic<std::uint64_t> deadline {0};
+        std::atomic<double> lastSeen {0.0};
+        std::atomic<std::uint8_t> state {0};
+        bool lost {false};
+        int next {-1}; // intrusive slot list, only touched by the wheel thread
+    };
+
+    void schedule(unsigned int id, std::uint64_t deadline);
+    void expire(std::uint64_t tick);
+    void dispatch(unsigned int id, std::function<void()> && fn);
+
+    std::array<std::unique_ptr<node_entry>, MAX_NODES> nodes;
+    std::array<int, WHEEL_SLOTS> slots;
+    std::vector<unsigned int> ids;
+    std::array<std::unique_ptr<NodeWorker>, MAX_NODES> workers; // only touched by the wheel thread
+
+    double startTime;
+    std::atomic<std::uint64_t> currentTick;
+    std::array<std::atomic<std::uint64_t>, MAX_NODES / 64> pendingBootUps; // one bit per node id
+};
+
+} // namespace roboticslab
+
+#endif // __HEARTBEAT_SUPERVISOR_HPP__
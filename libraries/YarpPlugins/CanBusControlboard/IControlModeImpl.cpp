@@ -2,11 +2,65 @@
 
 #include "CanBusControlboard.hpp"
 
+#include <memory>
+#include <vector>
+
 #include <yarp/os/Log.h>
 #include <yarp/os/Vocab.h>
 
+#include "ICiA402Drive.hpp"
+
 using namespace roboticslab;
 
+namespace
+{
+    struct drive_request
+    {
+        ICiA402Drive * drive;
+        int mode;
+        int affinity;
+    };
+
+    // dedicated executor if any, otherwise the one of the device mapper (e.g. bus-affine workers)
+    std::unique_ptr<FutureTask> createTask(FutureTaskFactory * taskFactory, const DeviceMapper & deviceMapper)
+    {
+        return taskFactory ? taskFactory->createTask() : deviceMapper.createTask();
+    }
+
+    // nodes run their preconditions concurrently, then all drive state machines are transitioned at once
+    void requestDriveStates(const std::vector<drive_request> & drives, std::unique_ptr<FutureTask> task)
+    {
+        std::vector<DriveState> states(drives.size());
+        std::vector<char> prepared(drives.size(), false);
+
+        for (auto i = 0u; i < drives.size(); i++)
+        {
+            task->addAffine(drives[i].affinity, [&drives, &states, &prepared, i]
+                {
+                    prepared[i] = drives[i].drive->prepareControlModeRaw(drives[i].mode, &states[i]);
+                    return true;
+                });
+        }
+
+        task->dispatch();
+
+        std::vector<DriveStatusMachine::request_t> requests;
+
+        for (auto i = 0u; i < drives.size(); i++)
+        {
+            if (prepared[i])
+            {
+                requests.emplace_back(drives[i].drive->getDriveStatusMachine(), states[i]);
+            }
+        }
+
+        if (!requests.empty() && !DriveStatusMachine::requestStates(requests))
+        {
+            yWarning("Unable to transition all drives at once, falling back to per-node requests");
+        }
+    }
+}
+
 // -----------------------------------------------------------------------------
 
 bool CanBusControlboard::getControlMode(int j, int * mode)
@@ -21,7 +75,7 @@ bool CanBusControlboard::getControlMode(int j, int * mode)
 bool CanBusControlboard::getControlModes(int * modes)
 {
     yTrace("");
-    return deviceMapper.mapAllJoints(&yarp::dev::IControlModeRaw::getControlModesRaw, modes);
+    return deviceMapper.mapAllJoints(DeviceMapper::inlined, &yarp::dev::IControlModeRaw::getControlModesRaw, modes);
 }
 
 // -----------------------------------------------------------------------------
@@ -29,7 +83,7 @@ bool CanBusControlboard::getControlModes(int * modes)
 bool CanBusControlboard::getControlModes(int n_joint, const int * joints, int * modes)
 {
     yTrace("%d", n_joint);
-    return deviceMapper.mapJointGroup(&yarp::dev::IControlModeRaw::getControlModesRaw, n_joint, joints, modes);
+    return deviceMapper.mapJointGroup(DeviceMapper::inlined, &yarp::dev::IControlModeRaw::getControlModesRaw, n_joint, joints, modes);
 }
 
 // -----------------------------------------------------------------------------
@@ -46,7 +100,35 @@ bool CanBusControlboard::setControlMode(int j, int mode)
 bool CanBusControlboard::setControlModes(int * modes)
 {
     yTrace("");
-    return deviceMapper.mapAllJoints(&yarp::dev::IControlModeRaw::setControlModesRaw, modes);
+
+    std::vector<drive_request> drives;
+    auto task = createTask(controlModeTaskFactory, deviceMapper);
+
+    for (const auto & t : deviceMapper.getDevicesWithOffsets())
+    {
+        auto * p = std::get<0>(t)->getHandle<yarp::dev::IControlModeRaw>();
+        auto * drive = std::get<0>(t)->castToType<ICiA402Drive>();
+        int affinity = std::get<0>(t)->getAffinity();
+        int * m = modes + std::get<1>(t);
+
+        if (p)
+        {
+            task->addAffine(affinity, [p, m] { return p->setControlModesRaw(m); });
+        }
+
+        if (drive)
+        {
+            drives.push_back({drive, *m, affinity});
+        }
+    }
+
+    if (task->size() == 0)
+    {
+        return false;
+    }
+
+    requestDriveStates(drives, createTask(controlModeTaskFactory, deviceMapper));
+    return task->dispatch();
 }
 
 // -----------------------------------------------------------------------------
@@ -54,7 +136,34 @@ bool CanBusControlboard::setControlModes(int * modes)
 bool CanBusControlboard::setControlModes(int n_joint, const int * joints, int * modes)
 {
     yTrace("%d", n_joint);
-    return deviceMapper.mapJointGroup(&yarp::dev::IControlModeRaw::setControlModesRaw, n_joint, joints, modes);
+
+    std::vector<drive_request> drives;
+    auto task = createTask(controlModeTaskFactory, deviceMapper);
+    auto devices = deviceMapper.getDevices(n_joint, joints);
+
+    for (const auto & t : devices)
+    {
+        auto * p = std::get<0>(t)->getHandle<yarp::dev::IControlModeRaw>();
+        auto * drive = std::get<0>(t)->castToType<ICiA402Drive>();
+        int affinity = std::get<0>(t)->getAffinity();
+        const auto & localIds = std::get<1>(t);
+        int * m = modes + std::get<2>(t);
+
+        if (!p)
+        {
+            return false;
+        }
+
+        task->addAffine(affinity, [p, &localIds, m] { return p->setControlModesRaw(localIds.size(), localIds.data(), m); });
+
+        if (drive)
+        {
+            drives.push_back({drive, *m, affinity});
+        }
+    }
+
+    requestDriveStates(drives, createTask(controlModeTaskFactory, deviceMapper));
+    return task->dispatch();
 }
 
 // -----------------------------------------------------------------------------
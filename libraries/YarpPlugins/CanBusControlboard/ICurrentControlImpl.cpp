@@ -12,7 +12,8 @@ bool CanBusControlboard::getCurrent(int m, double * curr)
 {
     yTrace("%d", m);
     CHECK_JOINT(m);
-    return deviceMapper.mapSingleJoint(&yarp::dev::ICurrentControlRaw::getCurrentRaw, m, curr);
+    return (jointState && jointState->read(JointStateSnapshot::field::CURRENT, m, curr))
+        || deviceMapper.mapSingleJoint(&yarp::dev::ICurrentControlRaw::getCurrentRaw, m, curr);
 }
 
 // -----------------------------------------------------------------------------
@@ -20,7 +21,8 @@ bool CanBusControlboard::getCurrent(int m, double * curr)
 bool CanBusControlboard::getCurrents(double * currs)
 {
     yTrace("");
-    return deviceMapper.mapAllJoints(&yarp::dev::ICurrentControlRaw::getCurrentsRaw, currs);
+    return (jointState && jointState->readAll(JointStateSnapshot::field::CURRENT, currs))
+        || deviceMapper.mapAllJoints(DeviceMapper::inlined, &yarp::dev::ICurrentControlRaw::getCurrentsRaw, currs);
 }
 
 // -----------------------------------------------------------------------------
@@ -54,7 +56,7 @@ bool CanBusControlboard::setRefCurrent(int m, double curr)
 bool CanBusControlboard::setRefCurrents(const double * currs)
 {
     yTrace("");
-    return deviceMapper.mapAllJoints(&yarp::dev::ICurrentControlRaw::setRefCurrentsRaw, currs);
+    return deviceMapper.mapAllJoints(DeviceMapper::inlined, &yarp::dev::ICurrentControlRaw::setRefCurrentsRaw, currs);
 }
 
 // -----------------------------------------------------------------------------
@@ -62,7 +64,7 @@ bool CanBusControlboard::setRefCurrents(const double * currs)
 bool CanBusControlboard::setRefCurrents(int n_motor, const int * motors, const double * currs)
 {
     yTrace("%d", n_motor);
-    return deviceMapper.mapJointGroup(&yarp::dev::ICurrentControlRaw::setRefCurrentsRaw, n_motor, motors, currs);
+    return deviceMapper.mapJointGroup(DeviceMapper::inlined, &yarp::dev::ICurrentControlRaw::setRefCurrentsRaw, n_motor, motors, currs);
 }
 
 // -----------------------------------------------------------------------------
@@ -79,7 +81,7 @@ bool CanBusControlboard::getRefCurrent(int m, double * curr)
 bool CanBusControlboard::getRefCurrents(double * currs)
 {
     yTrace("");
-    return deviceMapper.mapAllJoints(&yarp::dev::ICurrentControlRaw::getRefCurrentsRaw, currs);
+    return deviceMapper.mapAllJoints(DeviceMapper::inlined, &yarp::dev::ICurrentControlRaw::getRefCurrentsRaw, currs);
 }
 
 // -----------------------------------------------------------------------------
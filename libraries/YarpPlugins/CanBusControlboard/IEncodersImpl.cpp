@@ -55,7 +55,8 @@ bool CanBusControlboard::getEncoder(int j, double * v)
 {
     yTrace("%d", j);
     CHECK_JOINT(j);
-    return deviceMapper.mapSingleJoint(&yarp::dev::IEncodersRaw::getEncoderRaw, j, v);
+    return (jointState && jointState->read(JointStateSnapshot::field::POSITION, j, v))
+        || deviceMapper.mapSingleJoint(&yarp::dev::IEncodersRaw::getEncoderRaw, j, v);
 }
 
 // -----------------------------------------------------------------------------
@@ -63,7 +64,8 @@ bool CanBusControlboard::getEncoder(int j, double * v)
 bool CanBusControlboard::getEncoders(double * encs)
 {
     yTrace("");
-    return deviceMapper.mapAllJoints(&yarp::dev::IEncodersRaw::getEncodersRaw, encs);
+    return (jointState && jointState->readAll(JointStateSnapshot::field::POSITION, encs))
+        || deviceMapper.mapAllJoints(DeviceMapper::inlined, &yarp::dev::IEncodersRaw::getEncodersRaw, encs);
 }
 
 // -----------------------------------------------------------------------------
@@ -72,7 +74,8 @@ bool CanBusControlboard::getEncoderSpeed(int j, double * sp)
 {
     yTrace("%d", j);
     CHECK_JOINT(j);
-    return deviceMapper.mapSingleJoint(&yarp::dev::IEncodersRaw::getEncoderSpeedRaw, j, sp);
+    return (jointState && jointState->read(JointStateSnapshot::field::VELOCITY, j, sp))
+        || deviceMapper.mapSingleJoint(&yarp::dev::IEncodersRaw::getEncoderSpeedRaw, j, sp);
 }
 
 // -----------------------------------------------------------------------------
@@ -80,7 +83,8 @@ bool CanBusControlboard::getEncoderSpeed(int j, double * sp)
 bool CanBusControlboard::getEncoderSpeeds(double * spds)
 {
     yTrace("");
-    return deviceMapper.mapAllJoints(&yarp::dev::IEncodersRaw::getEncoderSpeedsRaw, spds);
+    return (jointState && jointState->readAll(JointStateSnapshot::field::VELOCITY, spds))
+        || deviceMapper.mapAllJoints(DeviceMapper::inlined, &yarp::dev::IEncodersRaw::getEncoderSpeedsRaw, spds);
 }
 
 // -----------------------------------------------------------------------------
@@ -89,7 +93,8 @@ bool CanBusControlboard::getEncoderAcceleration(int j, double * spds)
 {
     yTrace("%d", j);
     CHECK_JOINT(j);
-    return deviceMapper.mapSingleJoint(&yarp::dev::IEncodersRaw::getEncoderAccelerationRaw, j, spds);
+    return (jointState && jointState->read(JointStateSnapshot::field::ACCELERATION, j, spds))
+        || deviceMapper.mapSingleJoint(&yarp::dev::IEncodersRaw::getEncoderAccelerationRaw, j, spds);
 }
 
 // -----------------------------------------------------------------------------
@@ -97,7 +102,8 @@ bool CanBusControlboard::getEncoderAcceleration(int j, double * spds)
 bool CanBusControlboard::getEncoderAccelerations(double * accs)
 {
     yTrace("");
-    return deviceMapper.mapAllJoints(&yarp::dev::IEncodersRaw::getEncoderAccelerationsRaw, accs);
+    return (jointState && jointState->readAll(JointStateSnapshot::field::ACCELERATION, accs))
+        || deviceMapper.mapAllJoints(DeviceMapper::inlined, &yarp::dev::IEncodersRaw::getEncoderAccelerationsRaw, accs);
 }
 
 // -----------------------------------------------------------------------------
@@ -106,7 +112,8 @@ bool CanBusControlboard::getEncoderTimed(int j, double * enc, double * stamp)
 {
     yTrace("%d", j);
     CHECK_JOINT(j);
-    return deviceMapper.mapSingleJoint(&yarp::dev::IEncodersTimedRaw::getEncoderTimedRaw, j, enc, stamp);
+    return (jointState && jointState->read(JointStateSnapshot::field::POSITION, j, enc, stamp))
+        || deviceMapper.mapSingleJoint(&yarp::dev::IEncodersTimedRaw::getEncoderTimedRaw, j, enc, stamp);
 }
 
 // -----------------------------------------------------------------------------
@@ -114,7 +121,8 @@ bool CanBusControlboard::getEncoderTimed(int j, double * enc, double * stamp)
 bool CanBusControlboard::getEncodersTimed(double * encs, double * stamps)
 {
     yTrace("");
-    return deviceMapper.mapAllJoints(&yarp::dev::IEncodersTimedRaw::getEncodersTimedRaw, encs, stamps);
+    return (jointState && jointState->readAll(JointStateSnapshot::field::POSITION, encs, stamps))
+        || deviceMapper.mapAllJoints(DeviceMapper::inlined, &yarp::dev::IEncodersTimedRaw::getEncodersTimedRaw, encs, stamps);
 }
 
 // -----------------------------------------------------------------------------
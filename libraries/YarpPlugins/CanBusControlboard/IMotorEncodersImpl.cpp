@@ -72,7 +72,8 @@ bool CanBusControlboard::getMotorEncoder(int m, double * v)
 {
     yTrace("%d", m);
     CHECK_JOINT(m);
-    return deviceMapper.mapSingleJoint(&yarp::dev::IMotorEncodersRaw::getMotorEncoderRaw, m, v);
+    return (jointState && jointState->read(JointStateSnapshot::field::MOTOR_POSITION, m, v))
+        || deviceMapper.mapSingleJoint(&yarp::dev::IMotorEncodersRaw::getMotorEncoderRaw, m, v);
 }
 
 // -----------------------------------------------------------------------------
@@ -80,7 +81,8 @@ bool CanBusControlboard::getMotorEncoder(int m, double * v)
 bool CanBusControlboard::getMotorEncoders(double * encs)
 {
     yTrace("");
-    return deviceMapper.mapAllJoints(&yarp::dev::IMotorEncodersRaw::getMotorEncodersRaw, encs);
+    return (jointState && jointState->readAll(JointStateSnapshot::field::MOTOR_POSITION, encs))
+        || deviceMapper.mapAllJoints(DeviceMapper::inlined, &yarp::dev::IMotorEncodersRaw::getMotorEncodersRaw, encs);
 }
 
 // -----------------------------------------------------------------------------
@@ -89,7 +91,8 @@ bool CanBusControlboard::getMotorEncoderTimed(int m, double * enc, double * stam
 {
     yTrace("%d", m);
     CHECK_JOINT(m);
-    return deviceMapper.mapSingleJoint(&yarp::dev::IMotorEncodersRaw::getMotorEncoderTimedRaw, m, enc, stamp);
+    return (jointState && jointState->read(JointStateSnapshot::field::MOTOR_POSITION, m, enc, stamp))
+        || deviceMapper.mapSingleJoint(&yarp::dev::IMotorEncodersRaw::getMotorEncoderTimedRaw, m, enc, stamp);
 }
 
 // -----------------------------------------------------------------------------
@@ -97,7 +100,8 @@ bool CanBusControlboard::getMotorEncoderTimed(int m, double * enc, double * stam
 bool CanBusControlboard::getMotorEncodersTimed(double * encs, double * stamps)
 {
     yTrace("");
-    return deviceMapper.mapAllJoints(&yarp::dev::IMotorEncodersRaw::getMotorEncodersTimedRaw, encs, stamps);
+    return (jointState && jointState->readAll(JointStateSnapshot::field::MOTOR_POSITION, encs, stamps))
+        || deviceMapper.mapAllJoints(DeviceMapper::inlined, &yarp::dev::IMotorEncodersRaw::getMotorEncodersTimedRaw, encs, stamps);
 }
 
 // -----------------------------------------------------------------------------
@@ -106,7 +110,8 @@ bool CanBusControlboard::getMotorEncoderSpeed(int m, double * sp)
 {
     yTrace("%d", m);
     CHECK_JOINT(m);
-    return deviceMapper.mapSingleJoint(&yarp::dev::IMotorEncodersRaw::getMotorEncoderSpeedRaw, m, sp);
+    return (jointState && jointState->read(JointStateSnapshot::field::MOTOR_VELOCITY, m, sp))
+        || deviceMapper.mapSingleJoint(&yarp::dev::IMotorEncodersRaw::getMotorEncoderSpeedRaw, m, sp);
 }
 
 // -----------------------------------------------------------------------------
@@ -114,7 +119,8 @@ bool CanBusControlboard::getMotorEncoderSpeed(int m, double * sp)
 bool CanBusControlboard::getMotorEncoderSpeeds(double *spds)
 {
     yTrace("");
-    return deviceMapper.mapAllJoints(&yarp::dev::IMotorEncodersRaw::getMotorEncoderSpeedsRaw, spds);
+    return (jointState && jointState->readAll(JointStateSnapshot::field::MOTOR_VELOCITY, spds))
+        || deviceMapper.mapAllJoints(DeviceMapper::inlined, &yarp::dev::IMotorEncodersRaw::getMotorEncoderSpeedsRaw, spds);
 }
 
 // -----------------------------------------------------------------------------
@@ -123,7 +129,8 @@ bool CanBusControlboard::getMotorEncoderAcceleration(int m, double * acc)
 {
     yTrace("%d", m);
     CHECK_JOINT(m);
-    return deviceMapper.mapSingleJoint(&yarp::dev::IMotorEncodersRaw::getMotorEncoderAccelerationRaw, m, acc);
+    return (jointState && jointState->read(JointStateSnapshot::field::MOTOR_ACCELERATION, m, acc))
+        || deviceMapper.mapSingleJoint(&yarp::dev::IMotorEncodersRaw::getMotorEncoderAccelerationRaw, m, acc);
 }
 
 // -----------------------------------------------------------------------------
@@ -131,7 +138,8 @@ bool CanBusControlboard::getMotorEncoderAcceleration(int m, double * acc)
 bool CanBusControlboard::getMotorEncoderAccelerations(double * accs)
 {
     yTrace("");
-    return deviceMapper.mapAllJoints(&yarp::dev::IMotorEncodersRaw::getMotorEncoderAccelerationsRaw, accs);
+    return (jointState && jointState->readAll(JointStateSnapshot::field::MOTOR_ACCELERATION, accs))
+        || deviceMapper.mapAllJoints(DeviceMapper::inlined, &yarp::dev::IMotorEncodersRaw::getMotorEncoderAccelerationsRaw, accs);
 }
 
 // -----------------------------------------------------------------------------
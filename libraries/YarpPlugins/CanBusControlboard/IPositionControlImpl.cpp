@@ -77,7 +77,7 @@ bool CanBusControlboard::checkMotionDone(bool * flag)
 
     auto flags = std::make_unique<bool[]>(deviceMapper.getControlledAxes());
 
-    if (!deviceMapper.mapAllJoints(&yarp::dev::IPositionControlRaw::checkMotionDoneRaw, flags.get()))
+    if (!deviceMapper.mapAllJoints(DeviceMapper::inlined, &yarp::dev::IPositionControlRaw::checkMotionDoneRaw, flags.get()))
     {
         return false;
     }
@@ -94,7 +94,7 @@ bool CanBusControlboard::checkMotionDone(int n_joint, const int * joints, bool *
 
     auto flags = std::make_unique<bool[]>(n_joint);
 
-    if (!deviceMapper.mapJointGroup(&yarp::dev::IPositionControlRaw::checkMotionDoneRaw, n_joint, joints, flags.get()))
+    if (!deviceMapper.mapJointGroup(DeviceMapper::inlined, &yarp::dev::IPositionControlRaw::checkMotionDoneRaw, n_joint, joints, flags.get()))
     {
         return false;
     }
@@ -20,7 +20,7 @@ bool CanBusControlboard::setPosition(int j, double ref)
 bool CanBusControlboard::setPositions(const double * refs)
 {
     yTrace("");
-    return deviceMapper.mapAllJoints(&yarp::dev::IPositionDirectRaw::setPositionsRaw, refs);
+    return deviceMapper.mapAllJoints(DeviceMapper::inlined, &yarp::dev::IPositionDirectRaw::setPositionsRaw, refs);
 }
 
 // -----------------------------------------------------------------------------
@@ -28,7 +28,7 @@ bool CanBusControlboard::setPositions(const double * refs)
 bool CanBusControlboard::setPositions(int n_joint, const int * joints, const double * refs)
 {
     yTrace("%d", n_joint);
-    return deviceMapper.mapJointGroup(&yarp::dev::IPositionDirectRaw::setPositionsRaw, n_joint, joints, refs);
+    return deviceMapper.mapJointGroup(DeviceMapper::inlined, &yarp::dev::IPositionDirectRaw::setPositionsRaw, n_joint, joints, refs);
 }
 
 // -----------------------------------------------------------------------------
@@ -45,7 +45,7 @@ bool CanBusControlboard::getRefPosition(int joint, double * ref)
 bool CanBusControlboard::getRefPositions(double * refs)
 {
     yTrace("");
-    return deviceMapper.mapAllJoints(&yarp::dev::IPositionDirectRaw::getRefPositionsRaw, refs);
+    return deviceMapper.mapAllJoints(DeviceMapper::inlined, &yarp::dev::IPositionDirectRaw::getRefPositionsRaw, refs);
 }
 
 // -----------------------------------------------------------------------------
@@ -53,7 +53,7 @@ bool CanBusControlboard::getRefPositions(double * refs)
 bool CanBusControlboard::getRefPositions(int n_joint, const int * joints, double * refs)
 {
     yTrace("%d", n_joint);
-    return deviceMapper.mapJointGroup(&yarp::dev::IPositionDirectRaw::getRefPositionsRaw, n_joint, joints, refs);
+    return deviceMapper.mapJointGroup(DeviceMapper::inlined, &yarp::dev::IPositionDirectRaw::getRefPositionsRaw, n_joint, joints, refs);
 }
 
 // -----------------------------------------------------------------------------
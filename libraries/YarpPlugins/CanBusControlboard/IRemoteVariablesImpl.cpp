@@ -66,6 +66,41 @@ namespace
 
         return allOk;
     }
+
+    std::string nmtStateToString(NmtState state)
+    {
+        switch (state)
+        {
+        case NmtState::BOOTUP:
+            return "bootup";
+        case NmtState::STOPPED:
+            return "stopped";
+        case NmtState::OPERATIONAL:
+            return "operational";
+        case NmtState::PRE_OPERATIONAL:
+            return "preoperational";
+        default:
+            return "unknown";
+        }
+    }
+
+    void getHeartbeatStates(const std::vector<CanBusBroker *> & brokers, yarp::os::Bottle & val)
+    {
+        for (const auto * broker : brokers)
+        {
+            yarp::os::Bottle & busVal = val.addList();
+            busVal.addString(broker->getName());
+
+            for (const auto & node : broker->getHeartbeatSupervisor()->getNodeStates())
+            {
+                yarp::os::Bottle & nodeVal = busVal.addList();
+                nodeVal.addString("id" + std::to_string(node.id));
+                nodeVal.addString(nmtStateToString(node.state));
+                nodeVal.addFloat64(node.lastSeen);
+                nodeVal.addString(node.alive ? "alive" : "lost");
+            }
+        }
+    }
 }
 
 // -----------------------------------------------------------------------------
@@ -74,9 +109,35 @@ bool CanBusControlboard::getRemoteVariable(std::string key, yarp::os::Bottle & v
 {
     yTrace("%s", key.c_str());
 
-    bool queryAll = key == "all";
     val.clear();
 
+    if (key == "heartbeat")
+    {
+        getHeartbeatStates(canBusBrokers, val);
+        return true;
+    }
+
+    if (key == "emcy" || key == "sdo")
+    {
+        for (const auto & t : deviceMapper.getDevicesWithOffsets())
+        {
+            auto * iCanBusSharer = std::get<0>(t)->castToType<ICanBusSharer>();
+            auto * p = std::get<0>(t)->getHandle<yarp::dev::IRemoteVariablesRaw>();
+            yarp::os::Bottle b;
+
+            if (p && p->getRemoteVariableRaw(key, b))
+            {
+                yarp::os::Bottle & nodeVal = val.addList();
+                nodeVal.addString("id" + std::to_string(iCanBusSharer->getId()));
+                nodeVal.append(*b.get(1).asList());
+            }
+        }
+
+        return true;
+    }
+
+    bool queryAll = key == "all";
+
     for (const auto & t : deviceMapper.getDevicesWithOffsets())
     {
         auto * iCanBusSharer = std::get<0>(t)->castToType<ICanBusSharer>();
@@ -204,6 +265,10 @@ bool CanBusControlboard::getRemoteVariablesList(yarp::os::Bottle * listOfKeys)
         listOfKeys->addString("id" + std::to_string(iCanBusSharer->getId()));
     }
 
+    listOfKeys->addString("heartbeat");
+    listOfKeys->addString("emcy");
+    listOfKeys->addString("sdo");
+
     return true;
 }
 
@@ -18,7 +18,7 @@ bool CanBusControlboard::getRefTorque(int j, double * t)
 bool CanBusControlboard::getRefTorques(double * t)
 {
     yTrace("");
-    return deviceMapper.mapAllJoints(&yarp::dev::ITorqueControlRaw::getRefTorquesRaw, t);
+    return deviceMapper.mapAllJoints(DeviceMapper::inlined, &yarp::dev::ITorqueControlRaw::getRefTorquesRaw, t);
 }
 
 // -----------------------------------------------------------------------------
@@ -35,7 +35,7 @@ bool CanBusControlboard::setRefTorque(int j, double t)
 bool CanBusControlboard::setRefTorques(const double * t)
 {
     yTrace("");
-    return deviceMapper.mapAllJoints(&yarp::dev::ITorqueControlRaw::setRefTorquesRaw, t);
+    return deviceMapper.mapAllJoints(DeviceMapper::inlined, &yarp::dev::ITorqueControlRaw::setRefTorquesRaw, t);
 }
 
 // -----------------------------------------------------------------------------
@@ -43,7 +43,7 @@ bool CanBusControlboard::setRefTorques(const double * t)
 bool CanBusControlboard::setRefTorques(int n_joint, const int * joints, const double * t)
 {
     yTrace("");
-    return deviceMapper.mapJointGroup(&yarp::dev::ITorqueControlRaw::setRefTorquesRaw, n_joint, joints, t);
+    return deviceMapper.mapJointGroup(DeviceMapper::inlined, &yarp::dev::ITorqueControlRaw::setRefTorquesRaw, n_joint, joints, t);
 }
 
 // -----------------------------------------------------------------------------
@@ -78,7 +78,7 @@ bool CanBusControlboard::getTorque(int j, double * t)
 bool CanBusControlboard::getTorques(double * t)
 {
     yTrace("");
-    return deviceMapper.mapAllJoints(&yarp::dev::ITorqueControlRaw::getTorquesRaw, t);
+    return deviceMapper.mapAllJoints(DeviceMapper::inlined, &yarp::dev::ITorqueControlRaw::getTorquesRaw, t);
 }
 
 // -----------------------------------------------------------------------------
@@ -21,7 +21,7 @@ bool CanBusControlboard::velocityMove(int j, double spd)
 bool CanBusControlboard::velocityMove(const double * spds)
 {
     yTrace("");
-    return deviceMapper.mapAllJoints(&yarp::dev::IVelocityControlRaw::velocityMoveRaw, spds);
+    return deviceMapper.mapAllJoints(DeviceMapper::inlined, &yarp::dev::IVelocityControlRaw::velocityMoveRaw, spds);
 }
 
 // -----------------------------------------------------------------------------
@@ -29,7 +29,7 @@ bool CanBusControlboard::velocityMove(const double * spds)
 bool CanBusControlboard::velocityMove(int n_joint, const int * joints, const double * spds)
 {
     yTrace("%d", n_joint);
-    return deviceMapper.mapJointGroup(&yarp::dev::IVelocityControlRaw::velocityMoveRaw, n_joint, joints, spds);
+    return deviceMapper.mapJointGroup(DeviceMapper::inlined, &yarp::dev::IVelocityControlRaw::velocityMoveRaw, n_joint, joints, spds);
 }
 
 // -----------------------------------------------------------------------------
@@ -46,7 +46,7 @@ bool CanBusControlboard::getRefVelocity(int joint, double * vel)
 bool CanBusControlboard::getRefVelocities(double * vels)
 {
     yTrace("");
-    return deviceMapper.mapAllJoints(&yarp::dev::IVelocityControlRaw::getRefVelocitiesRaw, vels);
+    return deviceMapper.mapAllJoints(DeviceMapper::inlined, &yarp::dev::IVelocityControlRaw::getRefVelocitiesRaw, vels);
 }
 
 // -----------------------------------------------------------------------------
@@ -54,7 +54,7 @@ bool CanBusControlboard::getRefVelocities(double * vels)
 bool CanBusControlboard::getRefVelocities(int n_joint, const int * joints, double * vels)
 {
     yTrace("%d", n_joint);
-    return deviceMapper.mapJointGroup(&yarp::dev::IVelocityControlRaw::getRefVelocitiesRaw, n_joint, joints, vels);
+    return deviceMapper.mapJointGroup(DeviceMapper::inlined, &yarp::dev::IVelocityControlRaw::getRefVelocitiesRaw, n_joint, joints, vels);
 }
 
 // -----------------------------------------------------------------------------
@@ -0,0 +1,308 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#include "JointStateSnapshot.hpp"
+
+#include <cstddef>
+
+using namespace roboticslab;
+
+// -----------------------------------------------------------------------------
+
+constexpr int JointStateSnapshot::FIELDS;
+constexpr int JointStateSnapshot::TIMESTAMP;
+constexpr int JointStateSnapshot::BUFFERS;
+
+// -----------------------------------------------------------------------------
+
+namespace
+{
+    constexpr std::size_t CACHE_LINE = 64;
+
+    template<typename T>
+    T * alignToCacheLine(T * p)
+    {
+        auto misalignment = reinterpret_cast<std::uintptr_t>(p) % CACHE_LINE;
+        return misalignment == 0 ? p : p + (CACHE_LINE - misalignment) / sizeof(T);
+    }
+
+    int roundUpToCacheLine(int n)
+    {
+        const int perLine = CACHE_LINE / sizeof(double);
+        return (n + perLine - 1) / perLine * perLine;
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+class JointStateSnapshot::Slot : public JointStateSink
+{
+public:
+    Slot(JointStateSnapshot & owner)
+        : owner(owner), reported(false), lastCycle(0), state()
+    { }
+
+    virtual void store(std::uint64_t cycle, const joint_state & state) override
+    {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            this->state = state;
+        }
+
+        // late reports are stored, but only count towards their own cycle
+        if (cycle == owner.current.load() && lastCycle.exchange(cycle) != cycle && --owner.pending == 0)
+        {
+            owner.publish(cycle);
+        }
+    }
+
+    joint_state get() const
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        return state;
+    }
+
+    JointStateSnapshot & owner;
+    bool reported;
+
+private:
+    std::atomic<std::uint64_t> lastCycle;
+    joint_state state;
+    mutable std::mutex mtx;
+};
+
+// -----------------------------------------------------------------------------
+
+JointStateSnapshot::JointStateSnapshot(int _axes)
+    : axes(_axes),
+      stride(roundUpToCacheLine(_axes)),
+      valueStorage(BUFFERS * FIELDS * stride + CACHE_LINE / sizeof(double)),
+      modeStorage(BUFFERS * stride + CACHE_LINE / sizeof(std::int32_t)),
+      staged(_axes, joint_state()),
+      listener(nullptr),
+      reporting(0),
+      pending(0),
+      current(0),
+      published(0),
+      front(0)
+{
+    for (auto & value : valueStorage)
+    {
+        value = 0.0;
+    }
+
+    for (auto & mode : modeStorage)
+    {
+        mode = 0; // not a valid vocab, marks joints that never reported
+    }
+
+    auto * values = alignToCacheLine(valueStorage.data());
+    auto * modes = alignToCacheLine(modeStorage.data());
+
+    for (int i = 0; i < BUFFERS; i++)
+    {
+        buffers[i].values = values + i * FIELDS * stride;
+        buffers[i].modes = modes + i * stride;
+    }
+
+    for (int i = 0; i < axes; i++)
+    {
+        slots.emplace_back(new Slot(*this));
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+JointStateSnapshot::~JointStateSnapshot() = default;
+
+// -----------------------------------------------------------------------------
+
+JointStateSink * JointStateSnapshot::getSink(int joint)
+{
+    if (joint < 0 || joint >= axes)
+    {
+        return nullptr;
+    }
+
+    if (!slots[joint]->reported)
+    {
+        slots[joint]->reported = true;
+        reporting++;
+    }
+
+    return slots[joint].get();
+}
+
+// -----------------------------------------------------------------------------
+
+void JointStateSnapshot::beginCycle(std::uint64_t cycle)
+{
+    if (reporting == 0)
+    {
+        return;
+    }
+
+    std::uint64_t previous = current.load();
+
+    if (previous != 0)
+    {
+        publish(previous); // no-op if already complete
+    }
+
+    pending = reporting;
+    current = cycle;
+}
+
+// -----------------------------------------------------------------------------
+
+void JointStateSnapshot::publish(std::uint64_t cycle)
+{
+    std::lock_guard<std::mutex> lock(publishMutex);
+
+    if (published >= cycle)
+    {
+        return;
+    }
+
+    int next = (front.load() + 1) % BUFFERS;
+    buffer & b = buffers[next];
+
+    std::uint64_t sequence = b.sequence.load(std::memory_order_relaxed);
+    b.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    for (int j = 0; j < axes; j++)
+    {
+        if (!slots[j]->reported)
+        {
+            continue;
+        }
+
+        const joint_state state = slots[j]->get();
+        const double fields[FIELDS] = {state.position, state.velocity, state.acceleration, state.motorPosition,
+                                       state.motorVelocity, state.motorAcceleration, state.current, state.timestamp};
+
+        for (int f = 0; f < FIELDS; f++)
+        {
+            b.values[f * stride + j].store(fields[f], std::memory_order_relaxed);
+        }
+
+        b.modes[j].store(state.mode, std::memory_order_relaxed);
+
+        if (listener)
+        {
+            staged[j] = state;
+        }
+    }
+
+    b.cycle.store(cycle, std::memory_order_relaxed);
+    b.sequence.store(sequence + 2, std::memory_order_release);
+
+    front.store(next, std::memory_order_release);
+    published = cycle;
+
+    if (listener)
+    {
+        listener->onPublish(cycle, staged);
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+template<typename Fn>
+void JointStateSnapshot::readBuffer(Fn && fn) const
+{
+    while (true)
+    {
+        const buffer & b = buffers[front.load(std::memory_order_acquire)];
+        std::uint64_t sequence = b.sequence.load(std::memory_order_acquire);
+
+        if (sequence % 2 != 0)
+        {
+            continue; // the writer has lapped us, pick the new front buffer
+        }
+
+        fn(b);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if (b.sequence.load(std::memory_order_relaxed) == sequence)
+        {
+            return;
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+bool JointStateSnapshot::read(field f, int joint, double * value, double * stamp) const
+{
+    if (joint < 0 || joint >= axes || !slots[joint]->reported || published == 0)
+    {
+        return false;
+    }
+
+    const int offset = static_cast<int>(f) * stride + joint;
+    bool valid;
+
+    readBuffer([=, &valid](const buffer & b)
+        {
+            valid = b.modes[joint].load(std::memory_order_relaxed) != 0;
+            *value = b.values[offset].load(std::memory_order_relaxed);
+
+            if (stamp)
+            {
+                *stamp = b.values[TIMESTAMP * stride + joint].load(std::memory_order_relaxed);
+            }
+        });
+
+    return valid;
+}
+
+// -----------------------------------------------------------------------------
+
+bool JointStateSnapshot::readAll(field f, double * values, double * stamps) const
+{
+    if (reporting != axes || published == 0)
+    {
+        return false;
+    }
+
+    const int offset = static_cast<int>(f) * stride;
+    bool valid;
+
+    readBuffer([=, &valid](const buffer & b)
+        {
+            valid = true;
+
+            for (int j = 0; j < axes; j++)
+            {
+                valid &= b.modes[j].load(std::memory_order_relaxed) != 0;
+                values[j] = b.values[offset + j].load(std::memory_order_relaxed);
+            }
+
+            if (stamps)
+            {
+                for (int j = 0; j < axes; j++)
+                {
+                    stamps[j] = b.values[TIMESTAMP * stride + j].load(std::memory_order_relaxed);
+                }
+            }
+        });
+
+    return valid;
+}
+
+// -----------------------------------------------------------------------------
+
+bool JointStateSnapshot::readMode(int joint, int * mode) const
+{
+    if (joint < 0 || joint >= axes || !slots[joint]->reported || published == 0)
+    {
+        return false;
+    }
+
+    readBuffer([=](const buffer & b) { *mode = b.modes[joint].load(std::memory_order_relaxed); });
+    return *mode != 0;
+}
+
+// -----------------------------------------------------------------------------
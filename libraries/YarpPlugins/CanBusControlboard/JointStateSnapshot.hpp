@@ -0,0 +1,129 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __JOINT_STATE_SNAPSHOT_HPP__
+#define __JOINT_STATE_SNAPSHOT_HPP__
+
+#include <cstdint>
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "JointStateSink.hpp"
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup CanBusControlboard
+ * @brief Consistent per-SYNC-cycle state of all joints.
+ *
+ * Nodes report the state of their joints through a @ref JointStateSink, once
+ * per SYNC cycle. A cycle is published as soon as every reporting joint has
+ * stored its state, or else on the next SYNC (deadline) with the last known
+ * state of the missing ones. Joints that have never reported are not valid,
+ * callers should query the node instead. Published cycles are kept in a triple
+ * buffer laid out as a struct of arrays, one cache line-aligned array per field.
+ * Readers never lock, they retry in the unlikely event of a buffer being
+ * overwritten while being read (sequence lock). A @ref Listener may be attached
+ * to forward each published cycle elsewhere.
+ */
+class JointStateSnapshot final
+{
+public:
+    //! Published fields of each joint, cf. @ref joint_state.
+    enum class field
+    {
+        POSITION,
+        VELOCITY,
+        ACCELERATION,
+        MOTOR_POSITION,
+        MOTOR_VELOCITY,
+        MOTOR_ACCELERATION,
+        CURRENT
+    };
+
+    //! Receives each published cycle.
+    class Listener
+    {
+    public:
+        //! Virtual destructor.
+        virtual ~Listener() = default;
+
+        //! Invoked from the publishing thread, joints that have never reported are zeroed.
+        virtual void onPublish(std::uint64_t cycle, const std::vector<joint_state> & states) = 0;
+    };
+
+    //! Constructor.
+    JointStateSnapshot(int axes);
+
+    //! Destructor.
+    ~JointStateSnapshot();
+
+    //! Retrieve the sink of the given joint, which is then expected to report on each cycle.
+    JointStateSink * getSink(int joint);
+
+    //! Set listener, to be called before the first cycle begins.
+    void setListener(Listener * listener)
+    { this->listener = listener; }
+
+    //! Start a new SYNC cycle, publish the previous one if still incomplete.
+    void beginCycle(std::uint64_t cycle);
+
+    //! Retrieve number of the last published cycle, zero if none.
+    std::uint64_t getCycle() const
+    { return published; }
+
+    //! Read a field of one joint, false if not reported or nothing was published yet.
+    bool read(field f, int joint, double * value, double * stamp = nullptr) const;
+
+    //! Read a field of all joints, false unless all of them are reported.
+    bool readAll(field f, double * values, double * stamps = nullptr) const;
+
+    //! Read control mode of one joint, false if not reported or nothing was published yet.
+    bool readMode(int joint, int * mode) const;
+
+private:
+    static constexpr int FIELDS = 8;
+    static constexpr int TIMESTAMP = FIELDS - 1; // array that follows those of the published fields
+    static constexpr int BUFFERS = 3;
+
+    class Slot;
+
+    struct buffer
+    {
+        std::atomic<std::uint64_t> sequence {0}; // odd while being written
+        std::atomic<std::uint64_t> cycle {0};
+        std::atomic<double> * values; // FIELDS arrays of stride elements each
+        std::atomic<std::int32_t> * modes;
+    };
+
+    void publish(std::uint64_t cycle);
+
+    template<typename Fn>
+    void readBuffer(Fn && fn) const;
+
+    const int axes;
+    const int stride; // elements per array, rounded up to a whole number of cache lines
+
+    std::vector<std::unique_ptr<Slot>> slots; // staging area, one per joint
+    std::vector<std::atomic<double>> valueStorage;
+    std::vector<std::atomic<std::int32_t>> modeStorage;
+    std::array<buffer, BUFFERS> buffers;
+    std::vector<joint_state> staged; // handed over to the listener
+
+    Listener * listener;
+
+    int reporting;
+    std::atomic<int> pending;
+    std::atomic<std::uint64_t> current;
+    std::atomic<std::uint64_t> published;
+    std::atomic<int> front;
+    std::mutex publishMutex;
+};
+
+} // namespace roboticslab
+
+#endif // __JOINT_STATE_SNAPSHOT_HPP__
@@ -0,0 +1,70 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#include "NodeWorker.hpp"
+
+#include <utility>
+
+using namespace roboticslab;
+
+// -----------------------------------------------------------------------------
+
+NodeWorker::NodeWorker()
+    : stopped(false),
+      thread(&NodeWorker::run, this)
+{ }
+
+// -----------------------------------------------------------------------------
+
+NodeWorker::~NodeWorker()
+{
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopped = true;
+    }
+
+    cv.notify_one();
+    thread.join();
+}
+
+// -----------------------------------------------------------------------------
+
+std::future<void> NodeWorker::post(std::function<void()> && fn)
+{
+    std::packaged_task<void()> job(std::move(fn));
+    auto f = job.get_future();
+
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        jobs.push_back(std::move(job));
+    }
+
+    cv.notify_one();
+    return f;
+}
+
+// -----------------------------------------------------------------------------
+
+void NodeWorker::run()
+{
+    while (true)
+    {
+        std::packaged_task<void()> job;
+
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            cv.wait(lock, [this] { return stopped || !jobs.empty(); });
+
+            if (jobs.empty())
+            {
+                return;
+            }
+
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+
+        job();
+    }
+}
+
+// -----------------------------------------------------------------------------
@@ -0,0 +1,55 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __NODE_WORKER_HPP__
+#define __NODE_WORKER_HPP__
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup CanBusControlboard
+ * @brief Serializes blocking jobs that target a single CAN node on a long-lived thread.
+ *
+ * Jobs run in the order they were posted. Distinct nodes are meant to be served
+ * by distinct workers, so that slow transfers to one node never hold back the
+ * others.
+ */
+class NodeWorker final
+{
+public:
+    //! Constructor, spawns the thread.
+    NodeWorker();
+
+    //! Destructor, runs pending jobs and joins the thread.
+    ~NodeWorker();
+
+    NodeWorker(const NodeWorker &) = delete;
+    NodeWorker & operator=(const NodeWorker &) = delete;
+
+    //! Queue a job.
+    std::future<void> post(std::function<void()> && fn);
+
+    //! Block until all jobs posted so far are done.
+    void wait()
+    { post([]{}).wait(); }
+
+private:
+    void run();
+
+    std::deque<std::packaged_task<void()>> jobs;
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool stopped;
+    std::thread thread;
+};
+
+} // namespace roboticslab
+
+#endif // __NODE_WORKER_HPP__
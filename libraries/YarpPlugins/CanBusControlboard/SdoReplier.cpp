@@ -2,10 +2,16 @@
 
 #include "SdoReplier.hpp"
 
+#include <array>
+#include <functional>
+#include <future>
 #include <iomanip>
 #include <ios>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <sstream>
+#include <vector>
 
 #include <yarp/os/Bottle.h>
 #include <yarp/os/ConnectionReader.h>
@@ -13,6 +19,7 @@
 #include <yarp/os/Log.h>
 #include <yarp/os/Vocab.h>
 
+#include "NodeWorker.hpp"
 #include "SdoClient.hpp"
 
 using namespace roboticslab;
@@ -54,14 +61,11 @@ namespace
     {
     public:
         ConnectionGuard(yarp::os::Bottle * _response, yarp::os::ConnectionWriter * _writer)
-            : response(_response), writer(_writer), sdo(nullptr), success(false)
+            : response(_response), writer(_writer), success(false)
         { }
 
         ~ConnectionGuard()
         {
-            delete *sdo;
-            *sdo = nullptr;
-
             if (response && writer)
             {
                 response->addVocab(success ? VOCAB_SDO_OK : VOCAB_SDO_FAIL);
@@ -69,9 +73,6 @@ namespace
             }
         }
 
-        void attachSdoHandle(SdoClient ** sdo)
-        { this->sdo = sdo; }
-
         bool inhibit()
         { response = nullptr; writer = nullptr; return true; }
 
@@ -81,233 +82,384 @@ namespace
     private:
         yarp::os::Bottle * response;
         yarp::os::ConnectionWriter * writer;
-        SdoClient ** sdo;
         bool success;
     };
-}
 
-// -----------------------------------------------------------------------------
-
-class SdoReplier::Private
-{
-public:
-    SdoClient ** allocate(unsigned int id, CanSenderDelegate * sender)
+    struct sdo_request
     {
-        sdoClient = new SdoClient(id, SDO_COB_RX, SDO_COB_TX, SDO_TIMEOUT, sender);
-        return &sdoClient;
-    }
-
-    SdoClient * sdo()
-    { return sdoClient; }
-
-private:
-    SdoClient * sdoClient = nullptr;
-
-    static constexpr unsigned int SDO_COB_RX = 0x600;
-    static constexpr unsigned int SDO_COB_TX = 0x580;
-    static constexpr double SDO_TIMEOUT = 0.25; // seconds
-};
-
-// -----------------------------------------------------------------------------
-
-SdoReplier::SdoReplier()
-    : priv(new Private),
-      sender(nullptr)
-{ }
-
-// -----------------------------------------------------------------------------
+        sdo_direction dir;
+        unsigned int id;
+        unsigned int index;
+        unsigned int subindex;
+        data_type type;
+        yarp::os::Value data;
+    };
 
-SdoReplier::~SdoReplier()
-{
-    delete priv;
-}
+    bool parseRequest(const yarp::os::Bottle & b, sdo_request & req)
+    {
+        if (b.size() < 5)
+        {
+            yWarning("SDO requests require at least 5 elements, got %zu", b.size());
+            return false;
+        }
 
-// -----------------------------------------------------------------------------
+        req.dir = static_cast<sdo_direction>(b.get(0).asVocab());
+        req.id = b.get(1).asInt8();
+        req.index = b.get(2).asInt16();
+        req.subindex = b.get(3).asInt8();
+        req.type = static_cast<data_type>(b.get(4).asVocab());
 
-bool SdoReplier::read(yarp::os::ConnectionReader & reader)
-{
-    yarp::os::ConnectionWriter * writer = reader.getWriter();
-
-    yarp::os::Bottle request;
-    yarp::os::Bottle response;
+        if (req.id == 0 || req.id > 127)
+        {
+            yWarning("Invalid node id %u", req.id);
+            return false;
+        }
 
-    if (!writer || !request.read(reader))
-    {
-        return false;
-    }
+        if (req.dir == sdo_direction::DOWNLOAD)
+        {
+            if (b.size() != 6)
+            {
+                yWarning("Download SDO requires exactly 6 elements, got %zu", b.size());
+                return false;
+            }
 
-    ConnectionGuard guard(&response, writer);
+            req.data = b.get(5);
+        }
+        else if (req.dir != sdo_direction::UPLOAD)
+        {
+            yWarning("Invalid SDO direction %s", yarp::os::Vocab::decode(static_cast<yarp::conf::vocab32_t>(req.dir)).c_str());
+            return false;
+        }
 
-    if (request.size() < 5)
-    {
-        yWarning("SDO requests require at least 5 elements, got %zu", request.size());
-        return false;
+        return true;
     }
 
-    sdo_direction dir = static_cast<sdo_direction>(request.get(0).asVocab());
-    unsigned int id = request.get(1).asInt8();
-    unsigned int index = request.get(2).asInt16();
-    unsigned int subindex = request.get(3).asInt8();
-    data_type type = static_cast<data_type>(request.get(4).asVocab());
-
-    guard.attachSdoHandle(priv->allocate(id, sender));
-
-    if (dir == sdo_direction::UPLOAD)
+    bool uploadRequest(SdoClient * sdo, const sdo_request & req, yarp::os::Bottle & response)
     {
         std::stringstream ss;
         ss << std::setfill('0') << std::internal << std::hex << std::showbase;
-        bool ok = false;
 
-        switch (type)
+        switch (req.type)
         {
         case data_type::INTEGER_8:
         {
             std::int8_t int8data;
 
-            if (priv->sdo()->upload("Remote request", &int8data, index, subindex))
+            if (!sdo->upload("Remote request", &int8data, req.index, req.subindex))
             {
-                ss << std::setw(4) << (static_cast<long>(int8data) & 0xFF);
-                response.addInt8(int8data);
-                ok = true;
+                return false;
             }
 
+            ss << std::setw(4) << (static_cast<long>(int8data) & 0xFF);
+            response.addInt8(int8data);
             break;
         }
         case data_type::UNSIGNED_INTEGER_8:
         {
             std::uint8_t uint8data;
 
-            if (priv->sdo()->upload("Remote request", &uint8data, index, subindex))
+            if (!sdo->upload("Remote request", &uint8data, req.index, req.subindex))
             {
-                ss << std::setw(4) << (static_cast<unsigned long>(uint8data) & 0xFF);
-                response.addInt16(uint8data);
-                ok = true;
+                return false;
             }
 
+            ss << std::setw(4) << (static_cast<unsigned long>(uint8data) & 0xFF);
+            response.addInt16(uint8data);
             break;
         }
         case data_type::INTEGER_16:
         {
             std::int16_t int16data;
 
-            if (priv->sdo()->upload("Remote request", &int16data, index, subindex))
+            if (!sdo->upload("Remote request", &int16data, req.index, req.subindex))
             {
-                ss << std::setw(6) << (static_cast<long>(int16data) & 0xFFFF);
-                response.addInt16(int16data);
-                ok = true;
+                return false;
             }
 
+            ss << std::setw(6) << (static_cast<long>(int16data) & 0xFFFF);
+            response.addInt16(int16data);
             break;
         }
         case data_type::UNSIGNED_INTEGER_16:
         {
             std::uint16_t uint16data;
 
-            if (priv->sdo()->upload("Remote request", &uint16data, index, subindex))
+            if (!sdo->upload("Remote request", &uint16data, req.index, req.subindex))
             {
-                ss << std::setw(6) << (static_cast<unsigned long>(uint16data) & 0xFFFF);
-                response.addInt32(uint16data);
-                ok = true;
+                return false;
             }
 
+            ss << std::setw(6) << (static_cast<unsigned long>(uint16data) & 0xFFFF);
+            response.addInt32(uint16data);
             break;
         }
         case data_type::INTEGER_32:
         {
             std::int32_t int32data;
 
-            if (priv->sdo()->upload("Remote request", &int32data, index, subindex))
+            if (!sdo->upload("Remote request", &int32data, req.index, req.subindex))
             {
-                ss << std::setw(10) << (static_cast<long>(int32data) & 0xFFFFFFFF);
-                response.addInt32(int32data);
-                ok = true;
+                return false;
             }
 
+            ss << std::setw(10) << (static_cast<long>(int32data) & 0xFFFFFFFF);
+            response.addInt32(int32data);
             break;
         }
         case data_type::UNSIGNED_INTEGER_32:
         {
             std::uint32_t uint32data;
 
-            if (priv->sdo()->upload("Remote request", &uint32data, index, subindex))
+            if (!sdo->upload("Remote request", &uint32data, req.index, req.subindex))
             {
-                ss << std::setw(10) << (static_cast<unsigned long>(uint32data) & 0xFFFFFFFF);
-                response.addInt64(uint32data);
-                ok = true;
+                return false;
             }
 
+            ss << std::setw(10) << (static_cast<unsigned long>(uint32data) & 0xFFFFFFFF);
+            response.addInt64(uint32data);
             break;
         }
         case data_type::STRING:
         {
             std::string strData;
 
-            if (priv->sdo()->upload("Remote request", strData, index, subindex))
+            if (!sdo->upload("Remote request", strData, req.index, req.subindex))
             {
-                ss << strData;
-                ok = true;
+                return false;
             }
 
+            ss << strData;
             break;
         }
         default:
-            yWarning("Invalid data type %s", yarp::os::Vocab::decode(static_cast<yarp::conf::vocab32_t>(type)).c_str());
-            return false;
-        }
-
-        if (!ok)
-        {
+            yWarning("Invalid data type %s", yarp::os::Vocab::decode(static_cast<yarp::conf::vocab32_t>(req.type)).c_str());
             return false;
         }
 
         response.addString(ss.str());
-        return response.write(*writer) && guard.inhibit();
+        return true;
     }
-    else if (dir == sdo_direction::DOWNLOAD)
-    {
-        if (request.size() != 6)
-        {
-            yWarning("Download SDO requires exactly 6 elements, got %zu", request.size());
-            return false;
-        }
 
-        const yarp::os::Value & data = request.get(5);
-
-        switch (type)
+    bool downloadRequest(SdoClient * sdo, const sdo_request & req)
+    {
+        switch (req.type)
         {
         case data_type::INTEGER_8:
         case data_type::UNSIGNED_INTEGER_8:
-            return priv->sdo()->download("Remote indication", data.asInt8(), index, subindex) && guard.flip();
+            return sdo->download("Remote indication", req.data.asInt8(), req.index, req.subindex);
         case data_type::INTEGER_16:
         case data_type::UNSIGNED_INTEGER_16:
-            return priv->sdo()->download("Remote indication", data.asInt16(), index, subindex) && guard.flip();
+            return sdo->download("Remote indication", req.data.asInt16(), req.index, req.subindex);
         case data_type::INTEGER_32:
         case data_type::UNSIGNED_INTEGER_32:
-            return priv->sdo()->download("Remote indication", data.asInt32(), index, subindex) && guard.flip();
+            return sdo->download("Remote indication", req.data.asInt32(), req.index, req.subindex);
         case data_type::STRING:
-            return priv->sdo()->download("Remote indication", data.asString(), index, subindex) && guard.flip();
+            return sdo->download("Remote indication", req.data.asString(), req.index, req.subindex);
         default:
-            yWarning("Invalid data type %s", yarp::os::Vocab::decode(static_cast<yarp::conf::vocab32_t>(type)).c_str());
+            yWarning("Invalid data type %s", yarp::os::Vocab::decode(static_cast<yarp::conf::vocab32_t>(req.type)).c_str());
             return false;
         }
     }
-    else
+
+    bool processRequest(SdoClient * sdo, const sdo_request & req, yarp::os::Bottle & response)
+    {
+        return req.dir == sdo_direction::UPLOAD ? uploadRequest(sdo, req, response) : downloadRequest(sdo, req);
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+class SdoReplier::Private
+{
+public:
+    //! Run a transfer on the worker of the given node and wait for it to finish.
+    void transfer(unsigned int id, CanSenderDelegate * sender, const std::function<void(SdoClient *)> & fn)
+    {
+        post(id, sender, fn).wait();
+    }
+
+    //! Requests targeting the same node are processed in order, nodes are served in parallel.
+    void processBatch(const std::vector<sdo_request> & requests, std::vector<yarp::os::Bottle> & results,
+            std::vector<char> & statuses, CanSenderDelegate * sender)
+    {
+        std::map<unsigned int, std::vector<std::size_t>> itemsPerNode;
+
+        for (std::size_t i = 0; i < requests.size(); i++)
+        {
+            itemsPerNode[requests[i].id].push_back(i);
+        }
+
+        std::vector<std::future<void>> futures;
+        futures.reserve(itemsPerNode.size());
+
+        for (const auto & node : itemsPerNode)
+        {
+            const auto & items = node.second;
+
+            futures.push_back(post(node.first, sender, [&items, &requests, &results, &statuses](SdoClient * sdo)
+                {
+                    for (auto i : items)
+                    {
+                        statuses[i] = processRequest(sdo, requests[i], results[i]);
+                    }
+                }));
+        }
+
+        for (auto & f : futures)
+        {
+            f.wait();
+        }
+    }
+
+    //! Forward a SDO response to the client of the given node, if a transfer is in flight.
+    bool notify(unsigned int cobId, const std::uint8_t * data)
+    {
+        unsigned int id = cobId - SDO_COB_TX;
+
+        if (id == 0 || id >= inFlight.size())
+        {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(routingMutexes[id]);
+        return inFlight[id] && inFlight[id]->notify(data);
+    }
+
+private:
+    //! Queue a transfer, the SDO client is only reachable by responses while it runs.
+    std::future<void> post(unsigned int id, CanSenderDelegate * sender, std::function<void(SdoClient *)> fn)
+    {
+        return getWorker(id)->post([this, id, sender, fn]
+            {
+                SdoClient sdo(id, SDO_COB_RX, SDO_COB_TX, SDO_TIMEOUT, sender);
+                setInFlight(id, &sdo);
+                fn(&sdo);
+                setInFlight(id, nullptr);
+            });
+    }
+
+    NodeWorker * getWorker(unsigned int id)
+    {
+        std::lock_guard<std::mutex> lock(workerMutex);
+
+        if (!workers[id])
+        {
+            workers[id].reset(new NodeWorker);
+        }
+
+        return workers[id].get();
+    }
+
+    void setInFlight(unsigned int id, SdoClient * sdo)
+    {
+        std::lock_guard<std::mutex> lock(routingMutexes[id]);
+        inFlight[id] = sdo;
+    }
+
+    std::array<SdoClient *, 128> inFlight {};
+    std::array<std::mutex, 128> routingMutexes;
+    std::array<std::unique_ptr<NodeWorker>, 128> workers;
+    std::mutex workerMutex;
+
+    static constexpr unsigned int SDO_COB_RX = 0x600;
+    static constexpr unsigned int SDO_COB_TX = 0x580;
+    static constexpr double SDO_TIMEOUT = 0.25; // seconds
+};
+
+// -----------------------------------------------------------------------------
+
+SdoReplier::SdoReplier()
+    : sender(nullptr),
+      priv(new Private)
+{ }
+
+// -----------------------------------------------------------------------------
+
+SdoReplier::~SdoReplier()
+{
+    delete priv;
+}
+
+// -----------------------------------------------------------------------------
+
+bool SdoReplier::read(yarp::os::ConnectionReader & reader)
+{
+    yarp::os::ConnectionWriter * writer = reader.getWriter();
+
+    yarp::os::Bottle request;
+    yarp::os::Bottle response;
+
+    if (!writer || !request.read(reader))
     {
-        yWarning("Invalid SDO direction %s", yarp::os::Vocab::decode(static_cast<yarp::conf::vocab32_t>(dir)).c_str());
         return false;
     }
+
+    ConnectionGuard guard(&response, writer);
+
+    if (request.size() != 0 && request.get(0).isList())
+    {
+        // batch mode: one list per SDO transfer, one result list per item
+        return processBatch(request, response) && guard.flip();
+    }
+
+    sdo_request req;
+
+    if (!parseRequest(request, req))
+    {
+        return false;
+    }
+
+    bool ok;
+    priv->transfer(req.id, sender, [&req, &response, &ok](SdoClient * sdo) { ok = processRequest(sdo, req, response); });
+
+    if (req.dir == sdo_direction::UPLOAD)
+    {
+        return ok && response.write(*writer) && guard.inhibit();
+    }
+    else
+    {
+        return ok && guard.flip();
+    }
 }
 
 // -----------------------------------------------------------------------------
 
-bool SdoReplier::notifyMessage(const can_message & msg)
+bool SdoReplier::processBatch(const yarp::os::Bottle & request, yarp::os::Bottle & response)
 {
-    if (priv->sdo() && priv->sdo()->getCobIdTx() == msg.id)
+    std::vector<sdo_request> requests(request.size());
+
+    for (std::size_t i = 0; i < request.size(); i++)
+    {
+        if (!request.get(i).isList() || !parseRequest(*request.get(i).asList(), requests[i]))
+        {
+            yWarning("Invalid SDO batch item at position %zu", i);
+            return false;
+        }
+    }
+
+    std::vector<yarp::os::Bottle> results(requests.size());
+    std::vector<char> statuses(requests.size(), false);
+
+    priv->processBatch(requests, results, statuses, sender);
+
+    bool ok = true;
+
+    for (std::size_t i = 0; i < requests.size(); i++)
     {
-        return priv->sdo()->notify(msg.data);
+        yarp::os::Bottle & item = response.addList();
+        item.addVocab(statuses[i] ? VOCAB_SDO_OK : VOCAB_SDO_FAIL);
+        item.append(results[i]);
+        ok &= statuses[i];
     }
 
-    return false;
+    return ok;
+}
+
+// -----------------------------------------------------------------------------
+
+bool SdoReplier::notifyMessage(const can_message & msg)
+{
+    return priv->notify(msg.id, msg.data);
 }
 
 // -----------------------------------------------------------------------------
@@ -3,6 +3,7 @@
 #ifndef __SDO_REPLIER_HPP__
 #define __SDO_REPLIER_HPP__
 
+#include <yarp/os/Bottle.h>
 #include <yarp/os/PortReader.h>
 
 #include "CanMessageNotifier.hpp"
@@ -19,6 +20,15 @@ namespace roboticslab
  * CAN network via SDO commands. Every transfer (either upload-from-drive request
  * or download-to-drive indication) is confirmed and its response sent back to
  * the RPC client.
+ *
+ * A single RPC message may also carry a list of transfers, e.g.
+ * `((sdou 15 0x6064 0 i32) (sdod 16 0x6060 0 i8 1))`. Transfers that target
+ * the same node are performed in order, distinct nodes are served in parallel.
+ * The reply contains one `(ok [value string])` or `(fail)` list per item,
+ * followed by an overall `ok` or `fail` vocab. Each node is served by its own
+ * worker thread. SDO clients are created per transfer and only receive replies
+ * while the transfer is in flight, since they share COB-IDs with the clients
+ * owned by the nodes.
  */
 class SdoReplier final : public yarp::os::PortReader,
                          public CanMessageNotifier
@@ -36,6 +46,9 @@ public:
     //! Tell observers a new CAN message has arrived.
     virtual bool notifyMessage(const can_message & msg) override;
 
+    //! Perform a list of SDO transfers, append one result list per item.
+    bool processBatch(const yarp::os::Bottle & request, yarp::os::Bottle & response);
+
     //! Configure CAN sender handle.
     void configureSender(CanSenderDelegate * sender)
     { this->sender = sender; }
@@ -0,0 +1,31 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#include "SdoStatisticsMonitor.hpp"
+
+#include <string>
+
+using namespace roboticslab;
+
+// -----------------------------------------------------------------------------
+
+void SdoStatisticsMonitor::run()
+{
+    auto & b = prepare();
+    b.clear();
+
+    for (const auto & handle : handles)
+    {
+        yarp::os::Bottle val;
+
+        if (handle.second->getRemoteVariableRaw("sdo", val) && val.get(1).isList())
+        {
+            yarp::os::Bottle & nodeVal = b.addList();
+            nodeVal.addString("id" + std::to_string(handle.first));
+            nodeVal.append(*val.get(1).asList());
+        }
+    }
+
+    write(true);
+}
+
+// -----------------------------------------------------------------------------
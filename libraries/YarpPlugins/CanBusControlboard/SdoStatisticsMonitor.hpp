@@ -0,0 +1,51 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __SDO_STATISTICS_MONITOR_HPP__
+#define __SDO_STATISTICS_MONITOR_HPP__
+
+#include <utility>
+#include <vector>
+
+#include <yarp/os/Bottle.h>
+#include <yarp/os/PeriodicThread.h>
+#include <yarp/os/PortWriterBuffer.h>
+
+#include <yarp/dev/IRemoteVariables.h>
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup CanBusControlboard
+ * @brief Periodically sends SDO transfer statistics of a single CAN bus through a YARP port.
+ *
+ * Statistics are retrieved via the "sdo" remote variable of each registered
+ * raw subdevice and streamed as a single bottle per step.
+ */
+class SdoStatisticsMonitor final : public yarp::os::PeriodicThread,
+                                   public yarp::os::PortWriterBuffer<yarp::os::Bottle>
+{
+public:
+    //! Constructor.
+    SdoStatisticsMonitor(double period) : yarp::os::PeriodicThread(period)
+    { }
+
+    //! Register a node that provides the "sdo" remote variable.
+    void registerHandle(unsigned int id, yarp::dev::IRemoteVariablesRaw * p)
+    { handles.emplace_back(id, p); }
+
+    //! Whether any node has been registered.
+    bool hasNodes() const
+    { return !handles.empty(); }
+
+protected:
+    //! The thread will invoke this periodically.
+    virtual void run() override;
+
+private:
+    std::vector<std::pair<unsigned int, yarp::dev::IRemoteVariablesRaw *>> handles;
+};
+
+} // namespace roboticslab
+
+#endif // __SDO_STATISTICS_MONITOR_HPP__
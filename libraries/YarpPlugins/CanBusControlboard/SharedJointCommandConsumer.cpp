@@ -0,0 +1,119 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#include "SharedJointCommandConsumer.hpp"
+
+#include <cerrno>
+#include <cstring> // std::strerror
+
+#include <yarp/os/LogStream.h>
+
+using namespace roboticslab;
+
+// -----------------------------------------------------------------------------
+
+bool SharedJointCommandConsumer::open(const std::string & name, const DeviceMapper & deviceMapper, unsigned int _timeoutCycles)
+{
+    const int axes = deviceMapper.getControlledAxes();
+
+    if (!reader.open(name, axes))
+    {
+        yError() << "Unable to create shared memory object" << name << ":" << std::strerror(errno);
+        return false;
+    }
+
+    targets.clear();
+
+    for (int j = 0; j < axes; j++)
+    {
+        auto t = deviceMapper.getDevice(j);
+        const auto * device = std::get<0>(t);
+
+        joint_target target {};
+        target.iPositionDirectRaw = device->getHandle<yarp::dev::IPositionDirectRaw>();
+        target.iVelocityControlRaw = device->getHandle<yarp::dev::IVelocityControlRaw>();
+        target.localAxis = std::get<1>(t);
+        targets.push_back(target);
+    }
+
+    timeoutCycles = _timeoutCycles;
+
+    yInfo() << "Accepting commands for" << axes << "axes in shared memory object" << name
+            << "with a timeout of" << timeoutCycles << "cycles";
+
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+void SharedJointCommandConsumer::consume(std::uint64_t cycle)
+{
+    shared_joint_command command;
+
+    for (std::size_t j = 0; j < targets.size(); j++)
+    {
+        auto & target = targets[j];
+
+        if (!reader.read(j, command))
+        {
+            continue; // caught mid-write, pick it up on the next cycle
+        }
+
+        if (command.sequence != target.last.sequence)
+        {
+            if (target.stale)
+            {
+                yInfo() << "Shared memory commands of joint" << j << "resumed";
+                target.stale = false;
+            }
+
+            target.last = command;
+            target.lastCycle = cycle;
+            apply(j, target, command.type, command.value);
+        }
+        else if (target.last.sequence != 0 && !target.stale && cycle - target.lastCycle > timeoutCycles)
+        {
+            target.stale = true;
+
+            if (target.last.type == shared_command::VELOCITY)
+            {
+                yWarning() << "Shared memory commands of joint" << j << "stalled, stopping";
+                apply(j, target, shared_command::VELOCITY, 0.0);
+            }
+            else
+            {
+                yWarning() << "Shared memory commands of joint" << j << "stalled, holding position";
+            }
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+bool SharedJointCommandConsumer::apply(int joint, joint_target & target, shared_command type, double value)
+{
+    bool ok;
+
+    switch (type)
+    {
+    case shared_command::POSITION_DIRECT:
+        ok = target.iPositionDirectRaw && target.iPositionDirectRaw->setPositionRaw(target.localAxis, value);
+        break;
+    case shared_command::VELOCITY:
+        ok = target.iVelocityControlRaw && target.iVelocityControlRaw->velocityMoveRaw(target.localAxis, value);
+        break;
+    default:
+        ok = false;
+        break;
+    }
+
+    // warn once until commands are accepted again, e.g. after a control mode switch
+    if (!ok && !target.rejected)
+    {
+        yWarning() << "Shared memory command rejected by joint" << joint << "(wrong control mode?)";
+    }
+
+    target.rejected = !ok;
+    return ok;
+}
+
+// -----------------------------------------------------------------------------
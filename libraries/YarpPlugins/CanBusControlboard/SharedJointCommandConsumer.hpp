@@ -0,0 +1,63 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __SHARED_JOINT_COMMAND_CONSUMER_HPP__
+#define __SHARED_JOINT_COMMAND_CONSUMER_HPP__
+
+#include <cstdint>
+
+#include <string>
+#include <vector>
+
+#include <yarp/dev/IPositionDirect.h>
+#include <yarp/dev/IVelocityControl.h>
+
+#include "DeviceMapper.hpp"
+#include "SharedJointCommand.hpp"
+#include "SyncPeriodicThread.hpp"
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup CanBusControlboard
+ * @brief Forwards setpoints from POSIX shared memory to the nodes on each SYNC.
+ *
+ * Co-located clients stream position direct or velocity commands through a
+ * @ref SharedJointCommandWriter instead of going through the network wrapper.
+ * New commands, told apart by their per-joint sequence number, are handed over
+ * to the raw subdevices at the start of each cycle, hence sent along with the
+ * next SYNC. A joint whose producer stops sending commands for longer than the
+ * configured number of cycles is considered stale: position direct targets are
+ * held, velocity targets are set to zero. Joints that have never been commanded
+ * this way are left alone.
+ */
+class SharedJointCommandConsumer final : public SyncPeriodicThread::CommandSource
+{
+public:
+    //! Create the shared memory mailboxes and resolve raw interface handles of each joint.
+    bool open(const std::string & name, const DeviceMapper & deviceMapper, unsigned int timeoutCycles);
+
+    virtual void consume(std::uint64_t cycle) override;
+
+private:
+    struct joint_target
+    {
+        yarp::dev::IPositionDirectRaw * iPositionDirectRaw;
+        yarp::dev::IVelocityControlRaw * iVelocityControlRaw;
+        int localAxis;
+        shared_joint_command last; // last applied command
+        std::uint64_t lastCycle; // cycle of the last applied command
+        bool stale;
+        bool rejected;
+    };
+
+    bool apply(int joint, joint_target & target, shared_command type, double value);
+
+    SharedJointCommandReader reader;
+    std::vector<joint_target> targets;
+    unsigned int timeoutCycles {0};
+};
+
+} // namespace roboticslab
+
+#endif // __SHARED_JOINT_COMMAND_CONSUMER_HPP__
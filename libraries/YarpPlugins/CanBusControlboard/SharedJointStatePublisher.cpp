@@ -0,0 +1,42 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#include "SharedJointStatePublisher.hpp"
+
+#include <cerrno>
+#include <cstring> // std::strerror
+
+#include <yarp/os/LogStream.h>
+#include <yarp/os/Time.h>
+
+using namespace roboticslab;
+
+// -----------------------------------------------------------------------------
+
+bool SharedJointStatePublisher::open(const std::string & name, int axes, int depth)
+{
+    if (!writer.open(name, axes, depth))
+    {
+        yError() << "Unable to create shared memory object" << name << ":" << std::strerror(errno);
+        return false;
+    }
+
+    yInfo() << "Publishing joint state of" << axes << "axes in shared memory object" << name << "with depth" << depth;
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+void SharedJointStatePublisher::onPublish(std::uint64_t cycle, const std::vector<joint_state> & states)
+{
+    writer.beginRecord(cycle, yarp::os::Time::now());
+
+    for (std::size_t j = 0; j < states.size(); j++)
+    {
+        const auto & state = states[j];
+        writer.setJoint(j, state.position, state.velocity, state.current, state.mode, state.timestamp);
+    }
+
+    writer.endRecord();
+}
+
+// -----------------------------------------------------------------------------
@@ -0,0 +1,35 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __SHARED_JOINT_STATE_PUBLISHER_HPP__
+#define __SHARED_JOINT_STATE_PUBLISHER_HPP__
+
+#include <string>
+
+#include "JointStateSnapshot.hpp"
+#include "SharedJointState.hpp"
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup CanBusControlboard
+ * @brief Mirrors published joint state cycles into POSIX shared memory.
+ *
+ * Co-located clients attach to the ring with a @ref SharedJointStateReader
+ * instead of going through the network wrapper.
+ */
+class SharedJointStatePublisher final : public JointStateSnapshot::Listener
+{
+public:
+    //! Create the shared memory ring.
+    bool open(const std::string & name, int axes, int depth);
+
+    virtual void onPublish(std::uint64_t cycle, const std::vector<joint_state> & states) override;
+
+private:
+    SharedJointStateWriter writer;
+};
+
+} // namespace roboticslab
+
+#endif // __SHARED_JOINT_STATE_PUBLISHER_HPP__
@@ -5,6 +5,7 @@
 #include <cmath> // std::modf
 
 #include <yarp/conf/version.h>
+#include <yarp/os/Log.h>
 #include <yarp/os/SystemClock.h>
 
 using namespace roboticslab;
@@ -19,7 +20,12 @@ SyncPeriodicThread::SyncPeriodicThread(std::vector<CanBusBroker *> & _canBusBrok
 #endif
       canBusBrokers(_canBusBrokers),
       taskFactory(_taskFactory),
-      syncObserver(nullptr)
+      task(_taskFactory->createTask()),
+      syncObserver(nullptr),
+      jointState(nullptr),
+      commandSource(nullptr),
+      counterOverflow(0),
+      cycle(0)
 {}
 
 // -----------------------------------------------------------------------------
@@ -32,6 +38,7 @@ SyncPeriodicThread::~SyncPeriodicThread()
         syncPort.close();
     }
 
+    task.reset(); // might depend on the factory
     delete taskFactory;
 }
 
@@ -46,13 +53,40 @@ bool SyncPeriodicThread::openPort(const std::string & name)
 
 // -----------------------------------------------------------------------------
 
+bool SyncPeriodicThread::setCounterOverflow(unsigned int overflow)
+{
+    if (overflow == 1 || overflow > 240)
+    {
+        yError() << "Illegal SYNC counter overflow value:" << overflow;
+        return false;
+    }
+
+    counterOverflow = overflow;
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
 void SyncPeriodicThread::run()
 {
-    auto task = taskFactory->createTask();
+    task->clear(); // keep storage from previous cycles
+
+    const std::uint64_t current = ++cycle;
+    const std::uint8_t counter = counterOverflow != 0 ? (current - 1) % counterOverflow + 1 : 0;
+
+    if (jointState)
+    {
+        jointState->beginCycle(current); // deadline of the previous cycle
+    }
+
+    if (commandSource)
+    {
+        commandSource->consume(current); // applied by the SYNC that follows
+    }
 
     for (auto * canBusBroker : canBusBrokers)
     {
-        task->add([canBusBroker]
+        task->add([canBusBroker, current, counter]
             {
                 auto * reader = canBusBroker->getReader();
                 auto * writer = canBusBroker->getWriter();
@@ -62,8 +96,22 @@ void SyncPeriodicThread::run()
                     handle->synchronize();
                 }
 
-                writer->getDelegate()->prepareMessage({0x80, 0, nullptr}); // SYNC
+                if (counter != 0)
+                {
+                    writer->getDelegate()->prepareMessage({0x80, 1, &counter}); // SYNC with counter
+                }
+                else
+                {
+                    writer->getDelegate()->prepareMessage({0x80, 0, nullptr}); // SYNC
+                }
+
                 writer->flush();
+
+                for (auto * handle : reader->getHandles())
+                {
+                    handle->onSync(current);
+                }
+
                 return true;
             });
     }
@@ -3,6 +3,10 @@
 #ifndef __SYNC_PERIODIC_THREAD_HPP__
 #define __SYNC_PERIODIC_THREAD_HPP__
 
+#include <cstdint>
+
+#include <atomic>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -13,6 +17,7 @@
 
 #include "CanBusBroker.hpp"
 #include "FutureTask.hpp"
+#include "JointStateSnapshot.hpp"
 #include "StateObserver.hpp"
 
 namespace roboticslab
@@ -24,10 +29,29 @@ namespace roboticslab
  *
  * This thread performs periodic synchronization tasks across all managed
  * subdevices and sends a SYNC signal at the end of each iteration.
+ *
+ * Each iteration is assigned a cycle number that increases monotonically and
+ * is passed on to the subdevices via @ref ICanBusSharer::onSync. If a SYNC
+ * counter overflow value is set, the SYNC message carries a one-byte counter
+ * (CiA 301) that wraps around from said value to 1. The joint state snapshot,
+ * if any, is told about each new cycle before its SYNC is sent. Likewise, a
+ * @ref CommandSource may forward external setpoints to the subdevices right
+ * before these are synchronized.
  */
 class SyncPeriodicThread final : public yarp::os::PeriodicThread
 {
 public:
+    //! Supplier of setpoints that are polled on each cycle.
+    class CommandSource
+    {
+    public:
+        //! Virtual destructor.
+        virtual ~CommandSource() = default;
+
+        //! Invoked at the start of a cycle, prior to node synchronization.
+        virtual void consume(std::uint64_t cycle) = 0;
+    };
+
     //! Constructor, manages the lifetime of @ref taskFactory.
     SyncPeriodicThread(std::vector<CanBusBroker *> & canBusBrokers, FutureTaskFactory * taskFactory);
 
@@ -41,13 +65,33 @@ public:
     void setObserver(StateObserver * syncObserver)
     { this->syncObserver = syncObserver; }
 
+    //! Set joint state snapshot, published once per cycle.
+    void setJointStateSnapshot(JointStateSnapshot * jointState)
+    { this->jointState = jointState; }
+
+    //! Set source of setpoints, polled once per cycle.
+    void setCommandSource(CommandSource * commandSource)
+    { this->commandSource = commandSource; }
+
+    //! Enable SYNC counter with the given overflow value [2-240], zero disables it.
+    bool setCounterOverflow(unsigned int overflow);
+
+    //! Retrieve number of the last cycle, zero if none was issued yet.
+    std::uint64_t getCycle() const
+    { return cycle; }
+
     //! Periodic task.
     void run() override;
 
 private:
     std::vector<CanBusBroker *> & canBusBrokers;
     FutureTaskFactory * taskFactory;
+    std::unique_ptr<FutureTask> task; // reused on each cycle
     StateObserver * syncObserver;
+    JointStateSnapshot * jointState;
+    CommandSource * commandSource;
+    std::uint8_t counterOverflow;
+    std::atomic<std::uint64_t> cycle;
     yarp::os::Port syncPort;
     yarp::os::PortWriterBuffer<yarp::os::Bottle> syncWriter;
 };
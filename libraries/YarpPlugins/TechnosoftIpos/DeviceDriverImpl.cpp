@@ -2,15 +2,43 @@
 
 #include "TechnosoftIpos.hpp"
 
-#include <functional>
+#include <algorithm>
+#include <string>
+#include <vector>
 
 #include <yarp/os/LogStream.h>
 #include <yarp/os/Property.h>
 
+#include "TpdoMapping.hpp"
+
 using namespace roboticslab;
 
 // -----------------------------------------------------------------------------
 
+namespace
+{
+    // accepts integers and strings in any base, e.g. 24578 or "0x6002"
+    bool parseObjectIndex(const yarp::os::Value & value, std::uint16_t * index)
+    {
+        if (value.isInt32())
+        {
+            int parsed = value.asInt32();
+
+            if (parsed < 0 || parsed > 0xFFFF)
+            {
+                return false;
+            }
+
+            *index = parsed;
+            return true;
+        }
+
+        return value.isString() && TpdoMapping::parseIndex(value.asString(), index);
+    }
+}
+
+// -----------------------------------------------------------------------------
+
 bool TechnosoftIpos::open(yarp::os::Searchable & config)
 {
     if (!config.check("robotConfig") || !config.find("robotConfig").isBlob())
@@ -60,12 +88,52 @@ bool TechnosoftIpos::open(yarp::os::Searchable & config)
     vars.syncPeriod = iposGroup.check("syncPeriod", yarp::os::Value(0.0), "SYNC message period (seconds)").asFloat64();
     vars.initialMode = iposGroup.check("initialMode", yarp::os::Value(VOCAB_CM_IDLE), "initial YARP control mode vocab").asVocab();
 
+    vars.updateConversionFactors();
+
     if (!vars.validateInitialState())
     {
         yError() << "Invalid configuration parameters";
         return false;
     }
 
+    std::string cspInterpolation = iposGroup.check("cspInterpolation", yarp::os::Value("none"),
+        "host-side interpolation of CSP setpoints [none|linear|cubic]").asString();
+
+    SyncInterpolator::mode cspMode;
+
+    if (!SyncInterpolator::parseMode(cspInterpolation, &cspMode))
+    {
+        yError() << "Illegal CSP interpolation mode:" << cspInterpolation;
+        return false;
+    }
+
+    syncInterpolator = new SyncInterpolator(vars.syncPeriod, cspMode);
+
+    std::string encoderEstimator = iposGroup.check("encoderEstimator", yarp::os::Value(DEFAULT_ENCODER_ESTIMATOR),
+        "encoder speed and acceleration estimator [difference|leastSquares|alphaBeta|drive]").asString();
+    int encoderWindow = iposGroup.check("encoderWindow", yarp::os::Value(DEFAULT_ENCODER_WINDOW),
+        "window size of the least-squares encoder estimator (samples)").asInt32();
+    double encoderAlpha = iposGroup.check("encoderAlpha", yarp::os::Value(DEFAULT_ENCODER_ALPHA),
+        "position gain of the alpha-beta encoder estimator").asFloat64();
+    double encoderBeta = iposGroup.check("encoderBeta", yarp::os::Value(DEFAULT_ENCODER_BETA),
+        "speed gain of the alpha-beta encoder estimator").asFloat64();
+    double encoderGamma = iposGroup.check("encoderGamma", yarp::os::Value(DEFAULT_ENCODER_GAMMA),
+        "acceleration gain of the alpha-beta encoder estimator").asFloat64();
+
+    EncoderRead::estimator estimatorType;
+
+    if (!EncoderRead::parseEstimator(encoderEstimator, &estimatorType))
+    {
+        yError() << "Illegal encoder estimator:" << encoderEstimator;
+        return false;
+    }
+
+    if (encoderWindow < 0 || !vars.lastEncoderRead->configure(estimatorType, encoderWindow, encoderAlpha, encoderBeta, encoderGamma))
+    {
+        yError() << "Illegal parameters of encoder estimator" << encoderEstimator;
+        return false;
+    }
+
     if (iposGroup.check("externalEncoder", "external encoder"))
     {
         std::string externalEncoder = iposGroup.find("externalEncoder").asString();
@@ -108,65 +176,73 @@ bool TechnosoftIpos::open(yarp::os::Searchable & config)
 
     can = new CanOpenNode(vars.canId, sdoTimeout, driveStateTimeout);
 
-    PdoConfiguration tpdo1Conf;
+    if (iposGroup.check("sdoAdaptiveTimeout", yarp::os::Value(false),
+            "derive SDO timeout from measured round-trip times, retry uploads").asBool())
+    {
+        SdoClient::adaptive_policy policy;
 
-    // Manufacturer Status Register (1002h) and Modes of Operation Display (6061h)
-    tpdo1Conf.addMapping<std::uint32_t>(0x1002).addMapping<std::int8_t>(0x6061);
+        policy.minTimeout = iposGroup.check("sdoMinTimeout", yarp::os::Value(DEFAULT_SDO_MIN_TIMEOUT),
+                "lower bound of adaptive CAN SDO timeout (seconds)").asFloat64();
+        policy.maxTimeout = iposGroup.check("sdoMaxTimeout", yarp::os::Value(DEFAULT_SDO_MAX_TIMEOUT),
+                "upper bound of adaptive CAN SDO timeout (seconds)").asFloat64();
+        int retries = iposGroup.check("sdoRetries", yarp::os::Value(DEFAULT_SDO_RETRIES),
+                "retries of timed-out CAN SDO uploads").asInt32();
 
-    if (iposGroup.check("tpdo1InhibitTime", "TPDO1 inhibit time (seconds)"))
-    {
-        tpdo1Conf.setInhibitTime(iposGroup.find("tpdo1InhibitTime").asFloat64() * 1e4); // pass x100 microseconds
-    }
+        if (policy.minTimeout <= 0.0 || policy.maxTimeout < policy.minTimeout)
+        {
+            yError() << "Illegal adaptive SDO timeout bounds:" << policy.minTimeout << policy.maxTimeout;
+            return false;
+        }
 
-    if (iposGroup.check("tpdo1EventTimer", "TPDO1 event timer (seconds)"))
-    {
-        tpdo1Conf.setEventTimer(iposGroup.find("tpdo1EventTimer").asFloat64() * 1e3); // pass milliseconds
-    }
+        if (retries < 0)
+        {
+            yError() << "Illegal SDO retries:" << retries;
+            return false;
+        }
 
-    PdoConfiguration tpdo2Conf;
+        policy.retries = retries;
 
-    // Motion Error Register (2000h) and Detailed Error Register (2002h)
-    tpdo2Conf.addMapping<std::uint16_t>(0x2000).addMapping<std::uint16_t>(0x2002);
+        can->sdo()->enableAdaptiveTimeout(policy);
+    }
 
-    if (iposGroup.check("tpdo2InhibitTime", "TPDO2 inhibit time (seconds)"))
+    if (!configureTpdo(iposGroup, 1, can->tpdo1(), vars.tpdo1Conf)
+        || !configureTpdo(iposGroup, 2, can->tpdo2(), vars.tpdo2Conf)
+        || !configureTpdo(iposGroup, 3, can->tpdo3(), vars.tpdo3Conf)
+        || !configureTpdo(iposGroup, 4, can->tpdo4(), vars.tpdo4Conf))
     {
-        tpdo2Conf.setInhibitTime(iposGroup.find("tpdo2InhibitTime").asFloat64() * 1e4); // pass x100 microseconds
+        return false;
     }
 
-    if (iposGroup.check("tpdo2EventTimer", "TPDO2 event timer (seconds)"))
+    if (TpdoMapping::hasDuplicateStatusword(vars.tpdoMappedObjects))
     {
-        tpdo2Conf.setEventTimer(iposGroup.find("tpdo2EventTimer").asFloat64() * 1e3); // pass milliseconds
+        yError() << "Statusword mapped twice, either map 0x1002 or 0x6041";
+        return false;
     }
 
-    PdoConfiguration tpdo3Conf;
-
-    // Position actual internal value (6063h) and Torque actual value (6077h)
-    tpdo3Conf.addMapping<std::int32_t>(0x6063).addMapping<std::int16_t>(0x6077);
-
-    tpdo3Conf.setTransmissionType(PdoTransmissionType::SYNCHRONOUS_CYCLIC);
-
-    vars.tpdo1Conf = tpdo1Conf;
-    vars.tpdo2Conf = tpdo2Conf;
-    vars.tpdo3Conf = tpdo3Conf;
-
-    using namespace std::placeholders;
+    if (estimatorType == EncoderRead::estimator::DRIVE && !vars.tpdoMappedObjects.count(IposObjects::VelocityActualValue::index))
+    {
+        yError("Encoder estimator %s requires object 0x%04X in a TPDO mapping", encoderEstimator.c_str(), IposObjects::VelocityActualValue::index);
+        return false;
+    }
 
-    can->tpdo1()->registerHandler<std::uint16_t, std::uint16_t, std::int8_t>(std::bind(&TechnosoftIpos::handleTpdo1, this, _1, _2, _3));
-    can->tpdo2()->registerHandler<std::uint16_t, std::uint16_t>(std::bind(&TechnosoftIpos::handleTpdo2, this, _1, _2));
-    can->tpdo3()->registerHandler<std::int32_t, std::int16_t>(std::bind(&TechnosoftIpos::handleTpdo3, this, _1, _2));
+    if (!vars.tpdoMappedObjects.count(IposObjects::ManufacturerStatusRegister::index)
+        && !vars.tpdoMappedObjects.count(IposObjects::Statusword::index))
+    {
+        yWarning() << "Neither 0x1002 nor 0x6041 mapped, drive state changes will not be tracked";
+    }
 
-    can->emcy()->registerHandler(std::bind(&TechnosoftIpos::handleEmcy, this, _1, _2, _3));
+    can->emcy()->registerHandler([this](auto code, auto reg, auto msef) { handleEmcy(code, reg, msef); });
     can->emcy()->setErrorCodeRegistry<TechnosoftIposEmcy>();
 
-    can->nmt()->registerHandler(std::bind(&TechnosoftIpos::handleNmt, this, _1));
+    can->nmt()->registerHandler([this](auto state) { handleNmt(state); });
 
-    if (iposGroup.check("monitorPeriod", "monitor thread period (seconds)"))
+    if (iposGroup.check("monitorPeriod", "heartbeat consumer timeout (seconds)"))
     {
         double monitorPeriod = iposGroup.find("monitorPeriod").asFloat64();
 
         if (monitorPeriod > 0.0)
         {
-            monitorThread = new yarp::os::Timer(yarp::os::TimerSettings(monitorPeriod), std::bind(&TechnosoftIpos::monitorWorker, this, _1), false);
+            vars.heartbeatTimeout = monitorPeriod; // supervised by CanBusControlboard
         }
         else
         {
@@ -174,27 +250,171 @@ bool TechnosoftIpos::open(yarp::os::Searchable & config)
         }
     }
 
-    return !monitorThread || monitorThread->start();
+    return true;
 }
 
 // -----------------------------------------------------------------------------
 
-bool TechnosoftIpos::close()
+bool TechnosoftIpos::configureTpdo(const yarp::os::Searchable & config, unsigned int n, TransmitPdo * tpdo, PdoConfiguration & conf)
 {
-    // we need to do this in finalize(), too, since the monitor thread could be
-    // still requesting CAN transfers even after CAN RX/TX threads have been
-    // closed in CanBusControlboard::close()
-    if (monitorThread && monitorThread->isRunning())
+    const std::string prefix = "tpdo" + std::to_string(n);
+    std::vector<std::uint16_t> mapping = TpdoMapping::getDefaultLayout(n);
+
+    if (config.check(prefix + "Mapping", "TPDO" + std::to_string(n) + " mapped object indices"))
     {
-        monitorThread->stop();
+        const yarp::os::Value & value = config.find(prefix + "Mapping");
+
+        if (!value.isList())
+        {
+            yError() << "Mapping of TPDO" << n << "is not a list:" << value.toString();
+            return false;
+        }
+
+        const yarp::os::Bottle * list = value.asList();
+        mapping.clear();
+
+        for (int i = 0; i < list->size(); i++)
+        {
+            std::uint16_t index;
+
+            if (!parseObjectIndex(list->get(i), &index))
+            {
+                yError() << "Illegal object index in TPDO" << n << "mapping:" << list->get(i).toString();
+                return false;
+            }
+
+            mapping.push_back(index);
+        }
+    }
+
+    TpdoMapping layout;
+
+    for (auto index : mapping)
+    {
+        if (!layout.add(index))
+        {
+            yError("Unsupported, duplicated or overflowing object in TPDO%d mapping: 0x%04X", n, index);
+            return false;
+        }
+
+        vars.tpdoMappedObjects.insert(index);
+    }
+
+    if (layout.getObjects().empty())
+    {
+        // don't transmit anything
+        conf.setValid(false);
+        tpdo->unregisterHandler();
+        return true;
     }
 
-    delete monitorThread;
-    monitorThread = nullptr;
+    layout.configure(conf);
+
+    if (n == 3)
+    {
+        vars.syncPositionTpdo = std::find(mapping.cbegin(), mapping.cend(), IposObjects::PositionActualInternalValue::index) != mapping.cend();
+    }
+
+    const auto & objects = layout.getObjects();
+    const unsigned int size = layout.getSize();
+
+    bool isSyncCyclic = false;
+
+    if (config.check(prefix + "TransmissionType", "TPDO" + std::to_string(n) + " transmission type"))
+    {
+        int value = config.find(prefix + "TransmissionType").asInt32();
+        PdoTransmissionType type;
+
+        if (value < 0x00 || value > 0xFF || !PdoTransmissionType::fromByte(value, &type))
+        {
+            yError() << "Illegal TPDO" << n << "transmission type:" << value;
+            return false;
+        }
+
+        conf.setTransmissionType(type);
+        isSyncCyclic = type == PdoTransmissionType::SYNCHRONOUS_CYCLIC;
+    }
+    else if (n == 3)
+    {
+        conf.setTransmissionType(PdoTransmissionType::SYNCHRONOUS_CYCLIC);
+        isSyncCyclic = true;
+    }
 
+    if (config.check(prefix + "SyncStartValue", "TPDO" + std::to_string(n) + " SYNC start value [0-240]"))
+    {
+        int value = config.find(prefix + "SyncStartValue").asInt32();
+
+        if (value < 0x00 || value > 0xF0)
+        {
+            yError() << "Illegal TPDO" << n << "SYNC start value:" << value;
+            return false;
+        }
+
+        conf.setSyncStartValue(value);
+    }
+
+    if (isSyncCyclic)
+    {
+        // expect one TPDO per SYNC cycle, track losses
+        syncCycles.expect(n);
+    }
+
+    if (config.check(prefix + "InhibitTime", "TPDO" + std::to_string(n) + " inhibit time (seconds)"))
+    {
+        conf.setInhibitTime(config.find(prefix + "InhibitTime").asFloat64() * 1e4); // pass x100 microseconds
+    }
+
+    if (config.check(prefix + "EventTimer", "TPDO" + std::to_string(n) + " event timer (seconds)"))
+    {
+        conf.setEventTimer(config.find(prefix + "EventTimer").asFloat64() * 1e3); // pass milliseconds
+    }
+
+    if (isSyncCyclic)
+    {
+        tpdo->registerRawHandler([this, n, objects, size](const std::uint8_t * data, unsigned int len)
+            {
+                if (len != size)
+                {
+                    return false;
+                }
+
+                std::uint64_t cycle;
+                bool accepted = syncCycles.accept(n, &cycle);
+
+                if (accepted)
+                {
+                    vars.lastSyncCycle = cycle;
+                }
+
+                handleTpdo(objects, data, accepted ? cycle : 0); // late data is still the most recent one
+
+                if (accepted && n == 3 && jointStateSink)
+                {
+                    reportJointState(cycle);
+                }
+
+                return true;
+            });
+    }
+    else
+    {
+        tpdo->registerRawHandler([this, objects, size](const std::uint8_t * data, unsigned int len)
+            { return len == size && (handleTpdo(objects, data), true); });
+    }
+
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+bool TechnosoftIpos::close()
+{
     delete ipBuffer;
     ipBuffer = nullptr;
 
+    delete syncInterpolator;
+    syncInterpolator = nullptr;
+
     delete can;
     can = nullptr;
 
@@ -62,6 +62,19 @@ bool TechnosoftIpos::registerSender(CanSenderDelegate * sender)
 
 // -----------------------------------------------------------------------------
 
+bool TechnosoftIpos::registerJointStateSink(JointStateSink * sink)
+{
+    if (!vars.syncPositionTpdo)
+    {
+        return false; // joint state would not be refreshed on each SYNC
+    }
+
+    jointStateSink = sink;
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
 bool TechnosoftIpos::initialize()
 {
     if (!can->sdo()->ping())
@@ -72,26 +85,21 @@ bool TechnosoftIpos::initialize()
     if (!vars.configuredOnce)
     {
         // retrieve static drive info
-        vars.configuredOnce = can->sdo()->upload<std::uint32_t>("Device type",
+        vars.configuredOnce = can->sdo()->upload(IposObjects::DeviceType(),
                 [](auto data)
-                { yInfo("CiA standard: %d", data & 0xFFFF); },
-                0x1000)
-            && can->sdo()->upload<std::uint32_t>("Supported drive modes",
+                { yInfo("CiA standard: %d", data & 0xFFFF); })
+            && can->sdo()->upload(IposObjects::SupportedDriveModes(),
                 [this](auto data)
-                { interpretSupportedDriveModes(data); },
-                0x6502)
-            && can->sdo()->upload("Manufacturer software version",
+                { interpretSupportedDriveModes(data); })
+            && can->sdo()->upload(IposObjects::ManufacturerSoftwareVersion(),
                 [](const auto & data)
-                { yInfo("Firmware version: %s", rtrim(data).c_str()); },
-                0x100A)
-            && can->sdo()->upload<std::uint32_t>("Identity Object: Product Code",
+                { yInfo("Firmware version: %s", rtrim(data).c_str()); })
+            && can->sdo()->upload(IposObjects::ProductCode(),
                 [](auto data)
-                { yInfo("Product code: P%03d.%03d.E%03d", data / 1000000, (data / 1000) % 1000, data % 1000); },
-                0x1018, 0x02)
-            && can->sdo()->upload<std::uint32_t>("Identity Object: Serial number",
+                { yInfo("Product code: P%03d.%03d.E%03d", data / 1000000, (data / 1000) % 1000, data % 1000); })
+            && can->sdo()->upload(IposObjects::SerialNumber(),
                 [](auto data)
-                { yInfo("Serial number: %c%c%02x%02x", getByte(data, 3), getByte(data, 2), getByte(data, 1), getByte(data, 0)); },
-                0x1018, 0x04);
+                { yInfo("Serial number: %c%c%02x%02x", getByte(data, 3), getByte(data, 2), getByte(data, 1), getByte(data, 0)); });
     }
 
     double extEnc;
@@ -106,8 +114,9 @@ bool TechnosoftIpos::initialize()
         || !can->tpdo1()->configure(vars.tpdo1Conf)
         || !can->tpdo2()->configure(vars.tpdo2Conf)
         || !can->tpdo3()->configure(vars.tpdo3Conf)
+        || !can->tpdo4()->configure(vars.tpdo4Conf)
         || (vars.heartbeatPeriod != 0.0
-                && !can->sdo()->download<std::uint16_t>("Producer Heartbeat Time", vars.heartbeatPeriod * 1000, 0x1017))
+                && !can->sdo()->download(IposObjects::ProducerHeartbeatTime(), static_cast<std::uint16_t>(vars.heartbeatPeriod * 1000)))
         || !can->nmt()->issueServiceCommand(NmtService::START_REMOTE_NODE)
         || (can->driveStatus()->getCurrentState() == DriveState::NOT_READY_TO_SWITCH_ON
                 && !can->driveStatus()->awaitState(DriveState::SWITCH_ON_DISABLED)))
@@ -116,7 +125,6 @@ bool TechnosoftIpos::initialize()
         return false;
     }
 
-    vars.lastHeartbeat = yarp::os::Time::now();
     vars.actualControlMode = VOCAB_CM_CONFIGURED;
 
     if (!can->driveStatus()->requestState(DriveState::SWITCHED_ON)
@@ -133,11 +141,6 @@ bool TechnosoftIpos::initialize()
 
 bool TechnosoftIpos::finalize()
 {
-    if (monitorThread && monitorThread->isRunning())
-    {
-        monitorThread->stop();
-    }
-
     bool ok = true;
 
     if (vars.actualControlMode != VOCAB_CM_NOT_CONFIGURED)
@@ -233,7 +236,7 @@ bool TechnosoftIpos::synchronize()
     }
     case VOCAB_CM_POSITION_DIRECT:
     {
-        double value = vars.clipSyncPositionTarget();
+        double value = vars.clipSyncPositionTarget(syncInterpolator->next());
         std::int32_t data = vars.degreesToInternalUnits(value);
         return can->rpdo3()->write(data);
     }
@@ -243,3 +246,55 @@ bool TechnosoftIpos::synchronize()
 }
 
 // -----------------------------------------------------------------------------
+
+void TechnosoftIpos::onSync(std::uint64_t cycle)
+{
+    if (syncCycles.isEnabled())
+    {
+        // TPDOs are not expected until the node has been configured
+        syncCycles.beginCycle(cycle, vars.actualControlMode != VOCAB_CM_NOT_CONFIGURED);
+    }
+
+    double start = vars.ipMotionStartTime;
+
+    // uploaded trajectories start on the first SYNC at or after the requested time, same for all joints
+    if (start != 0.0 && vars.ipBufferFilled && !vars.ipMotionStarted && yarp::os::Time::now() >= start)
+    {
+        startIpMotion();
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+double TechnosoftIpos::getHeartbeatTimeout()
+{
+    return vars.heartbeatTimeout;
+}
+
+// -----------------------------------------------------------------------------
+
+void TechnosoftIpos::onHeartbeatLost(double elapsed)
+{
+    if (vars.heartbeatPeriod != 0.0 && vars.actualControlMode != VOCAB_CM_NOT_CONFIGURED)
+    {
+        yError("Last heartbeat response was %f seconds ago (canId %d)", elapsed, can->getId());
+        vars.actualControlMode = VOCAB_CM_NOT_CONFIGURED;
+        can->nmt()->issueServiceCommand(NmtService::RESET_NODE);
+        can->driveStatus()->reset();
+        vars.reset();
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+void TechnosoftIpos::onBootUp()
+{
+    // configured nodes are reset and reinitialized upon heartbeat loss
+    if (vars.actualControlMode == VOCAB_CM_NOT_CONFIGURED && !initialize())
+    {
+        yError("Unable to initialize CAN comms (canId %d)", can->getId());
+        can->nmt()->issueServiceCommand(NmtService::RESET_NODE);
+    }
+}
+
+// -----------------------------------------------------------------------------
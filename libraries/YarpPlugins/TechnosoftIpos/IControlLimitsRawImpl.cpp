@@ -35,22 +35,16 @@ bool TechnosoftIpos::setLimitsRaw(int axis, double min, double max)
 
 bool TechnosoftIpos::setLimitRaw(double limit, bool isMin)
 {
-    std::string name = "Software position limit: ";
-    std::uint8_t subindex;
+    std::int32_t data = vars.degreesToInternalUnits(limit);
 
     if (isMin ^ vars.reverse)
     {
-        name += "minimal position limit";
-        subindex = 0x01;
+        return can->sdo()->download(IposObjects::MinPositionLimit(), data);
     }
     else
     {
-        name += "maximal position limit";
-        subindex = 0x02;
+        return can->sdo()->download(IposObjects::MaxPositionLimit(), data);
     }
-
-    std::int32_t data = vars.degreesToInternalUnits(limit);
-    return can->sdo()->download(name, data, 0x607D, subindex);
 }
 
 // -----------------------------------------------------------------------------
@@ -74,23 +68,17 @@ bool TechnosoftIpos::getLimitsRaw(int axis, double * min, double * max)
 
 bool TechnosoftIpos::getLimitRaw(double * limit, bool isMin)
 {
-    std::string name = "Software position limit: ";
-    std::uint8_t subindex;
+    auto fn = [this, limit](auto data)
+        { *limit = vars.internalUnitsToDegrees(data); };
 
     if (isMin ^ vars.reverse)
     {
-        name += "minimal position limit";
-        subindex = 0x01;
+        return can->sdo()->upload(IposObjects::MinPositionLimit(), fn);
     }
     else
     {
-        name += "maximal position limit";
-        subindex = 0x02;
+        return can->sdo()->upload(IposObjects::MaxPositionLimit(), fn);
     }
-
-    return can->sdo()->upload<std::int32_t>(name, [this, limit](auto data)
-        { *limit = vars.internalUnitsToDegrees(data); },
-        0x607D, subindex);
 }
 
 // -----------------------------------------------------------------------------
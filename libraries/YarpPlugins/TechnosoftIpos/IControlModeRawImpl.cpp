@@ -9,6 +9,29 @@
 
 using namespace roboticslab;
 
+namespace
+{
+    bool controlModeToDriveState(int mode, DriveState * state)
+    {
+        switch (mode)
+        {
+        case VOCAB_CM_POSITION:
+        case VOCAB_CM_VELOCITY:
+        case VOCAB_CM_CURRENT:
+        case VOCAB_CM_TORQUE:
+        case VOCAB_CM_POSITION_DIRECT:
+            *state = DriveState::OPERATION_ENABLED;
+            return true;
+        case VOCAB_CM_FORCE_IDLE:
+        case VOCAB_CM_IDLE:
+            *state = DriveState::SWITCHED_ON;
+            return true;
+        default:
+            return false;
+        }
+    }
+}
+
 // -----------------------------------------------------------------------------
 
 bool TechnosoftIpos::getControlModeRaw(int j, int * mode)
@@ -40,25 +63,25 @@ bool TechnosoftIpos::setControlModeRaw(int j, int mode)
     yTrace("%d %s", j, yarp::os::Vocab::decode(mode).c_str());
     CHECK_JOINT(j);
 
-    vars.requestedcontrolMode = mode;
-    bool extRefTorque = vars.actualControlMode == VOCAB_CM_TORQUE || vars.actualControlMode == VOCAB_CM_CURRENT;
-
-    if (mode == vars.actualControlMode || (extRefTorque && (mode == VOCAB_CM_CURRENT || mode == VOCAB_CM_TORQUE)))
+    // skip preconditions if already met on behalf of the CAN master, see prepareControlModeRaw()
+    if (vars.preparedControlMode.exchange(0) != mode)
     {
-        vars.actualControlMode.store(vars.requestedcontrolMode.load()); // disambiguate torque/current modes
-        return true;
-    }
+        bool unchanged;
 
-    vars.enableSync = false;
+        if (!prepareControlModeSwitch(mode, &unchanged))
+        {
+            return false;
+        }
 
-    // reset mode-specific bits (4-6) and halt bit (8)
-    if (!can->driveStatus()->controlword(can->driveStatus()->controlword().reset(4).reset(5).reset(6).reset(8)))
-    {
-        return false;
+        if (unchanged)
+        {
+            return true;
+        }
     }
 
-    // bug in F508M/F509M firmware, switch to homing mode to stop controlling external reference torque
-    if (extRefTorque && !can->sdo()->download<std::int8_t>("Modes of Operation", 6, 0x6060))
+    DriveState driveState;
+
+    if (controlModeToDriveState(mode, &driveState) && !can->driveStatus()->requestState(driveState))
     {
         return false;
     }
@@ -69,9 +92,8 @@ bool TechnosoftIpos::setControlModeRaw(int j, int mode)
     switch (mode)
     {
     case VOCAB_CM_POSITION:
-        return can->driveStatus()->requestState(DriveState::OPERATION_ENABLED)
-            && can->sdo()->download<std::int32_t>("Target position", vars.lastEncoderRead->queryPosition(), 0x607A)
-            && can->sdo()->download<std::int8_t>("Modes of Operation", 1, 0x6060)
+        return can->sdo()->download(IposObjects::TargetPosition(), vars.lastEncoderRead->queryPosition())
+            && can->sdo()->download(IposObjects::ModesOfOperation(), static_cast<std::int8_t>(1))
             && can->driveStatus()->controlword(can->driveStatus()->controlword().set(5)) // change set immediately
             && vars.awaitControlMode(mode);
 
@@ -80,19 +102,17 @@ bool TechnosoftIpos::setControlModeRaw(int j, int mode)
 
         if (vars.enableCsv)
         {
-            return can->driveStatus()->requestState(DriveState::OPERATION_ENABLED)
-                && can->rpdo3()->configure(rpdo3conf.addMapping<std::int32_t>(0x607A))
-                && can->sdo()->download<std::uint8_t>("Interpolation time period", vars.syncPeriod * 1000, 0x60C2, 0x01)
-                && can->sdo()->download<std::int8_t>("Interpolation time period", -3, 0x60C2, 0x02)
-                && can->sdo()->download<std::int8_t>("Modes of Operation", 8, 0x6060)
+            return can->rpdo3()->configure(rpdo3conf.addMapping(IposObjects::TargetPosition()))
+                && can->sdo()->download(IposObjects::InterpolationTimePeriodValue(), static_cast<std::uint8_t>(vars.syncPeriod * 1000))
+                && can->sdo()->download(IposObjects::InterpolationTimeIndex(), static_cast<std::int8_t>(-3))
+                && can->sdo()->download(IposObjects::ModesOfOperation(), static_cast<std::int8_t>(8))
                 && can->driveStatus()->controlword(can->driveStatus()->controlword().set(6)) // relative position mode
                 && vars.awaitControlMode(mode);
         }
         else
         {
-            return can->driveStatus()->requestState(DriveState::OPERATION_ENABLED)
-                && can->rpdo3()->configure(rpdo3conf.addMapping<std::int32_t>(0x60FF))
-                && can->sdo()->download<std::int8_t>("Modes of Operation", 3, 0x6060)
+            return can->rpdo3()->configure(rpdo3conf.addMapping(IposObjects::TargetVelocity()))
+                && can->sdo()->download(IposObjects::ModesOfOperation(), static_cast<std::int8_t>(3))
                 && vars.awaitControlMode(mode);
         }
 
@@ -100,10 +120,9 @@ bool TechnosoftIpos::setControlModeRaw(int j, int mode)
     case VOCAB_CM_TORQUE:
         vars.synchronousCommandTarget = 0.0;
 
-        return can->driveStatus()->requestState(DriveState::OPERATION_ENABLED)
-            && can->rpdo3()->configure(rpdo3conf.addMapping<std::int32_t>(0x201C))
-            && can->sdo()->download<std::uint16_t>("External Reference Type", 1, 0x201D)
-            && can->sdo()->download<std::int8_t>("Modes of Operation", -5, 0x6060)
+        return can->rpdo3()->configure(rpdo3conf.addMapping(IposObjects::ExternalOnlineReference()))
+            && can->sdo()->download(IposObjects::ExternalReferenceType(), static_cast<std::uint16_t>(1))
+            && can->sdo()->download(IposObjects::ModesOfOperation(), static_cast<std::int8_t>(-5))
             && can->driveStatus()->controlword(can->driveStatus()->controlword().set(4)) // new setpoint (assume target position)
             && vars.awaitControlMode(mode);
 
@@ -112,52 +131,35 @@ bool TechnosoftIpos::setControlModeRaw(int j, int mode)
         {
             vars.ipBufferFilled = vars.ipMotionStarted = false;
             vars.ipBufferEnabled = true;
+            vars.ipMotionStartTime = 0.0;
             ipBuffer->clearQueue();
 
             PdoConfiguration rpdo3Conf;
-            rpdo3Conf.addMapping<std::uint32_t>(0x60C1, 0x01);
-            rpdo3Conf.addMapping<std::uint32_t>(0x60C1, 0x02);
-
-            return can->driveStatus()->requestState(DriveState::OPERATION_ENABLED)
-                && can->rpdo3()->configure(rpdo3Conf)
-                && can->sdo()->download<std::uint16_t>("Auxiliary Settings Register", 0x0000, 0x208E) // legacy ip mode
-                && can->sdo()->download("Interpolation sub mode select", ipBuffer->getSubMode(), 0x60C0)
-                && can->sdo()->download("Interpolated position buffer length", ipBuffer->getBufferSize(), 0x2073)
-                && can->sdo()->download("Interpolated position buffer configuration", ipBuffer->getBufferConfig(), 0x2074)
-                && can->sdo()->download<std::int8_t>("Modes of Operation", 7, 0x6060)
+            rpdo3Conf.addMapping(IposObjects::InterpolationDataRecord1());
+            rpdo3Conf.addMapping(IposObjects::InterpolationDataRecord2());
+
+            return can->rpdo3()->configure(rpdo3Conf)
+                && can->sdo()->download(IposObjects::AuxiliarySettingsRegister(), static_cast<std::uint16_t>(0x0000)) // legacy ip mode
+                && can->sdo()->download(IposObjects::InterpolationSubModeSelect(), ipBuffer->getSubMode())
+                && can->sdo()->download(IposObjects::InterpolatedPositionBufferLength(), ipBuffer->getBufferSize())
+                && can->sdo()->download(IposObjects::InterpolatedPositionBufferConfiguration(), ipBuffer->getBufferConfig())
+                && can->sdo()->download(IposObjects::ModesOfOperation(), static_cast<std::int8_t>(7))
                 && vars.awaitControlMode(VOCAB_CM_POSITION_DIRECT);
         }
 
-        // bug in F508M/F509M firmware, switch to homing mode to stop controlling profile velocity
-        if (vars.actualControlMode == VOCAB_CM_VELOCITY && !vars.enableCsv
-            && !can->sdo()->download<std::int8_t>("Modes of Operation", 6, 0x6060))
-        {
-            return false;
-        }
-
         vars.synchronousCommandTarget = vars.internalUnitsToDegrees(vars.lastEncoderRead->queryPosition());
         vars.prevSyncTarget.store(vars.synchronousCommandTarget);
+        syncInterpolator->reset(vars.synchronousCommandTarget);
 
-        return can->driveStatus()->requestState(DriveState::OPERATION_ENABLED)
-            && can->rpdo3()->configure(rpdo3conf.addMapping<std::int32_t>(0x607A))
-            && can->sdo()->download<std::uint8_t>("Interpolation time period", vars.syncPeriod * 1000, 0x60C2, 0x01)
-            && can->sdo()->download<std::int8_t>("Interpolation time period", -3, 0x60C2, 0x02)
-            && can->sdo()->download<std::int8_t>("Modes of Operation", 8, 0x6060)
+        return can->rpdo3()->configure(rpdo3conf.addMapping(IposObjects::TargetPosition()))
+            && can->sdo()->download(IposObjects::InterpolationTimePeriodValue(), static_cast<std::uint8_t>(vars.syncPeriod * 1000))
+            && can->sdo()->download(IposObjects::InterpolationTimeIndex(), static_cast<std::int8_t>(-3))
+            && can->sdo()->download(IposObjects::ModesOfOperation(), static_cast<std::int8_t>(8))
             && vars.awaitControlMode(mode);
 
     case VOCAB_CM_FORCE_IDLE:
-        if (vars.actualControlMode == VOCAB_CM_HW_FAULT
-            && !can->driveStatus()->requestTransition(DriveTransition::FAULT_RESET))
-        {
-            yError("Unable to reset fault status");
-            return false;
-        }
-
-        // no break
-
     case VOCAB_CM_IDLE:
-        return can->driveStatus()->requestState(DriveState::SWITCHED_ON)
-            && can->sdo()->download<std::int8_t>("Modes of Operation", 0, 0x6060); // reset drive mode
+        return can->sdo()->download(IposObjects::ModesOfOperation(), static_cast<std::int8_t>(0)); // reset drive mode
 
     default:
         yError("Unsupported, unknown or read-only mode: %s", yarp::os::Vocab::decode(mode).c_str());
@@ -167,6 +169,76 @@ bool TechnosoftIpos::setControlModeRaw(int j, int mode)
 
 // -----------------------------------------------------------------------------
 
+bool TechnosoftIpos::prepareControlModeSwitch(int mode, bool * unchanged)
+{
+    vars.requestedcontrolMode = mode;
+    bool extRefTorque = vars.actualControlMode == VOCAB_CM_TORQUE || vars.actualControlMode == VOCAB_CM_CURRENT;
+
+    if (mode == vars.actualControlMode || (extRefTorque && (mode == VOCAB_CM_CURRENT || mode == VOCAB_CM_TORQUE)))
+    {
+        vars.actualControlMode.store(vars.requestedcontrolMode.load()); // disambiguate torque/current modes
+        *unchanged = true;
+        return true;
+    }
+
+    *unchanged = false;
+    vars.enableSync = false;
+
+    // reset mode-specific bits (4-6) and halt bit (8)
+    if (!can->driveStatus()->controlword(can->driveStatus()->controlword().reset(4).reset(5).reset(6).reset(8)))
+    {
+        return false;
+    }
+
+    // bug in F508M/F509M firmware, switch to homing mode to stop controlling external reference torque
+    if (extRefTorque && !can->sdo()->download(IposObjects::ModesOfOperation(), static_cast<std::int8_t>(6)))
+    {
+        return false;
+    }
+
+    // bug in F508M/F509M firmware, switch to homing mode to stop controlling profile velocity
+    if (mode == VOCAB_CM_POSITION_DIRECT && !ipBuffer && vars.actualControlMode == VOCAB_CM_VELOCITY && !vars.enableCsv
+        && !can->sdo()->download(IposObjects::ModesOfOperation(), static_cast<std::int8_t>(6)))
+    {
+        return false;
+    }
+
+    if (mode == VOCAB_CM_FORCE_IDLE && vars.actualControlMode == VOCAB_CM_HW_FAULT
+        && !can->driveStatus()->requestTransition(DriveTransition::FAULT_RESET))
+    {
+        yError("Unable to reset fault status");
+        return false;
+    }
+
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+bool TechnosoftIpos::prepareControlModeRaw(int mode, DriveState * state)
+{
+    yTrace("%s", yarp::os::Vocab::decode(mode).c_str());
+
+    // faulted and unconfigured drives need per-node handling, which also reports errors
+    if (vars.actualControlMode == VOCAB_CM_HW_FAULT || vars.actualControlMode == VOCAB_CM_NOT_CONFIGURED
+        || !controlModeToDriveState(mode, state))
+    {
+        return false;
+    }
+
+    bool unchanged;
+
+    if (!prepareControlModeSwitch(mode, &unchanged) || unchanged)
+    {
+        return false;
+    }
+
+    vars.preparedControlMode = mode;
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
 bool TechnosoftIpos::setControlModesRaw(int * modes)
 {
     return setControlModeRaw(0, modes[0]);
@@ -31,10 +31,9 @@ bool TechnosoftIpos::getCurrentRangeRaw(int m, double * min, double * max)
     yTrace("%d", m);
     CHECK_JOINT(m);
 
-    return can->sdo()->upload<std::uint16_t>("Current limit", [this, min, max](auto data)
+    return can->sdo()->upload(IposObjects::CurrentLimit(), [this, min, max](auto data)
         { *max = vars.internalUnitsToPeakCurrent(data);
-          *min = -(*max); },
-        0x207F);
+          *min = -(*max); });
 }
 
 // -----------------------------------------------------------------------------
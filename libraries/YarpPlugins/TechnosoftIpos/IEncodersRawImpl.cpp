@@ -38,7 +38,7 @@ bool TechnosoftIpos::setEncoderRaw(int j, double val)
     CHECK_JOINT(j);
     std::int32_t data = vars.degreesToInternalUnits(val);
 
-    if (!can->sdo()->download("Set actual position", data, 0X2081))
+    if (!can->sdo()->download(IposObjects::SetActualPosition(), data))
     {
         return false;
     }
@@ -36,6 +36,7 @@ bool TechnosoftIpos::setMotorEncoderCountsPerRevolutionRaw(int m, double cpr)
     yTrace("%d %f", m, cpr);
     CHECK_JOINT(m);
     vars.encoderPulses = cpr;
+    vars.updateConversionFactors();
     return true;
 }
 
@@ -57,7 +58,7 @@ bool TechnosoftIpos::setMotorEncoderRaw(int m, double val)
     CHECK_JOINT(m);
     std::int32_t data = vars.reverse ? -val : val;
 
-    if (!can->sdo()->download("Set actual position", data, 0X2081))
+    if (!can->sdo()->download(IposObjects::SetActualPosition(), data))
     {
         return false;
     }
@@ -62,6 +62,7 @@ bool TechnosoftIpos::setGearboxRatioRaw(int m, double val)
     yTrace("%d %f", m, val);
     CHECK_JOINT(m);
     vars.tr = val;
+    vars.updateConversionFactors();
     return true;
 }
 
@@ -19,7 +19,7 @@ bool TechnosoftIpos::positionMoveRaw(int j, double ref)
     CHECK_MODE(VOCAB_CM_POSITION);
 
     return !can->driveStatus()->controlword()[8] // check halt bit
-        && can->sdo()->download<std::int32_t>("Target position", vars.degreesToInternalUnits(ref), 0x607A)
+        && can->sdo()->download(IposObjects::TargetPosition(), static_cast<std::int32_t>(vars.degreesToInternalUnits(ref)))
         // new setpoint (assume absolute target position)
         && can->driveStatus()->controlword(can->driveStatus()->controlword().set(4).reset(6));
 }
@@ -47,7 +47,7 @@ bool TechnosoftIpos::relativeMoveRaw(int j, double delta)
     CHECK_MODE(VOCAB_CM_POSITION);
 
     return !can->driveStatus()->controlword()[8] // check halt bit
-        && can->sdo()->download<std::int32_t>("Target position", vars.degreesToInternalUnits(delta), 0x607A)
+        && can->sdo()->download(IposObjects::TargetPosition(), static_cast<std::int32_t>(vars.degreesToInternalUnits(delta)))
         // new setpoint (assume relative target position)
         && can->driveStatus()->controlword(can->driveStatus()->controlword().set(4).set(6));
 }
@@ -116,7 +116,7 @@ bool TechnosoftIpos::setRefSpeedRaw(int j, double sp)
 
     std::uint32_t data = (dataInt << 16) + dataFrac;
 
-    if (!can->sdo()->download("Profile velocity", data, 0x6081))
+    if (!can->sdo()->download(IposObjects::ProfileVelocity(), data))
     {
         return false;
     }
@@ -160,7 +160,7 @@ bool TechnosoftIpos::setRefAccelerationRaw(int j, double acc)
 
     std::uint32_t data = (dataInt << 16) + dataFrac;
 
-    if (!can->sdo()->download("Profile acceleration", data, 0x6083))
+    if (!can->sdo()->download(IposObjects::ProfileAcceleration(), data))
     {
         return false;
     }
@@ -196,14 +196,13 @@ bool TechnosoftIpos::getRefSpeedRaw(int j, double * ref)
         return true;
     }
 
-    return can->sdo()->upload<std::uint32_t>("Profile velocity", [this, ref](auto data)
+    return can->sdo()->upload(IposObjects::ProfileVelocity(), [this, ref](auto data)
         {
             std::uint16_t dataInt = data >> 16;
             std::uint16_t dataFrac = data & 0xFFFF;
             double value = CanUtils::decodeFixedPoint(dataInt, dataFrac);
             *ref = std::abs(vars.internalUnitsToDegrees(value, 1));
-        },
-        0x6081);
+        });
 }
 
 // --------------------------------------------------------------------------------
@@ -233,14 +232,13 @@ bool TechnosoftIpos::getRefAccelerationRaw(int j, double * acc)
         return true;
     }
 
-    return can->sdo()->upload<std::uint32_t>("Profile acceleration", [this, acc](auto data)
+    return can->sdo()->upload(IposObjects::ProfileAcceleration(), [this, acc](auto data)
         {
             std::uint16_t dataInt = data >> 16;
             std::uint16_t dataFrac = data & 0xFFFF;
             double value = CanUtils::decodeFixedPoint(dataInt, dataFrac);
             *acc = std::abs(vars.internalUnitsToDegrees(value, 2));
-        },
-        0x6083);
+        });
 }
 
 // --------------------------------------------------------------------------------
@@ -290,9 +288,8 @@ bool TechnosoftIpos::getTargetPositionRaw(int joint, double * ref)
     yTrace("%d", joint);
     CHECK_JOINT(joint);
 
-    return can->sdo()->upload<std::int32_t>("Target position", [this, ref](auto data)
-        { *ref = vars.internalUnitsToDegrees(data); },
-        0x607A);
+    return can->sdo()->upload(IposObjects::TargetPosition(), [this, ref](auto data)
+        { *ref = vars.internalUnitsToDegrees(data); });
 }
 
 // --------------------------------------------------------------------------------
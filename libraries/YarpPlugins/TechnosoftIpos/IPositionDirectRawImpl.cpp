@@ -2,7 +2,9 @@
 
 #include "TechnosoftIpos.hpp"
 
+#include <yarp/os/Bottle.h>
 #include <yarp/os/Log.h>
+#include <yarp/os/Time.h>
 
 using namespace roboticslab;
 
@@ -16,28 +18,24 @@ bool TechnosoftIpos::setPositionRaw(int j, double ref)
 
     if (ipBuffer)
     {
-        ipBuffer->addSetpoint(ref); // register point in the internal queue
+        if (!ipBuffer->addSetpoint(ref)) // register point in the internal queue
+        {
+            yWarning("Interpolation queue is full, setpoint dropped (canId %d)", can->getId());
+            return false;
+        }
 
         // ip mode is enabled, drive's buffer is empty, motion has not started yet, we have enough points in the queue
         if (vars.ipBufferEnabled && !vars.ipBufferFilled && !vars.ipMotionStarted && ipBuffer->isQueueReady())
         {
             std::int32_t refInternal = vars.lastEncoderRead->queryPosition();
             ipBuffer->setInitial(vars.internalUnitsToDegrees(refInternal));
-
-            bool ok = true;
-
-            for (auto setpoint : ipBuffer->popBatch(true))
-            {
-                ok &= can->rpdo3()->write(setpoint); // load point into the buffer
-            }
-
-            vars.ipBufferFilled = ok;
-            return ok;
+            return loadIpBuffer();
         }
     }
     else
     {
         vars.synchronousCommandTarget = ref;
+        syncInterpolator->addSetpoint(ref, yarp::os::Time::now());
     }
 
     return true;
@@ -91,3 +89,179 @@ bool TechnosoftIpos::getRefPositionsRaw(int n_joint, const int * joints, double
 }
 
 // -----------------------------------------------------------------------------
+
+bool TechnosoftIpos::loadIpBuffer()
+{
+    bool ok = true;
+
+    for (auto setpoint : ipBuffer->popBatch(true))
+    {
+        ok &= can->rpdo3()->write(setpoint); // load point into the buffer
+    }
+
+    vars.ipBufferFilled = ok;
+    return ok;
+}
+
+// -----------------------------------------------------------------------------
+
+bool TechnosoftIpos::startIpMotion()
+{
+    vars.ipMotionStartTime = 0.0;
+    vars.ipMotionStarted = can->driveStatus()->controlword(can->driveStatus()->controlword().set(4));
+    return vars.ipMotionStarted;
+}
+
+// -----------------------------------------------------------------------------
+
+bool TechnosoftIpos::uploadTrajectory(const yarp::os::Searchable & config)
+{
+    if (!ipBuffer)
+    {
+        yError("Interpolated position mode is not enabled, see \"linInterp\" (canId %d)", can->getId());
+        return false;
+    }
+
+    if (vars.actualControlMode != VOCAB_CM_POSITION_DIRECT || !vars.ipBufferEnabled)
+    {
+        yError("Not in interpolated position mode (canId %d)", can->getId());
+        return false;
+    }
+
+    if (vars.ipBufferFilled || vars.ipMotionStarted || !ipBuffer->isQueueEmpty())
+    {
+        yError("Interpolated motion already in progress (canId %d)", can->getId());
+        return false;
+    }
+
+    const yarp::os::Value & positionsValue = config.find("positions");
+
+    if (!positionsValue.isList() || positionsValue.asList()->size() == 0)
+    {
+        yError("Missing or empty \"positions\" list (canId %d)", can->getId());
+        return false;
+    }
+
+    const yarp::os::Bottle * positions = positionsValue.asList();
+    const int size = positions->size();
+    const double period = ipBuffer->getPeriodMs() * 0.001;
+
+    if (static_cast<std::size_t>(size) > ipBuffer->getQueueCapacity())
+    {
+        yError("Trajectory too long: %d points, up to %zu allowed (canId %d)", size, ipBuffer->getQueueCapacity(), can->getId());
+        return false;
+    }
+
+    const yarp::os::Bottle * times = nullptr;
+
+    if (config.check("times"))
+    {
+        if (period != 0.0)
+        {
+            yError("Option \"times\" is not allowed with a fixed period (canId %d)", can->getId());
+            return false;
+        }
+
+        times = config.find("times").asList();
+
+        if (!times || times->size() != size)
+        {
+            yError("Option \"times\" must be a list of %d elements (canId %d)", size, can->getId());
+            return false;
+        }
+
+        double previous = 0.0;
+
+        for (int i = 0; i < size; i++)
+        {
+            double t = times->get(i).asFloat64();
+
+            if (t <= previous)
+            {
+                yError("Times must be positive and strictly increasing (canId %d)", can->getId());
+                return false;
+            }
+
+            previous = t;
+        }
+    }
+    else if (period == 0.0)
+    {
+        yError("Missing \"times\" list, required unless a fixed period is configured (canId %d)", can->getId());
+        return false;
+    }
+
+    const yarp::os::Bottle * velocities = nullptr;
+
+    if (config.check("velocities"))
+    {
+        if (ipBuffer->getType() != "pvt")
+        {
+            yError("Option \"velocities\" requires pvt mode (canId %d)", can->getId());
+            return false;
+        }
+
+        velocities = config.find("velocities").asList();
+
+        if (!velocities || velocities->size() != size)
+        {
+            yError("Option \"velocities\" must be a list of %d elements (canId %d)", size, can->getId());
+            return false;
+        }
+    }
+
+    double start = yarp::os::Time::now();
+
+    if (config.check("start"))
+    {
+        if (vars.syncPeriod <= 0.0)
+        {
+            yError("Option \"start\" requires a SYNC period (canId %d)", can->getId());
+            return false;
+        }
+
+        if (config.find("start").asFloat64() < start)
+        {
+            yError("Start time has already passed (canId %d)", can->getId());
+            return false;
+        }
+
+        start = config.find("start").asFloat64();
+    }
+
+    std::int32_t refInternal = vars.lastEncoderRead->queryPosition();
+    ipBuffer->setInitial(vars.internalUnitsToDegrees(refInternal), start);
+
+    for (int i = 0; i < size; i++)
+    {
+        double position = positions->get(i).asFloat64();
+        double timestamp = start + (times ? times->get(i).asFloat64() : (i + 1) * period);
+
+        bool ok = velocities ? ipBuffer->addSetpoint(position, velocities->get(i).asFloat64(), timestamp)
+                             : ipBuffer->addSetpoint(position, timestamp);
+
+        if (!ok)
+        {
+            yError("Interpolation queue is full (canId %d)", can->getId());
+            ipBuffer->clearQueue();
+            return false;
+        }
+    }
+
+    vars.ipMotionStartTime = start; // hold off the start on buffer-full events
+
+    if (!loadIpBuffer())
+    {
+        yError("Unable to load the drive's buffer (canId %d)", can->getId());
+        vars.ipMotionStartTime = 0.0;
+        ipBuffer->clearQueue();
+        return false;
+    }
+
+    yInfo("Uploaded trajectory of %d points starting at %f (canId %d)", size, start, can->getId());
+
+    // without SYNC, start right away; otherwise, wait for the scheduled SYNC cycle
+    return vars.syncPeriod > 0.0 || startIpMotion();
+}
+
+// -----------------------------------------------------------------------------
@@ -2,6 +2,10 @@
 
 #include "TechnosoftIpos.hpp"
 
+#include <cstdio>
+
+#include <utility>
+
 #include <yarp/os/Log.h>
 #include <yarp/os/Property.h>
 
@@ -9,6 +13,65 @@ using namespace roboticslab;
 
 // -----------------------------------------------------------------------------
 
+namespace
+{
+    std::string toHex(unsigned int value, int width)
+    {
+        char buf[11];
+        std::snprintf(buf, sizeof(buf), "0x%0*X", width, value);
+        return buf;
+    }
+
+    void addSdoStats(const std::string & label, const SdoStatistics::object_stats & stats, yarp::os::Bottle & val)
+    {
+        yarp::os::Bottle & b = val.addList();
+        b.addString(label);
+
+        yarp::os::Bottle & count = b.addList();
+        count.addString("count");
+        count.addInt64(stats.count);
+
+        yarp::os::Bottle & p50 = b.addList();
+        p50.addString("p50");
+        p50.addFloat64(stats.p50);
+
+        yarp::os::Bottle & p99 = b.addList();
+        p99.addString("p99");
+        p99.addFloat64(stats.p99);
+
+        yarp::os::Bottle & max = b.addList();
+        max.addString("max");
+        max.addFloat64(stats.max);
+
+        yarp::os::Bottle & timeouts = b.addList();
+        timeouts.addString("timeouts");
+        timeouts.addInt64(stats.timeouts);
+
+        yarp::os::Bottle & errors = b.addList();
+        errors.addString("errors");
+        errors.addInt64(stats.errors);
+
+        yarp::os::Bottle & retries = b.addList();
+        retries.addString("retries");
+        retries.addInt64(stats.retries);
+
+        yarp::os::Bottle & aborts = b.addList();
+        aborts.addString("aborts");
+        aborts.addInt64(stats.aborts);
+
+        yarp::os::Bottle & codes = aborts.addList();
+
+        for (const auto & code : stats.abortCodes)
+        {
+            yarp::os::Bottle & c = codes.addList();
+            c.addString(toHex(code.first, 8));
+            c.addInt64(code.second);
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+
 bool TechnosoftIpos::getRemoteVariableRaw(std::string key, yarp::os::Bottle & val)
 {
     yTrace("%s: %s", key.c_str(), val.toString().c_str());
@@ -40,6 +103,140 @@ bool TechnosoftIpos::getRemoteVariableRaw(std::string key, yarp::os::Bottle & va
         list.addInt8(vars.enableCsv);
         return true;
     }
+    else if (key == "trajectory")
+    {
+        yarp::os::Bottle & list = val.addList();
+
+        yarp::os::Bottle & pending = list.addList();
+        pending.addString("pending");
+        pending.addInt64(ipBuffer ? ipBuffer->getQueueSize() : 0);
+
+        yarp::os::Bottle & start = list.addList();
+        start.addString("start");
+        start.addFloat64(vars.ipMotionStartTime);
+
+        yarp::os::Bottle & started = list.addList();
+        started.addString("started");
+        started.addInt8(vars.ipMotionStarted);
+
+        return true;
+    }
+    else if (key == "csp")
+    {
+        yarp::os::Bottle & list = val.addList();
+
+        yarp::os::Bottle & mode = list.addList();
+        mode.addString("mode");
+        mode.addString(SyncInterpolator::modeToString(syncInterpolator->getMode()));
+
+        const auto stats = syncInterpolator->getJitterStatistics();
+
+        yarp::os::Bottle & count = list.addList();
+        count.addString("count");
+        count.addInt64(stats.count);
+
+        const std::pair<const char *, double> entries[] = {
+            {"meanPeriod", stats.meanPeriod},
+            {"stddev", stats.stddev},
+            {"minPeriod", stats.minPeriod},
+            {"maxPeriod", stats.maxPeriod},
+            {"estimate", stats.estimate}
+        };
+
+        for (const auto & entry : entries)
+        {
+            yarp::os::Bottle & b = list.addList();
+            b.addString(entry.first);
+            b.addFloat64(entry.second);
+        }
+
+        return true;
+    }
+    else if (key == "telemetry")
+    {
+        yarp::os::Property & dict = val.addDict();
+
+        // only objects mapped into a TPDO are reported
+        if (vars.tpdoMappedObjects.count(IposObjects::VelocityActualValue::index))
+        {
+            dict.put("velocity", vars.internalUnitsToDegrees(vars.lastVelocityRead, 1));
+        }
+
+        if (vars.tpdoMappedObjects.count(IposObjects::DCLinkVoltage::index))
+        {
+            dict.put("dcLinkVoltage", vars.lastDcLinkVoltage.load());
+        }
+
+        return true;
+    }
+    else if (key == "emcy")
+    {
+        yarp::os::Bottle & list = val.addList();
+
+        for (const auto & record : can->emcy()->getHistory())
+        {
+            yarp::os::Bottle & b = list.addList();
+            b.addInt64(record.seq);
+            b.addFloat64(record.timestamp);
+            b.addInt32(record.code);
+            b.addString(can->emcy()->codeToMessage(record.code).second);
+            b.addInt32(record.reg);
+
+            yarp::os::Bottle & msef = b.addList();
+
+            for (auto byte : record.msef)
+            {
+                msef.addInt32(byte);
+            }
+        }
+
+        return true;
+    }
+    else if (key == "sdo")
+    {
+        yarp::os::Bottle & list = val.addList();
+        const auto & stats = can->sdo()->getStatistics();
+
+        addSdoStats("total", stats.getSummary(), list);
+
+        yarp::os::Bottle & total = *list.get(0).asList();
+
+        yarp::os::Bottle & timeout = total.addList();
+        timeout.addString("timeout");
+        timeout.addFloat64(can->sdo()->getTimeout());
+
+        yarp::os::Bottle & srtt = total.addList();
+        srtt.addString("srtt");
+        srtt.addFloat64(can->sdo()->getSmoothedRtt());
+
+        for (const auto & object : stats.getObjectStats())
+        {
+            addSdoStats(toHex(object.index, 4) + ":" + toHex(object.subindex, 2).substr(2), object, list);
+        }
+
+        return true;
+    }
+    else if (key == "sync")
+    {
+        yarp::os::Bottle & list = val.addList();
+
+        const std::pair<const char *, std::uint64_t> entries[] = {
+            {"cycle", syncCycles.getCycle()},
+            {"tpdoCycle", vars.lastSyncCycle},
+            {"completeCycle", syncCycles.getLastCompleteCycle()},
+            {"lost", syncCycles.getLostCount()},
+            {"late", syncCycles.getLateCount()}
+        };
+
+        for (const auto & entry : entries)
+        {
+            yarp::os::Bottle & b = list.addList();
+            b.addString(entry.first);
+            b.addInt64(entry.second);
+        }
+
+        return true;
+    }
 
     yError("Unsupported key: \"%s\"", key.c_str());
     return false;
@@ -106,6 +303,73 @@ bool TechnosoftIpos::setRemoteVariableRaw(std::string key, const yarp::os::Bottl
 
         return true;
     }
+    else if (key == "trajectory")
+    {
+        if (val.size() == 0 || (!val.get(0).isDict() && !val.get(0).isList()))
+        {
+            yError("Empty value or not a dict (canId %d)", can->getId());
+            return false;
+        }
+
+        if (val.get(0).isDict())
+        {
+            return uploadTrajectory(*val.get(0).asDict()); // C++ API
+        }
+        else
+        {
+            return uploadTrajectory(*val.get(0).asList()); // CLI (RPC via terminal)
+        }
+    }
+    else if (key == "sdo")
+    {
+        if (!val.check("reset") || !val.find("reset").asBool())
+        {
+            yError("Missing or false \"reset\" option (canId %d)", can->getId());
+            return false;
+        }
+
+        can->sdo()->resetStatistics();
+        return true;
+    }
+    else if (key == "sync")
+    {
+        if (!val.check("reset") || !val.find("reset").asBool())
+        {
+            yError("Missing or false \"reset\" option (canId %d)", can->getId());
+            return false;
+        }
+
+        syncCycles.resetCounters();
+        return true;
+    }
+    else if (key == "csp")
+    {
+        if (!val.check("mode") && !val.check("reset"))
+        {
+            yError("Missing \"mode\" or \"reset\" option (canId %d)", can->getId());
+            return false;
+        }
+
+        if (val.check("mode"))
+        {
+            SyncInterpolator::mode mode;
+
+            if (!SyncInterpolator::parseMode(val.find("mode").asString(), &mode))
+            {
+                yError("Illegal CSP interpolation mode: %s (canId %d)", val.find("mode").asString().c_str(), can->getId());
+                return false;
+            }
+
+            syncInterpolator->setMode(mode); // applies from the next setpoint on
+        }
+
+        if (val.check("reset") && val.find("reset").asBool())
+        {
+            syncInterpolator->resetJitterStatistics();
+        }
+
+        return true;
+    }
     else if (key == "csv")
     {
         if (!val.check("enable"))
@@ -148,7 +412,13 @@ bool TechnosoftIpos::getRemoteVariablesListRaw(yarp::os::Bottle * listOfKeys)
 
     // Place each key in its own list so that clients can just call check('<key>') or !find('<key>').isNull().
     listOfKeys->addString("linInterp");
+    listOfKeys->addString("trajectory");
+    listOfKeys->addString("csp");
     listOfKeys->addString("csv");
+    listOfKeys->addString("telemetry");
+    listOfKeys->addString("emcy");
+    listOfKeys->addString("sdo");
+    listOfKeys->addString("sync");
 
     return true;
 }
@@ -68,11 +68,10 @@ bool TechnosoftIpos::getTorqueRangeRaw(int j, double * min, double * max)
     yTrace("%d", j);
     CHECK_JOINT(j);
 
-    return can->sdo()->upload<std::uint16_t>("Current limit", [this, min, max](auto data)
+    return can->sdo()->upload(IposObjects::CurrentLimit(), [this, min, max](auto data)
         { double temp = vars.internalUnitsToPeakCurrent(data);
           *max = vars.currentToTorque(temp);
-          *min = -(*max); },
-        0x207F);
+          *min = -(*max); });
 }
 
 // -------------------------------------------------------------------------------------
@@ -104,6 +103,7 @@ bool TechnosoftIpos::setMotorTorqueParamsRaw(int j, const yarp::dev::MotorTorque
     yTrace("%d", j);
     CHECK_JOINT(j);
     vars.k = params.ktau;
+    vars.updateConversionFactors();
     return true;
 }
 
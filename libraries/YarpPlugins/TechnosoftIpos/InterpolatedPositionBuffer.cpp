@@ -7,7 +7,6 @@
 
 #include <algorithm>
 #include <bitset>
-#include <iterator>
 
 #include <yarp/os/LogStream.h>
 #include <yarp/os/Time.h>
@@ -23,22 +22,32 @@ namespace
     constexpr std::size_t PT_BUFFER_MAX = 9; // 285 if properly configured
     constexpr std::size_t PVT_BUFFER_MAX = 7; // 222 if properly configured
     constexpr std::size_t BUFFER_LOW = 4; // max: 15
+    constexpr std::size_t QUEUE_CAPACITY = 1024; // pending setpoints
 }
 
 InterpolatedPositionBuffer::InterpolatedPositionBuffer(const StateVariables & _vars, int periodMs)
     : vars(_vars),
       fixedSamples(periodMs * 0.001 / vars.samplingPeriod),
       integrityCounter(0),
-      prevTarget({0.0, 0.0}),
+      prevTarget({0.0, 0.0, 0.0, false}),
+      lastLoadedTarget(0.0),
       initialTimestamp(0.0),
-      sampleCount(0)
-{ }
+      sampleCount(0),
+      pendingTargets(QUEUE_CAPACITY)
+{
+    batch.reserve(std::max(PT_BUFFER_MAX, PVT_BUFFER_MAX));
+}
 
 void InterpolatedPositionBuffer::setInitial(double initialTarget)
 {
-    std::lock_guard<std::mutex> lock(queueMutex);
-    initialTimestamp = 0.0; // dummy timestamp, to be amended later on
-    prevTarget = {initialTarget, initialTimestamp};
+    setInitial(initialTarget, 0.0); // dummy timestamp, to be amended later on
+}
+
+void InterpolatedPositionBuffer::setInitial(double initialTarget, double _initialTimestamp)
+{
+    initialTimestamp = _initialTimestamp;
+    prevTarget = {initialTarget, initialTimestamp, 0.0, false};
+    lastLoadedTarget = initialTarget;
     sampleCount = 0;
 }
 
@@ -55,27 +64,41 @@ std::uint16_t InterpolatedPositionBuffer::getBufferConfig() const
     return bits.to_ulong();
 }
 
-void InterpolatedPositionBuffer::addSetpoint(double target)
+bool InterpolatedPositionBuffer::addSetpoint(double target)
 {
-    std::lock_guard<std::mutex> lock(queueMutex);
-    pendingTargets.push_back({target, yarp::os::Time::now()});
+    return addSetpoint(target, yarp::os::Time::now());
 }
 
-std::vector<std::uint64_t> InterpolatedPositionBuffer::popBatch(bool fullBuffer)
+bool InterpolatedPositionBuffer::addSetpoint(double target, double timestamp)
 {
-    std::lock_guard<std::mutex> lock(queueMutex);
+    std::lock_guard<std::mutex> lock(producerMutex);
+    return pendingTargets.push({target, timestamp, 0.0, false});
+}
 
-    if (pendingTargets.empty())
+bool InterpolatedPositionBuffer::addSetpoint(double target, double velocity, double timestamp)
+{
+    std::lock_guard<std::mutex> lock(producerMutex);
+    return pendingTargets.push({target, timestamp, velocity, true});
+}
+
+const std::vector<std::uint64_t> & InterpolatedPositionBuffer::popBatch(bool fullBuffer)
+{
+    batch.clear(); // keeps capacity
+
+    // take a snapshot, client threads may keep adding points in the meantime
+    const std::size_t queued = pendingTargets.size();
+
+    if (queued == 0)
     {
-        return {};
+        return batch;
     }
 
-    if (prevTarget.second == 0.0 && pendingTargets.size() > 1)
+    if (prevTarget.timestamp == 0.0 && queued > 1)
     {
         // Prior to initializing motion, prevTarget is a dummy setpoint referring to current
         // joint position. Infer timestamp from first two stored points.
-        auto diff = pendingTargets[1].second - pendingTargets[0].second;
-        initialTimestamp = prevTarget.second = pendingTargets[0].second - diff;
+        auto diff = pendingTargets.peek(1).timestamp - pendingTargets.peek(0).timestamp;
+        initialTimestamp = prevTarget.timestamp = pendingTargets.peek(0).timestamp - diff;
     }
 
     // This method may be called in any of these two circumstances:
@@ -83,55 +106,58 @@ std::vector<std::uint64_t> InterpolatedPositionBuffer::popBatch(bool fullBuffer)
     // - fullBuffer == false: replenish HW buffer on buffer-low signal, substract fixed threshold from max size.
     const std::size_t batchSize = fullBuffer ? getBufferSize() : getBufferSize() - BUFFER_LOW;
 
-    std::vector<std::uint64_t> batch;
-    batch.reserve(batchSize);
-
     // This correction is necessary to make sure that pendingTargets is fully processed in case
     // there is exactly one point left, even if the submode (i.e. PVT) uses an intrinsic offset.
-    const std::size_t pending = std::max(pendingTargets.size() - getOffset(), getOffset());
+    const std::size_t pending = std::max(queued - getOffset(), getOffset());
+    const std::size_t count = std::min(batchSize, pending);
 
-    std::generate_n(std::back_inserter(batch), std::min(batchSize, pending),
-        [this]
-        {
-            // Pop first point from queue (FIFO).
-            ip_record currTarget = pendingTargets.front();
-            pendingTargets.pop_front();
+    for (std::size_t i = 0; i < count; i++)
+    {
+        // Pop first point from queue (FIFO).
+        ip_record currTarget = pendingTargets.peek();
+        pendingTargets.pop();
 
-            // If available, capture next point, otherwise default to empty pair.
-            ip_record nextTarget = !pendingTargets.empty() ? pendingTargets.front() : std::make_pair(0.0, 0.0);
+        // If available, capture next point, otherwise default to empty record.
+        ip_record nextTarget = !pendingTargets.empty() ? pendingTargets.peek() : ip_record{0.0, 0.0, 0.0, false};
 
-            auto setpoint = makeDataRecord(prevTarget, currTarget, nextTarget);
+        batch.push_back(makeDataRecord(prevTarget, currTarget, nextTarget));
 
-            prevTarget = currTarget;
-            integrityCounter++;
-            return setpoint;
-        });
+        prevTarget = currTarget;
+        integrityCounter++;
+    }
 
+    lastLoadedTarget = prevTarget.position;
     return batch;
 }
 
 double InterpolatedPositionBuffer::getPrevTarget() const
 {
-    std::lock_guard<std::mutex> lock(queueMutex);
-    return prevTarget.first;
+    return lastLoadedTarget;
 }
 
 bool InterpolatedPositionBuffer::isQueueReady() const
 {
-    std::lock_guard<std::mutex> lock(queueMutex);
     // account for the offset (only PVT) and one extra point in async mode (`>` instead of `>=`)
     return pendingTargets.size() > getBufferSize() + getOffset();
 }
 
 bool InterpolatedPositionBuffer::isQueueEmpty() const
 {
-    std::lock_guard<std::mutex> lock(queueMutex);
     return pendingTargets.empty();
 }
 
+std::size_t InterpolatedPositionBuffer::getQueueSize() const
+{
+    return pendingTargets.size();
+}
+
+std::size_t InterpolatedPositionBuffer::getQueueCapacity() const
+{
+    return pendingTargets.capacity();
+}
+
 void InterpolatedPositionBuffer::clearQueue()
 {
-    std::lock_guard<std::mutex> lock(queueMutex);
     pendingTargets.clear();
 }
 
@@ -155,7 +181,7 @@ std::uint16_t InterpolatedPositionBuffer::getSampledTime(double currentTimestamp
 
     // Asynchronous interpolation.
     double elapsed = currentTimestamp - initialTimestamp;
-    int samplesSinceStart = elapsed / vars.samplingPeriod;
+    int samplesSinceStart = std::lround(elapsed / vars.samplingPeriod); // don't truncate 49.999... samples
     std::uint16_t currentWindow = samplesSinceStart - sampleCount;
     sampleCount = samplesSinceStart;
     return currentWindow;
@@ -163,7 +189,7 @@ std::uint16_t InterpolatedPositionBuffer::getSampledTime(double currentTimestamp
 
 double InterpolatedPositionBuffer::getMeanVelocity(const ip_record & earliest, const ip_record & latest) const
 {
-    double distance = latest.first - earliest.first;
+    double distance = latest.position - earliest.position;
 
     if (fixedSamples != 0)
     {
@@ -173,7 +199,7 @@ double InterpolatedPositionBuffer::getMeanVelocity(const ip_record & earliest, c
     else
     {
         // Asynchronous interpolation.
-        return distance / (latest.second - earliest.second);
+        return distance / (latest.timestamp - earliest.timestamp);
     }
 }
 
@@ -196,8 +222,8 @@ std::uint64_t PtBuffer::makeDataRecord(const ip_record & previous, const ip_reco
 {
     std::uint64_t data = 0;
 
-    std::int32_t p = vars.degreesToInternalUnits(current.first);
-    std::uint16_t t = getSampledTime(current.second);
+    std::int32_t p = vars.degreesToInternalUnits(current.position);
+    std::uint16_t t = getSampledTime(current.timestamp);
     std::uint8_t ic = getIntegrityCounter() << 1;
 
     std::memcpy((unsigned char *)&data, &p, sizeof(p));
@@ -231,18 +257,27 @@ std::uint64_t PvtBuffer::makeDataRecord(const ip_record & previous, const ip_rec
 {
     std::uint64_t data = 0;
 
-    std::int32_t position = vars.degreesToInternalUnits(current.first);
+    std::int32_t position = vars.degreesToInternalUnits(current.position);
     std::int16_t p_lsb = position & 0x0000FFFF;
     std::int8_t p_msb = ((position & 0x00FF0000) << 8) >> 24;
 
     std::memcpy((unsigned char *)&data, &p_lsb, sizeof(p_lsb));
     std::memcpy((unsigned char *)&data + 3, &p_msb, sizeof(p_msb));
 
-    if (next.second != 0.0)
+    if (current.hasVelocity || next.timestamp != 0.0)
     {
-        double prevVelocity = getMeanVelocity(previous, current);
-        double nextVelocity = getMeanVelocity(current, next);
-        double velocity = vars.degreesToInternalUnits((prevVelocity + nextVelocity) / 2.0, 1);
+        double velocity;
+
+        if (current.hasVelocity)
+        {
+            velocity = vars.degreesToInternalUnits(current.velocity, 1);
+        }
+        else
+        {
+            double prevVelocity = getMeanVelocity(previous, current);
+            double nextVelocity = getMeanVelocity(current, next);
+            velocity = vars.degreesToInternalUnits((prevVelocity + nextVelocity) / 2.0, 1);
+        }
 
         std::int16_t v_int;
         std::uint8_t v_frac;
@@ -253,7 +288,7 @@ std::uint64_t PvtBuffer::makeDataRecord(const ip_record & previous, const ip_rec
         std::memcpy((unsigned char *)&data + 4, &v_int, sizeof(v_int));
     }
 
-    std::uint16_t t = getSampledTime(current.second) & 0x1FF;
+    std::uint16_t t = getSampledTime(current.timestamp) & 0x1FF;
     std::uint8_t ic = getIntegrityCounter() << 1;
     std::uint16_t tic = t + (static_cast<std::uint16_t>(ic) << 8);
 
@@ -5,13 +5,14 @@
 
 #include <cstdint>
 
-#include <deque>
+#include <atomic>
 #include <mutex>
 #include <string>
 #include <vector>
 
 #include <yarp/os/Searchable.h>
 
+#include "SpscRing.hpp"
 #include "StateVariables.hpp"
 
 namespace roboticslab
@@ -22,7 +23,11 @@ namespace roboticslab
  * @brief Base class for a PT/PVT buffer of setpoints.
  *
  * Stores an internal queue of setpoints aimed to be processed in batches on
- * demand by client code.
+ * demand by client code. Setpoints are produced by client threads and consumed
+ * either by the client thread that starts the motion or, once in motion, by
+ * the CAN reader thread on buffer-low signals. Said queue is a preallocated
+ * lock-free ring, and batches are generated into a reusable vector, hence the
+ * consumer never blocks nor allocates.
  */
 class InterpolatedPositionBuffer
 {
@@ -33,9 +38,12 @@ public:
     //! Virtual destructor.
     virtual ~InterpolatedPositionBuffer() = default;
 
-    //! Store initial position.
+    //! Store initial position, timestamp is inferred from the first queued points.
     void setInitial(double initialTarget);
 
+    //! Store initial position and the time (seconds) it refers to.
+    void setInitial(double initialTarget, double initialTimestamp);
+
     //! Get buffer type as string identifier (pt/pvt).
     virtual std::string getType() const = 0;
 
@@ -51,11 +59,17 @@ public:
     //! Generate interpolation submode register value (object 60C0h).
     virtual std::int16_t getSubMode() const = 0;
 
-    //! Place a new setpoint at the end of the queue.
-    void addSetpoint(double target);
+    //! Place a new setpoint at the end of the queue, timestamped on arrival; false if full.
+    bool addSetpoint(double target);
+
+    //! Place a new setpoint at the end of the queue given its timestamp (seconds), false if full.
+    bool addSetpoint(double target, double timestamp);
+
+    //! Place a new setpoint at the end of the queue given its velocity and timestamp (seconds), false if full.
+    bool addSetpoint(double target, double velocity, double timestamp);
 
-    //! Generate next batch of setpoints popped from the front of the queue.
-    std::vector<std::uint64_t> popBatch(bool fullBuffer);
+    //! Generate next batch of setpoints popped from the front of the queue, valid until the next call.
+    const std::vector<std::uint64_t> & popBatch(bool fullBuffer);
 
     //! Retrieve last point loaded into the buffer.
     double getPrevTarget() const;
@@ -66,11 +80,24 @@ public:
     //! Report whether there are no more points in the queue.
     bool isQueueEmpty() const;
 
-    //! Clear internal queue.
+    //! Retrieve number of points in the queue.
+    std::size_t getQueueSize() const;
+
+    //! Retrieve maximum number of points the queue can hold.
+    std::size_t getQueueCapacity() const;
+
+    //! Clear internal queue, not to be called while in motion.
     void clearQueue();
 
 protected:
-    using ip_record = std::pair<double, double>;
+    //! Queued setpoint.
+    struct ip_record
+    {
+        double position;  ///< position target (degrees)
+        double timestamp; ///< time of arrival or scheduled time (seconds), zero if not applicable
+        double velocity;  ///< velocity target (degrees/second), only if hasVelocity
+        bool hasVelocity; ///< whether the velocity target was given by the client
+    };
 
     //! Retrieve current integrity counter value.
     std::uint8_t getIntegrityCounter() const;
@@ -93,10 +120,12 @@ private:
     const std::uint16_t fixedSamples;
     std::uint8_t integrityCounter;
     ip_record prevTarget;
+    std::atomic<double> lastLoadedTarget;
     double initialTimestamp;
     int sampleCount;
-    std::deque<ip_record> pendingTargets;
-    mutable std::mutex queueMutex;
+    SpscRing<ip_record> pendingTargets;
+    std::mutex producerMutex; // only contended by concurrent client threads
+    std::vector<std::uint64_t> batch;
 };
 
 /**
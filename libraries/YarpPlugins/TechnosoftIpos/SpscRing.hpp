@@ -0,0 +1,99 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __SPSC_RING_HPP__
+#define __SPSC_RING_HPP__
+
+#include <cstddef>
+
+#include <atomic>
+#include <vector>
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup TechnosoftIpos
+ * @brief Bounded single-producer, single-consumer lock-free queue.
+ *
+ * Storage is allocated once on construction, its capacity is rounded up to
+ * a power of two. The producer only writes the tail index, the consumer only
+ * writes the head index, hence neither of them ever blocks the other one.
+ * Indices are kept on separate cache lines to prevent false sharing.
+ */
+template<typename T>
+class SpscRing final
+{
+public:
+    //! Constructor, preallocates room for at least @p capacity elements.
+    explicit SpscRing(std::size_t capacity)
+        : storage(roundUpToPowerOfTwo(capacity)),
+          mask(storage.size() - 1)
+    { }
+
+    //! Retrieve maximum number of stored elements.
+    std::size_t capacity() const
+    { return storage.size(); }
+
+    //! Retrieve number of stored elements, might be outdated by the time it is used.
+    std::size_t size() const
+    { return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire); }
+
+    //! Check whether there are no stored elements.
+    bool empty() const
+    { return size() == 0; }
+
+    //! Append an element at the back (producer), false if full.
+    bool push(const T & value)
+    {
+        const std::size_t t = tail.load(std::memory_order_relaxed);
+
+        if (t - head.load(std::memory_order_acquire) == storage.size())
+        {
+            return false;
+        }
+
+        storage[t & mask] = value;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    //! Access the i-th element counting from the front (consumer), requires i < size().
+    const T & peek(std::size_t i = 0) const
+    { return storage[(head.load(std::memory_order_relaxed) + i) & mask]; }
+
+    //! Remove the element at the front (consumer), requires !empty().
+    void pop()
+    { head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    //! Discard all stored elements (consumer).
+    void clear()
+    { head.store(tail.load(std::memory_order_acquire), std::memory_order_release); }
+
+private:
+    static constexpr std::size_t CACHE_LINE = 64;
+
+    static std::size_t roundUpToPowerOfTwo(std::size_t n)
+    {
+        std::size_t pow = 1;
+
+        while (pow < n)
+        {
+            pow <<= 1;
+        }
+
+        return pow;
+    }
+
+    std::vector<T> storage;
+    const std::size_t mask;
+
+    char pad0[CACHE_LINE];
+    std::atomic<std::size_t> head {0}; // next element to be consumed
+    char pad1[CACHE_LINE - sizeof(std::atomic<std::size_t>)];
+    std::atomic<std::size_t> tail {0}; // next free slot
+    char pad2[CACHE_LINE - sizeof(std::atomic<std::size_t>)];
+};
+
+} // namespace roboticslab
+
+#endif // __SPSC_RING_HPP__
@@ -4,12 +4,18 @@
 
 #include <cmath>
 
+#include <algorithm>
+
 #include <yarp/os/LogStream.h>
+#include <yarp/os/Time.h>
 #include <yarp/os/Vocab.h>
 #include <yarp/dev/IAxisInfo.h>
 
 using namespace roboticslab;
 
+constexpr unsigned int EncoderRead::MAX_WINDOW;
+constexpr int StateVariables::DERIVATIVE_ORDERS;
+
 namespace
 {
     // return -1 for negative numbers, +1 for positive numbers, 0 for zero
@@ -23,31 +29,268 @@ namespace
 
 // -----------------------------------------------------------------------------
 
-EncoderRead::EncoderRead(double samplingPeriod)
+EncoderRead::EncoderRead(double samplingPeriod, double _syncPeriod)
     : samplingFreq(1.0 / samplingPeriod),
+      syncPeriod(_syncPeriod),
+      type(estimator::DIFFERENCE),
+      window(MAX_WINDOW),
+      alpha(0.0), beta(0.0), gamma(0.0),
       lastPosition(0),
       lastSpeed(0.0),
-      lastAcceleration(0.0)
+      lastAcceleration(0.0),
+      lastTime(0.0),
+      lastSyncBased(false),
+      samples(0),
+      historyTimes(),
+      historyPositions(),
+      historyNext(0),
+      filterPosition(0.0),
+      lastSpeedTime(0.0),
+      lastSpeedSyncBased(false),
+      hasSpeed(false)
 {
     lastStamp.update();
 }
 
 // -----------------------------------------------------------------------------
 
-void EncoderRead::update(std::int32_t newPos)
+bool EncoderRead::configure(estimator _type, unsigned int _window, double _alpha, double _beta, double _gamma)
+{
+    if (_type == estimator::LEAST_SQUARES && (_window < 3 || _window > MAX_WINDOW))
+    {
+        return false; // a quadratic fit needs at least three samples
+    }
+
+    if (_type == estimator::ALPHA_BETA
+        && (_alpha <= 0.0 || _alpha > 1.0 || _beta <= 0.0 || _beta >= 4.0 - 2.0 * _alpha || _gamma < 0.0 || _gamma >= 1.0))
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> guard(encoderMutex);
+
+    type = _type;
+    window = _type == estimator::LEAST_SQUARES ? _window : MAX_WINDOW;
+    alpha = _alpha;
+    beta = _beta;
+    gamma = _gamma;
+
+    lastSpeed = lastAcceleration = 0.0;
+    hasSpeed = false;
+    clearHistory();
+
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+EncoderRead::estimator EncoderRead::getEstimator() const
 {
     std::lock_guard<std::mutex> guard(encoderMutex);
+    return type;
+}
+
+// -----------------------------------------------------------------------------
 
-    const double lastTime = lastStamp.getTime();
-    const double nextToLastPosition = lastPosition;
-    const double nextToLastSpeed = lastSpeed;
+bool EncoderRead::parseEstimator(const std::string & str, estimator * type)
+{
+    if (str == "difference")
+    {
+        *type = estimator::DIFFERENCE;
+    }
+    else if (str == "leastSquares")
+    {
+        *type = estimator::LEAST_SQUARES;
+    }
+    else if (str == "alphaBeta")
+    {
+        *type = estimator::ALPHA_BETA;
+    }
+    else if (str == "drive")
+    {
+        *type = estimator::DRIVE;
+    }
+    else
+    {
+        return false;
+    }
+
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+std::string EncoderRead::estimatorToString(estimator type)
+{
+    switch (type)
+    {
+    case estimator::LEAST_SQUARES:
+        return "leastSquares";
+    case estimator::ALPHA_BETA:
+        return "alphaBeta";
+    case estimator::DRIVE:
+        return "drive";
+    default:
+        return "difference";
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+void EncoderRead::update(std::int32_t newPos, std::uint64_t syncCycle)
+{
+    std::lock_guard<std::mutex> guard(encoderMutex);
 
     lastStamp.update();
-    const double samples = (lastStamp.getTime() - lastTime) * samplingFreq;
+
+    const bool syncBased = syncCycle != 0 && syncPeriod > 0.0;
+    const double time = (syncBased ? syncCycle * syncPeriod : lastStamp.getTime()) * samplingFreq; // drive samples
+
+    if (samples != 0 && (syncBased != lastSyncBased || time <= lastTime))
+    {
+        // time base switched or did not advance, keep last estimates and start over
+        clearHistory();
+    }
+
+    const double dt = time - lastTime; // only meaningful if samples != 0
+    const std::int32_t nextToLastPosition = lastPosition;
 
     lastPosition = newPos;
-    lastSpeed = (lastPosition - nextToLastPosition) / samples;
-    lastAcceleration = (lastSpeed - nextToLastSpeed) / samples;
+    lastTime = time;
+    lastSyncBased = syncBased;
+
+    switch (type)
+    {
+    case estimator::DIFFERENCE:
+        if (samples != 0)
+        {
+            const double nextToLastSpeed = lastSpeed;
+            lastSpeed = (newPos - nextToLastPosition) / dt;
+            lastAcceleration = (lastSpeed - nextToLastSpeed) / dt;
+        }
+        break;
+    case estimator::LEAST_SQUARES:
+        historyTimes[historyNext] = time;
+        historyPositions[historyNext] = newPos;
+        historyNext = (historyNext + 1) % window;
+        break;
+    case estimator::ALPHA_BETA:
+        if (samples == 0)
+        {
+            filterPosition = newPos;
+        }
+        else
+        {
+            const double predictedPosition = filterPosition + lastSpeed * dt + 0.5 * lastAcceleration * dt * dt;
+            const double predictedSpeed = lastSpeed + lastAcceleration * dt;
+            const double residual = newPos - predictedPosition;
+
+            filterPosition = predictedPosition + alpha * residual;
+            lastSpeed = predictedSpeed + beta * residual / dt;
+            lastAcceleration += 2.0 * gamma * residual / (dt * dt);
+        }
+        break;
+    default: // speed supplied via updateSpeed()
+        break;
+    }
+
+    if (samples < MAX_WINDOW)
+    {
+        samples++;
+    }
+
+    if (type == estimator::LEAST_SQUARES)
+    {
+        fitWindow();
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+void EncoderRead::updateSpeed(double newSpeed, std::uint64_t syncCycle)
+{
+    std::lock_guard<std::mutex> guard(encoderMutex);
+
+    if (type != estimator::DRIVE)
+    {
+        return;
+    }
+
+    const bool syncBased = syncCycle != 0 && syncPeriod > 0.0;
+    const double time = (syncBased ? syncCycle * syncPeriod : yarp::os::Time::now()) * samplingFreq;
+
+    if (hasSpeed && syncBased == lastSpeedSyncBased && time > lastSpeedTime)
+    {
+        lastAcceleration = (newSpeed - lastSpeed) / (time - lastSpeedTime);
+    }
+
+    lastSpeed = newSpeed;
+    lastSpeedTime = time;
+    lastSpeedSyncBased = syncBased;
+    hasSpeed = true;
+}
+
+// -----------------------------------------------------------------------------
+
+void EncoderRead::clearHistory()
+{
+    samples = 0;
+    historyNext = 0;
+}
+
+// -----------------------------------------------------------------------------
+
+void EncoderRead::fitWindow()
+{
+    const unsigned int n = std::min(samples, window);
+
+    if (n < 2)
+    {
+        return;
+    }
+
+    // fit p(t) = c0 + c1 * t + c2 * t^2 around the last sample, hence speed = c1 and acceleration = 2 * c2
+    double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0, s4 = 0.0;
+    double t0 = 0.0, t1 = 0.0, t2 = 0.0;
+
+    for (unsigned int i = 0; i < n; i++)
+    {
+        const unsigned int idx = (historyNext + window - 1 - i) % window;
+        const double t = historyTimes[idx] - lastTime;
+        const double p = static_cast<double>(historyPositions[idx]) - lastPosition;
+        const double tt = t * t;
+
+        s0 += 1.0;
+        s1 += t;
+        s2 += tt;
+        s3 += tt * t;
+        s4 += tt * tt;
+        t0 += p;
+        t1 += p * t;
+        t2 += p * tt;
+    }
+
+    if (n == 2)
+    {
+        // not enough samples for a quadratic fit, s1 is the (negative) time span
+        lastSpeed = t0 / s1;
+        lastAcceleration = 0.0;
+        return;
+    }
+
+    // Cramer's rule on the normal equations
+    const double det = s0 * (s2 * s4 - s3 * s3) - s1 * (s1 * s4 - s3 * s2) + s2 * (s1 * s3 - s2 * s2);
+
+    if (std::abs(det) < 1e-12)
+    {
+        return; // degenerate timestamps, keep last estimates
+    }
+
+    const double det1 = s0 * (t1 * s4 - s3 * t2) - t0 * (s1 * s4 - s3 * s2) + s2 * (s1 * t2 - t1 * s2);
+    const double det2 = s0 * (s2 * t2 - t1 * s3) - s1 * (s1 * t2 - t1 * s2) + t0 * (s1 * s3 - s2 * s2);
+
+    lastSpeed = det1 / det;
+    lastAcceleration = 2.0 * det2 / det;
 }
 
 // -----------------------------------------------------------------------------
@@ -58,6 +301,8 @@ void EncoderRead::reset(std::int32_t pos)
     lastPosition = pos;
     lastSpeed = lastAcceleration = 0.0;
     lastStamp.update();
+    hasSpeed = false;
+    clearHistory();
 }
 
 // -----------------------------------------------------------------------------
@@ -209,16 +454,15 @@ bool StateVariables::validateInitialState()
         return false;
     }
 
-    lastEncoderRead = std::make_unique<EncoderRead>(samplingPeriod);
+    lastEncoderRead = std::make_unique<EncoderRead>(samplingPeriod, syncPeriod);
 
     return true;
 }
 
 // -----------------------------------------------------------------------------
 
-double StateVariables::clipSyncPositionTarget()
+double StateVariables::clipSyncPositionTarget(double requested)
 {
-    double requested = synchronousCommandTarget;
     double previous = prevSyncTarget;
     double diff = requested - previous;
 
@@ -231,7 +475,7 @@ double StateVariables::clipSyncPositionTarget()
     }
     else
     {
-        prevSyncTarget.store(synchronousCommandTarget);
+        prevSyncTarget = requested;
         return requested;
     }
 }
@@ -245,12 +489,15 @@ void StateVariables::reset()
 
     lastEncoderRead->reset();
     lastCurrentRead = 0.0;
+    lastVelocityRead = 0.0;
+    lastDcLinkVoltage = 0;
 
     requestedcontrolMode = 0;
     synchronousCommandTarget = prevSyncTarget = 0.0;
     enableSync = false;
 
     ipBufferFilled = ipMotionStarted = ipBufferEnabled = false;
+    ipMotionStartTime = 0.0;
 }
 
 // -----------------------------------------------------------------------------
@@ -264,6 +511,11 @@ bool StateVariables::awaitControlMode(yarp::conf::vocab32_t mode)
 
 double StateVariables::degreesToInternalUnits(double value, int derivativeOrder) const
 {
+    if (derivativeOrder >= 0 && derivativeOrder < DERIVATIVE_ORDERS)
+    {
+        return value * positionFactors[derivativeOrder].load(std::memory_order_relaxed);
+    }
+
     return value * tr * (reverse ? -1 : 1) * (encoderPulses / 360.0) * std::pow(samplingPeriod, derivativeOrder);
 }
 
@@ -271,6 +523,11 @@ double StateVariables::degreesToInternalUnits(double value, int derivativeOrder)
 
 double StateVariables::internalUnitsToDegrees(double value, int derivativeOrder) const
 {
+    if (derivativeOrder >= 0 && derivativeOrder < DERIVATIVE_ORDERS)
+    {
+        return value * inversePositionFactors[derivativeOrder].load(std::memory_order_relaxed);
+    }
+
     return value / (tr * (reverse ? -1 : 1) * (encoderPulses / 360.0) * std::pow(samplingPeriod, derivativeOrder));
 }
 
@@ -278,14 +535,14 @@ double StateVariables::internalUnitsToDegrees(double value, int derivativeOrder)
 
 std::int16_t StateVariables::currentToInternalUnits(double value) const
 {
-    return value * (reverse ? -1 : 1) * 65520.0 / (2.0 * drivePeakCurrent);
+    return value * currentFactor.load(std::memory_order_relaxed);
 }
 
 // -----------------------------------------------------------------------------
 
 double StateVariables::internalUnitsToCurrent(std::int16_t value) const
 {
-    return value * (reverse ? -1 : 1) * 2.0 * drivePeakCurrent / 65520.0;
+    return value * inverseCurrentFactor.load(std::memory_order_relaxed);
 }
 
 // -----------------------------------------------------------------------------
@@ -299,14 +556,60 @@ double StateVariables::internalUnitsToPeakCurrent(std::int16_t value) const
 
 double StateVariables::currentToTorque(double current) const
 {
-    return current * tr * k;
+    return current * torqueFactor.load(std::memory_order_relaxed);
 }
 
 // -----------------------------------------------------------------------------
 
 double StateVariables::torqueToCurrent(double torque) const
 {
-    return torque / (tr * k);
+    return torque / torqueFactor.load(std::memory_order_relaxed);
+}
+
+// -----------------------------------------------------------------------------
+
+void StateVariables::internalUnitsToDegrees(const double * values, double * out, std::size_t n, int derivativeOrder) const
+{
+    const double factor = derivativeOrder >= 0 && derivativeOrder < DERIVATIVE_ORDERS
+            ? inversePositionFactors[derivativeOrder].load(std::memory_order_relaxed)
+            : internalUnitsToDegrees(1.0, derivativeOrder);
+
+    // single load of the factor, plain loop over contiguous arrays to allow vectorization
+    for (std::size_t i = 0; i < n; i++)
+    {
+        out[i] = values[i] * factor;
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+void StateVariables::internalUnitsToCurrent(const std::int16_t * values, double * out, std::size_t n) const
+{
+    const double factor = inverseCurrentFactor.load(std::memory_order_relaxed);
+
+    for (std::size_t i = 0; i < n; i++)
+    {
+        out[i] = values[i] * factor;
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+void StateVariables::updateConversionFactors()
+{
+    const double sign = reverse ? -1.0 : 1.0;
+    double factor = tr * sign * (encoderPulses / 360.0);
+
+    for (int order = 0; order < DERIVATIVE_ORDERS; order++)
+    {
+        positionFactors[order] = factor;
+        inversePositionFactors[order] = 1.0 / factor;
+        factor *= samplingPeriod;
+    }
+
+    currentFactor = sign * 65520.0 / (2.0 * drivePeakCurrent);
+    inverseCurrentFactor = sign * 2.0 * drivePeakCurrent / 65520.0;
+    torqueFactor = tr * k;
 }
 
 // -----------------------------------------------------------------------------
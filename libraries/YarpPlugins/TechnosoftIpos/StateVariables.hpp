@@ -3,12 +3,14 @@
 #ifndef __IPOS_STATE_VARIABLES_HPP__
 #define __IPOS_STATE_VARIABLES_HPP__
 
+#include <cstddef>
 #include <cstdint>
 
 #include <atomic>
 #include <bitset>
 #include <memory>
 #include <mutex>
+#include <set>
 #include <string>
 
 #include <yarp/conf/numeric.h>
@@ -22,17 +24,48 @@ namespace roboticslab
 
 /**
  * @ingroup TechnosoftIpos
- * @brief Stores last encoder reads, obtains mean speeds and accelerations
- * via differentiation.
+ * @brief Stores last encoder reads, estimates speeds and accelerations.
+ *
+ * Samples are timestamped with the SYNC cycle they belong to, if known and
+ * the SYNC period is valid, otherwise with their host arrival time. Estimators
+ * rely on a fixed-size history, hence no memory is allocated on update and
+ * the cost per sample is bounded.
  */
 class EncoderRead
 {
 public:
-    //! Constructor.
-    EncoderRead(double samplingPeriod);
+    //! Speed and acceleration estimation scheme.
+    enum class estimator
+    {
+        DIFFERENCE,    ///< first and second finite differences
+        LEAST_SQUARES, ///< quadratic least-squares fit over a sliding window
+        ALPHA_BETA,    ///< alpha-beta-gamma tracking filter
+        DRIVE          ///< speed reported by the drive, finite differences for accelerations
+    };
+
+    //! Maximum window size of the least-squares estimator.
+    static constexpr unsigned int MAX_WINDOW = 32;
+
+    //! Constructor, both periods in seconds.
+    EncoderRead(double samplingPeriod, double syncPeriod = 0.0);
+
+    //! Select estimator and its parameters, false if any of them is out of range.
+    bool configure(estimator type, unsigned int window, double alpha, double beta, double gamma);
+
+    //! Retrieve selected estimator.
+    estimator getEstimator() const;
+
+    //! Parse estimator from its string identifier (difference/leastSquares/alphaBeta/drive).
+    static bool parseEstimator(const std::string & str, estimator * type);
+
+    //! Retrieve string identifier of an estimator.
+    static std::string estimatorToString(estimator type);
 
     //! Set new position (counts), update speeds (counts/sample) and accelerations (counts/sample^2).
-    void update(std::int32_t newPos);
+    void update(std::int32_t newPos, std::uint64_t syncCycle = 0);
+
+    //! Set speed reported by the drive (counts/sample), ignored unless the drive estimator is selected.
+    void updateSpeed(double newSpeed, std::uint64_t syncCycle = 0);
 
     //! Reset internals to zero, pick provided position (encoder counts).
     void reset(std::int32_t pos = 0);
@@ -50,11 +83,39 @@ public:
     double queryTime() const;
 
 private:
+    void clearHistory();
+    void fitWindow();
+
     const double samplingFreq; // samples per second
+    const double syncPeriod;
+
+    estimator type;
+    unsigned int window;
+    double alpha, beta, gamma;
+
     std::int32_t lastPosition;
     double lastSpeed;
     double lastAcceleration;
     yarp::os::Stamp lastStamp;
+
+    // time base of the last sample (drive samples), either SYNC-based or host-based
+    double lastTime;
+    bool lastSyncBased;
+    unsigned int samples;
+
+    // least-squares history, circular buffer
+    double historyTimes[MAX_WINDOW];
+    std::int32_t historyPositions[MAX_WINDOW];
+    unsigned int historyNext;
+
+    // alpha-beta-gamma state
+    double filterPosition;
+
+    // drive estimator
+    double lastSpeedTime;
+    bool lastSpeedSyncBased;
+    bool hasSpeed;
+
     mutable std::mutex encoderMutex;
 };
 
@@ -91,8 +152,17 @@ struct StateVariables
     //! Convert torque (Nm) to current (amperes).
     double torqueToCurrent(double torque) const;
 
-    //! Clip travelled distance according to the maximum velocity allowed.
-    double clipSyncPositionTarget();
+    //! Convert an array of positions, speeds or accelerations to degrees in one pass.
+    void internalUnitsToDegrees(const double * values, double * out, std::size_t n, int derivativeOrder = 0) const;
+
+    //! Convert an array of currents to amperes in one pass.
+    void internalUnitsToCurrent(const std::int16_t * values, double * out, std::size_t n) const;
+
+    //! Precompute conversion factors, to be called whenever any parameter involved changes.
+    void updateConversionFactors();
+
+    //! Clip travelled distance towards the requested position according to the maximum velocity allowed.
+    double clipSyncPositionTarget(double requested);
 
     //! Reset internal state.
     void reset();
@@ -115,9 +185,13 @@ struct StateVariables
 
     std::unique_ptr<EncoderRead> lastEncoderRead {nullptr};
     std::atomic<std::int16_t> lastCurrentRead {0};
+    std::atomic<double> lastVelocityRead {0.0};
+    std::atomic<std::uint16_t> lastDcLinkVoltage {0};
+    std::atomic<std::uint64_t> lastSyncCycle {0}; // SYNC cycle of the last synchronous TPDO
 
     std::atomic<yarp::conf::vocab32_t> actualControlMode {0};
     std::atomic<yarp::conf::vocab32_t> requestedcontrolMode {0};
+    std::atomic<yarp::conf::vocab32_t> preparedControlMode {0}; // preconditions met, see ICiA402Drive
 
     std::atomic<double> tr {0.0};
     std::atomic<double> k {0.0};
@@ -129,7 +203,6 @@ struct StateVariables
     std::atomic<double> refSpeed {0.0};
     std::atomic<double> refAcceleration {0.0};
 
-    std::atomic<double> lastHeartbeat {0.0};
     std::atomic<std::uint8_t> lastNmtState {0};
 
     std::atomic<double> synchronousCommandTarget {0.0};
@@ -141,6 +214,17 @@ struct StateVariables
     std::atomic<bool> ipMotionStarted {false};
     std::atomic<bool> ipBufferFilled {false};
     std::atomic<bool> ipBufferEnabled {false};
+    std::atomic<double> ipMotionStartTime {0.0}; // scheduled start of an uploaded trajectory, zero if none
+
+    // precomputed on updateConversionFactors(), derived from tr, k, encoderPulses, reverse, samplingPeriod and drivePeakCurrent
+
+    static constexpr int DERIVATIVE_ORDERS = 3; // position, speed, acceleration
+
+    std::atomic<double> positionFactors[DERIVATIVE_ORDERS] {}; // degrees to internal units
+    std::atomic<double> inversePositionFactors[DERIVATIVE_ORDERS] {};
+    std::atomic<double> currentFactor {0.0}; // amperes to internal units
+    std::atomic<double> inverseCurrentFactor {0.0};
+    std::atomic<double> torqueFactor {0.0}; // amperes to Nm
 
     // read only, conceptually immutable
 
@@ -157,8 +241,13 @@ struct StateVariables
     PdoConfiguration tpdo1Conf;
     PdoConfiguration tpdo2Conf;
     PdoConfiguration tpdo3Conf;
+    PdoConfiguration tpdo4Conf;
+
+    std::set<std::uint16_t> tpdoMappedObjects;
+    bool syncPositionTpdo {false}; // position is mapped in the synchronous TPDO3
 
     double heartbeatPeriod {0.0};
+    double heartbeatTimeout {0.0};
     double syncPeriod {0.0};
 
     unsigned int canId = 0;
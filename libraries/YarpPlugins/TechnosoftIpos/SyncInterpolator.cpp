@@ -0,0 +1,237 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#include "SyncInterpolator.hpp"
+
+#include <cmath>
+
+#include <algorithm>
+
+using namespace roboticslab;
+
+// -----------------------------------------------------------------------------
+
+namespace
+{
+    constexpr double SMOOTHING = 0.1; // weight of the last interval in the period estimate
+    constexpr double STREAM_GAP = 5.0; // intervals longer than this many estimated periods start a new stream
+    constexpr double EPSILON = 1e-9; // seconds, absorbs rounding errors when accumulating SYNC periods
+}
+
+// -----------------------------------------------------------------------------
+
+SyncInterpolator::SyncInterpolator(double _syncPeriod, mode m)
+    : syncPeriod(_syncPeriod),
+      interpMode(m),
+      p0(0.0), v0(0.0), p1(0.0), v1(0.0), duration(0.0), elapsed(0.0),
+      lastPosition(0.0), lastVelocity(0.0),
+      prevTarget(0.0),
+      lastArrival(-1.0),
+      periodEstimate(0.0),
+      count(0), mean(0.0), m2(0.0), minPeriod(0.0), maxPeriod(0.0)
+{ }
+
+// -----------------------------------------------------------------------------
+
+void SyncInterpolator::setMode(mode m)
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    interpMode = m;
+}
+
+// -----------------------------------------------------------------------------
+
+SyncInterpolator::mode SyncInterpolator::getMode() const
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    return interpMode;
+}
+
+// -----------------------------------------------------------------------------
+
+bool SyncInterpolator::parseMode(const std::string & str, mode * m)
+{
+    if (str == "none")
+    {
+        *m = mode::NONE;
+    }
+    else if (str == "linear")
+    {
+        *m = mode::LINEAR;
+    }
+    else if (str == "cubic")
+    {
+        *m = mode::CUBIC;
+    }
+    else
+    {
+        return false;
+    }
+
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+std::string SyncInterpolator::modeToString(mode m)
+{
+    switch (m)
+    {
+    case mode::LINEAR:
+        return "linear";
+    case mode::CUBIC:
+        return "cubic";
+    default:
+        return "none";
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+void SyncInterpolator::reset(double position)
+{
+    std::lock_guard<std::mutex> lock(mtx);
+
+    p0 = p1 = lastPosition = prevTarget = position;
+    v0 = v1 = lastVelocity = 0.0;
+    duration = elapsed = 0.0;
+    lastArrival = -1.0;
+}
+
+// -----------------------------------------------------------------------------
+
+void SyncInterpolator::addSetpoint(double position, double timestamp)
+{
+    std::lock_guard<std::mutex> lock(mtx);
+
+    bool streaming = false;
+
+    if (lastArrival >= 0.0)
+    {
+        double interval = timestamp - lastArrival;
+
+        if (periodEstimate == 0.0 || interval <= STREAM_GAP * periodEstimate)
+        {
+            streaming = true;
+            periodEstimate = periodEstimate == 0.0 ? interval : periodEstimate + SMOOTHING * (interval - periodEstimate);
+
+            double delta = interval - mean;
+            mean += delta / ++count;
+            m2 += delta * (interval - mean);
+            minPeriod = count == 1 ? interval : std::min(minPeriod, interval);
+            maxPeriod = count == 1 ? interval : std::max(maxPeriod, interval);
+        }
+    }
+
+    lastArrival = timestamp;
+
+    // start a new segment from the current output
+    p0 = lastPosition;
+    v0 = lastVelocity;
+    p1 = position;
+    elapsed = 0.0;
+
+    if (interpMode == mode::NONE)
+    {
+        duration = 0.0;
+        v1 = 0.0;
+    }
+    else
+    {
+        duration = std::max(periodEstimate, syncPeriod);
+        // feedforward: keep moving at the pace of the client, unless the stream just (re)started
+        v1 = streaming ? (position - prevTarget) / duration : 0.0;
+    }
+
+    prevTarget = position;
+}
+
+// -----------------------------------------------------------------------------
+
+void SyncInterpolator::evaluate(double s, double * position, double * velocity) const
+{
+    if (duration == 0.0)
+    {
+        *position = p1;
+        *velocity = 0.0;
+        return;
+    }
+
+    if (interpMode == mode::LINEAR)
+    {
+        *velocity = (p1 - p0) / duration;
+        *position = p0 + *velocity * s;
+        return;
+    }
+
+    // cubic Hermite spline, u in [0, 1]
+    const double u = s / duration;
+    const double u2 = u * u;
+    const double u3 = u2 * u;
+
+    *position = (2 * u3 - 3 * u2 + 1) * p0
+              + (u3 - 2 * u2 + u) * duration * v0
+              + (-2 * u3 + 3 * u2) * p1
+              + (u3 - u2) * duration * v1;
+
+    *velocity = ((6 * u2 - 6 * u) * p0 + (-6 * u2 + 6 * u) * p1) / duration
+              + (3 * u2 - 4 * u + 1) * v0
+              + (3 * u2 - 2 * u) * v1;
+}
+
+// -----------------------------------------------------------------------------
+
+double SyncInterpolator::next(double * velocity)
+{
+    std::lock_guard<std::mutex> lock(mtx);
+
+    const bool holding = elapsed >= duration;
+    elapsed = elapsed + syncPeriod >= duration - EPSILON ? duration : elapsed + syncPeriod;
+    evaluate(elapsed, &lastPosition, &lastVelocity);
+
+    if (holding)
+    {
+        lastVelocity = 0.0; // the end velocity only applies to the sample that reaches the target
+    }
+
+    if (velocity)
+    {
+        *velocity = lastVelocity;
+    }
+
+    return lastPosition;
+}
+
+// -----------------------------------------------------------------------------
+
+double SyncInterpolator::getTarget() const
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    return p1;
+}
+
+// -----------------------------------------------------------------------------
+
+SyncInterpolator::jitter_stats SyncInterpolator::getJitterStatistics() const
+{
+    std::lock_guard<std::mutex> lock(mtx);
+
+    jitter_stats stats;
+    stats.count = count;
+    stats.meanPeriod = mean;
+    stats.stddev = count > 1 ? std::sqrt(m2 / (count - 1)) : 0.0;
+    stats.minPeriod = minPeriod;
+    stats.maxPeriod = maxPeriod;
+    stats.estimate = periodEstimate;
+    return stats;
+}
+
+// -----------------------------------------------------------------------------
+
+void SyncInterpolator::resetJitterStatistics()
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    count = 0;
+    mean = m2 = minPeriod = maxPeriod = 0.0;
+}
+
+// -----------------------------------------------------------------------------
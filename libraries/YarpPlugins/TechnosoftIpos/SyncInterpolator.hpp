@@ -0,0 +1,105 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __SYNC_INTERPOLATOR_HPP__
+#define __SYNC_INTERPOLATOR_HPP__
+
+#include <cstdint>
+
+#include <mutex>
+#include <string>
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup TechnosoftIpos
+ * @brief Host-side interpolator of position setpoints for the CSP mode.
+ *
+ * Clients stream setpoints at their own pace, a new sample is generated on
+ * each SYNC. Every setpoint starts a new segment from the current output
+ * towards the requested target, spanning the estimated client period (or one
+ * SYNC period, whichever is greater). Once reached, the target is held until
+ * the next setpoint arrives. Inter-arrival times of setpoints are tracked for
+ * jitter statistics.
+ */
+class SyncInterpolator final
+{
+public:
+    //! Interpolation scheme.
+    enum class mode
+    {
+        NONE,   ///< zero-order hold, targets are forwarded as they are
+        LINEAR, ///< constant velocity towards the target
+        CUBIC   ///< cubic Hermite segments with velocity feedforward
+    };
+
+    //! Inter-arrival statistics of client setpoints.
+    struct jitter_stats
+    {
+        std::uint64_t count;  ///< number of measured intervals
+        double meanPeriod;    ///< average inter-arrival time (seconds)
+        double stddev;        ///< standard deviation of inter-arrival times (seconds)
+        double minPeriod;     ///< shortest inter-arrival time (seconds)
+        double maxPeriod;     ///< longest inter-arrival time (seconds)
+        double estimate;      ///< smoothed client period used for interpolation (seconds)
+    };
+
+    //! Constructor, @p syncPeriod in seconds.
+    SyncInterpolator(double syncPeriod, mode m = mode::NONE);
+
+    //! Select interpolation scheme.
+    void setMode(mode m);
+
+    //! Retrieve interpolation scheme.
+    mode getMode() const;
+
+    //! Parse interpolation scheme from its string identifier (none/linear/cubic).
+    static bool parseMode(const std::string & str, mode * m);
+
+    //! Retrieve string identifier of an interpolation scheme.
+    static std::string modeToString(mode m);
+
+    //! Hold the given position, forget about previous setpoints.
+    void reset(double position);
+
+    //! Register a new client setpoint received at the given time (seconds).
+    void addSetpoint(double position, double timestamp);
+
+    //! Advance one SYNC period and generate the next sample, optionally retrieve its velocity.
+    double next(double * velocity = nullptr);
+
+    //! Retrieve the last requested target.
+    double getTarget() const;
+
+    //! Retrieve jitter statistics of incoming setpoints.
+    jitter_stats getJitterStatistics() const;
+
+    //! Clear jitter statistics, the smoothed period estimate is preserved.
+    void resetJitterStatistics();
+
+private:
+    void evaluate(double s, double * position, double * velocity) const;
+
+    const double syncPeriod;
+    mode interpMode;
+
+    // current segment
+    double p0, v0, p1, v1, duration, elapsed;
+
+    // last generated sample
+    double lastPosition, lastVelocity;
+
+    double prevTarget;
+    double lastArrival;
+    double periodEstimate;
+
+    // Welford's online algorithm
+    std::uint64_t count;
+    double mean, m2, minPeriod, maxPeriod;
+
+    mutable std::mutex mtx;
+};
+
+} // namespace roboticslab
+
+#endif // __SYNC_INTERPOLATOR_HPP__
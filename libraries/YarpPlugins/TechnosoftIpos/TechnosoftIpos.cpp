@@ -9,7 +9,8 @@
 #include <string>
 
 #include <yarp/os/Log.h>
-#include <yarp/os/Time.h>
+
+#include "CanUtils.hpp"
 
 using namespace roboticslab;
 
@@ -17,6 +18,14 @@ using namespace roboticslab;
 
 namespace
 {
+    template<typename Obj>
+    typename Obj::type readObject(const std::uint8_t * data)
+    {
+        typename Obj::type value;
+        std::memcpy(&value, data, sizeof(value));
+        return value;
+    }
+
     enum report_level { INFO, WARN, NONE };
 
     struct report_storage
@@ -406,10 +415,10 @@ void TechnosoftIpos::interpretIpStatus(std::uint16_t status)
         vars.ipBufferEnabled = false;
     }
 
-    if (isBufferFull && vars.ipBufferEnabled && !vars.ipMotionStarted)
+    if (isBufferFull && vars.ipBufferEnabled && !vars.ipMotionStarted && vars.ipMotionStartTime == 0.0)
     {
-        // enable ip mode
-        vars.ipMotionStarted = can->driveStatus()->controlword(can->driveStatus()->controlword().set(4));
+        // enable ip mode (unless an uploaded trajectory is scheduled to start later on)
+        startIpMotion();
     }
 
     if (isBufferLow && vars.ipBufferEnabled && vars.ipMotionStarted && !ipBuffer->isQueueEmpty() && !isBufferEmpty)
@@ -433,34 +442,93 @@ void TechnosoftIpos::interpretIpStatus(std::uint16_t status)
 
 // -----------------------------------------------------------------------------
 
-void TechnosoftIpos::handleTpdo1(std::uint16_t statusword, std::uint16_t msr, std::int8_t modesOfOperation)
+void TechnosoftIpos::handleTpdo(const std::vector<TpdoMapping::object> & objects, const std::uint8_t * data, std::uint64_t syncCycle)
 {
-    interpretModesOfOperation(modesOfOperation); // statusword callback depends on this
-    interpretStatusword(statusword);
-    interpretMsr(msr);
+    // objects have been sorted on configuration, the statusword callback depends on modes of operation
+    for (const auto & object : objects)
+    {
+        handleTpdoObject(object.first, data + object.second, syncCycle);
+    }
 }
 
 // -----------------------------------------------------------------------------
 
-void TechnosoftIpos::handleTpdo2(std::uint16_t mer, std::uint16_t der)
+void TechnosoftIpos::handleTpdoObject(std::uint16_t index, const std::uint8_t * data, std::uint64_t syncCycle)
 {
-    interpretMer(mer);
-    interpretDer(der);
+    using namespace IposObjects;
+
+    switch (index)
+    {
+    case ManufacturerStatusRegister::index: // statusword (LSW) and MSR (MSW)
+    {
+        auto value = readObject<ManufacturerStatusRegister>(data);
+        interpretStatusword(value & 0x0000FFFF);
+        interpretMsr(value >> 16);
+        break;
+    }
+    case Statusword::index:
+        interpretStatusword(readObject<Statusword>(data));
+        break;
+    case ModesOfOperationDisplay::index:
+        interpretModesOfOperation(readObject<ModesOfOperationDisplay>(data));
+        break;
+    case MotionErrorRegister::index:
+        interpretMer(readObject<MotionErrorRegister>(data));
+        break;
+    case DetailedErrorRegister::index:
+        interpretDer(readObject<DetailedErrorRegister>(data));
+        break;
+    case DCLinkVoltage::index:
+        vars.lastDcLinkVoltage = readObject<DCLinkVoltage>(data);
+        break;
+    case PositionActualInternalValue::index:
+        vars.lastEncoderRead->update(readObject<PositionActualInternalValue>(data), syncCycle);
+        break;
+    case VelocityActualValue::index: // 16.16 fixed point
+    {
+        auto value = readObject<VelocityActualValue>(data);
+        std::int16_t velocityInt = value >> 16;
+        std::uint16_t velocityFrac = value & 0x0000FFFF;
+        vars.lastVelocityRead = CanUtils::decodeFixedPoint(velocityInt, velocityFrac);
+        vars.lastEncoderRead->updateSpeed(vars.lastVelocityRead, syncCycle);
+        break;
+    }
+    case TorqueActualValue::index:
+        vars.lastCurrentRead = readObject<TorqueActualValue>(data);
+        break;
+    default:
+        break;
+    }
 }
 
 // -----------------------------------------------------------------------------
 
-void TechnosoftIpos::handleTpdo3(std::int32_t position, std::int16_t current)
+void TechnosoftIpos::reportJointState(std::uint64_t cycle)
 {
-    vars.lastEncoderRead->update(position);
-    vars.lastCurrentRead = current;
+    const std::int32_t position = vars.lastEncoderRead->queryPosition();
+    const double speed = vars.lastEncoderRead->querySpeed();
+    const double acceleration = vars.lastEncoderRead->queryAcceleration();
+
+    joint_state state;
+    state.position = vars.internalUnitsToDegrees(position);
+    state.velocity = vars.internalUnitsToDegrees(speed, 1);
+    state.acceleration = vars.internalUnitsToDegrees(acceleration, 2);
+    state.motorPosition = vars.reverse ? -position : position;
+    state.motorVelocity = vars.reverse ? -speed : speed;
+    state.motorAcceleration = vars.reverse ? -acceleration : acceleration;
+    state.current = vars.internalUnitsToCurrent(vars.lastCurrentRead);
+    state.timestamp = vars.lastEncoderRead->queryTime();
+    state.mode = vars.actualControlMode;
+
+    jointStateSink->store(cycle, state);
 }
 
 // -----------------------------------------------------------------------------
 
-void TechnosoftIpos::handleEmcy(EmcyConsumer::code_t code, std::uint8_t reg, const std::uint8_t * msef)
+void TechnosoftIpos::handleEmcy(std::uint16_t code, std::uint8_t reg, const std::uint8_t * msef)
 {
-    switch (code.first)
+    // generic reporting is performed by the CAN master outside the CAN read thread
+    switch (code)
     {
     case 0x7300:
     {
@@ -488,9 +556,6 @@ void TechnosoftIpos::handleEmcy(EmcyConsumer::code_t code, std::uint8_t reg, con
         interpretIpStatus(ipStatus);
         break;
     }
-    default:
-        yWarning("%s (canId %d)", code.second.c_str(), can->getId());
-        break;
     }
 }
 
@@ -498,7 +563,6 @@ void TechnosoftIpos::handleEmcy(EmcyConsumer::code_t code, std::uint8_t reg, con
 
 void TechnosoftIpos::handleNmt(NmtState state)
 {
-    vars.lastHeartbeat = yarp::os::Time::now();
     std::uint8_t nmtState = static_cast<std::uint8_t>(state);
 
     // always report boot-up
@@ -534,30 +598,3 @@ void TechnosoftIpos::handleNmt(NmtState state)
 }
 
 // -----------------------------------------------------------------------------
-
-bool TechnosoftIpos::monitorWorker(const yarp::os::YarpTimerEvent & event)
-{
-    bool isConfigured = vars.actualControlMode != VOCAB_CM_NOT_CONFIGURED;
-    double elapsed = event.currentReal - vars.lastHeartbeat;
-
-    if (vars.heartbeatPeriod != 0.0 && isConfigured && elapsed > event.lastDuration)
-    {
-        yError("Last heartbeat response was %f seconds ago (canId %d)", elapsed, can->getId());
-        vars.actualControlMode = VOCAB_CM_NOT_CONFIGURED;
-        can->nmt()->issueServiceCommand(NmtService::RESET_NODE);
-        can->driveStatus()->reset();
-        vars.reset();
-    }
-    else if (!isConfigured && elapsed < event.lastDuration && vars.lastNmtState == 0) // boot-up event
-    {
-        if (!initialize())
-        {
-            yError("Unable to initialize CAN comms (canId %d)", can->getId());
-            can->nmt()->issueServiceCommand(NmtService::RESET_NODE);
-        }
-    }
-
-    return true;
-}
-
-// -----------------------------------------------------------------------------
@@ -3,7 +3,7 @@
 #ifndef __TECHNOSOFT_IPOS_HPP__
 #define __TECHNOSOFT_IPOS_HPP__
 
-#include <yarp/os/Timer.h>
+#include <vector>
 
 #include <yarp/dev/DeviceDriver.h>
 #include <yarp/dev/IAxisInfo.h>
@@ -22,9 +22,14 @@
 
 #include "CanOpenNode.hpp"
 #include "ICanBusSharer.hpp"
+#include "ICiA402Drive.hpp"
 
 #include "InterpolatedPositionBuffer.hpp"
 #include "StateVariables.hpp"
+#include "SyncCycleMonitor.hpp"
+#include "SyncInterpolator.hpp"
+#include "TechnosoftIposObjects.hpp"
+#include "TpdoMapping.hpp"
 
 #define CHECK_JOINT(j) do { int ax; if (getAxes(&ax), (j) != ax - 1) return false; } while (0)
 
@@ -32,8 +37,18 @@
 
 // seconds
 #define DEFAULT_SDO_TIMEOUT 0.02
+#define DEFAULT_SDO_MIN_TIMEOUT 0.005
+#define DEFAULT_SDO_MAX_TIMEOUT 0.1
 #define DEFAULT_DRIVE_STATE_TIMEOUT 2.0
 
+#define DEFAULT_SDO_RETRIES 2
+
+#define DEFAULT_ENCODER_ESTIMATOR "difference"
+#define DEFAULT_ENCODER_WINDOW 8
+#define DEFAULT_ENCODER_ALPHA 0.5
+#define DEFAULT_ENCODER_BETA 0.1
+#define DEFAULT_ENCODER_GAMMA 0.01
+
 namespace roboticslab
 {
 
@@ -70,7 +85,8 @@ class TechnosoftIpos : public yarp::dev::DeviceDriver,
                        public yarp::dev::IRemoteVariablesRaw,
                        public yarp::dev::ITorqueControlRaw,
                        public yarp::dev::IVelocityControlRaw,
-                       public ICanBusSharer
+                       public ICanBusSharer,
+                       public ICiA402Drive
 {
 public:
 
@@ -79,7 +95,8 @@ public:
           iEncodersTimedRawExternal(nullptr),
           iExternalEncoderCanBusSharer(nullptr),
           ipBuffer(nullptr),
-          monitorThread(nullptr)
+          syncInterpolator(nullptr),
+          jointStateSink(nullptr)
     { }
 
     ~TechnosoftIpos()
@@ -98,7 +115,19 @@ public:
     virtual bool initialize() override;
     virtual bool finalize() override;
     virtual bool registerSender(CanSenderDelegate * sender) override;
+    virtual bool registerJointStateSink(JointStateSink * sink) override;
     virtual bool synchronize() override;
+    virtual void onSync(std::uint64_t cycle) override;
+    virtual double getHeartbeatTimeout() override;
+    virtual void onHeartbeatLost(double elapsed) override;
+    virtual void onBootUp() override;
+
+    //  --------- ICiA402Drive declarations. Implementation in IControlModeRawImpl.cpp ---------
+
+    virtual DriveStatusMachine * getDriveStatusMachine() override
+    { return can->driveStatus(); }
+
+    virtual bool prepareControlModeRaw(int mode, DriveState * state) override;
 
     //  --------- IAxisInfoRaw declarations. Implementation in IAxisInfoRawImpl.cpp ---------
 
@@ -275,13 +304,19 @@ private:
     void interpretModesOfOperation(std::int8_t modesOfOperation);
     void interpretIpStatus(std::uint16_t ipStatus);
 
-    void handleTpdo1(std::uint16_t statusword, std::uint16_t msr, std::int8_t modesOfOperation);
-    void handleTpdo2(std::uint16_t mer, std::uint16_t der);
-    void handleTpdo3(std::int32_t position, std::int16_t current);
-    void handleEmcy(EmcyConsumer::code_t code, std::uint8_t reg, const std::uint8_t * msef);
-    void handleNmt(NmtState state);
+    bool prepareControlModeSwitch(int mode, bool * unchanged);
+
+    bool loadIpBuffer();
+    bool startIpMotion();
+    bool uploadTrajectory(const yarp::os::Searchable & config);
 
-    bool monitorWorker(const yarp::os::YarpTimerEvent & event);
+    bool configureTpdo(const yarp::os::Searchable & config, unsigned int n, TransmitPdo * tpdo, PdoConfiguration & conf);
+
+    void handleTpdo(const std::vector<TpdoMapping::object> & objects, const std::uint8_t * data, std::uint64_t syncCycle = 0);
+    void handleTpdoObject(std::uint16_t index, const std::uint8_t * data, std::uint64_t syncCycle);
+    void reportJointState(std::uint64_t cycle);
+    void handleEmcy(std::uint16_t code, std::uint8_t reg, const std::uint8_t * msef);
+    void handleNmt(NmtState state);
 
     CanOpenNode * can;
 
@@ -290,10 +325,11 @@ private:
     roboticslab::ICanBusSharer * iExternalEncoderCanBusSharer;
 
     StateVariables vars;
+    SyncCycleMonitor syncCycles;
 
     InterpolatedPositionBuffer * ipBuffer;
-
-    yarp::os::Timer * monitorThread;
+    SyncInterpolator * syncInterpolator;
+    JointStateSink * jointStateSink;
 };
 
 } // namespace roboticslab
@@ -0,0 +1,133 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#include "TpdoMapping.hpp"
+
+#include <cstdlib> // std::strtol
+
+#include <algorithm> // std::stable_partition
+
+#include "TechnosoftIposObjects.hpp"
+
+using namespace roboticslab;
+
+namespace
+{
+    template<typename Obj>
+    unsigned int mapObject(PdoConfiguration * conf)
+    {
+        if (conf)
+        {
+            conf->addMapping(Obj());
+        }
+
+        return sizeof(typename Obj::type);
+    }
+
+    // returns object size (in bytes), zero if not supported by TechnosoftIpos::handleTpdoObject
+    unsigned int mapObject(std::uint16_t index, PdoConfiguration * conf = nullptr)
+    {
+        using namespace IposObjects;
+
+        switch (index)
+        {
+        case ManufacturerStatusRegister::index:
+            return mapObject<ManufacturerStatusRegister>(conf);
+        case Statusword::index:
+            return mapObject<Statusword>(conf);
+        case MotionErrorRegister::index:
+            return mapObject<MotionErrorRegister>(conf);
+        case DetailedErrorRegister::index:
+            return mapObject<DetailedErrorRegister>(conf);
+        case DCLinkVoltage::index:
+            return mapObject<DCLinkVoltage>(conf);
+        case ModesOfOperationDisplay::index:
+            return mapObject<ModesOfOperationDisplay>(conf);
+        case PositionActualInternalValue::index:
+            return mapObject<PositionActualInternalValue>(conf);
+        case VelocityActualValue::index:
+            return mapObject<VelocityActualValue>(conf);
+        case TorqueActualValue::index:
+            return mapObject<TorqueActualValue>(conf);
+        default:
+            return 0;
+        }
+    }
+}
+
+std::vector<std::uint16_t> TpdoMapping::getDefaultLayout(unsigned int n)
+{
+    switch (n)
+    {
+    case 1:
+        return {IposObjects::ManufacturerStatusRegister::index, IposObjects::ModesOfOperationDisplay::index};
+    case 2:
+        return {IposObjects::MotionErrorRegister::index, IposObjects::DetailedErrorRegister::index};
+    case 3:
+        return {IposObjects::PositionActualInternalValue::index, IposObjects::TorqueActualValue::index};
+    default: // disabled
+        return {};
+    }
+}
+
+bool TpdoMapping::parseIndex(const std::string & s, std::uint16_t * index)
+{
+    if (s.empty())
+    {
+        return false;
+    }
+
+    char * end;
+    long parsed = std::strtol(s.c_str(), &end, 0);
+
+    if (*end != '\0' || parsed < 0 || parsed > 0xFFFF)
+    {
+        return false;
+    }
+
+    *index = parsed;
+    return true;
+}
+
+bool TpdoMapping::hasDuplicateStatusword(const std::set<std::uint16_t> & indices)
+{
+    return indices.count(IposObjects::ManufacturerStatusRegister::index) != 0
+        && indices.count(IposObjects::Statusword::index) != 0;
+}
+
+bool TpdoMapping::add(std::uint16_t index)
+{
+    unsigned int objectSize = mapObject(index);
+
+    if (objectSize == 0 || size + objectSize > 8 || indices.count(index) != 0)
+    {
+        return false;
+    }
+
+    std::set<std::uint16_t> candidate(indices);
+    candidate.insert(index);
+
+    if (hasDuplicateStatusword(candidate))
+    {
+        return false;
+    }
+
+    indices.swap(candidate);
+    mapped.emplace_back(index, size);
+    size += objectSize;
+
+    parsed = mapped;
+
+    // modes of operation must be parsed prior to the statusword
+    std::stable_partition(parsed.begin(), parsed.end(), [](const object & o)
+        { return o.first == IposObjects::ModesOfOperationDisplay::index; });
+
+    return true;
+}
+
+void TpdoMapping::configure(PdoConfiguration & conf) const
+{
+    for (const auto & o : mapped)
+    {
+        mapObject(o.first, &conf);
+    }
+}
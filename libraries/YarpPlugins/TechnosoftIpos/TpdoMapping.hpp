@@ -0,0 +1,66 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __TPDO_MAPPING_HPP__
+#define __TPDO_MAPPING_HPP__
+
+#include <cstdint>
+
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "PdoProtocol.hpp"
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup TechnosoftIpos
+ * @brief Layout of the objects mapped into a TPDO.
+ *
+ * Only objects interpreted by TechnosoftIpos are accepted, and the statusword
+ * may be mapped just once, either standalone (6041h) or along with the MSR
+ * (1002h). Objects are parsed in mapping order, except for the modes of
+ * operation display (6061h), which goes first since the statusword depends
+ * on it.
+ */
+class TpdoMapping final
+{
+public:
+    //! Mapped object index and its byte offset within the TPDO payload.
+    using object = std::pair<std::uint16_t, unsigned int>;
+
+    //! Retrieve the default layout of TPDO @p n (starting at 1), empty if disabled.
+    static std::vector<std::uint16_t> getDefaultLayout(unsigned int n);
+
+    //! Parse an object index in any base, e.g. "24578" or "0x6002".
+    static bool parseIndex(const std::string & s, std::uint16_t * index);
+
+    //! Check whether the statusword is mapped twice, possibly across TPDOs.
+    static bool hasDuplicateStatusword(const std::set<std::uint16_t> & indices);
+
+    //! Map an object, fails if unsupported, already mapped or exceeding 8 bytes.
+    bool add(std::uint16_t index);
+
+    //! Retrieve mapped objects in parsing order.
+    const std::vector<object> & getObjects() const
+    { return parsed; }
+
+    //! Retrieve cumulative size of mapped objects (bytes).
+    unsigned int getSize() const
+    { return size; }
+
+    //! Register mapped objects in a PDO configuration, in mapping order.
+    void configure(PdoConfiguration & conf) const;
+
+private:
+    std::vector<object> mapped;
+    std::vector<object> parsed;
+    std::set<std::uint16_t> indices;
+    unsigned int size {0};
+};
+
+} // namespace roboticslab
+
+#endif // __TPDO_MAPPING_HPP__
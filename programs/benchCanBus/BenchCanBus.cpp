@@ -0,0 +1,558 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#include "BenchCanBus.hpp"
+
+#include <sys/resource.h> // getrusage
+
+#include <cmath>
+#include <cstdint>
+
+#include <algorithm>
+#include <fstream>
+#include <numeric>
+#include <set>
+#include <sstream>
+
+#include <yarp/os/Bottle.h>
+#include <yarp/os/LogStream.h>
+#include <yarp/os/ResourceFinder.h>
+#include <yarp/os/Value.h>
+
+#include <yarp/dev/IControlMode.h>
+
+#include "SimulatedCanBus.hpp"
+
+using namespace roboticslab;
+
+// -----------------------------------------------------------------------------
+
+namespace
+{
+    struct summary
+    {
+        double mean, stddev, min, p50, p99, p999, max;
+    };
+
+    summary summarize(std::vector<double> values)
+    {
+        summary s {};
+
+        if (values.empty())
+        {
+            return s;
+        }
+
+        std::sort(values.begin(), values.end());
+
+        s.mean = std::accumulate(values.cbegin(), values.cend(), 0.0) / values.size();
+
+        for (auto value : values)
+        {
+            s.stddev += (value - s.mean) * (value - s.mean);
+        }
+
+        s.stddev = std::sqrt(s.stddev / values.size());
+
+        auto percentile = [&values](double q) { return values[std::lround(q * (values.size() - 1))]; };
+
+        s.min = values.front();
+        s.p50 = percentile(0.5);
+        s.p99 = percentile(0.99);
+        s.p999 = percentile(0.999);
+        s.max = values.back();
+
+        return s;
+    }
+
+    std::string toJson(const summary & s)
+    {
+        std::ostringstream oss;
+        oss << "{\"mean\": " << s.mean << ", \"stddev\": " << s.stddev << ", \"min\": " << s.min
+            << ", \"p50\": " << s.p50 << ", \"p99\": " << s.p99 << ", \"p99.9\": " << s.p999
+            << ", \"max\": " << s.max << "}";
+        return oss.str();
+    }
+
+    bool readThread(long tid, double * cpu, double * wait, long * voluntary, long * involuntary)
+    {
+        const std::string path = "/proc/self/task/" + std::to_string(tid);
+
+        std::ifstream schedstat(path + "/schedstat");
+        unsigned long long runNs, waitNs;
+
+        if (!(schedstat >> runNs >> waitNs))
+        {
+            return false; // thread is gone or kernel built without CONFIG_SCHED_INFO
+        }
+
+        *cpu = runNs * 1e-9;
+        *wait = waitNs * 1e-9;
+
+        std::ifstream status(path + "/status");
+        std::string key;
+
+        while (status >> key)
+        {
+            if (key == "voluntary_ctxt_switches:")
+            {
+                status >> *voluntary;
+            }
+            else if (key == "nonvoluntary_ctxt_switches:")
+            {
+                status >> *involuntary;
+            }
+        }
+
+        return true;
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+bool BenchCanBus::configure(yarp::os::ResourceFinder & rf)
+{
+    yDebug() << "BenchCanBus config:" << rf.toString();
+
+    buses = rf.check("buses", yarp::os::Value(1), "number of simulated CAN buses").asInt32();
+    nodes = rf.check("nodes", yarp::os::Value(6), "number of simulated drives per bus").asInt32();
+    syncPeriod = rf.check("syncPeriod", yarp::os::Value(0.001), "SYNC period (seconds)").asFloat64();
+    clientPeriod = rf.check("clientPeriod", yarp::os::Value(syncPeriod), "period of position commands (seconds)").asFloat64();
+    warmup = rf.check("warmup", yarp::os::Value(2.0), "time before measurements start (seconds)").asFloat64();
+    duration = rf.check("duration", yarp::os::Value(10.0), "measurement time (seconds)").asFloat64();
+    amplitude = rf.check("amplitude", yarp::os::Value(10.0), "amplitude of commanded sine wave (degrees)").asFloat64();
+    frequency = rf.check("frequency", yarp::os::Value(0.5), "frequency of commanded sine wave (hertz)").asFloat64();
+    rxDelay = rf.check("rxDelay", yarp::os::Value(0.0005), "CAN bus RX delay (seconds)").asFloat64();
+    txDelay = rf.check("txDelay", yarp::os::Value(0.0005), "CAN bus TX delay (seconds)").asFloat64();
+    bitrate = rf.check("bitrate", yarp::os::Value(1000000), "nominal CAN bitrate (bits per second)").asInt32();
+    busAffinity = rf.check("busAffinity", yarp::os::Value(false), "dispatch commands on bus-affine worker threads").asBool();
+    output = rf.check("output", yarp::os::Value(""), "path to JSON report").asString();
+
+    if (buses <= 0 || nodes <= 0 || nodes > 127)
+    {
+        yError() << "Illegal number of buses or nodes per bus:" << buses << nodes;
+        return false;
+    }
+
+    if (syncPeriod <= 0.0 || clientPeriod <= 0.0 || duration <= 0.0 || warmup < 0.0)
+    {
+        yError() << "Illegal period, warmup or duration options";
+        return false;
+    }
+
+    if (rxDelay <= 0.0 || txDelay <= 0.0 || bitrate <= 0)
+    {
+        yError() << "Illegal CAN bus options";
+        return false;
+    }
+
+    if (amplitude < 0.0 || amplitude >= 90.0 || frequency < 0.0)
+    {
+        yError() << "Illegal sine wave options, amplitude must lie within [0, 90) degrees";
+        return false;
+    }
+
+    SimulatedCanBus::registerDevice();
+
+    if (!robotConfig.fromConfig(makeRobotConfig().c_str()))
+    {
+        yError() << "Unable to parse robot configuration";
+        return false;
+    }
+
+    const auto * robotConfigPtr = &robotConfig;
+
+    yarp::os::Property options;
+    options.put("device", "CanBusControlboard");
+    options.put("robotConfig", yarp::os::Value::makeBlob(&robotConfigPtr, sizeof(robotConfigPtr)));
+    options.put("syncPeriod", syncPeriod);
+    options.put("busAffinity", busAffinity);
+
+    auto * busList = yarp::os::Value::makeList();
+
+    for (int i = 1; i <= buses; i++)
+    {
+        const std::string bus = "bus" + std::to_string(i);
+        auto * nodeList = yarp::os::Value::makeList();
+
+        for (int j = 1; j <= nodes; j++)
+        {
+            nodeList->asList()->addString(bus + "-node" + std::to_string(j));
+        }
+
+        busList->asList()->addString(bus);
+        options.put(bus, nodeList);
+    }
+
+    options.put("buses", busList);
+
+    if (!controlboard.open(options))
+    {
+        yError() << "Unable to open CanBusControlboard device";
+        return false;
+    }
+
+    if (SimulatedCanBus::getInstances().size() != static_cast<std::size_t>(buses))
+    {
+        yError() << "Unable to retrieve all simulated CAN buses";
+        return false;
+    }
+
+    yarp::dev::IControlMode * iControlMode;
+
+    if (!controlboard.view(iControlMode) || !controlboard.view(iPositionDirect))
+    {
+        yError() << "Unable to view control board interfaces";
+        return false;
+    }
+
+    int axes;
+
+    if (!iPositionDirect->getAxes(&axes) || axes != buses * nodes)
+    {
+        yError() << "Unexpected number of joints";
+        return false;
+    }
+
+    std::vector<int> modes(axes, VOCAB_CM_POSITION_DIRECT);
+
+    if (!iControlMode->setControlModes(modes.data()) || !iControlMode->getControlModes(modes.data())
+        || std::count(modes.cbegin(), modes.cend(), VOCAB_CM_POSITION_DIRECT) != axes)
+    {
+        yError() << "Unable to switch all joints to position direct mode";
+        return false;
+    }
+
+    targets.assign(axes, 0.0);
+    clientLatencies.reserve(static_cast<std::size_t>(duration / clientPeriod) + 1);
+
+    yInfo() << "Streaming position commands to" << axes << "joints, warming up for" << warmup << "seconds";
+
+    startTime = std::chrono::steady_clock::now();
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+bool BenchCanBus::updateModule()
+{
+    auto start = std::chrono::steady_clock::now();
+    double elapsed = std::chrono::duration<double>(start - startTime).count();
+
+    std::fill(targets.begin(), targets.end(), amplitude * std::sin(2.0 * M_PI * frequency * elapsed));
+
+    if (!iPositionDirect->setPositions(targets.data()))
+    {
+        yWarning() << "setPositions() failed";
+    }
+
+    if (measuring)
+    {
+        clientLatencies.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+
+        if (elapsed >= warmup + duration)
+        {
+            endMeasurement();
+            return false;
+        }
+    }
+    else if (elapsed >= warmup)
+    {
+        beginMeasurement();
+    }
+
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+bool BenchCanBus::close()
+{
+    return controlboard.close();
+}
+
+// -----------------------------------------------------------------------------
+
+std::string BenchCanBus::makeRobotConfig() const
+{
+    std::ostringstream oss;
+
+    oss << "[common-ipos]\n"
+        << "driver bench-driver\n"
+        << "motor bench-motor\n"
+        << "gearbox bench-gearbox\n"
+        << "encoder bench-encoder\n"
+        << "type atrv\n"
+        << "min -90.0\n"
+        << "max 90.0\n"
+        << "maxVel 100.0\n"
+        << "refSpeed 10.0\n"
+        << "refAcceleration 10.0\n"
+        << "samplingPeriod 0.001\n"
+        << "[bench-driver]\n"
+        << "peakCurrent 10.0\n"
+        << "[bench-motor]\n"
+        << "k 0.0706\n"
+        << "[bench-gearbox]\n"
+        << "tr 160.0\n"
+        << "[bench-encoder]\n"
+        << "encoderPulses 4096\n";
+
+    for (int i = 1; i <= buses; i++)
+    {
+        const std::string bus = "bus" + std::to_string(i);
+
+        oss << "[" << bus << "]\n"
+            << "device " << SimulatedCanBus::NAME << "\n"
+            << "bitrate " << bitrate << "\n"
+            << "rxBufferSize 500\n"
+            << "txBufferSize 500\n"
+            << "rxDelay " << rxDelay << "\n"
+            << "txDelay " << txDelay << "\n"
+            << "nodeIds (";
+
+        for (int j = 1; j <= nodes; j++)
+        {
+            oss << (j != 1 ? " " : "") << j;
+        }
+
+        oss << ")\n";
+
+        for (int j = 1; j <= nodes; j++)
+        {
+            oss << "[" << bus << "-node" << j << "]\n"
+                << "device TechnosoftIpos\n"
+                << "canId " << j << "\n"
+                << "name " << bus << "-node" << j << "\n";
+        }
+    }
+
+    return oss.str();
+}
+
+// -----------------------------------------------------------------------------
+
+BenchCanBus::usage_sample BenchCanBus::sampleUsage(int who)
+{
+    struct rusage usage;
+    getrusage(who, &usage);
+
+    double cpu = usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1e-6;
+    return {cpu, usage.ru_nvcsw, usage.ru_nivcsw};
+}
+
+// -----------------------------------------------------------------------------
+
+std::map<long, BenchCanBus::thread_sample> BenchCanBus::sampleThreads() const
+{
+    std::map<long, thread_sample> samples;
+
+    for (auto * bus : SimulatedCanBus::getInstances())
+    {
+        auto roles = bus->getThreadRoles();
+
+        for (const auto * tids : {&roles.reader, &roles.sync, &roles.writer})
+        {
+            for (auto tid : *tids)
+            {
+                thread_sample sample {};
+
+                if (readThread(tid, &sample.cpu, &sample.wait, &sample.voluntary, &sample.involuntary))
+                {
+                    samples[tid] = sample;
+                }
+            }
+        }
+    }
+
+    return samples;
+}
+
+// -----------------------------------------------------------------------------
+
+void BenchCanBus::beginMeasurement()
+{
+    for (auto * bus : SimulatedCanBus::getInstances())
+    {
+        bus->getStatistics(true);
+    }
+
+    threadsStart = sampleThreads();
+    processStart = sampleUsage(RUSAGE_SELF);
+    clientStart = sampleUsage(RUSAGE_THREAD);
+    measurementStart = std::chrono::steady_clock::now();
+    measuring = true;
+
+    yInfo() << "Measuring for" << duration << "seconds";
+}
+
+// -----------------------------------------------------------------------------
+
+void BenchCanBus::endMeasurement()
+{
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - measurementStart).count();
+    usage_sample processEnd = sampleUsage(RUSAGE_SELF);
+    usage_sample clientEnd = sampleUsage(RUSAGE_THREAD);
+    std::map<long, thread_sample> threadsEnd = sampleThreads();
+
+    measuring = false;
+
+    auto instances = SimulatedCanBus::getInstances();
+    std::vector<SimulatedCanBus::statistics> stats;
+    std::vector<double> intervals;
+    std::vector<double> latencies;
+    std::uint64_t missedFeedback = 0;
+    double simulationTime = 0.0;
+
+    // a thread is only accounted once, under its first role
+    std::set<long> roleTids[3];
+    std::set<long> seen;
+
+    for (auto * bus : instances)
+    {
+        stats.push_back(bus->getStatistics());
+        const auto & last = stats.back();
+
+        intervals.insert(intervals.end(), last.syncIntervals.cbegin(), last.syncIntervals.cend());
+        latencies.insert(latencies.end(), last.feedbackLatencies.cbegin(), last.feedbackLatencies.cend());
+        missedFeedback += last.missedFeedback;
+        simulationTime += last.simulationTime;
+
+        auto roles = bus->getThreadRoles();
+        const std::set<long> * tids[3] = {&roles.reader, &roles.sync, &roles.writer};
+
+        for (int i = 0; i < 3; i++)
+        {
+            for (auto tid : *tids[i])
+            {
+                if (seen.insert(tid).second)
+                {
+                    roleTids[i].insert(tid);
+                }
+            }
+        }
+    }
+
+    const std::size_t cycles = stats.empty() ? 0 : stats.front().syncIntervals.size();
+
+    if (cycles == 0)
+    {
+        yError() << "No SYNC cycles recorded";
+        return;
+    }
+
+    const auto intervalSummary = summarize(intervals);
+    const auto latencySummary = summarize(latencies);
+    const auto clientSummary = summarize(clientLatencies);
+
+    const std::size_t overruns = std::count_if(intervals.cbegin(), intervals.cend(),
+        [this](double interval) { return interval > 1.5 * syncPeriod; });
+
+    // the client thread (this one) is not part of the control cycle
+    const double cpu = (processEnd.cpu - processStart.cpu) - (clientEnd.cpu - clientStart.cpu);
+    const long voluntary = (processEnd.voluntary - processStart.voluntary) - (clientEnd.voluntary - clientStart.voluntary);
+    const long involuntary = (processEnd.involuntary - processStart.involuntary) - (clientEnd.involuntary - clientStart.involuntary);
+
+    yInfo("Configuration: %d buses, %d drives per bus, SYNC period %.3f ms, client period %.3f ms%s",
+          buses, nodes, syncPeriod * 1e3, clientPeriod * 1e3, busAffinity ? ", bus affinity" : "");
+    yInfo("Measured %zu SYNC cycles in %.3f s", cycles, elapsed);
+    yInfo("SYNC interval (ms): mean %.4f, stddev %.4f, min %.4f, p50 %.4f, p99 %.4f, p99.9 %.4f, max %.4f, overruns (>1.5T) %zu",
+          intervalSummary.mean * 1e3, intervalSummary.stddev * 1e3, intervalSummary.min * 1e3, intervalSummary.p50 * 1e3,
+          intervalSummary.p99 * 1e3, intervalSummary.p999 * 1e3, intervalSummary.max * 1e3, overruns);
+    yInfo("SYNC-to-feedback latency (ms): mean %.4f, p50 %.4f, p99 %.4f, max %.4f, missed cycles %llu",
+          latencySummary.mean * 1e3, latencySummary.p50 * 1e3, latencySummary.p99 * 1e3, latencySummary.max * 1e3,
+          static_cast<unsigned long long>(missedFeedback));
+    yInfo("setPositions() call (us): mean %.2f, p50 %.2f, p99 %.2f, max %.2f",
+          clientSummary.mean * 1e6, clientSummary.p50 * 1e6, clientSummary.p99 * 1e6, clientSummary.max * 1e6);
+    yInfo("CPU per cycle (us): %.2f (%.1f%% of one core), of which simulated drives %.2f",
+          cpu / cycles * 1e6, cpu / elapsed * 100.0, simulationTime / cycles * 1e6);
+    yInfo("Context switches per cycle: %.3f voluntary, %.3f involuntary",
+          static_cast<double>(voluntary) / cycles, static_cast<double>(involuntary) / cycles);
+
+    const char * roleNames[3] = {"reader", "sync", "writer"};
+    std::ostringstream threadsJson;
+    double rolesCpu = 0.0;
+
+    for (int i = 0; i < 3; i++)
+    {
+        thread_sample total {};
+
+        for (auto tid : roleTids[i])
+        {
+            auto end = threadsEnd.find(tid);
+
+            if (end == threadsEnd.cend())
+            {
+                continue;
+            }
+
+            auto start = threadsStart.find(tid);
+            thread_sample begin = start != threadsStart.cend() ? start->second : thread_sample {};
+
+            total.cpu += end->second.cpu - begin.cpu;
+            total.wait += end->second.wait - begin.wait;
+            total.voluntary += end->second.voluntary - begin.voluntary;
+            total.involuntary += end->second.involuntary - begin.involuntary;
+        }
+
+        rolesCpu += total.cpu;
+
+        yInfo("  %s threads (%zu): CPU %.2f us/cycle, run queue wait %.2f us/cycle, context switches %.3f voluntary + %.3f involuntary per cycle",
+              roleNames[i], roleTids[i].size(), total.cpu / cycles * 1e6, total.wait / cycles * 1e6,
+              static_cast<double>(total.voluntary) / cycles, static_cast<double>(total.involuntary) / cycles);
+
+        threadsJson << (i != 0 ? ", " : "") << "\"" << roleNames[i] << "\": {\"threads\": " << roleTids[i].size()
+                    << ", \"cpuPerCycle\": " << total.cpu / cycles << ", \"waitPerCycle\": " << total.wait / cycles
+                    << ", \"voluntaryPerCycle\": " << static_cast<double>(total.voluntary) / cycles
+                    << ", \"involuntaryPerCycle\": " << static_cast<double>(total.involuntary) / cycles << "}";
+    }
+
+    yInfo("  other threads: CPU %.2f us/cycle", (cpu - rolesCpu) / cycles * 1e6);
+
+    std::ostringstream busesJson;
+
+    for (std::size_t i = 0; i < stats.size(); i++)
+    {
+        const auto & s = stats[i];
+        double load = (s.txBits + s.rxBits) / (instances[i]->getBitrate() * elapsed);
+
+        yInfo("  bus%zu: TX %.0f frames/s, RX %.0f frames/s, estimated load %.1f%%",
+              i + 1, s.txFrames / elapsed, s.rxFrames / elapsed, load * 100.0);
+
+        busesJson << (i != 0 ? ", " : "") << "{\"txFramesPerSecond\": " << s.txFrames / elapsed
+                  << ", \"rxFramesPerSecond\": " << s.rxFrames / elapsed << ", \"load\": " << load << "}";
+    }
+
+    if (!output.empty())
+    {
+        std::ofstream out(output);
+
+        out << "{\n"
+            << "  \"config\": {\"buses\": " << buses << ", \"nodes\": " << nodes << ", \"syncPeriod\": " << syncPeriod
+            << ", \"clientPeriod\": " << clientPeriod << ", \"busAffinity\": " << (busAffinity ? "true" : "false") << "},\n"
+            << "  \"elapsed\": " << elapsed << ",\n"
+            << "  \"cycles\": " << cycles << ",\n"
+            << "  \"syncInterval\": " << toJson(intervalSummary) << ",\n"
+            << "  \"overruns\": " << overruns << ",\n"
+            << "  \"feedbackLatency\": " << toJson(latencySummary) << ",\n"
+            << "  \"missedFeedback\": " << missedFeedback << ",\n"
+            << "  \"clientLatency\": " << toJson(clientSummary) << ",\n"
+            << "  \"cpuPerCycle\": " << cpu / cycles << ",\n"
+            << "  \"simulationPerCycle\": " << simulationTime / cycles << ",\n"
+            << "  \"voluntaryPerCycle\": " << static_cast<double>(voluntary) / cycles << ",\n"
+            << "  \"involuntaryPerCycle\": " << static_cast<double>(involuntary) / cycles << ",\n"
+            << "  \"threads\": {" << threadsJson.str() << "},\n"
+            << "  \"bus\": [" << busesJson.str() << "]\n"
+            << "}\n";
+
+        if (!out)
+        {
+            yError() << "Unable to write report to" << output;
+        }
+        else
+        {
+            yInfo() << "Report written to" << output;
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
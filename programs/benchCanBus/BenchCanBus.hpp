@@ -0,0 +1,97 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __BENCH_CAN_BUS__
+#define __BENCH_CAN_BUS__
+
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <yarp/os/Property.h>
+#include <yarp/os/RFModule.h>
+
+#include <yarp/dev/IPositionDirect.h>
+#include <yarp/dev/PolyDriver.h>
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup benchCanBus
+ * @brief Drives a CanBusControlboard instance on simulated CAN buses and
+ * reports control cycle statistics.
+ */
+class BenchCanBus : public yarp::os::RFModule
+{
+public:
+    ~BenchCanBus()
+    { close(); }
+
+    bool configure(yarp::os::ResourceFinder & rf) override;
+
+    double getPeriod() override
+    { return clientPeriod; }
+
+    bool updateModule() override;
+
+    bool close() override;
+
+private:
+    //! Resource usage of a single thread.
+    struct thread_sample
+    {
+        double cpu; // seconds
+        double wait; // seconds spent on a run queue
+        long voluntary; // context switches
+        long involuntary; // context switches
+    };
+
+    //! Resource usage of the whole process (or a single thread).
+    struct usage_sample
+    {
+        double cpu; // seconds
+        long voluntary; // context switches
+        long involuntary; // context switches
+    };
+
+    static usage_sample sampleUsage(int who);
+
+    std::string makeRobotConfig() const;
+    std::map<long, thread_sample> sampleThreads() const;
+    void beginMeasurement();
+    void endMeasurement();
+
+    int buses;
+    int nodes;
+    double syncPeriod;
+    double clientPeriod;
+    double warmup;
+    double duration;
+    double amplitude;
+    double frequency;
+    double rxDelay;
+    double txDelay;
+    int bitrate;
+    bool busAffinity;
+    std::string output;
+
+    yarp::os::Property robotConfig;
+    yarp::dev::PolyDriver controlboard;
+    yarp::dev::IPositionDirect * iPositionDirect {nullptr};
+
+    std::vector<double> targets;
+    std::vector<double> clientLatencies;
+
+    std::chrono::steady_clock::time_point startTime;
+    std::chrono::steady_clock::time_point measurementStart;
+    bool measuring {false};
+
+    usage_sample processStart;
+    usage_sample clientStart;
+    std::map<long, thread_sample> threadsStart;
+};
+
+} // namespace roboticslab
+
+#endif // __BENCH_CAN_BUS__
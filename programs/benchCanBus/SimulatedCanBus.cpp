@@ -0,0 +1,263 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#include "SimulatedCanBus.hpp"
+
+#include <sys/syscall.h> // SYS_gettid
+#include <unistd.h> // syscall
+
+#include <cmath>
+#include <cstring> // std::memcpy
+
+#include <algorithm>
+
+#include <yarp/os/Bottle.h>
+#include <yarp/os/LogStream.h>
+#include <yarp/os/Value.h>
+#include <yarp/dev/Drivers.h>
+
+using namespace roboticslab;
+
+constexpr const char * SimulatedCanBus::NAME;
+
+// -----------------------------------------------------------------------------
+
+namespace
+{
+    std::mutex instancesMutex;
+    std::vector<SimulatedCanBus *> instances;
+
+    // same estimate as BusLoadMonitor, standard frames with worst-case bit stuffing
+    inline unsigned long computeLength(unsigned int len)
+    {
+        return 8 * len + 44 + std::floor((34 + 8 * len - 1) / 4.0) + 3;
+    }
+
+    inline void registerCaller(std::set<long> & tids)
+    {
+        static thread_local long tid = syscall(SYS_gettid);
+        tids.insert(tid);
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+void SimulatedCanBus::registerDevice()
+{
+    yarp::dev::Drivers::factory().add(new yarp::dev::DriverCreatorOf<SimulatedCanBus>(NAME, "", NAME));
+}
+
+// -----------------------------------------------------------------------------
+
+std::vector<SimulatedCanBus *> SimulatedCanBus::getInstances()
+{
+    std::lock_guard<std::mutex> lock(instancesMutex);
+    return instances;
+}
+
+// -----------------------------------------------------------------------------
+
+SimulatedCanBus::statistics SimulatedCanBus::getStatistics(bool reset)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    statistics copy = stats;
+
+    if (reset)
+    {
+        stats = {};
+    }
+
+    return copy;
+}
+
+// -----------------------------------------------------------------------------
+
+SimulatedCanBus::thread_roles SimulatedCanBus::getThreadRoles()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return roles;
+}
+
+// -----------------------------------------------------------------------------
+
+bool SimulatedCanBus::open(yarp::os::Searchable & config)
+{
+    int rate = config.check("bitrate", yarp::os::Value(1000000), "nominal bitrate (bits per second)").asInt32();
+
+    if (rate <= 0)
+    {
+        yError() << "Illegal bitrate:" << rate;
+        return false;
+    }
+
+    bitrate = rate;
+
+    const auto * nodeIds = config.find("nodeIds").asList();
+
+    if (nodeIds == nullptr)
+    {
+        yError() << "Missing key \"nodeIds\" or not a list";
+        return false;
+    }
+
+    for (int i = 0; i < nodeIds->size(); i++)
+    {
+        int id = nodeIds->get(i).asInt32();
+
+        if (id <= 0 || id > 127 || nodes[id] != nullptr)
+        {
+            yError() << "Illegal or duplicated CAN node ID:" << id;
+            return false;
+        }
+
+        drives.push_back(std::make_unique<SimulatedDrive>(id));
+        nodes[id] = drives.back().get();
+    }
+
+    yInfo() << "Simulated CAN bus with" << drives.size() << "drives at" << bitrate << "bps";
+
+    std::lock_guard<std::mutex> lock(instancesMutex);
+    instances.push_back(this);
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+bool SimulatedCanBus::close()
+{
+    std::lock_guard<std::mutex> lock(instancesMutex);
+    instances.erase(std::remove(instances.begin(), instances.end(), this), instances.end());
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+bool SimulatedCanBus::canSetBaudRate(unsigned int rate)
+{
+    bitrate = rate;
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+bool SimulatedCanBus::canGetBaudRate(unsigned int * rate)
+{
+    *rate = bitrate;
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+bool SimulatedCanBus::canRead(yarp::dev::CanBuffer & msgs, unsigned int size, unsigned int * read, bool wait)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto now = std::chrono::steady_clock::now();
+    unsigned int n = 0;
+
+    registerCaller(roles.reader);
+
+    while (n < size && !rxQueue.empty())
+    {
+        const auto & queued = rxQueue.front();
+        auto & msg = msgs[n++];
+
+        msg.setId(queued.frame.id);
+        msg.setLen(queued.frame.len);
+        std::memcpy(msg.getData(), queued.frame.data, queued.frame.len);
+
+        stats.rxFrames++;
+        stats.rxBits += computeLength(queued.frame.len);
+
+        if (queued.syncCycle == syncCycle && pendingFeedback != 0 && --pendingFeedback == 0)
+        {
+            stats.feedbackLatencies.push_back(std::chrono::duration<double>(now - lastSync).count());
+        }
+
+        rxQueue.pop_front();
+    }
+
+    *read = n;
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+bool SimulatedCanBus::canWrite(const yarp::dev::CanBuffer & msgs, unsigned int size, unsigned int * sent, bool wait)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto start = std::chrono::steady_clock::now();
+    bool hasSync = false;
+
+    for (unsigned int i = 0; i < size; i++)
+    {
+        const auto & msg = msgs[i];
+        sim_frame frame {msg.getId(), static_cast<std::uint8_t>(std::min<unsigned int>(msg.getLen(), 8)), {0}};
+        std::memcpy(frame.data, msg.getData(), frame.len);
+
+        stats.txFrames++;
+        stats.txBits += computeLength(frame.len);
+
+        if (frame.id == 0x080)
+        {
+            auto now = std::chrono::steady_clock::now();
+
+            if (syncCycle != 0)
+            {
+                stats.syncIntervals.push_back(std::chrono::duration<double>(now - lastSync).count());
+                stats.missedFeedback += pendingFeedback != 0;
+            }
+
+            hasSync = true;
+            lastSync = now;
+            syncCycle++;
+
+            for (auto & drive : drives)
+            {
+                drive->handleSync(responses);
+            }
+
+            pendingFeedback = responses.size();
+            flushResponses(syncCycle);
+        }
+        else if (frame.id == 0x000) // NMT
+        {
+            for (auto & drive : drives)
+            {
+                drive->handleMessage(frame, responses);
+            }
+
+            flushResponses(0);
+        }
+        else if (auto * drive = nodes[frame.id & 0x7F])
+        {
+            drive->handleMessage(frame, responses);
+            flushResponses(0);
+        }
+    }
+
+    registerCaller(hasSync ? roles.sync : roles.writer);
+    stats.simulationTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    *sent = size;
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+bool SimulatedCanBus::canGetErrors(yarp::dev::CanErrors & err)
+{
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+void SimulatedCanBus::flushResponses(std::uint64_t cycle)
+{
+    for (const auto & frame : responses)
+    {
+        rxQueue.push_back({frame, cycle});
+    }
+
+    responses.clear();
+}
+
+// -----------------------------------------------------------------------------
@@ -0,0 +1,135 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __SIMULATED_CAN_BUS__
+#define __SIMULATED_CAN_BUS__
+
+#include <cstdint>
+
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
+
+#include <yarp/dev/CanBusInterface.h>
+#include <yarp/dev/DeviceDriver.h>
+
+#include "SimulatedCanMessage.hpp"
+#include "SimulatedDrive.hpp"
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup benchCanBus
+ * @brief In-process CAN bus with simulated drives attached to it.
+ *
+ * Frames written by the CAN master are handled by the simulated drives within
+ * the caller's thread, their responses are queued for the next read. Traffic,
+ * SYNC timing and the identity of calling threads are recorded for later
+ * inspection by @ref BenchCanBus. Register it as a YARP device with
+ * @ref SimulatedCanBus::registerDevice, options:
+ *
+ * - <code>bitrate</code>: nominal bitrate (bits per second), used to estimate bus load
+ * - <code>nodeIds</code>: list of CAN node IDs of simulated drives
+ */
+class SimulatedCanBus : public yarp::dev::DeviceDriver,
+                        public yarp::dev::ICanBus,
+                        public yarp::dev::ICanBusErrors,
+                        public yarp::dev::ImplementCanBufferFactory<SimulatedCanMessage, sim_frame>
+{
+public:
+    //! Device name to be used in the <code>device</code> option.
+    static constexpr const char * NAME = "SimulatedCanBus";
+
+    //! Traffic and timing records.
+    struct statistics
+    {
+        std::uint64_t txFrames {0};
+        std::uint64_t rxFrames {0};
+        std::uint64_t txBits {0};
+        std::uint64_t rxBits {0};
+        std::uint64_t missedFeedback {0}; ///< SYNC cycles whose TPDOs were not read before the next SYNC
+        double simulationTime {0.0}; ///< time spent handling written frames, mostly within simulated drives (seconds)
+        std::vector<double> syncIntervals; ///< time between consecutive SYNC frames (seconds)
+        std::vector<double> feedbackLatencies; ///< time between SYNC and the read of its last TPDO (seconds)
+    };
+
+    //! Kernel thread IDs of callers, grouped by role.
+    struct thread_roles
+    {
+        std::set<long> reader; ///< callers of canRead
+        std::set<long> sync; ///< callers of canWrite with a SYNC frame in the batch
+        std::set<long> writer; ///< callers of canWrite otherwise
+    };
+
+    //! Add this device to the YARP factory.
+    static void registerDevice();
+
+    //! Retrieve all open instances, in order of creation.
+    static std::vector<SimulatedCanBus *> getInstances();
+
+    //! Retrieve a copy of recorded statistics, clear them afterwards if requested.
+    statistics getStatistics(bool reset = false);
+
+    //! Retrieve IDs of calling threads.
+    thread_roles getThreadRoles();
+
+    //! Retrieve nominal bitrate (bits per second).
+    unsigned int getBitrate() const
+    { return bitrate; }
+
+    //  --------- DeviceDriver declarations ---------
+
+    virtual bool open(yarp::os::Searchable & config) override;
+    virtual bool close() override;
+
+    //  --------- ICanBus declarations ---------
+
+    virtual bool canSetBaudRate(unsigned int rate) override;
+    virtual bool canGetBaudRate(unsigned int * rate) override;
+
+    virtual bool canIdAdd(unsigned int id) override
+    { return true; }
+
+    virtual bool canIdDelete(unsigned int id) override
+    { return true; }
+
+    virtual bool canRead(yarp::dev::CanBuffer & msgs, unsigned int size, unsigned int * read, bool wait = false) override;
+    virtual bool canWrite(const yarp::dev::CanBuffer & msgs, unsigned int size, unsigned int * sent, bool wait = false) override;
+
+    //  --------- ICanBusErrors declarations ---------
+
+    virtual bool canGetErrors(yarp::dev::CanErrors & err) override;
+
+private:
+    struct queued_frame
+    {
+        sim_frame frame;
+        std::uint64_t syncCycle; ///< zero if not sent in response to a SYNC
+    };
+
+    void flushResponses(std::uint64_t cycle);
+
+    unsigned int bitrate {0};
+
+    std::vector<std::unique_ptr<SimulatedDrive>> drives;
+    SimulatedDrive * nodes[128] {nullptr}; // indexed by CAN node ID
+
+    std::deque<queued_frame> rxQueue;
+    std::vector<sim_frame> responses;
+
+    std::uint64_t syncCycle {0};
+    std::size_t pendingFeedback {0};
+    std::chrono::steady_clock::time_point lastSync;
+
+    statistics stats;
+    thread_roles roles;
+
+    mutable std::mutex mutex;
+};
+
+} // namespace roboticslab
+
+#endif // __SIMULATED_CAN_BUS__
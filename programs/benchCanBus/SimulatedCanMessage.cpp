@@ -0,0 +1,95 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#include "SimulatedCanMessage.hpp"
+
+#include <cstring> // std::memcpy
+
+// -----------------------------------------------------------------------------
+
+roboticslab::SimulatedCanMessage::SimulatedCanMessage()
+{
+    message = nullptr;
+}
+
+// -----------------------------------------------------------------------------
+
+roboticslab::SimulatedCanMessage::~SimulatedCanMessage()
+{
+}
+
+// -----------------------------------------------------------------------------
+
+yarp::dev::CanMessage & roboticslab::SimulatedCanMessage::operator=(const yarp::dev::CanMessage & l)
+{
+    const SimulatedCanMessage & tmp = dynamic_cast<const SimulatedCanMessage &>(l);
+    std::memcpy(message, tmp.message, sizeof(sim_frame));
+    return *this;
+}
+
+// -----------------------------------------------------------------------------
+
+unsigned int roboticslab::SimulatedCanMessage::getId() const
+{
+    return message->id;
+}
+
+// -----------------------------------------------------------------------------
+
+unsigned char roboticslab::SimulatedCanMessage::getLen() const
+{
+    return message->len;
+}
+
+// -----------------------------------------------------------------------------
+
+void roboticslab::SimulatedCanMessage::setLen(unsigned char len)
+{
+    message->len = len;
+}
+
+// -----------------------------------------------------------------------------
+
+void roboticslab::SimulatedCanMessage::setId(unsigned int id)
+{
+    message->id = id;
+}
+
+// -----------------------------------------------------------------------------
+
+const unsigned char * roboticslab::SimulatedCanMessage::getData() const
+{
+    return message->data;
+}
+
+// -----------------------------------------------------------------------------
+
+unsigned char * roboticslab::SimulatedCanMessage::getData()
+{
+    return message->data;
+}
+
+// -----------------------------------------------------------------------------
+
+unsigned char * roboticslab::SimulatedCanMessage::getPointer()
+{
+    return reinterpret_cast<unsigned char *>(message);
+}
+
+// -----------------------------------------------------------------------------
+
+const unsigned char * roboticslab::SimulatedCanMessage::getPointer() const
+{
+    return reinterpret_cast<const unsigned char *>(message);
+}
+
+// -----------------------------------------------------------------------------
+
+void roboticslab::SimulatedCanMessage::setBuffer(unsigned char * buf)
+{
+    if (buf != nullptr)
+    {
+        message = reinterpret_cast<sim_frame *>(buf);
+    }
+}
+
+// -----------------------------------------------------------------------------
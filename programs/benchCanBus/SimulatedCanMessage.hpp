@@ -0,0 +1,40 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __SIMULATED_CAN_MESSAGE__
+#define __SIMULATED_CAN_MESSAGE__
+
+#include <yarp/dev/CanBusInterface.h>
+
+#include "SimulatedDrive.hpp"
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup benchCanBus
+ * @brief YARP wrapper for simulated CAN messages.
+ */
+class SimulatedCanMessage : public yarp::dev::CanMessage
+{
+public:
+    SimulatedCanMessage();
+    virtual ~SimulatedCanMessage();
+    virtual yarp::dev::CanMessage & operator=(const yarp::dev::CanMessage & l) override;
+
+    virtual unsigned int getId() const override;
+    virtual unsigned char getLen() const override;
+    virtual void setLen(unsigned char len) override;
+    virtual void setId(unsigned int id) override;
+    virtual const unsigned char * getData() const override;
+    virtual unsigned char * getData() override;
+    virtual unsigned char * getPointer() override;
+    virtual const unsigned char * getPointer() const override;
+    virtual void setBuffer(unsigned char * buf) override;
+
+private:
+    sim_frame * message;
+};
+
+} // namespace roboticslab
+
+#endif // __SIMULATED_CAN_MESSAGE__
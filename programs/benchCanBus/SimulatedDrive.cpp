@@ -0,0 +1,531 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#include "SimulatedDrive.hpp"
+
+#include <cstring> // std::memcmp, std::memcpy
+
+#include <algorithm> // std::min
+
+using namespace roboticslab;
+
+// -----------------------------------------------------------------------------
+
+namespace
+{
+    constexpr std::uint32_t PDO_INVALID = 0x80000000;
+
+    constexpr std::uint32_t SDO_ABORT_COMMAND = 0x05040001; // client/server command specifier not valid or unknown
+    constexpr std::uint32_t SDO_ABORT_ACCESS = 0x06010000; // unsupported access to an object
+
+    std::uint32_t unpack(const std::uint8_t * data, unsigned int size)
+    {
+        std::uint32_t value = 0;
+
+        for (unsigned int i = 0; i < size; i++)
+        {
+            value += static_cast<std::uint32_t>(data[i]) << (8 * i);
+        }
+
+        return value;
+    }
+
+    void pack(std::uint32_t value, unsigned int size, std::uint8_t * data)
+    {
+        for (unsigned int i = 0; i < size; i++)
+        {
+            data[i] = (value >> (8 * i)) & 0xFF;
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+SimulatedDrive::SimulatedDrive(std::uint8_t _id)
+    : id(_id)
+{
+    reset();
+}
+
+// -----------------------------------------------------------------------------
+
+std::uint32_t SimulatedDrive::get(std::uint16_t index, std::uint8_t subindex) const
+{
+    auto it = objects.find(key(index, subindex));
+    return it != objects.cend() ? it->second : 0; // unknown objects read as zero
+}
+
+// -----------------------------------------------------------------------------
+
+void SimulatedDrive::set(std::uint16_t index, std::uint8_t subindex, std::uint32_t value)
+{
+    objects[key(index, subindex)] = value;
+}
+
+// -----------------------------------------------------------------------------
+
+void SimulatedDrive::write(std::uint16_t index, std::uint8_t subindex, std::uint32_t value)
+{
+    set(index, subindex, value);
+
+    switch (index)
+    {
+    case 0x6040: // controlword
+        handleControlword(value);
+        break;
+    case 0x6060: // modes of operation, mirrored at once by the display object
+        set(0x6061, 0x00, value);
+        break;
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+void SimulatedDrive::reset()
+{
+    nmtState = nmt_state::PRE_OPERATIONAL;
+    driveState = drive_state::SWITCH_ON_DISABLED;
+    lastControlword = 0;
+
+    objects.clear();
+    strings.clear();
+    pendingRpdos.clear();
+    segmentedData.clear();
+    segmentedOffset = 0;
+    segmentedToggle = false;
+
+    set(0x1000, 0x00, 0x00020192); // device type: CiA 402, servo drive
+    set(0x6502, 0x00, 0x000000E5); // supported drive modes: pp, pv, hm, ip, csp
+
+    strings[key(0x1008, 0x00)] = "SimulatedDrive";
+    strings[key(0x1009, 0x00)] = "1.0";
+    strings[key(0x100A, 0x00)] = "SIM 1.0";
+
+    for (unsigned int n = 1; n <= 4; n++)
+    {
+        set(0x1400 + n - 1, 0x01, 0x100 * (n + 1) + id); // RPDO COB-ID
+        set(0x1400 + n - 1, 0x02, 0xFF); // RPDO transmission type
+        set(0x1800 + n - 1, 0x01, 0x80 + 0x100 * n + id); // TPDO COB-ID
+        set(0x1800 + n - 1, 0x02, 0xFF); // TPDO transmission type
+
+        tpdos[n - 1] = {};
+    }
+
+    // controlword on RPDO1, statusword on TPDO1
+    set(0x1600, 0x00, 1);
+    set(0x1600, 0x01, 0x60400010);
+    set(0x1A00, 0x00, 1);
+    set(0x1A00, 0x01, 0x60410010);
+
+    updateStatusword();
+}
+
+// -----------------------------------------------------------------------------
+
+void SimulatedDrive::handleMessage(const sim_frame & frame, std::vector<sim_frame> & out)
+{
+    if (frame.id == 0x000)
+    {
+        if (frame.len == 2 && (frame.data[1] == 0 || frame.data[1] == id))
+        {
+            handleNmt(frame.data[0]);
+        }
+    }
+    else if (frame.id == 0x600u + id)
+    {
+        if (frame.len == 8 && nmtState != nmt_state::STOPPED)
+        {
+            handleSdo(frame.data, out);
+        }
+    }
+    else if (nmtState == nmt_state::OPERATIONAL)
+    {
+        for (unsigned int n = 1; n <= 4; n++)
+        {
+            std::uint32_t cobId = get(0x1400 + n - 1, 0x01);
+
+            if ((cobId & PDO_INVALID) == 0 && (cobId & 0x7FF) == frame.id)
+            {
+                if (get(0x1400 + n - 1, 0x02) >= 0xFE) // event-driven, apply now
+                {
+                    handleRpdo(n, frame);
+                }
+                else // synchronous, apply on next SYNC
+                {
+                    pendingRpdos.emplace_back(n, frame);
+                }
+
+                break;
+            }
+        }
+    }
+
+    sendEventTpdos(out);
+}
+
+// -----------------------------------------------------------------------------
+
+void SimulatedDrive::handleSync(std::vector<sim_frame> & out)
+{
+    if (nmtState != nmt_state::OPERATIONAL)
+    {
+        return;
+    }
+
+    for (const auto & rpdo : pendingRpdos)
+    {
+        handleRpdo(rpdo.first, rpdo.second);
+    }
+
+    pendingRpdos.clear();
+
+    if (driveState == drive_state::OPERATION_ENABLED && static_cast<std::int8_t>(get(0x6061)) == 8)
+    {
+        // cyclic synchronous position: ideal tracking of the latest target
+        std::uint32_t target = get(0x607A);
+        set(0x6063, 0x00, target); // position actual internal value
+        set(0x6064, 0x00, target); // position actual value
+    }
+
+    for (unsigned int n = 1; n <= 4; n++)
+    {
+        std::uint32_t cobId = get(0x1800 + n - 1, 0x01);
+        std::uint32_t type = get(0x1800 + n - 1, 0x02);
+
+        if ((cobId & PDO_INVALID) != 0 || get(0x1A00 + n - 1) == 0)
+        {
+            continue;
+        }
+
+        if (type >= 0x01 && type <= 0xF0)
+        {
+            if (++tpdos[n - 1].syncCount % type == 0)
+            {
+                sendTpdo(n, out);
+            }
+        }
+        else if (type == 0x00) // acyclic synchronous, only on change
+        {
+            std::uint8_t data[8];
+            unsigned int len = packTpdo(n, data);
+            const auto & state = tpdos[n - 1];
+
+            if (!state.sent || len != state.lastLen || std::memcmp(data, state.last, len) != 0)
+            {
+                sendTpdo(n, out);
+            }
+        }
+    }
+
+    sendEventTpdos(out);
+}
+
+// -----------------------------------------------------------------------------
+
+void SimulatedDrive::handleNmt(std::uint8_t command)
+{
+    switch (command)
+    {
+    case 0x01: // start remote node
+        nmtState = nmt_state::OPERATIONAL;
+
+        for (auto & tpdo : tpdos)
+        {
+            tpdo.sent = false; // transmit all event-driven TPDOs once
+        }
+
+        break;
+    case 0x02: // stop remote node
+        nmtState = nmt_state::STOPPED;
+        break;
+    case 0x80: // enter pre-operational
+        nmtState = nmt_state::PRE_OPERATIONAL;
+        break;
+    case 0x81: // reset node
+    case 0x82: // reset communication
+        reset(); // no boot-up message, would trigger a reinitialization of TechnosoftIpos
+        break;
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+void SimulatedDrive::handleSdo(const std::uint8_t * data, std::vector<sim_frame> & out)
+{
+    const std::uint16_t index = data[1] + (data[2] << 8);
+    const std::uint8_t subindex = data[3];
+
+    sim_frame response {0x580u + id, 8, {0}};
+
+    switch (data[0] >> 5)
+    {
+    case 1: // initiate download
+    {
+        if ((data[0] & 0x02) == 0)
+        {
+            // segmented downloads are not required by TechnosoftIpos
+            out.push_back(sdoAbort(id, data, SDO_ABORT_ACCESS));
+            return;
+        }
+
+        unsigned int size = (data[0] & 0x01) != 0 ? 4 - ((data[0] >> 2) & 0x03) : 4;
+        write(index, subindex, unpack(data + 4, size));
+
+        response.data[0] = 0x60;
+        std::memcpy(response.data + 1, data + 1, 3);
+        break;
+    }
+    case 2: // initiate upload
+    {
+        std::memcpy(response.data + 1, data + 1, 3);
+        auto it = strings.find(key(index, subindex));
+
+        if (it != strings.cend())
+        {
+            segmentedData = it->second;
+            segmentedOffset = 0;
+            segmentedToggle = false;
+
+            response.data[0] = 0x41; // segmented, size indicated
+            pack(segmentedData.size(), 4, response.data + 4);
+        }
+        else
+        {
+            response.data[0] = 0x42; // expedited, size not indicated
+            pack(get(index, subindex), 4, response.data + 4);
+        }
+
+        break;
+    }
+    case 3: // upload segment
+    {
+        bool toggle = (data[0] & 0x10) != 0;
+
+        if (segmentedOffset >= segmentedData.size() || toggle != segmentedToggle)
+        {
+            segmentedData.clear();
+            out.push_back(sdoAbort(id, data, SDO_ABORT_COMMAND));
+            return;
+        }
+
+        std::size_t size = std::min<std::size_t>(segmentedData.size() - segmentedOffset, 7);
+        bool last = segmentedOffset + size == segmentedData.size();
+
+        response.data[0] = (toggle ? 0x10 : 0x00) + ((7 - size) << 1) + (last ? 0x01 : 0x00);
+        std::memcpy(response.data + 1, segmentedData.data() + segmentedOffset, size);
+
+        segmentedOffset += size;
+        segmentedToggle = !segmentedToggle;
+
+        if (last)
+        {
+            segmentedData.clear();
+            segmentedOffset = 0;
+        }
+
+        break;
+    }
+    case 4: // abort transfer
+        segmentedData.clear();
+        segmentedOffset = 0;
+        return;
+    default:
+        out.push_back(sdoAbort(id, data, SDO_ABORT_COMMAND));
+        return;
+    }
+
+    out.push_back(response);
+}
+
+// -----------------------------------------------------------------------------
+
+sim_frame SimulatedDrive::sdoAbort(std::uint8_t id, const std::uint8_t * request, std::uint32_t code)
+{
+    sim_frame response {0x580u + id, 8, {0x80}};
+    std::memcpy(response.data + 1, request + 1, 3);
+    pack(code, 4, response.data + 4);
+    return response;
+}
+
+// -----------------------------------------------------------------------------
+
+void SimulatedDrive::handleRpdo(unsigned int n, const sim_frame & frame)
+{
+    const std::uint16_t mappingIdx = 0x1600 + n - 1;
+    const std::uint32_t count = get(mappingIdx);
+    unsigned int offset = 0;
+
+    for (std::uint32_t i = 1; i <= count; i++)
+    {
+        std::uint32_t entry = get(mappingIdx, i);
+        unsigned int size = (entry & 0xFF) / 8;
+
+        if (offset + size > frame.len)
+        {
+            return; // too short, discard remaining objects
+        }
+
+        write(entry >> 16, (entry >> 8) & 0xFF, unpack(frame.data + offset, size));
+        offset += size;
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+void SimulatedDrive::handleControlword(std::uint16_t controlword)
+{
+    bool faultReset = (controlword & 0x0080) != 0 && (lastControlword & 0x0080) == 0; // rising edge
+    lastControlword = controlword;
+
+    if (driveState == drive_state::FAULT)
+    {
+        if (faultReset)
+        {
+            driveState = drive_state::SWITCH_ON_DISABLED;
+        }
+    }
+    else if ((controlword & 0x0082) == 0x0000) // disable voltage
+    {
+        driveState = drive_state::SWITCH_ON_DISABLED;
+    }
+    else if ((controlword & 0x0086) == 0x0002) // quick stop
+    {
+        switch (driveState)
+        {
+        case drive_state::READY_TO_SWITCH_ON:
+        case drive_state::SWITCHED_ON:
+            driveState = drive_state::SWITCH_ON_DISABLED;
+            break;
+        case drive_state::OPERATION_ENABLED:
+            driveState = drive_state::QUICK_STOP_ACTIVE;
+            break;
+        default:
+            break;
+        }
+    }
+    else if ((controlword & 0x0087) == 0x0006) // shutdown
+    {
+        if (driveState != drive_state::QUICK_STOP_ACTIVE)
+        {
+            driveState = drive_state::READY_TO_SWITCH_ON;
+        }
+    }
+    else if ((controlword & 0x008F) == 0x0007) // switch on, disable operation
+    {
+        if (driveState == drive_state::READY_TO_SWITCH_ON || driveState == drive_state::OPERATION_ENABLED)
+        {
+            driveState = drive_state::SWITCHED_ON;
+        }
+    }
+    else if ((controlword & 0x008F) == 0x000F) // enable operation
+    {
+        if (driveState != drive_state::SWITCH_ON_DISABLED)
+        {
+            driveState = drive_state::OPERATION_ENABLED;
+        }
+    }
+
+    updateStatusword();
+}
+
+// -----------------------------------------------------------------------------
+
+void SimulatedDrive::updateStatusword()
+{
+    std::uint16_t statusword = 0x0210; // remote, voltage enabled
+
+    switch (driveState)
+    {
+    case drive_state::SWITCH_ON_DISABLED:
+        statusword |= 0x0040;
+        break;
+    case drive_state::READY_TO_SWITCH_ON:
+        statusword |= 0x0021;
+        break;
+    case drive_state::SWITCHED_ON:
+        statusword |= 0x0023;
+        break;
+    case drive_state::OPERATION_ENABLED:
+        statusword |= 0x8027; // axis on
+        break;
+    case drive_state::QUICK_STOP_ACTIVE:
+        statusword |= 0x8007; // axis on
+        break;
+    case drive_state::FAULT:
+        statusword |= 0x0008;
+        break;
+    }
+
+    set(0x6041, 0x00, statusword);
+    set(0x1002, 0x00, (get(0x1002) & 0xFFFF0000) + statusword); // iPOS: MSR on the high word
+}
+
+// -----------------------------------------------------------------------------
+
+unsigned int SimulatedDrive::packTpdo(unsigned int n, std::uint8_t * data) const
+{
+    const std::uint16_t mappingIdx = 0x1A00 + n - 1;
+    const std::uint32_t count = get(mappingIdx);
+    unsigned int len = 0;
+
+    for (std::uint32_t i = 1; i <= count; i++)
+    {
+        std::uint32_t entry = get(mappingIdx, i);
+        unsigned int size = (entry & 0xFF) / 8;
+
+        if (len + size > 8)
+        {
+            break;
+        }
+
+        pack(get(entry >> 16, (entry >> 8) & 0xFF), size, data + len);
+        len += size;
+    }
+
+    return len;
+}
+
+// -----------------------------------------------------------------------------
+
+void SimulatedDrive::sendTpdo(unsigned int n, std::vector<sim_frame> & out)
+{
+    auto & state = tpdos[n - 1];
+    sim_frame frame {get(0x1800 + n - 1, 0x01) & 0x7FF, 0, {0}};
+
+    frame.len = packTpdo(n, frame.data);
+    std::memcpy(state.last, frame.data, frame.len);
+    state.lastLen = frame.len;
+    state.sent = true;
+
+    out.push_back(frame);
+}
+
+// -----------------------------------------------------------------------------
+
+void SimulatedDrive::sendEventTpdos(std::vector<sim_frame> & out)
+{
+    if (nmtState != nmt_state::OPERATIONAL)
+    {
+        return;
+    }
+
+    for (unsigned int n = 1; n <= 4; n++)
+    {
+        std::uint32_t cobId = get(0x1800 + n - 1, 0x01);
+
+        if ((cobId & PDO_INVALID) != 0 || get(0x1800 + n - 1, 0x02) < 0xFE || get(0x1A00 + n - 1) == 0)
+        {
+            continue;
+        }
+
+        std::uint8_t data[8];
+        unsigned int len = packTpdo(n, data);
+        const auto & state = tpdos[n - 1];
+
+        if (!state.sent || len != state.lastLen || std::memcmp(data, state.last, len) != 0)
+        {
+            sendTpdo(n, out);
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
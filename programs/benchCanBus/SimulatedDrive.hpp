@@ -0,0 +1,108 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __SIMULATED_DRIVE__
+#define __SIMULATED_DRIVE__
+
+#include <cstdint>
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup benchCanBus
+ * @brief Raw CAN frame exchanged with simulated drives.
+ */
+struct sim_frame
+{
+    std::uint32_t id;
+    std::uint8_t len;
+    std::uint8_t data[8];
+};
+
+/**
+ * @ingroup benchCanBus
+ * @brief Minimal CiA 402 drive emulator.
+ *
+ * Covers the subset of CANopen services exercised by TechnosoftIpos: an SDO
+ * server (expedited transfers, segmented uploads of string objects), PDO
+ * communication and mapping objects, NMT node control, the CiA 402 state
+ * machine and cyclic synchronous position mode. Incoming frames are handled
+ * right away, responses are appended to the given output buffer. Boot-up
+ * messages, heartbeats and EMCY are never produced.
+ */
+class SimulatedDrive
+{
+public:
+    //! Constructor, object dictionary holds default values.
+    SimulatedDrive(std::uint8_t id);
+
+    //! Retrieve CAN node ID.
+    std::uint8_t getId() const
+    { return id; }
+
+    //! Handle an incoming NMT, SDO or RPDO frame addressed to this node.
+    void handleMessage(const sim_frame & frame, std::vector<sim_frame> & out);
+
+    //! Handle a SYNC message: latch synchronous RPDOs, move, send synchronous TPDOs.
+    void handleSync(std::vector<sim_frame> & out);
+
+private:
+    enum class nmt_state { PRE_OPERATIONAL, OPERATIONAL, STOPPED };
+
+    enum class drive_state { SWITCH_ON_DISABLED, READY_TO_SWITCH_ON, SWITCHED_ON, OPERATION_ENABLED, QUICK_STOP_ACTIVE, FAULT };
+
+    //! Last payload sent by a TPDO.
+    struct pdo_state
+    {
+        std::uint8_t last[8];
+        std::uint8_t lastLen;
+        bool sent;
+        unsigned int syncCount;
+    };
+
+    static std::uint32_t key(std::uint16_t index, std::uint8_t subindex)
+    { return (index << 8) + subindex; }
+
+    static sim_frame sdoAbort(std::uint8_t id, const std::uint8_t * request, std::uint32_t code);
+
+    std::uint32_t get(std::uint16_t index, std::uint8_t subindex = 0) const;
+    void set(std::uint16_t index, std::uint8_t subindex, std::uint32_t value);
+    void write(std::uint16_t index, std::uint8_t subindex, std::uint32_t value);
+
+    void reset();
+    void handleNmt(std::uint8_t command);
+    void handleSdo(const std::uint8_t * data, std::vector<sim_frame> & out);
+    void handleRpdo(unsigned int n, const sim_frame & frame);
+    void handleControlword(std::uint16_t controlword);
+    void updateStatusword();
+
+    unsigned int packTpdo(unsigned int n, std::uint8_t * data) const;
+    void sendTpdo(unsigned int n, std::vector<sim_frame> & out);
+    void sendEventTpdos(std::vector<sim_frame> & out);
+
+    const std::uint8_t id;
+
+    nmt_state nmtState;
+    drive_state driveState;
+    std::uint16_t lastControlword;
+
+    std::map<std::uint32_t, std::uint32_t> objects;
+    std::map<std::uint32_t, std::string> strings;
+
+    pdo_state tpdos[4];
+    std::vector<std::pair<unsigned int, sim_frame>> pendingRpdos;
+
+    // segmented upload in progress
+    std::string segmentedData;
+    std::size_t segmentedOffset;
+    bool segmentedToggle;
+};
+
+} // namespace roboticslab
+
+#endif // __SIMULATED_DRIVE__
@@ -0,0 +1,53 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+/**
+ * @ingroup yarp_devices_programs
+ * @defgroup benchCanBus benchCanBus
+ * @brief Creates an instance of roboticslab::BenchCanBus.
+ *
+ * End-to-end benchmark of the CAN control cycle that needs no CAN hardware
+ * nor YARP name server. A CanBusControlboard device is opened on top of
+ * <code>--buses</code> simulated CAN buses with <code>--nodes</code>
+ * TechnosoftIpos drives each, all switched to position direct mode. The SYNC
+ * thread runs at <code>--syncPeriod</code> seconds while this app streams
+ * <code>setPositions</code> commands (a sine wave of <code>--amplitude</code>
+ * degrees and <code>--frequency</code> hertz) every <code>--clientPeriod</code>
+ * seconds. After <code>--warmup</code> seconds, it measures for
+ * <code>--duration</code> seconds and reports:
+ *
+ * - distribution of SYNC intervals, as seen on the bus, and overruns
+ * - latency between each SYNC and the read of the last TPDO it triggered
+ * - duration of <code>setPositions</code> calls
+ * - CPU time and context switches per cycle, overall and per thread role
+ *   (CAN reader, SYNC sender, CAN writer), excluding the client thread
+ * - TX/RX frames per second and estimated load of each bus
+ *
+ * Pass <code>--output report.json</code> to store the results in JSON format,
+ * and <code>--busAffinity</code>, <code>--rxDelay</code>, <code>--txDelay</code>
+ * or <code>--bitrate</code> to tune the CAN layer as in real deployments.
+ *
+ * Simulated drives answer SDO, NMT and PDO traffic within the CAN write call,
+ * and track position targets perfectly in cyclic synchronous position mode.
+ * The time they take is reported separately. The TechnosoftIpos and
+ * CanBusControlboard plugins must be discoverable by YARP.
+ */
+
+#include <yarp/os/Network.h>
+#include <yarp/os/ResourceFinder.h>
+
+#include "BenchCanBus.hpp"
+
+int main(int argc, char * argv[])
+{
+    yarp::os::ResourceFinder rf;
+    rf.setVerbose(true);
+    rf.setDefaultContext("benchCanBus");
+    rf.setDefaultConfigFile("benchCanBus.ini");
+    rf.configure(argc, argv);
+
+    yarp::os::Network yarp;
+    yarp::os::Network::setLocalMode(true); // ports opened by CanBusControlboard stay within this process
+
+    roboticslab::BenchCanBus mod;
+    return mod.runModule(rf);
+}
@@ -0,0 +1,48 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+// Generated from objects.eds by roboticslab_generate_object_dictionary(), do not edit.
+
+#ifndef __TESTOBJECTS_HPP__
+#define __TESTOBJECTS_HPP__
+
+#include <cstdint>
+
+#include <string>
+
+#include "ObjectDictionary.hpp"
+
+namespace roboticslab
+{
+
+namespace TestObjects
+{
+
+//! Device type (0x1000:00)
+struct DeviceType : ObjectEntry<std::uint32_t, 0x1000, 0x00, ObjectAccess::RO, false>
+{ static constexpr const char * name() { return "Device type"; } };
+
+//! Manufacturer device name (0x1008:00)
+struct ManufacturerDeviceName : ObjectEntry<std::string, 0x1008, 0x00, ObjectAccess::CONST, false>
+{ static constexpr const char * name() { return "Manufacturer device name"; } };
+
+//! 2nd axis (offset) (0x2001:00)
+struct Object2001_02ndAxisOffset : ObjectEntry<std::int16_t, 0x2001, 0x00, ObjectAccess::RW, true>
+{ static constexpr const char * name() { return "2nd axis (offset)"; } };
+
+//! Position actual internal value (0x6063:00)
+struct PositionActualInternalValue : ObjectEntry<std::int32_t, 0x6063, 0x00, ObjectAccess::RO, true>
+{ static constexpr const char * name() { return "Position actual internal value"; } };
+
+//! Min position limit (0x607D:01)
+struct MinPositionLimit : ObjectEntry<std::int32_t, 0x607D, 0x01, ObjectAccess::RW, true>
+{ static constexpr const char * name() { return "Min position limit"; } };
+
+//! Max position limit (0x607D:02)
+struct MaxPositionLimit : ObjectEntry<std::int32_t, 0x607D, 0x02, ObjectAccess::WO, false>
+{ static constexpr const char * name() { return "Max position limit"; } };
+
+} // namespace TestObjects
+
+} // namespace roboticslab
+
+#endif // __TESTOBJECTS_HPP__
@@ -0,0 +1,868 @@
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <yarp/os/Bottle.h>
+#include <yarp/os/Vocab.h>
+
+#include <yarp/dev/IRemoteVariables.h>
+
+#include "ICanBusSharer.hpp"
+#include "HeartbeatSupervisor.hpp"
+#include "EmcyMonitor.hpp"
+#include "JointStateSnapshot.hpp"
+#include "SdoReplier.hpp"
+
+namespace roboticslab
+{
+
+namespace test
+{
+
+constexpr std::int32_t JOINT_MODE = 0x736F70; // any non-zero vocab
+
+/**
+ * @ingroup yarp_devices_tests
+ * @defgroup testCanBusControlboard
+ * @brief Unit tests related to @ref CanBusControlboard.
+ */
+
+/**
+ * @ingroup testCanBusControlboard
+ * @brief Fake CAN node, keeps track of supervision events.
+ */
+class FakeCanBusSharer : public ICanBusSharer
+{
+public:
+    FakeCanBusSharer(unsigned int id, double timeout)
+        : id(id), timeout(timeout), lost(0), bootUps(0), elapsed(0.0)
+    { }
+
+    virtual unsigned int getId() override
+    { return id; }
+
+    virtual bool initialize() override
+    { return true; }
+
+    virtual bool finalize() override
+    { return true; }
+
+    virtual bool registerSender(CanSenderDelegate * sender) override
+    { return true; }
+
+    virtual bool synchronize() override
+    { return true; }
+
+    virtual bool notifyMessage(const can_message & message) override
+    { return true; }
+
+    virtual double getHeartbeatTimeout() override
+    { return timeout; }
+
+    virtual void onHeartbeatLost(double elapsed) override
+    { lost++; this->elapsed = elapsed; }
+
+    virtual void onBootUp() override
+    {
+        if (blocker.valid())
+        {
+            blocker.wait(); // e.g. a lengthy reinitialization
+        }
+
+        bootUps++;
+    }
+
+    unsigned int id;
+    double timeout;
+    std::atomic<unsigned int> lost;
+    std::atomic<unsigned int> bootUps;
+    std::atomic<double> elapsed;
+    std::shared_future<void> blocker;
+};
+
+/**
+ * @ingroup testCanBusControlboard
+ * @brief Fake raw subdevice, exposes an EMCY history in the format of @ref TechnosoftIpos.
+ */
+class FakeRemoteVariables : public yarp::dev::IRemoteVariablesRaw
+{
+public:
+    FakeRemoteVariables(bool hasEmcy)
+        : hasEmcy(hasEmcy), queries(0)
+    { }
+
+    virtual bool getRemoteVariableRaw(std::string key, yarp::os::Bottle & val) override
+    {
+        queries++;
+        val.clear();
+        val.addString(key);
+
+        if (!hasEmcy || key != "emcy")
+        {
+            return false;
+        }
+
+        yarp::os::Bottle & list = val.addList();
+
+        for (auto seq : history)
+        {
+            yarp::os::Bottle & b = list.addList();
+            b.addInt64(seq);
+            b.addFloat64(0.0);
+            b.addInt32(0x1000);
+            b.addString("Generic error");
+            b.addInt32(0x01);
+            b.addList();
+        }
+
+        return true;
+    }
+
+    virtual bool setRemoteVariableRaw(std::string key, const yarp::os::Bottle & val) override
+    { return false; }
+
+    virtual bool getRemoteVariablesListRaw(yarp::os::Bottle * listOfKeys) override
+    {
+        listOfKeys->clear();
+        listOfKeys->addString("linInterp");
+
+        if (hasEmcy)
+        {
+            listOfKeys->addString("emcy");
+        }
+
+        return true;
+    }
+
+    bool hasEmcy;
+    unsigned int queries;
+    std::vector<std::uint64_t> history;
+};
+
+/**
+ * @ingroup testCanBusControlboard
+ * @brief Fake SDO servers, answer expedited transfers of all nodes with a short delay.
+ */
+class FakeSdoServer : public CanSenderDelegate
+{
+public:
+    FakeSdoServer(SdoReplier & replier, std::set<unsigned int> aborting = {})
+        : replier(replier), aborting(std::move(aborting))
+    { }
+
+    virtual bool prepareMessage(const can_message & msg) override
+    {
+        unsigned int id = msg.id - 0x600;
+        std::vector<std::uint8_t> response(msg.data, msg.data + 8);
+
+        if (aborting.count(id))
+        {
+            std::uint32_t code = 0x06020000; // object does not exist
+            response[0] = 0x80;
+            std::memcpy(response.data() + 4, &code, 4);
+        }
+        else if (msg.data[0] == 0x40)
+        {
+            std::int32_t value = id * 1000 + msg.data[3];
+            response[0] = 0x43;
+            std::memcpy(response.data() + 4, &value, 4);
+        }
+        else
+        {
+            response[0] = 0x60;
+            std::memset(response.data() + 4, 0, 4);
+        }
+
+        std::lock_guard<std::mutex> lock(mtx);
+        requests.emplace_back(id, msg.data[0]);
+
+        pending.push_back(std::async(std::launch::async, [this, id, response]
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                replier.notifyMessage({0x580 + id, 8, response.data()});
+            }));
+
+        return true;
+    }
+
+    std::vector<std::uint8_t> commandsOf(unsigned int id)
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        std::vector<std::uint8_t> commands;
+
+        for (const auto & r : requests)
+        {
+            if (r.first == id)
+            {
+                commands.push_back(r.second);
+            }
+        }
+
+        return commands;
+    }
+
+    std::size_t sent()
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        return requests.size();
+    }
+
+private:
+    SdoReplier & replier;
+    std::set<unsigned int> aborting;
+    std::vector<std::pair<unsigned int, std::uint8_t>> requests;
+    std::vector<std::future<void>> pending;
+    std::mutex mtx;
+};
+
+/**
+ * @ingroup testCanBusControlboard
+ * @brief Tests auxiliary classes of @ref CanBusControlboard.
+ */
+class CanBusControlboardTest : public testing::Test
+{
+public:
+    virtual void SetUp()
+    { now = 0.0; }
+
+    virtual void TearDown()
+    { }
+
+protected:
+    static bool heartbeat(HeartbeatSupervisor & supervisor, unsigned int id, std::uint8_t state = 0x05)
+    { return supervisor.notifyMessage({0x700u + id, 1, &state}); }
+
+    //! Step the supervisor once per tick of a fake clock, then wait for the events it fired.
+    void advance(HeartbeatSupervisor & supervisor, unsigned int ticks)
+    {
+        for (unsigned int i = 0; i < ticks; i++)
+        {
+            supervisor.advance(now += PERIOD);
+        }
+
+        supervisor.waitForEvents();
+    }
+
+    static bool emcy(EmcyMonitor & monitor, unsigned int id)
+    {
+        std::uint8_t data[8] = {0x00, 0x10, 0x01};
+        return monitor.notifyMessage({0x080u + id, 8, data});
+    }
+
+    static void sdoUpload(yarp::os::Bottle & batch, int id, int subindex)
+    {
+        yarp::os::Bottle & b = batch.addList();
+        b.addVocab(yarp::os::createVocab('s', 'd', 'o', 'u'));
+        b.addInt32(id);
+        b.addInt32(0x2000);
+        b.addInt32(subindex);
+        b.addVocab(yarp::os::createVocab('i', '3', '2'));
+    }
+
+    static void sdoDownload(yarp::os::Bottle & batch, int id, int value)
+    {
+        yarp::os::Bottle & b = batch.addList();
+        b.addVocab(yarp::os::createVocab('s', 'd', 'o', 'd'));
+        b.addInt32(id);
+        b.addInt32(0x2000);
+        b.addInt32(0);
+        b.addVocab(yarp::os::createVocab('i', '3', '2'));
+        b.addInt32(value);
+    }
+
+    static joint_state makeState(double value, std::int32_t mode = JOINT_MODE)
+    { return {value, value, value, value, value, value, value, value, mode}; }
+
+    static bool isOk(const yarp::os::Value & item)
+    { return item.isList() && item.asList()->get(0).asVocab() == yarp::os::createVocab('o', 'k'); }
+
+    static constexpr double PERIOD = 1.0 / 64; // exact multiples
+
+    double now;
+};
+
+TEST_F(CanBusControlboardTest, HeartbeatSupervisorRegister)
+{
+    HeartbeatSupervisor supervisor(PERIOD);
+    ASSERT_FALSE(supervisor.hasNodes());
+
+    FakeCanBusSharer unsupervised(0x01, 0.0);
+    supervisor.registerHandle(&unsupervised);
+    ASSERT_FALSE(supervisor.hasNodes());
+
+    FakeCanBusSharer node(0x02, 0.05);
+    supervisor.registerHandle(&node);
+    ASSERT_TRUE(supervisor.hasNodes());
+
+    FakeCanBusSharer duplicate(0x02, 0.05);
+    supervisor.registerHandle(&duplicate);
+    ASSERT_EQ(supervisor.getNodeStates().size(), 1u);
+
+    // frames of other nodes or protocols are ignored
+
+    ASSERT_FALSE(heartbeat(supervisor, 0x01));
+    ASSERT_TRUE(heartbeat(supervisor, 0x02));
+
+    std::uint8_t data[2] = {0x05, 0x00};
+    ASSERT_FALSE(supervisor.notifyMessage({0x702, 2, data}));
+    ASSERT_FALSE(supervisor.notifyMessage({0x182, 1, data}));
+}
+
+TEST_F(CanBusControlboardTest, HeartbeatSupervisorExpiry)
+{
+    HeartbeatSupervisor supervisor(PERIOD);
+    FakeCanBusSharer node(0x05, 5 * PERIOD);
+    supervisor.registerHandle(&node);
+    supervisor.arm(now);
+
+    // no heartbeat ever received, deadline is the timeout
+
+    advance(supervisor, 4);
+    ASSERT_EQ(node.lost, 0u);
+
+    advance(supervisor, 1);
+    ASSERT_EQ(node.lost, 1u);
+    ASSERT_GT(node.elapsed, 0.0);
+
+    auto states = supervisor.getNodeStates();
+    ASSERT_EQ(states.size(), 1u);
+    ASSERT_EQ(states[0].id, 0x05u);
+    ASSERT_FALSE(states[0].alive);
+    ASSERT_EQ(states[0].lastSeen, 0.0);
+
+    // loss is reported once per outage
+
+    advance(supervisor, 20);
+    ASSERT_EQ(node.lost, 1u);
+
+    // node is back, then goes silent again
+
+    ASSERT_TRUE(heartbeat(supervisor, 0x05));
+    states = supervisor.getNodeStates();
+    ASSERT_TRUE(states[0].alive);
+    ASSERT_EQ(states[0].state, NmtState::OPERATIONAL);
+    ASSERT_NE(states[0].lastSeen, 0.0);
+
+    advance(supervisor, 5);
+    ASSERT_EQ(node.lost, 1u);
+
+    advance(supervisor, 1);
+    ASSERT_EQ(node.lost, 2u);
+}
+
+TEST_F(CanBusControlboardTest, HeartbeatSupervisorRearm)
+{
+    HeartbeatSupervisor supervisor(PERIOD);
+    FakeCanBusSharer node(0x05, 5 * PERIOD);
+    supervisor.registerHandle(&node);
+    supervisor.arm(now);
+
+    // each heartbeat pushes the deadline one timeout further
+
+    for (int i = 0; i < 50; i++)
+    {
+        advance(supervisor, 3);
+        ASSERT_TRUE(heartbeat(supervisor, 0x05));
+    }
+
+    ASSERT_EQ(node.lost, 0u);
+    ASSERT_TRUE(supervisor.getNodeStates()[0].alive);
+
+    // deadline is the last heartbeat plus timeout, plus one tick of slack
+
+    advance(supervisor, 5);
+    ASSERT_EQ(node.lost, 0u);
+
+    advance(supervisor, 1);
+    ASSERT_EQ(node.lost, 1u);
+}
+
+TEST_F(CanBusControlboardTest, HeartbeatSupervisorWrapAround)
+{
+    HeartbeatSupervisor supervisor(PERIOD);
+
+    // timeouts longer than one turn of the wheel (64 slots), plus a short one sharing a slot
+
+    FakeCanBusSharer node1(0x01, 100 * PERIOD);
+    FakeCanBusSharer node2(0x02, 36 * PERIOD);
+    supervisor.registerHandle(&node1);
+    supervisor.registerHandle(&node2);
+    supervisor.arm(now);
+
+    advance(supervisor, 36);
+    ASSERT_EQ(node1.lost, 0u);
+    ASSERT_EQ(node2.lost, 1u);
+
+    advance(supervisor, 63);
+    ASSERT_EQ(node1.lost, 0u);
+
+    advance(supervisor, 1);
+    ASSERT_EQ(node1.lost, 1u);
+
+    // deadline lies beyond the next turn of the wheel
+
+    ASSERT_TRUE(heartbeat(supervisor, 0x01));
+    advance(supervisor, 100);
+    ASSERT_EQ(node1.lost, 1u);
+
+    advance(supervisor, 1);
+    ASSERT_EQ(node1.lost, 2u);
+}
+
+TEST_F(CanBusControlboardTest, HeartbeatSupervisorBootUp)
+{
+    HeartbeatSupervisor supervisor(PERIOD);
+    FakeCanBusSharer node(0x05, 5 * PERIOD);
+    supervisor.registerHandle(&node);
+    supervisor.arm(now);
+
+    // boot-up is deferred to the supervisor thread
+
+    ASSERT_TRUE(heartbeat(supervisor, 0x05, 0x00));
+    ASSERT_EQ(node.bootUps, 0u);
+    ASSERT_EQ(supervisor.getNodeStates()[0].state, NmtState::BOOTUP);
+
+    advance(supervisor, 1);
+    ASSERT_EQ(node.bootUps, 1u);
+
+    advance(supervisor, 1);
+    ASSERT_EQ(node.bootUps, 1u);
+    ASSERT_EQ(node.lost, 0u);
+}
+
+TEST_F(CanBusControlboardTest, HeartbeatSupervisorLateStep)
+{
+    HeartbeatSupervisor supervisor(PERIOD);
+    FakeCanBusSharer node(0x05, 5 * PERIOD);
+    supervisor.registerHandle(&node);
+    supervisor.arm(now);
+
+    // a late step processes all ticks that were due meanwhile
+
+    supervisor.advance(now += 4 * PERIOD);
+    supervisor.waitForEvents();
+    ASSERT_EQ(node.lost, 0u);
+
+    supervisor.advance(now += 70 * PERIOD); // more than one turn of the wheel
+    supervisor.waitForEvents();
+    ASSERT_EQ(node.lost, 1u);
+
+    // steps within the same tick are no-ops
+
+    ASSERT_TRUE(heartbeat(supervisor, 0x05));
+    supervisor.advance(now += PERIOD / 2);
+    supervisor.advance(now += PERIOD / 4);
+    advance(supervisor, 5);
+    ASSERT_EQ(node.lost, 1u);
+
+    advance(supervisor, 1);
+    ASSERT_EQ(node.lost, 2u);
+}
+
+TEST_F(CanBusControlboardTest, HeartbeatSupervisorBlockingHandler)
+{
+    HeartbeatSupervisor supervisor(PERIOD);
+    FakeCanBusSharer node1(0x01, 5 * PERIOD);
+    FakeCanBusSharer node2(0x02, 5 * PERIOD);
+    supervisor.registerHandle(&node1);
+    supervisor.registerHandle(&node2);
+    supervisor.arm(now);
+
+    std::promise<void> release;
+    node1.blocker = release.get_future().share();
+
+    // a stalled boot-up handler holds back neither the wheel nor other nodes
+
+    ASSERT_TRUE(heartbeat(supervisor, 0x01, 0x00));
+    ASSERT_TRUE(heartbeat(supervisor, 0x02));
+
+    for (int i = 0; i < 7; i++)
+    {
+        supervisor.advance(now += PERIOD);
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+
+    while (node2.lost == 0 && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    ASSERT_EQ(node2.lost, 1u);
+    ASSERT_EQ(node1.bootUps, 0u);
+
+    // events of the same node are handled in order
+
+    release.set_value();
+    supervisor.waitForEvents();
+    ASSERT_EQ(node1.bootUps, 1u);
+    ASSERT_EQ(node1.lost, 1u);
+}
+
+TEST_F(CanBusControlboardTest, EmcyMonitorRegister)
+{
+    EmcyMonitor monitor(PERIOD);
+    ASSERT_FALSE(monitor.hasNodes());
+
+    // only nodes that expose an EMCY history are monitored
+
+    FakeRemoteVariables other(false);
+    ASSERT_FALSE(monitor.registerHandle(0x01, &other));
+    ASSERT_FALSE(monitor.hasNodes());
+    ASSERT_FALSE(emcy(monitor, 0x01));
+
+    FakeRemoteVariables node(true);
+    ASSERT_FALSE(monitor.registerHandle(0x00, &node));
+    ASSERT_FALSE(monitor.registerHandle(0x80, &node));
+    ASSERT_TRUE(monitor.registerHandle(0x02, &node));
+    ASSERT_TRUE(monitor.hasNodes());
+
+    // frames of other protocols are ignored
+
+    ASSERT_TRUE(emcy(monitor, 0x02));
+
+    std::uint8_t data[8] = {0};
+    ASSERT_FALSE(monitor.notifyMessage({0x182, 8, data}));
+    ASSERT_FALSE(monitor.notifyMessage({0x080, 1, data})); // SYNC
+}
+
+TEST_F(CanBusControlboardTest, EmcyMonitorPoll)
+{
+    EmcyMonitor monitor(PERIOD);
+    FakeRemoteVariables node1(true);
+    FakeRemoteVariables node2(true);
+    ASSERT_TRUE(monitor.registerHandle(0x01, &node1));
+    ASSERT_TRUE(monitor.registerHandle(0x7F, &node2));
+
+    // nodes are queried only after sending an EMCY message
+
+    monitor.poll();
+    ASSERT_EQ(node1.queries, 0u);
+    ASSERT_EQ(node2.queries, 0u);
+
+    node1.history = {1, 2};
+    ASSERT_TRUE(emcy(monitor, 0x01));
+    ASSERT_TRUE(emcy(monitor, 0x01)); // coalesced
+
+    monitor.poll();
+    ASSERT_EQ(node1.queries, 1u);
+    ASSERT_EQ(node2.queries, 0u);
+    ASSERT_EQ(monitor.getLastReported(0x01), 2u);
+    ASSERT_EQ(monitor.getLastReported(0x7F), 0u);
+
+    monitor.poll();
+    ASSERT_EQ(node1.queries, 1u);
+
+    // only records newer than the last reported one are taken
+
+    node1.history = {2, 3, 4};
+    node2.history = {1};
+    ASSERT_TRUE(emcy(monitor, 0x01));
+    ASSERT_TRUE(emcy(monitor, 0x7F));
+
+    monitor.poll();
+    ASSERT_EQ(node1.queries, 2u);
+    ASSERT_EQ(node2.queries, 1u);
+    ASSERT_EQ(monitor.getLastReported(0x01), 4u);
+    ASSERT_EQ(monitor.getLastReported(0x7F), 1u);
+
+    // stale history, e.g. retrieved before the last poll
+
+    node1.history = {3};
+    ASSERT_TRUE(emcy(monitor, 0x01));
+    monitor.poll();
+    ASSERT_EQ(monitor.getLastReported(0x01), 4u);
+}
+
+TEST_F(CanBusControlboardTest, SdoReplierBatch)
+{
+    SdoReplier replier;
+    FakeSdoServer server(replier);
+    replier.configureSender(&server);
+
+    // responses are not routed while no transfer is in flight
+
+    std::uint8_t data[8] = {0x43};
+    ASSERT_FALSE(replier.notifyMessage({0x581, 8, data}));
+
+    // same-node items are performed in order, one result per item
+
+    yarp::os::Bottle request;
+    yarp::os::Bottle response;
+    sdoUpload(request, 1, 1);
+    sdoDownload(request, 2, 10);
+    sdoUpload(request, 2, 2);
+    sdoUpload(request, 1, 3);
+
+    ASSERT_TRUE(replier.processBatch(request, response));
+    ASSERT_EQ(response.size(), 4);
+
+    for (int i = 0; i < response.size(); i++)
+    {
+        ASSERT_TRUE(isOk(response.get(i)));
+    }
+
+    ASSERT_EQ(response.get(0).asList()->get(1).asInt32(), 1001);
+    ASSERT_EQ(response.get(1).asList()->size(), 1);
+    ASSERT_EQ(response.get(2).asList()->get(1).asInt32(), 2002);
+    ASSERT_EQ(response.get(3).asList()->get(1).asInt32(), 1003);
+
+    ASSERT_EQ(server.commandsOf(1), (std::vector<std::uint8_t>{0x40, 0x40}));
+    ASSERT_EQ(server.commandsOf(2), (std::vector<std::uint8_t>{0x23, 0x40}));
+}
+
+TEST_F(CanBusControlboardTest, SdoReplierBatchFailure)
+{
+    SdoReplier replier;
+    FakeSdoServer server(replier, {3});
+    replier.configureSender(&server);
+
+    // a failed item does not prevent the others from completing
+
+    yarp::os::Bottle request;
+    yarp::os::Bottle response;
+    sdoUpload(request, 1, 1);
+    sdoUpload(request, 3, 1);
+    sdoDownload(request, 3, 10);
+    sdoDownload(request, 2, 10);
+
+    ASSERT_FALSE(replier.processBatch(request, response));
+    ASSERT_EQ(response.size(), 4);
+    ASSERT_TRUE(isOk(response.get(0)));
+    ASSERT_FALSE(isOk(response.get(1)));
+    ASSERT_FALSE(isOk(response.get(2)));
+    ASSERT_TRUE(isOk(response.get(3)));
+    ASSERT_EQ(response.get(1).asList()->size(), 1);
+    ASSERT_EQ(server.commandsOf(3).size(), 2u);
+}
+
+TEST_F(CanBusControlboardTest, SdoReplierBatchMalformed)
+{
+    SdoReplier replier;
+    FakeSdoServer server(replier);
+    replier.configureSender(&server);
+
+    // the whole batch is rejected before any transfer takes place
+
+    yarp::os::Bottle response;
+
+    yarp::os::Bottle request1;
+    sdoUpload(request1, 1, 1);
+    sdoUpload(request1, 0, 1); // invalid node id
+    ASSERT_FALSE(replier.processBatch(request1, response));
+
+    yarp::os::Bottle request2;
+    sdoUpload(request2, 1, 1);
+    request2.addInt32(5); // not a list
+    ASSERT_FALSE(replier.processBatch(request2, response));
+
+    yarp::os::Bottle request3;
+    sdoUpload(request3, 1, 1);
+    sdoDownload(request3, 2, 10);
+    request3.get(1).asList()->pop(); // download without data
+    ASSERT_FALSE(replier.processBatch(request3, response));
+
+    ASSERT_EQ(response.size(), 0);
+    ASSERT_EQ(server.sent(), 0u);
+}
+
+TEST_F(CanBusControlboardTest, JointStateSnapshotPublish)
+{
+    using field = JointStateSnapshot::field;
+
+    JointStateSnapshot snapshot(3);
+    JointStateSink * sink0 = snapshot.getSink(0);
+    JointStateSink * sink2 = snapshot.getSink(2);
+
+    ASSERT_NE(sink0, nullptr);
+    ASSERT_NE(sink2, nullptr);
+    ASSERT_EQ(snapshot.getSink(3), nullptr);
+
+    double value;
+    double values[3];
+    int mode;
+
+    // nothing published yet
+
+    ASSERT_FALSE(snapshot.read(field::POSITION, 0, &value));
+
+    // the cycle is published as soon as all reporting joints have stored their state
+
+    snapshot.beginCycle(1);
+    sink0->store(1, makeState(10.0));
+    ASSERT_EQ(snapshot.getCycle(), 0u);
+
+    sink0->store(1, makeState(11.0)); // duplicate, doesn't count
+    ASSERT_EQ(snapshot.getCycle(), 0u);
+
+    sink2->store(1, makeState(20.0));
+    ASSERT_EQ(snapshot.getCycle(), 1u);
+
+    ASSERT_TRUE(snapshot.read(field::POSITION, 0, &value));
+    ASSERT_EQ(value, 11.0);
+    ASSERT_TRUE(snapshot.read(field::CURRENT, 2, &value));
+    ASSERT_EQ(value, 20.0);
+    ASSERT_TRUE(snapshot.readMode(2, &mode));
+    ASSERT_EQ(mode, JOINT_MODE);
+
+    // joints that don't report are never valid, nor are whole reads
+
+    ASSERT_FALSE(snapshot.read(field::POSITION, 1, &value));
+    ASSERT_FALSE(snapshot.readAll(field::POSITION, values));
+
+    // incomplete cycles are published on the next SYNC, keeping the last known state
+
+    snapshot.beginCycle(2);
+    sink2->store(2, makeState(21.0));
+    ASSERT_EQ(snapshot.getCycle(), 1u);
+
+    snapshot.beginCycle(3);
+    ASSERT_EQ(snapshot.getCycle(), 2u);
+    ASSERT_TRUE(snapshot.read(field::POSITION, 0, &value));
+    ASSERT_EQ(value, 11.0);
+    ASSERT_TRUE(snapshot.read(field::POSITION, 2, &value));
+    ASSERT_EQ(value, 21.0);
+
+    // late reports are stored, but don't complete the current cycle
+
+    sink0->store(2, makeState(12.0));
+    sink2->store(3, makeState(22.0));
+    ASSERT_EQ(snapshot.getCycle(), 2u);
+
+    sink0->store(3, makeState(13.0));
+    ASSERT_EQ(snapshot.getCycle(), 3u);
+    ASSERT_TRUE(snapshot.read(field::POSITION, 0, &value));
+    ASSERT_EQ(value, 13.0);
+}
+
+TEST_F(CanBusControlboardTest, JointStateSnapshotListener)
+{
+    struct listener : JointStateSnapshot::Listener
+    {
+        virtual void onPublish(std::uint64_t cycle, const std::vector<joint_state> & states) override
+        {
+            cycles.push_back(cycle);
+            last = states;
+        }
+
+        std::vector<std::uint64_t> cycles;
+        std::vector<joint_state> last;
+    };
+
+    listener l;
+    JointStateSnapshot snapshot(3);
+    snapshot.setListener(&l);
+
+    JointStateSink * sink0 = snapshot.getSink(0);
+    JointStateSink * sink2 = snapshot.getSink(2);
+
+    snapshot.beginCycle(1);
+    sink0->store(1, makeState(10.0));
+    ASSERT_TRUE(l.cycles.empty());
+
+    sink2->store(1, makeState(20.0));
+    ASSERT_EQ(l.cycles, std::vector<std::uint64_t>{1});
+    ASSERT_EQ(l.last.size(), 3u);
+    ASSERT_EQ(l.last[0].position, 10.0);
+    ASSERT_EQ(l.last[0].mode, JOINT_MODE);
+    ASSERT_EQ(l.last[1].mode, 0); // never reported
+    ASSERT_EQ(l.last[2].current, 20.0);
+
+    // incomplete cycles are forwarded on the next SYNC, too
+
+    snapshot.beginCycle(2);
+    sink2->store(2, makeState(21.0));
+    snapshot.beginCycle(3);
+    ASSERT_EQ(l.cycles, (std::vector<std::uint64_t>{1, 2}));
+    ASSERT_EQ(l.last[0].position, 10.0);
+    ASSERT_EQ(l.last[2].position, 21.0);
+}
+
+TEST_F(CanBusControlboardTest, JointStateSnapshotConsistency)
+{
+    using field = JointStateSnapshot::field;
+
+    constexpr int AXES = 10;
+    constexpr int CYCLES = 20000;
+
+    JointStateSnapshot snapshot(AXES);
+    std::vector<JointStateSink *> sinks;
+
+    for (int j = 0; j < AXES; j++)
+    {
+        sinks.push_back(snapshot.getSink(j));
+    }
+
+    double values[AXES];
+    double stamps[AXES];
+
+    // joints that have never reported are not valid
+
+    snapshot.beginCycle(1);
+    snapshot.beginCycle(2);
+    ASSERT_EQ(snapshot.getCycle(), 1u);
+    ASSERT_FALSE(snapshot.readAll(field::POSITION, values));
+
+    // two writer threads (CAN buses) feed half of the joints each, all values of a cycle are equal
+
+    std::atomic<bool> done(false);
+
+    auto reader = std::async(std::launch::async, [&]
+        {
+            unsigned int torn = 0;
+
+            while (!done)
+            {
+                if (snapshot.readAll(field::VELOCITY, values, stamps))
+                {
+                    for (int j = 0; j < AXES; j++)
+                    {
+                        torn += values[j] != values[0] || stamps[j] != values[0];
+                    }
+                }
+            }
+
+            return torn;
+        });
+
+    for (std::uint64_t cycle = 2; cycle < CYCLES; cycle++)
+    {
+        auto bus = std::async(std::launch::async, [&sinks, cycle]
+            {
+                for (int j = 0; j < AXES / 2; j++)
+                {
+                    sinks[j]->store(cycle, makeState(cycle));
+                }
+            });
+
+        for (int j = AXES / 2; j < AXES; j++)
+        {
+            sinks[j]->store(cycle, makeState(cycle));
+        }
+
+        bus.wait();
+        ASSERT_EQ(snapshot.getCycle(), cycle);
+        snapshot.beginCycle(cycle + 1);
+    }
+
+    done = true;
+    ASSERT_EQ(reader.get(), 0u);
+
+    ASSERT_TRUE(snapshot.readAll(field::POSITION, values, stamps));
+    ASSERT_EQ(values[0], CYCLES - 1);
+    ASSERT_EQ(values[AXES - 1], CYCLES - 1);
+}
+
+} // namespace test
+} // namespace roboticslab
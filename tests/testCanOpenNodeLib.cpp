@@ -3,17 +3,25 @@
 #include <cstdint>
 #include <cstring>
 
+#include <atomic>
+#include <chrono>
 #include <future>
+#include <memory>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
 #include "CanSenderDelegate.hpp"
+#include "InplaceFunction.hpp"
+#include "ObjectDictionary.hpp"
 #include "SdoClient.hpp"
+#include "SdoStatistics.hpp"
 #include "PdoProtocol.hpp"
 #include "NmtProtocol.hpp"
 #include "EmcyConsumer.hpp"
 #include "DriveStatusMachine.hpp"
+#include "SyncCycleMonitor.hpp"
 #include "CanOpenNode.hpp"
 
 #include "FutureObserverLib.hpp"
@@ -133,6 +141,20 @@ private:
     FakeCanSenderDelegate * senderDelegate;
 };
 
+/**
+ * @ingroup testCanOpenNodeLib
+ * @brief Read-write object descriptor, mimics an EDS-generated entry.
+ */
+struct TestVariable : ObjectEntry<std::int16_t, 0x1234, 0x56, ObjectAccess::RW, true>
+{ static constexpr const char * name() { return "Test variable"; } };
+
+/**
+ * @ingroup testCanOpenNodeLib
+ * @brief Read-only string object descriptor, mimics an EDS-generated entry.
+ */
+struct TestString : ObjectEntry<std::string, 0x1234, 0x56, ObjectAccess::CONST, false>
+{ static constexpr const char * name() { return "Test string"; } };
+
 TEST_F(CanOpenNodeTest, SdoClientExpeditedUpload)
 {
     const std::uint8_t id = 0x05;
@@ -388,6 +410,270 @@ TEST_F(CanOpenNodeTest, SdoClientPing)
     ASSERT_TRUE(sdo.ping());
 }
 
+TEST_F(CanOpenNodeTest, SdoStatistics)
+{
+    SdoStatistics stats;
+
+    const std::uint16_t index = 0x1234;
+    const std::uint8_t subindex = 0x56;
+
+    ASSERT_TRUE(stats.getObjectStats().empty());
+    ASSERT_EQ(stats.getSummary().count, 0);
+    ASSERT_EQ(stats.getSummary().p50, 0.0);
+
+    // test percentiles, relative error bounded by bucket width (2^(1/4))
+
+    for (int i = 0; i < 100; i++)
+    {
+        stats.addSample(index, subindex, 0.001);
+    }
+
+    stats.addSample(index, subindex, 0.1);
+    stats.addSample(index, subindex, 0.1);
+
+    auto objects = stats.getObjectStats();
+    ASSERT_EQ(objects.size(), 1);
+    ASSERT_EQ(objects[0].index, index);
+    ASSERT_EQ(objects[0].subindex, subindex);
+    ASSERT_EQ(objects[0].count, 102);
+    ASSERT_GE(objects[0].p50, 0.001);
+    ASSERT_LE(objects[0].p50, 0.001 * 1.19);
+    ASSERT_GE(objects[0].p99, 0.1 / 1.19);
+    ASSERT_LE(objects[0].p99, 0.1);
+    ASSERT_EQ(objects[0].max, 0.1);
+
+    // test failures and abort codes on another object
+
+    stats.addTimeout(index + 1, 0x00);
+    stats.addAbort(index + 1, 0x00, 0x06090011);
+    stats.addAbort(index + 1, 0x00, 0x06090011);
+    stats.addAbort(index + 1, 0x00, 0x06020000);
+    stats.addError(index + 1, 0x00);
+
+    objects = stats.getObjectStats();
+    ASSERT_EQ(objects.size(), 2);
+    ASSERT_EQ(objects[1].index, index + 1);
+    ASSERT_EQ(objects[1].count, 0);
+    ASSERT_EQ(objects[1].timeouts, 1);
+    ASSERT_EQ(objects[1].aborts, 3);
+    ASSERT_EQ(objects[1].errors, 1);
+    ASSERT_EQ(objects[1].abortCodes.size(), 2);
+    ASSERT_EQ(objects[1].abortCodes[0], std::make_pair(0x06020000u, std::uint64_t(1)));
+    ASSERT_EQ(objects[1].abortCodes[1], std::make_pair(0x06090011u, std::uint64_t(2)));
+
+    // test summary
+
+    auto summary = stats.getSummary();
+    ASSERT_EQ(summary.count, 102);
+    ASSERT_EQ(summary.timeouts, 1);
+    ASSERT_EQ(summary.aborts, 3);
+    ASSERT_EQ(summary.errors, 1);
+    ASSERT_EQ(summary.max, 0.1);
+    ASSERT_EQ(summary.abortCodes.size(), 2);
+
+    stats.reset();
+    ASSERT_TRUE(stats.getObjectStats().empty());
+
+    // test statistics collected by SdoClient
+
+    SdoClient sdo(0x05, 0x600, 0x580, TIMEOUT, getSender());
+
+    std::uint8_t response[8] = {0x4F, 0x00, 0x00, subindex, 0x44};
+    std::memcpy(response + 1, &index, 2);
+
+    std::int8_t data;
+    f() = std::async(std::launch::async, observer_timer{MILLIS, [&]{ return sdo.notify(response); }});
+    ASSERT_TRUE(sdo.upload("Upload test", &data, index, subindex));
+
+    ASSERT_FALSE(sdo.upload("Timeout test", &data, index, subindex));
+
+    response[0] = 0x80;
+    std::uint32_t abortCode = 0x06090011; // "Sub-index does not exist"
+    std::memcpy(response + 4, &abortCode, 4);
+    f() = std::async(std::launch::async, observer_timer{MILLIS, [&]{ return sdo.notify(response); }});
+    ASSERT_FALSE(sdo.upload("Abort test", &data, index, subindex));
+
+    response[0] = 0x4F;
+    response[3] = 0x69; // different subindex
+    f() = std::async(std::launch::async, observer_timer{MILLIS, [&]{ return sdo.notify(response); }});
+    ASSERT_FALSE(sdo.upload("Overrun test", &data, index, subindex));
+
+    objects = sdo.getStatistics().getObjectStats();
+    ASSERT_EQ(objects.size(), 1);
+    ASSERT_EQ(objects[0].count, 1);
+    ASSERT_EQ(objects[0].timeouts, 1);
+    ASSERT_EQ(objects[0].aborts, 1);
+    ASSERT_EQ(objects[0].errors, 1);
+    ASSERT_EQ(objects[0].abortCodes.size(), 1);
+    ASSERT_EQ(objects[0].abortCodes[0].first, abortCode);
+    ASSERT_GE(objects[0].max, MILLIS * 0.001);
+    ASSERT_LT(objects[0].max, 2 * MILLIS * 0.001);
+
+    sdo.resetStatistics();
+    ASSERT_TRUE(sdo.getStatistics().getObjectStats().empty());
+}
+
+TEST_F(CanOpenNodeTest, SdoClientAdaptiveTimeout)
+{
+    const std::uint16_t index = 0x1234;
+    const std::uint8_t subindex = 0x56;
+
+    SdoClient sdo(0x05, 0x600, 0x580, TIMEOUT, getSender());
+    ASSERT_EQ(sdo.getTimeout(), TIMEOUT * 1);
+    ASSERT_EQ(sdo.getSmoothedRtt(), 0.0);
+
+    SdoClient::adaptive_policy policy;
+    policy.minTimeout = 0.02;
+    policy.maxTimeout = 0.2;
+    policy.retries = 2;
+
+    sdo.enableAdaptiveTimeout(policy);
+    ASSERT_EQ(sdo.getTimeout(), TIMEOUT * 1); // no samples yet
+
+    std::uint8_t response[8] = {0x4F, 0x00, 0x00, subindex, 0x44};
+    std::memcpy(response + 1, &index, 2);
+
+    // test timeout estimation, fast responses should shrink it down to the lower bound
+
+    const int fastMillis = 5;
+    std::int8_t data;
+
+    for (int i = 0; i < 5; i++)
+    {
+        f() = std::async(std::launch::async, observer_timer{fastMillis, [&]{ return sdo.notify(response); }});
+        ASSERT_TRUE(sdo.upload("Upload test", &data, index, subindex));
+    }
+
+    double srtt = sdo.getSmoothedRtt();
+    ASSERT_GE(srtt, fastMillis * 0.001);
+    ASSERT_LT(srtt, MILLIS * 0.001);
+    ASSERT_GE(sdo.getTimeout(), policy.minTimeout);
+    ASSERT_LT(sdo.getTimeout(), MILLIS * 0.001);
+
+    // test retry, the response arrives after the first attempt has timed out
+
+    f() = std::async(std::launch::async, observer_timer{MILLIS, [&]{ return sdo.notify(response); }});
+    ASSERT_TRUE(sdo.upload("Retry test", &data, index, subindex));
+    ASSERT_EQ(sdo.getSmoothedRtt(), srtt); // ambiguous sample, not accounted for
+
+    auto stats = sdo.getStatistics().getSummary();
+    ASSERT_EQ(stats.count, 6);
+    ASSERT_EQ(stats.retries, 1);
+    ASSERT_EQ(stats.timeouts, 0);
+    ASSERT_LT(stats.max, MILLIS * 0.001); // only the successful attempt is timed
+
+    // test exhausted retries
+
+    ASSERT_FALSE(sdo.upload("Timeout test", &data, index, subindex));
+
+    stats = sdo.getStatistics().getSummary();
+    ASSERT_EQ(stats.retries, 3);
+    ASSERT_EQ(stats.timeouts, 1);
+
+    // test downloads, never retried
+
+    ASSERT_FALSE(sdo.download<std::int8_t>("Download test", 0x44, index, subindex));
+
+    stats = sdo.getStatistics().getSummary();
+    ASSERT_EQ(stats.retries, 3);
+    ASSERT_EQ(stats.timeouts, 2);
+
+    // test fixed timeout
+
+    sdo.disableAdaptiveTimeout();
+    ASSERT_EQ(sdo.getTimeout(), TIMEOUT * 1);
+}
+
+TEST_F(CanOpenNodeTest, SdoClientObjectDictionary)
+{
+    static_assert(is_object_entry<TestVariable>::value, "Object descriptor expected.");
+    static_assert(!is_object_entry<std::int16_t>::value, "Object descriptor not expected.");
+    static_assert(TestVariable::readable && TestVariable::writable && TestVariable::pdoMappable, "");
+    static_assert(TestString::readable && !TestString::writable && !TestString::pdoMappable, "");
+
+    SdoClient sdo(0x05, 0x600, 0x580, TIMEOUT, getSender());
+
+    const std::uint16_t index = TestVariable::index;
+    const std::uint8_t subindex = TestVariable::subindex;
+
+    std::uint8_t response[8] = {0x4B, 0x00, 0x00, subindex};
+    std::memcpy(response + 1, &index, 2);
+
+    // test SdoClient::upload(), typed descriptor
+
+    std::int16_t actual1;
+    const std::int16_t expected = 0x4444;
+    std::memcpy(response + 4, &expected, 2);
+    f() = std::async(std::launch::async, observer_timer{MILLIS, [&]{ return sdo.notify(response); }});
+    ASSERT_TRUE(sdo.upload(TestVariable(), &actual1));
+    ASSERT_EQ(getSender()->getLastMessage().id, sdo.getCobIdRx());
+    ASSERT_EQ(getSender()->getLastMessage().len, 8);
+    ASSERT_EQ(getSender()->getLastMessage().data, toInt64(0x40, index, subindex));
+    ASSERT_EQ(actual1, expected);
+
+    // test SdoClient::upload(), typed descriptor (lambda overload)
+
+    std::int16_t actual2;
+    f() = std::async(std::launch::async, observer_timer{MILLIS, [&]{ return sdo.notify(response); }});
+    ASSERT_TRUE(sdo.upload(TestVariable(), [&](auto data) { actual2 = data; }));
+    ASSERT_EQ(getSender()->getLastMessage().data, toInt64(0x40, index, subindex));
+    ASSERT_EQ(actual2, expected);
+
+    // test SdoClient::download(), typed descriptor
+
+    response[0] = 0x60;
+    f() = std::async(std::launch::async, observer_timer{MILLIS, [&]{ return sdo.notify(response); }});
+    ASSERT_TRUE(sdo.download(TestVariable(), static_cast<std::int16_t>(0x4444)));
+    ASSERT_EQ(getSender()->getLastMessage().id, sdo.getCobIdRx());
+    ASSERT_EQ(getSender()->getLastMessage().len, 8);
+    ASSERT_EQ(getSender()->getLastMessage().data, toInt64(0x2B, index, subindex, 0x4444));
+
+    // test SdoClient::upload(), typed descriptor (string)
+
+    getSender()->flush();
+
+    const std::string s = "abc";
+    const std::uint8_t response1[8] = {0x41, 0x34, 0x12, subindex, static_cast<std::uint8_t>(s.size())};
+    const std::uint8_t response2[8] = {0x09, 'a', 'b', 'c'};
+
+    std::string actual3;
+    f() = std::async(std::launch::async, observer_timer{MILLIS, [&]{ return sdo.notify(response1); }});
+    f() = std::async(std::launch::async, observer_timer{MILLIS * 2, [&]{ return sdo.notify(response2); }});
+    ASSERT_TRUE(sdo.upload(TestString(), [&](const auto & data) { actual3 = data; }));
+    ASSERT_EQ(getSender()->getMessage(0).data, toInt64(0x40, index, subindex));
+    ASSERT_EQ(getSender()->getMessage(1).data, toInt64(0x60));
+    ASSERT_EQ(actual3, s);
+}
+
+TEST_F(CanOpenNodeTest, PdoTransmissionType)
+{
+    PdoTransmissionType type;
+
+    ASSERT_TRUE(PdoTransmissionType::fromByte(0x00, &type));
+    ASSERT_EQ(type, PdoTransmissionType::SYNCHRONOUS_ACYCLIC);
+
+    ASSERT_TRUE(PdoTransmissionType::fromByte(0x01, &type));
+    ASSERT_EQ(type, PdoTransmissionType::SYNCHRONOUS_CYCLIC);
+
+    ASSERT_TRUE(PdoTransmissionType::fromByte(0xF0, &type));
+    ASSERT_EQ(type, PdoTransmissionType::SYNCHRONOUS_CYCLIC_N<0xF0>());
+
+    ASSERT_FALSE(PdoTransmissionType::fromByte(0xF1, &type));
+    ASSERT_FALSE(PdoTransmissionType::fromByte(0xFB, &type));
+
+    ASSERT_TRUE(PdoTransmissionType::fromByte(0xFC, &type));
+    ASSERT_EQ(type, PdoTransmissionType::RTR_SYNCHRONOUS);
+
+    ASSERT_TRUE(PdoTransmissionType::fromByte(0xFD, &type));
+    ASSERT_EQ(type, PdoTransmissionType::RTR_EVENT_DRIVEN);
+
+    ASSERT_TRUE(PdoTransmissionType::fromByte(0xFE, &type));
+    ASSERT_EQ(type, PdoTransmissionType::EVENT_DRIVEN_MANUFACTURER);
+
+    ASSERT_TRUE(PdoTransmissionType::fromByte(0xFF, &type));
+    ASSERT_EQ(type, PdoTransmissionType::EVENT_DRIVEN_DEVICE_APP_PROFILE);
+}
+
 TEST_F(CanOpenNodeTest, ReceivePdo)
 {
     SdoClient sdo(0x05, 0x600, 0x580, TIMEOUT, getSender());
@@ -604,12 +890,180 @@ TEST_F(CanOpenNodeTest, TransmitPdo)
     ASSERT_EQ(actual2, expected2);
     ASSERT_EQ(actual3, expected3);
 
+    // test TransmitPdo::registerRawHandler() and accept()
+
+    tpdo1.registerRawHandler([&](const std::uint8_t * data, unsigned int size)
+            { return size == 7 && (std::memcpy(&actual3, data + 3, 4), true); });
+
+    actual3 = 0;
+    ASSERT_FALSE(tpdo1.accept(raw, 3));
+    ASSERT_EQ(actual3, 0);
+    ASSERT_TRUE(tpdo1.accept(raw, 7));
+    ASSERT_EQ(actual3, expected3);
+
     // test TransmitPdo::accept(), handler was detached
 
     tpdo1.unregisterHandler();
     ASSERT_FALSE(tpdo1.accept(nullptr, 0));
 }
 
+TEST_F(CanOpenNodeTest, SyncCycleMonitor)
+{
+    SyncCycleMonitor monitor;
+    ASSERT_FALSE(monitor.isEnabled());
+    ASSERT_EQ(monitor.getCycle(), 0);
+
+    monitor.expect(1);
+    monitor.expect(3);
+    ASSERT_TRUE(monitor.isEnabled());
+
+    // test untracked TPDO
+
+    std::uint64_t cycle = 0;
+    ASSERT_FALSE(monitor.accept(2, &cycle));
+    ASSERT_EQ(monitor.getLateCount(), 0);
+
+    // test complete cycle
+
+    ASSERT_TRUE(monitor.beginCycle(1));
+    ASSERT_EQ(monitor.getCycle(), 1);
+    ASSERT_TRUE(monitor.accept(1, &cycle));
+    ASSERT_EQ(cycle, 1);
+    ASSERT_TRUE(monitor.accept(3, &cycle));
+    ASSERT_EQ(cycle, 1);
+
+    ASSERT_TRUE(monitor.beginCycle(2));
+    ASSERT_EQ(monitor.getLastCompleteCycle(), 1);
+    ASSERT_EQ(monitor.getLostCount(), 0);
+
+    // test lost TPDO
+
+    ASSERT_TRUE(monitor.accept(1, &cycle));
+    ASSERT_EQ(cycle, 2);
+
+    ASSERT_FALSE(monitor.beginCycle(3));
+    ASSERT_EQ(monitor.getLastCompleteCycle(), 1);
+    ASSERT_EQ(monitor.getLostCount(), 1);
+
+    // test late TPDO, a second one within the same cycle
+
+    ASSERT_TRUE(monitor.accept(3, &cycle));
+    ASSERT_FALSE(monitor.accept(3, &cycle));
+    ASSERT_EQ(monitor.getLateCount(), 1);
+    ASSERT_TRUE(monitor.accept(1, &cycle));
+
+    ASSERT_TRUE(monitor.beginCycle(4));
+    ASSERT_EQ(monitor.getLastCompleteCycle(), 3);
+
+    // test unchecked cycle
+
+    ASSERT_TRUE(monitor.beginCycle(5, false));
+    ASSERT_EQ(monitor.getLostCount(), 1);
+
+    monitor.resetCounters();
+    ASSERT_EQ(monitor.getLostCount(), 0);
+    ASSERT_EQ(monitor.getLateCount(), 0);
+
+    // test concurrent access, TPDOs are received in a separate thread
+
+    SyncCycleMonitor monitor2;
+    monitor2.expect(1);
+
+    const std::uint64_t cycles = 100;
+    std::atomic<std::uint64_t> acknowledged {0};
+    std::atomic<bool> mismatch {false};
+
+    std::thread receiver([&]
+        {
+            std::uint64_t tag = 0;
+
+            while (tag != cycles)
+            {
+                if (monitor2.getCycle() != tag)
+                {
+                    std::uint64_t expected = monitor2.getCycle();
+
+                    if (!monitor2.accept(1, &tag) || tag != expected)
+                    {
+                        mismatch = true;
+                        return;
+                    }
+
+                    acknowledged = tag;
+                }
+
+                std::this_thread::yield();
+            }
+        });
+
+    for (std::uint64_t i = 1; i <= cycles && !mismatch; i++)
+    {
+        monitor2.beginCycle(i);
+
+        while (acknowledged != i && !mismatch)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    receiver.join();
+    ASSERT_FALSE(mismatch);
+    ASSERT_EQ(monitor2.getLastCompleteCycle(), cycles - 1);
+    ASSERT_EQ(monitor2.getLostCount(), 0);
+    ASSERT_EQ(monitor2.getLateCount(), 0);
+}
+
+TEST_F(CanOpenNodeTest, InplaceFunction)
+{
+    // test empty instance
+
+    InplaceFunction<int(int)> fn1;
+    ASSERT_FALSE(fn1);
+
+    // test invocation, captured state is preserved
+
+    int offset = 2;
+    fn1 = [offset](int v) { return v + offset; };
+    ASSERT_TRUE(fn1);
+    ASSERT_EQ(fn1(3), 5);
+
+    // test copy, both instances are independent
+
+    InplaceFunction<int(int)> fn2(fn1);
+    fn1.reset();
+    ASSERT_FALSE(fn1);
+    ASSERT_TRUE(fn2);
+    ASSERT_EQ(fn2(3), 5);
+
+    // test destruction of stored callable objects
+
+    auto counter = std::make_shared<int>(0);
+
+    {
+        InplaceFunction<long()> fn3([counter] { return counter.use_count(); });
+        ASSERT_EQ(fn3(), 2);
+
+        InplaceFunction<long()> fn4;
+        fn4 = fn3;
+        ASSERT_EQ(fn4(), 3);
+
+        fn4 = [] { return 0L; };
+        ASSERT_EQ(fn3(), 2);
+
+        // test move, stored callable object is transferred
+
+        InplaceFunction<long()> fn5(std::move(fn3));
+        ASSERT_FALSE(fn3);
+        ASSERT_EQ(fn5(), 2);
+
+        fn4 = std::move(fn5);
+        ASSERT_FALSE(fn5);
+        ASSERT_EQ(fn4(), 2);
+    }
+
+    ASSERT_EQ(counter.use_count(), 1);
+}
+
 TEST_F(CanOpenNodeTest, NmtProtocol)
 {
     const std::uint8_t id = 0x05;
@@ -700,9 +1154,9 @@ TEST_F(CanOpenNodeTest, EmcyConsumer)
     raw1[2] = expectedReg1;
     std::memcpy(raw1 + 3, &expectedMsef1, 5);
 
-    emcy.registerHandler([&](EmcyConsumer::code_t code, std::uint8_t reg, const std::uint8_t * msef)
+    emcy.registerHandler([&](std::uint16_t code, std::uint8_t reg, const std::uint8_t * msef)
         {
-            actualCode1 = code;
+            actualCode1 = emcy.codeToMessage(code);
             actualReg1 = reg;
             std::memcpy(&actualMsef1, msef, 5);
         });
@@ -735,9 +1189,9 @@ TEST_F(CanOpenNodeTest, EmcyConsumer)
     raw2[2] = expectedReg1;
     std::memcpy(raw2 + 3, &expectedMsef2, 5);
 
-    emcy.registerHandler([&](EmcyConsumer::code_t code, std::uint8_t reg, const std::uint8_t * msef)
+    emcy.registerHandler([&](std::uint16_t code, std::uint8_t reg, const std::uint8_t * msef)
         {
-            actualCode2 = code;
+            actualCode2 = emcy.codeToMessage(code);
             actualReg2 = reg;
             std::memcpy(&actualMsef2, msef, 5);
         });
@@ -747,10 +1201,96 @@ TEST_F(CanOpenNodeTest, EmcyConsumer)
     ASSERT_EQ(actualReg2, expectedReg2);
     ASSERT_EQ(actualMsef2, expectedMsef2);
 
+    // test EmcyConsumer::getHistory()
+
+    auto history = emcy.getHistory();
+    ASSERT_EQ(history.size(), 2);
+    ASSERT_EQ(emcy.getLastSequence(), 2);
+
+    ASSERT_EQ(history[0].seq, 1);
+    ASSERT_EQ(history[0].code, expectedCode1.first);
+    ASSERT_EQ(history[0].reg, expectedReg1);
+    ASSERT_EQ(std::memcmp(history[0].msef, &expectedMsef1, 5), 0);
+
+    ASSERT_EQ(history[1].seq, 2);
+    ASSERT_EQ(history[1].code, expectedCode2.first);
+    ASSERT_GE(history[1].timestamp, history[0].timestamp);
+
+    ASSERT_EQ(emcy.getHistory(1).size(), 1);
+    ASSERT_EQ(emcy.getHistory(1)[0].seq, 2);
+    ASSERT_TRUE(emcy.getHistory(2).empty());
+
+    // test EmcyConsumer::getHistory(), oldest records are overwritten
+
+    for (unsigned int i = 0; i < EmcyConsumer::HISTORY_SIZE; i++)
+    {
+        ASSERT_TRUE(emcy.accept(raw1));
+    }
+
+    history = emcy.getHistory();
+    ASSERT_EQ(history.size(), EmcyConsumer::HISTORY_SIZE);
+    ASSERT_EQ(history.front().seq, 3);
+    ASSERT_EQ(history.back().seq, EmcyConsumer::HISTORY_SIZE + 2);
+    ASSERT_EQ(history.back().code, expectedCode1.first);
+
     // test EmcyConsumer::accept(), handler was detached
 
     emcy.unregisterHandler();
     ASSERT_FALSE(emcy.accept(nullptr));
+
+    // test EmcyConsumer::accept(), history is kept without a handler
+
+    ASSERT_TRUE(emcy.accept(raw2));
+    ASSERT_EQ(emcy.getLastSequence(), EmcyConsumer::HISTORY_SIZE + 3);
+
+    history = emcy.getHistory(EmcyConsumer::HISTORY_SIZE + 2);
+    ASSERT_EQ(history.size(), 1);
+    ASSERT_EQ(history[0].code, expectedCode2.first);
+    ASSERT_EQ(history[0].reg, expectedReg2);
+}
+
+TEST_F(CanOpenNodeTest, EmcyConsumerConcurrent)
+{
+    EmcyConsumer emcy;
+    const std::uint64_t messages = 10000;
+
+    std::atomic<bool> mismatch {false};
+    std::atomic<bool> done {false};
+
+    // test EmcyConsumer::getHistory(), records are never torn
+
+    std::thread reader([&]
+        {
+            while (!done)
+            {
+                for (const auto & record : emcy.getHistory())
+                {
+                    std::uint64_t msef = 0;
+                    std::memcpy(&msef, record.msef, 5);
+
+                    if (record.code != (record.seq & 0xFFFF) || msef != record.seq)
+                    {
+                        mismatch = true;
+                    }
+                }
+
+                std::this_thread::yield();
+            }
+        });
+
+    for (std::uint64_t seq = 1; seq <= messages; seq++)
+    {
+        std::uint8_t raw[8] = {0};
+        std::memcpy(raw, &seq, 2);
+        std::memcpy(raw + 3, &seq, 5);
+        ASSERT_TRUE(emcy.accept(raw));
+    }
+
+    done = true;
+    reader.join();
+
+    ASSERT_FALSE(mismatch);
+    ASSERT_EQ(emcy.getLastSequence(), messages);
 }
 
 TEST_F(CanOpenNodeTest, DriveStatusMachine)
@@ -1101,6 +1641,130 @@ TEST_F(CanOpenNodeTest, DriveStatusMachine)
     ASSERT_FALSE(status.requestState(DriveState::SWITCH_ON_DISABLED));
 }
 
+TEST_F(CanOpenNodeTest, DriveStatusMachineGroup)
+{
+    constexpr int DRIVES = 4;
+    constexpr int RESPONSE_MILLIS = 20;
+
+    const std::uint16_t switchOnDisabled = 0b0000'0000'0100'0000;
+    const std::uint16_t readyToSwitchOn = 0b0000'0000'0010'0001;
+    const std::uint16_t switchedOn = 0b0000'0000'0010'0011;
+    const std::uint16_t operationEnabled = 0b0000'0000'0010'0111;
+    const std::uint16_t fault = 0b0000'0000'0000'1000;
+
+    std::vector<std::unique_ptr<SdoClient>> sdos;
+    std::vector<std::unique_ptr<ReceivePdo>> rpdos;
+    std::vector<std::unique_ptr<DriveStatusMachine>> drives;
+
+    for (int i = 0; i < DRIVES; i++)
+    {
+        const std::uint8_t id = 0x05 + i;
+        sdos.emplace_back(new SdoClient(id, 0x600, 0x580, TIMEOUT, getSender()));
+        rpdos.emplace_back(new ReceivePdo(id, 0x200, 1, sdos.back().get(), getSender()));
+        drives.emplace_back(new DriveStatusMachine(rpdos.back().get(), TIMEOUT));
+    }
+
+    // fake drives that answer all pending commands once per cycle, as if sampled at a fixed rate
+    auto requestStates = [&](const std::vector<DriveStatusMachine::request_t> & requests)
+    {
+        std::atomic<bool> done(false);
+
+        std::thread responder([&]
+            {
+                while (!done)
+                {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(RESPONSE_MILLIS));
+
+                    for (const auto & drive : drives)
+                    {
+                        if (drive->getCurrentState() == DriveState::FAULT)
+                        {
+                            continue;
+                        }
+
+                        switch (drive->controlword().to_ulong() & 0x008F)
+                        {
+                        case 0x0006: drive->update(readyToSwitchOn); break;
+                        case 0x0007: drive->update(switchedOn); break;
+                        case 0x000F: drive->update(operationEnabled); break;
+                        case 0x0000: drive->update(switchOnDisabled); break;
+                        }
+                    }
+                }
+            });
+
+        bool ok = DriveStatusMachine::requestStates(requests);
+
+        done = true;
+        responder.join();
+        return ok;
+    };
+
+    // test SWITCH_ON_DISABLED -> OPERATION_ENABLED on all drives
+
+    std::vector<DriveStatusMachine::request_t> requests;
+
+    for (const auto & drive : drives)
+    {
+        ASSERT_TRUE(drive->update(switchOnDisabled));
+        requests.emplace_back(drive.get(), DriveState::OPERATION_ENABLED);
+    }
+
+    getSender()->flush();
+
+    ASSERT_TRUE(requestStates(requests));
+
+    for (int i = 0; i < DRIVES; i++)
+    {
+        ASSERT_EQ(drives[i]->getCurrentState(), DriveState::OPERATION_ENABLED);
+
+        // each transition step is issued to all drives before awaiting any of them
+        ASSERT_EQ(getSender()->getMessage(i).id, rpdos[i]->getCobId());
+        ASSERT_EQ(getSender()->getMessage(i).data, 0x0006);
+        ASSERT_EQ(getSender()->getMessage(DRIVES + i).id, rpdos[i]->getCobId());
+        ASSERT_EQ(getSender()->getMessage(DRIVES + i).data, 0x0007);
+        ASSERT_EQ(getSender()->getMessage(2 * DRIVES + i).id, rpdos[i]->getCobId());
+        ASSERT_EQ(getSender()->getMessage(2 * DRIVES + i).data, 0x000F);
+    }
+
+    // test drives already in their goal state and mixed goals
+
+    requests.clear();
+    requests.emplace_back(drives[0].get(), DriveState::SWITCHED_ON);
+    requests.emplace_back(drives[1].get(), DriveState::SWITCH_ON_DISABLED);
+    requests.emplace_back(drives[2].get(), DriveState::OPERATION_ENABLED);
+
+    getSender()->flush();
+
+    ASSERT_TRUE(requestStates(requests));
+    ASSERT_EQ(drives[0]->getCurrentState(), DriveState::SWITCHED_ON);
+    ASSERT_EQ(drives[1]->getCurrentState(), DriveState::SWITCH_ON_DISABLED);
+    ASSERT_EQ(drives[2]->getCurrentState(), DriveState::OPERATION_ENABLED);
+    ASSERT_EQ(drives[3]->getCurrentState(), DriveState::OPERATION_ENABLED);
+    ASSERT_EQ(getSender()->getMessage(0).data, 0x0007);
+    ASSERT_EQ(getSender()->getMessage(1).data, 0x0000);
+
+    // test unsupported request on one drive, the rest of them still transition
+
+    ASSERT_TRUE(drives[3]->update(fault));
+
+    requests.clear();
+
+    for (const auto & drive : drives)
+    {
+        requests.emplace_back(drive.get(), DriveState::OPERATION_ENABLED);
+    }
+
+    ASSERT_FALSE(requestStates(requests));
+
+    for (int i = 0; i < DRIVES - 1; i++)
+    {
+        ASSERT_EQ(drives[i]->getCurrentState(), DriveState::OPERATION_ENABLED);
+    }
+
+    ASSERT_EQ(drives[3]->getCurrentState(), DriveState::FAULT);
+}
+
 TEST_F(CanOpenNodeTest, CanOpenNode)
 {
     std::uint8_t id = 0x05;
@@ -1149,9 +1813,9 @@ TEST_F(CanOpenNodeTest, CanOpenNode)
     raw1[2] = expectedReg;
     std::memcpy(raw1 + 3, &expectedMsef, 5);
 
-    can.emcy()->registerHandler([&](EmcyConsumer::code_t code, std::uint8_t reg, const std::uint8_t * msef)
+    can.emcy()->registerHandler([&](std::uint16_t code, std::uint8_t reg, const std::uint8_t * msef)
         {
-            actualCode = code;
+            actualCode = can.emcy()->codeToMessage(code);
             actualReg = reg;
             std::memcpy(&actualMsef, msef, 5);
         });
@@ -0,0 +1,329 @@
+#include "gtest/gtest.h"
+
+#include <unistd.h> // getpid
+
+#include <cerrno>
+#include <cstdint>
+
+#include <atomic>
+#include <future>
+#include <string>
+
+#include "SharedJointCommand.hpp"
+#include "SharedJointState.hpp"
+
+namespace roboticslab
+{
+
+namespace test
+{
+
+/**
+ * @ingroup yarp_devices_tests
+ * @defgroup testSharedMemoryLib
+ * @brief Unit tests related to @ref SharedMemoryLib.
+ */
+
+/**
+ * @ingroup testSharedMemoryLib
+ * @brief Creates a uniquely named shared memory object per test.
+ */
+class SharedMemoryTest : public testing::Test
+{
+public:
+    virtual void SetUp()
+    {
+        name = "/roboticslab-test-" + std::to_string(::getpid()) + "-"
+             + testing::UnitTest::GetInstance()->current_test_info()->name();
+    }
+
+    virtual void TearDown()
+    {
+    }
+
+protected:
+    static void publish(SharedJointStateWriter & writer, std::uint64_t cycle, double value)
+    {
+        writer.beginRecord(cycle, value);
+
+        for (int j = 0; j < writer.getAxes(); j++)
+        {
+            writer.setJoint(j, value, value, value, static_cast<std::int32_t>(cycle), value);
+        }
+
+        writer.endRecord();
+    }
+
+    std::string name;
+};
+
+TEST_F(SharedMemoryTest, SharedJointState)
+{
+    SharedJointStateWriter writer;
+    SharedJointStateReader reader;
+    shared_joint_state state;
+
+    // nothing to attach to yet
+
+    ASSERT_FALSE(reader.open(name));
+    ASSERT_EQ(errno, ENOENT);
+
+    ASSERT_FALSE(writer.open(name, 0, 4));
+    ASSERT_FALSE(writer.open(name, 3, 1));
+    ASSERT_TRUE(writer.open(name, 3, 4));
+    ASSERT_TRUE(writer.isOpen());
+
+    ASSERT_TRUE(reader.open(name));
+    ASSERT_TRUE(reader.isAlive());
+    ASSERT_EQ(reader.getAxes(), 3);
+    ASSERT_EQ(reader.getPublished(), 0u);
+    ASSERT_FALSE(reader.readLatest(state));
+    ASSERT_FALSE(reader.readNext(state));
+
+    // a single record
+
+    writer.beginRecord(1, 100.0);
+    ASSERT_TRUE(writer.setJoint(0, 1.0, 2.0, 3.0, 4, 5.0));
+    ASSERT_TRUE(writer.setJoint(2, 6.0, 7.0, 8.0, 9, 10.0));
+    ASSERT_FALSE(writer.setJoint(3, 0.0, 0.0, 0.0, 0, 0.0));
+    ASSERT_FALSE(reader.readLatest(state)); // not published yet
+    writer.endRecord();
+
+    ASSERT_EQ(reader.getPublished(), 1u);
+    ASSERT_TRUE(reader.readLatest(state));
+    ASSERT_EQ(state.cycle, 1u);
+    ASSERT_EQ(state.stamp, 100.0);
+    ASSERT_EQ(state.positions.size(), 3u);
+    ASSERT_EQ(state.positions[0], 1.0);
+    ASSERT_EQ(state.velocities[0], 2.0);
+    ASSERT_EQ(state.currents[0], 3.0);
+    ASSERT_EQ(state.modes[0], 4);
+    ASSERT_EQ(state.timestamps[0], 5.0);
+    ASSERT_EQ(state.modes[1], 0); // never written
+    ASSERT_EQ(state.positions[2], 6.0);
+    ASSERT_EQ(state.timestamps[2], 10.0);
+
+    // records are read in order, once
+
+    ASSERT_TRUE(reader.readNext(state));
+    ASSERT_EQ(state.cycle, 1u);
+    ASSERT_FALSE(reader.readNext(state));
+
+    publish(writer, 2, 2.0);
+    publish(writer, 3, 3.0);
+
+    ASSERT_TRUE(reader.readNext(state));
+    ASSERT_EQ(state.cycle, 2u);
+    ASSERT_TRUE(reader.readNext(state));
+    ASSERT_EQ(state.cycle, 3u);
+    ASSERT_FALSE(reader.readNext(state));
+    ASSERT_EQ(reader.getMissed(), 0u);
+
+    // lagging readers skip overwritten records
+
+    for (std::uint64_t cycle = 4; cycle <= 13; cycle++)
+    {
+        publish(writer, cycle, cycle);
+    }
+
+    ASSERT_TRUE(reader.readNext(state));
+    ASSERT_EQ(state.cycle, 11u); // depth - 1 records are safe to read
+    ASSERT_EQ(state.positions[1], 11.0);
+    ASSERT_EQ(reader.getMissed(), 7u);
+
+    ASSERT_TRUE(reader.readLatest(state));
+    ASSERT_EQ(state.cycle, 13u);
+
+    // late readers start with the latest record
+
+    SharedJointStateReader lateReader;
+    ASSERT_TRUE(lateReader.open(name));
+    ASSERT_TRUE(lateReader.readNext(state));
+    ASSERT_EQ(state.cycle, 13u);
+    ASSERT_FALSE(lateReader.readNext(state));
+
+    // mappings outlive the writer
+
+    writer.close();
+    ASSERT_FALSE(reader.isAlive());
+    ASSERT_TRUE(reader.readLatest(state));
+    ASSERT_EQ(state.cycle, 13u);
+
+    SharedJointStateReader orphanReader;
+    ASSERT_FALSE(orphanReader.open(name));
+}
+
+TEST_F(SharedMemoryTest, SharedJointStateConsistency)
+{
+    constexpr int AXES = 24;
+    constexpr int DEPTH = 2; // force frequent overwrites
+    constexpr int RECORDS = 200000;
+
+    SharedJointStateWriter writer;
+    SharedJointStateReader reader;
+
+    ASSERT_TRUE(writer.open(name, AXES, DEPTH));
+    ASSERT_TRUE(reader.open(name));
+
+    std::atomic<bool> done(false);
+
+    auto task = std::async(std::launch::async, [&]
+        {
+            shared_joint_state state;
+            unsigned int torn = 0;
+            std::uint64_t last = 0;
+            unsigned int backwards = 0;
+
+            while (!done)
+            {
+                if (reader.readNext(state))
+                {
+                    for (int j = 0; j < AXES; j++)
+                    {
+                        const double expected = state.cycle;
+
+                        torn += state.positions[j] != expected || state.velocities[j] != expected
+                                || state.currents[j] != expected || state.timestamps[j] != expected
+                                || state.modes[j] != static_cast<std::int32_t>(state.cycle);
+                    }
+
+                    backwards += state.cycle <= last;
+                    last = state.cycle;
+                }
+            }
+
+            return torn + backwards;
+        });
+
+    for (std::uint64_t cycle = 1; cycle <= RECORDS; cycle++)
+    {
+        publish(writer, cycle, cycle);
+    }
+
+    done = true;
+    ASSERT_EQ(task.get(), 0u);
+
+    shared_joint_state state;
+    ASSERT_TRUE(reader.readLatest(state));
+    ASSERT_EQ(state.cycle, static_cast<std::uint64_t>(RECORDS));
+}
+
+TEST_F(SharedMemoryTest, SharedJointCommand)
+{
+    SharedJointCommandReader reader;
+    SharedJointCommandWriter writer;
+    shared_joint_command command;
+
+    // mailboxes are created by the consumer
+
+    ASSERT_FALSE(writer.open(name));
+    ASSERT_FALSE(reader.open(name, 0));
+    ASSERT_TRUE(reader.open(name, 3));
+    ASSERT_EQ(reader.getAxes(), 3);
+
+    ASSERT_TRUE(writer.open(name));
+    ASSERT_TRUE(writer.isAlive());
+    ASSERT_EQ(writer.getAxes(), 3);
+
+    ASSERT_TRUE(reader.read(0, command));
+    ASSERT_EQ(command.sequence, 0u);
+    ASSERT_EQ(command.type, shared_command::NONE);
+    ASSERT_FALSE(reader.read(3, command));
+
+    // each joint counts its own commands, only the last one is kept
+
+    ASSERT_TRUE(writer.setPosition(0, 1.0));
+    ASSERT_TRUE(writer.setPosition(0, 2.0));
+    ASSERT_TRUE(writer.velocityMove(2, -3.0));
+    ASSERT_FALSE(writer.setPosition(3, 0.0));
+
+    ASSERT_TRUE(reader.read(0, command));
+    ASSERT_EQ(command.sequence, 2u);
+    ASSERT_EQ(command.type, shared_command::POSITION_DIRECT);
+    ASSERT_EQ(command.value, 2.0);
+
+    ASSERT_TRUE(reader.read(1, command));
+    ASSERT_EQ(command.sequence, 0u);
+
+    ASSERT_TRUE(reader.read(2, command));
+    ASSERT_EQ(command.sequence, 1u);
+    ASSERT_EQ(command.type, shared_command::VELOCITY);
+    ASSERT_EQ(command.value, -3.0);
+
+    const double refs[] = {10.0, 11.0, 12.0};
+    ASSERT_TRUE(writer.setPositions(refs));
+
+    ASSERT_TRUE(reader.read(1, command));
+    ASSERT_EQ(command.sequence, 1u);
+    ASSERT_EQ(command.value, 11.0);
+
+    ASSERT_TRUE(reader.read(2, command));
+    ASSERT_EQ(command.sequence, 2u);
+    ASSERT_EQ(command.type, shared_command::POSITION_DIRECT);
+
+    // a new producer resumes the count
+
+    SharedJointCommandWriter writer2;
+    ASSERT_TRUE(writer2.open(name));
+    ASSERT_TRUE(writer2.velocityMove(0, 5.0));
+
+    ASSERT_TRUE(reader.read(0, command));
+    ASSERT_EQ(command.sequence, 4u);
+    ASSERT_EQ(command.value, 5.0);
+
+    // producers are told when the consumer goes away
+
+    reader.close();
+    ASSERT_FALSE(writer.isAlive());
+    ASSERT_FALSE(writer2.isAlive());
+    ASSERT_FALSE(SharedJointCommandWriter().open(name));
+}
+
+TEST_F(SharedMemoryTest, SharedJointCommandConsistency)
+{
+    constexpr int AXES = 2;
+    constexpr int COMMANDS = 200000;
+
+    SharedJointCommandReader reader;
+    SharedJointCommandWriter writer;
+
+    ASSERT_TRUE(reader.open(name, AXES));
+    ASSERT_TRUE(writer.open(name));
+
+    std::atomic<bool> done(false);
+
+    auto task = std::async(std::launch::async, [&]
+        {
+            shared_joint_command command;
+            unsigned int torn = 0;
+            std::uint64_t last = 0;
+
+            while (!done)
+            {
+                if (reader.read(0, command) && command.sequence != 0)
+                {
+                    // the value encodes the command number, the type its parity
+                    auto type = command.sequence % 2 ? shared_command::POSITION_DIRECT : shared_command::VELOCITY;
+                    torn += command.sequence < last || command.value != command.sequence || command.type != type;
+                    last = command.sequence;
+                }
+            }
+
+            return torn;
+        });
+
+    for (int i = 1; i <= COMMANDS; i++)
+    {
+        writer.write(0, i % 2 ? shared_command::POSITION_DIRECT : shared_command::VELOCITY, i);
+    }
+
+    done = true;
+    ASSERT_EQ(task.get(), 0u);
+
+    shared_joint_command command;
+    ASSERT_TRUE(reader.read(0, command));
+    ASSERT_EQ(command.sequence, static_cast<std::uint64_t>(COMMANDS));
+}
+
+} // namespace test
+} // namespace roboticslab
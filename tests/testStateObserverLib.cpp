@@ -1,6 +1,11 @@
 #include "gtest/gtest.h"
 
+#include <cstdint>
+
+#include <atomic>
+#include <chrono>
 #include <future>
+#include <thread>
 
 #include "StateObserver.hpp"
 
@@ -110,5 +115,94 @@ TEST_F(StateObserverTest, StateObserver)
     ASSERT_TRUE(emptyStateObserver.notify());
 }
 
+TEST_F(StateObserverTest, StateObserverBackends)
+{
+    for (auto backend : {StateObserverBackend::CONDITION_VARIABLE, StateObserverBackend::FUTEX})
+    {
+        // test TypedStateObserver<int>, await() and notify()
+
+        int val;
+        const int _v = 4;
+        TypedStateObserver<int> intStateObserver(TIMEOUT, backend);
+        f() = std::async(std::launch::async, observer_timer{MILLIS, [&]{ return intStateObserver.notify(_v); }});
+        ASSERT_TRUE(intStateObserver.await(&val));
+        ASSERT_EQ(val, _v);
+
+        // test StateObserver, never call notify()
+
+        StateObserver orphanStateObserver(TIMEOUT, backend);
+        auto start = std::chrono::steady_clock::now();
+        ASSERT_FALSE(orphanStateObserver.await());
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        ASSERT_GE(elapsed.count(), TIMEOUT * 0.99);
+
+        // test StateObserver, notify() but don't await(), then await() and notify()
+
+        ASSERT_TRUE(orphanStateObserver.notify());
+        ASSERT_FALSE(orphanStateObserver.await());
+        f() = std::async(std::launch::async, observer_timer{MILLIS, [&]{ return orphanStateObserver.notify(); }});
+        ASSERT_TRUE(orphanStateObserver.await());
+
+        // test StateObserver, concurrent await() calls take turns
+
+        StateObserver busyStateObserver(TIMEOUT * 4, backend);
+        auto first = std::async(std::launch::async, [&]{ return busyStateObserver.await(); });
+        std::this_thread::sleep_for(std::chrono::milliseconds(MILLIS));
+        auto second = std::async(std::launch::async, [&]{ return busyStateObserver.await(); });
+
+        while (first.wait_for(std::chrono::milliseconds(1)) != std::future_status::ready
+            || second.wait_for(std::chrono::milliseconds(1)) != std::future_status::ready)
+        {
+            busyStateObserver.notify(); // no-op if nobody awaits yet
+        }
+
+        ASSERT_TRUE(first.get());
+        ASSERT_TRUE(second.get());
+    }
+}
+
+TEST_F(StateObserverTest, StateObserverWakeOrder)
+{
+    const int iterations = 1000;
+
+    for (auto backend : {StateObserverBackend::FUTEX, StateObserverBackend::CONDITION_VARIABLE})
+    {
+        // notify() is a no-op if nobody awaits, hence keep poking until the waiter wakes up;
+        // each notification carries its own sequence number, thus the waiter reads the one that woke it
+        TypedStateObserver<int> observer(TIMEOUT, backend);
+        std::atomic<int> woken {0};
+        bool ordered = true;
+
+        std::thread waiter([&]
+            {
+                int value, previous = 0;
+
+                while (woken < iterations)
+                {
+                    if (observer.await(&value))
+                    {
+                        ordered = ordered && value > previous;
+                        previous = value;
+                        woken++;
+                    }
+                }
+            });
+
+        int sent = 0;
+
+        for (int i = 0; i < iterations; i++)
+        {
+            while (woken == i)
+            {
+                observer.notify(++sent);
+                std::this_thread::yield();
+            }
+        }
+
+        waiter.join();
+        ASSERT_TRUE(ordered);
+    }
+}
+
 } // namespace test
 } // namespace roboticslab
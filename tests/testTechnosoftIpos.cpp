@@ -0,0 +1,548 @@
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "InterpolatedPositionBuffer.hpp"
+#include "SpscRing.hpp"
+#include "StateVariables.hpp"
+#include "SyncInterpolator.hpp"
+#include "TpdoMapping.hpp"
+#include "TechnosoftIposObjects.hpp"
+
+namespace roboticslab
+{
+
+namespace test
+{
+
+/**
+ * @ingroup yarp_devices_tests
+ * @defgroup testTechnosoftIpos
+ * @brief Unit tests related to @ref TechnosoftIpos.
+ */
+
+/**
+ * @ingroup testTechnosoftIpos
+ * @brief Tests TPDO layouts of @ref TechnosoftIpos.
+ */
+class TechnosoftIposTest : public testing::Test
+{
+public:
+    virtual void SetUp()
+    { }
+
+    virtual void TearDown()
+    { }
+};
+
+TEST_F(TechnosoftIposTest, TpdoMappingParseIndex)
+{
+    std::uint16_t index = 0;
+
+    ASSERT_TRUE(TpdoMapping::parseIndex("24578", &index));
+    ASSERT_EQ(index, 0x6002);
+
+    ASSERT_TRUE(TpdoMapping::parseIndex("0x6041", &index));
+    ASSERT_EQ(index, 0x6041);
+
+    ASSERT_TRUE(TpdoMapping::parseIndex("0xFFFF", &index));
+    ASSERT_EQ(index, 0xFFFF);
+
+    ASSERT_FALSE(TpdoMapping::parseIndex("", &index));
+    ASSERT_FALSE(TpdoMapping::parseIndex("0x", &index));
+    ASSERT_FALSE(TpdoMapping::parseIndex("0x6041h", &index));
+    ASSERT_FALSE(TpdoMapping::parseIndex("statusword", &index));
+    ASSERT_FALSE(TpdoMapping::parseIndex("-1", &index));
+    ASSERT_FALSE(TpdoMapping::parseIndex("0x10000", &index));
+    ASSERT_EQ(index, 0xFFFF); // untouched on failure
+}
+
+TEST_F(TechnosoftIposTest, TpdoMappingDefaults)
+{
+    for (unsigned int n = 1; n <= 3; n++)
+    {
+        TpdoMapping layout;
+
+        for (auto index : TpdoMapping::getDefaultLayout(n))
+        {
+            ASSERT_TRUE(layout.add(index));
+        }
+
+        ASSERT_FALSE(layout.getObjects().empty());
+        ASSERT_LE(layout.getSize(), 8);
+    }
+
+    ASSERT_TRUE(TpdoMapping::getDefaultLayout(4).empty());
+}
+
+TEST_F(TechnosoftIposTest, TpdoMappingLayout)
+{
+    using namespace IposObjects;
+
+    TpdoMapping layout;
+
+    ASSERT_TRUE(layout.add(Statusword::index));
+    ASSERT_TRUE(layout.add(ModesOfOperationDisplay::index));
+    ASSERT_TRUE(layout.add(PositionActualInternalValue::index));
+    ASSERT_EQ(layout.getSize(), 7);
+
+    // modes of operation are parsed first, offsets follow the mapping order
+
+    const auto & objects = layout.getObjects();
+    ASSERT_EQ(objects.size(), 3);
+    ASSERT_EQ(objects[0], TpdoMapping::object(ModesOfOperationDisplay::index, 2));
+    ASSERT_EQ(objects[1], TpdoMapping::object(Statusword::index, 0));
+    ASSERT_EQ(objects[2], TpdoMapping::object(PositionActualInternalValue::index, 3));
+
+    // test rejections, the layout must remain unchanged
+
+    ASSERT_FALSE(layout.add(0x1234)); // unsupported
+    ASSERT_FALSE(layout.add(TargetPosition::index)); // not interpreted by TechnosoftIpos
+    ASSERT_FALSE(layout.add(Statusword::index)); // already mapped
+    ASSERT_FALSE(layout.add(ManufacturerStatusRegister::index)); // statusword mapped twice
+    ASSERT_FALSE(layout.add(TorqueActualValue::index)); // exceeds 8 bytes
+    ASSERT_EQ(layout.getSize(), 7);
+    ASSERT_EQ(layout.getObjects().size(), 3);
+}
+
+TEST_F(TechnosoftIposTest, TpdoMappingStatusword)
+{
+    using namespace IposObjects;
+
+    std::set<std::uint16_t> indices = {ManufacturerStatusRegister::index, PositionActualInternalValue::index};
+    ASSERT_FALSE(TpdoMapping::hasDuplicateStatusword(indices));
+
+    indices.insert(Statusword::index); // e.g. MSR in TPDO1, statusword in TPDO3
+    ASSERT_TRUE(TpdoMapping::hasDuplicateStatusword(indices));
+}
+
+TEST_F(TechnosoftIposTest, SyncInterpolatorNone)
+{
+    SyncInterpolator interp(0.01);
+    interp.reset(1.0);
+    ASSERT_EQ(interp.next(), 1.0);
+
+    interp.addSetpoint(5.0, 0.0);
+    ASSERT_EQ(interp.next(), 5.0); // stair-step
+    ASSERT_EQ(interp.next(), 5.0);
+
+    interp.addSetpoint(6.0, 0.04);
+    interp.addSetpoint(7.0, 0.045); // previous one is dropped
+    ASSERT_EQ(interp.next(), 7.0);
+    ASSERT_EQ(interp.getTarget(), 7.0);
+}
+
+TEST_F(TechnosoftIposTest, SyncInterpolatorLinear)
+{
+    SyncInterpolator interp(0.01, SyncInterpolator::mode::LINEAR);
+    interp.reset(0.0);
+
+    interp.addSetpoint(0.0, 0.0); // no period estimate yet
+    ASSERT_NEAR(interp.next(), 0.0, 1e-9);
+
+    interp.addSetpoint(4.0, 0.04); // client is four times slower than the bus
+
+    for (int i = 1; i <= 4; i++)
+    {
+        double velocity;
+        ASSERT_NEAR(interp.next(&velocity), i, 1e-9);
+        ASSERT_NEAR(velocity, 100.0, 1e-6);
+    }
+
+    double velocity;
+    ASSERT_NEAR(interp.next(&velocity), 4.0, 1e-9); // hold until the next setpoint arrives
+    ASSERT_EQ(velocity, 0.0);
+}
+
+TEST_F(TechnosoftIposTest, SyncInterpolatorCubic)
+{
+    SyncInterpolator interp(0.01, SyncInterpolator::mode::CUBIC);
+    interp.reset(0.0);
+
+    interp.addSetpoint(0.0, 0.0);
+    ASSERT_NEAR(interp.next(), 0.0, 1e-9);
+
+    // accelerate from rest, then reach the pace of the client
+    interp.addSetpoint(4.0, 0.04);
+
+    double prevPosition = 0.0;
+    double velocity = 0.0;
+
+    for (int i = 0; i < 4; i++)
+    {
+        double position = interp.next(&velocity);
+        ASSERT_GT(position, prevPosition);
+        prevPosition = position;
+    }
+
+    ASSERT_NEAR(prevPosition, 4.0, 1e-9);
+    ASSERT_NEAR(velocity, 100.0, 1e-6); // feedforward
+
+    // steady motion at constant velocity, no stair-steps
+    for (int k = 2; k < 5; k++)
+    {
+        interp.addSetpoint(4.0 * k, 0.04 * k);
+
+        for (int i = 1; i <= 4; i++)
+        {
+            ASSERT_NEAR(interp.next(&velocity), 4.0 * (k - 1) + i, 1e-6);
+            ASSERT_NEAR(velocity, 100.0, 1e-6);
+        }
+    }
+}
+
+TEST_F(TechnosoftIposTest, SyncInterpolatorFastClient)
+{
+    SyncInterpolator interp(0.01, SyncInterpolator::mode::LINEAR);
+    interp.reset(0.0);
+
+    // four setpoints per SYNC, the last one is reached in one period
+    for (int i = 1; i <= 4; i++)
+    {
+        interp.addSetpoint(i, 0.0025 * i);
+    }
+
+    ASSERT_NEAR(interp.next(), 4.0, 1e-9);
+    ASSERT_NEAR(interp.getJitterStatistics().estimate, 0.0025, 1e-9);
+}
+
+TEST_F(TechnosoftIposTest, SyncInterpolatorJitter)
+{
+    SyncInterpolator interp(0.01, SyncInterpolator::mode::LINEAR);
+    interp.reset(0.0);
+
+    auto stats = interp.getJitterStatistics();
+    ASSERT_EQ(stats.count, 0u);
+
+    interp.addSetpoint(1.0, 1.0);
+    interp.addSetpoint(2.0, 1.04);
+    interp.addSetpoint(3.0, 1.09);
+    interp.addSetpoint(4.0, 1.12);
+    interp.addSetpoint(5.0, 2.12); // stream restarted, not accounted for
+
+    stats = interp.getJitterStatistics();
+    ASSERT_EQ(stats.count, 3u);
+    ASSERT_NEAR(stats.meanPeriod, 0.04, 1e-9);
+    ASSERT_NEAR(stats.stddev, 0.01, 1e-9);
+    ASSERT_NEAR(stats.minPeriod, 0.03, 1e-9);
+    ASSERT_NEAR(stats.maxPeriod, 0.05, 1e-9);
+    ASSERT_NEAR(stats.estimate, 0.0399, 1e-9);
+
+    interp.resetJitterStatistics();
+    stats = interp.getJitterStatistics();
+    ASSERT_EQ(stats.count, 0u);
+    ASSERT_NEAR(stats.estimate, 0.0399, 1e-9); // preserved
+
+    SyncInterpolator::mode mode;
+    ASSERT_TRUE(SyncInterpolator::parseMode("cubic", &mode));
+    ASSERT_EQ(mode, SyncInterpolator::mode::CUBIC);
+    ASSERT_EQ(SyncInterpolator::modeToString(mode), "cubic");
+    ASSERT_FALSE(SyncInterpolator::parseMode("quintic", &mode));
+}
+
+TEST_F(TechnosoftIposTest, StateVariablesConversions)
+{
+    StateVariables vars;
+    vars.tr = 160.0;
+    vars.k = 0.0706;
+    vars.encoderPulses = 4096;
+    vars.samplingPeriod = 0.001;
+    vars.drivePeakCurrent = 20.0;
+    vars.reverse = true;
+    vars.updateConversionFactors();
+
+    const double countsPerDegree = -160.0 * 4096 / 360.0;
+
+    ASSERT_NEAR(vars.degreesToInternalUnits(1.0), countsPerDegree, 1e-9);
+    ASSERT_NEAR(vars.degreesToInternalUnits(1.0, 1), countsPerDegree * 0.001, 1e-12);
+    ASSERT_NEAR(vars.degreesToInternalUnits(1.0, 2), countsPerDegree * 1e-6, 1e-15);
+    ASSERT_NEAR(vars.degreesToInternalUnits(1.0, 3), countsPerDegree * 1e-9, 1e-18); // not precomputed
+    ASSERT_NEAR(vars.internalUnitsToDegrees(countsPerDegree), 1.0, 1e-12);
+    ASSERT_NEAR(vars.internalUnitsToDegrees(countsPerDegree * 0.001, 1), 1.0, 1e-12);
+
+    ASSERT_EQ(vars.currentToInternalUnits(1.0), -1638);
+    ASSERT_NEAR(vars.internalUnitsToCurrent(-1638), 1638 * 40.0 / 65520.0, 1e-12);
+    ASSERT_NEAR(vars.currentToTorque(1.0), 160.0 * 0.0706, 1e-12);
+    ASSERT_NEAR(vars.torqueToCurrent(160.0 * 0.0706), 1.0, 1e-12);
+
+    const double counts[] = {0.0, countsPerDegree, -2 * countsPerDegree, 90 * countsPerDegree};
+    double degrees[4];
+    vars.internalUnitsToDegrees(counts, degrees, 4);
+
+    for (int i = 0; i < 4; i++)
+    {
+        ASSERT_NEAR(degrees[i], vars.internalUnitsToDegrees(counts[i]), 1e-12);
+    }
+
+    const std::int16_t currents[] = {0, 1638, -1638};
+    double amperes[3];
+    vars.internalUnitsToCurrent(currents, amperes, 3);
+
+    for (int i = 0; i < 3; i++)
+    {
+        ASSERT_NEAR(amperes[i], vars.internalUnitsToCurrent(currents[i]), 1e-12);
+    }
+
+    // factors follow parameter changes
+    vars.tr = 80.0;
+    vars.updateConversionFactors();
+    ASSERT_NEAR(vars.degreesToInternalUnits(1.0), countsPerDegree / 2, 1e-9);
+    ASSERT_NEAR(vars.currentToTorque(1.0), 80.0 * 0.0706, 1e-12);
+}
+
+TEST_F(TechnosoftIposTest, EncoderReadEstimators)
+{
+    EncoderRead::estimator type;
+    ASSERT_TRUE(EncoderRead::parseEstimator("leastSquares", &type));
+    ASSERT_EQ(type, EncoderRead::estimator::LEAST_SQUARES);
+    ASSERT_EQ(EncoderRead::estimatorToString(type), "leastSquares");
+    ASSERT_FALSE(EncoderRead::parseEstimator("kalman", &type));
+
+    // ten drive samples per SYNC, p(t) = 100 + 3t + 0.1t^2 (t in samples)
+    EncoderRead encoder(0.001, 0.01);
+    auto position = [](std::uint64_t cycle) { double t = cycle * 10.0; return static_cast<std::int32_t>(100 + 3 * t + 0.1 * t * t); };
+
+    // finite differences against the SYNC time base
+    encoder.reset(position(1));
+    encoder.update(position(1), 1);
+    encoder.update(position(2), 2);
+    ASSERT_NEAR(encoder.querySpeed(), 6.0, 1e-9); // secant at t = 15
+    encoder.update(position(3), 3);
+    ASSERT_NEAR(encoder.querySpeed(), 8.0, 1e-9);
+    ASSERT_NEAR(encoder.queryAcceleration(), 0.2, 1e-9);
+
+    // quadratic fit recovers exact derivatives, even if a SYNC cycle was lost
+    ASSERT_FALSE(encoder.configure(EncoderRead::estimator::LEAST_SQUARES, 2, 0.0, 0.0, 0.0));
+    ASSERT_FALSE(encoder.configure(EncoderRead::estimator::LEAST_SQUARES, EncoderRead::MAX_WINDOW + 1, 0.0, 0.0, 0.0));
+    ASSERT_TRUE(encoder.configure(EncoderRead::estimator::LEAST_SQUARES, 5, 0.0, 0.0, 0.0));
+    ASSERT_EQ(encoder.getEstimator(), EncoderRead::estimator::LEAST_SQUARES);
+
+    for (std::uint64_t cycle : {10, 11, 13, 14, 15, 16, 17, 18})
+    {
+        encoder.update(position(cycle), cycle);
+    }
+
+    ASSERT_EQ(encoder.queryPosition(), position(18));
+    ASSERT_NEAR(encoder.querySpeed(), 3 + 0.2 * 180, 1e-6);
+    ASSERT_NEAR(encoder.queryAcceleration(), 0.2, 1e-9);
+
+    // switching to the host time base holds last estimates
+    encoder.update(position(19));
+    ASSERT_NEAR(encoder.querySpeed(), 3 + 0.2 * 180, 1e-6);
+
+    // alpha-beta-gamma filter converges on a ramp
+    ASSERT_FALSE(encoder.configure(EncoderRead::estimator::ALPHA_BETA, 0, 0.0, 0.1, 0.01));
+    ASSERT_FALSE(encoder.configure(EncoderRead::estimator::ALPHA_BETA, 0, 0.5, 3.5, 0.01));
+    ASSERT_TRUE(encoder.configure(EncoderRead::estimator::ALPHA_BETA, 0, 0.5, 0.1, 0.01));
+
+    for (std::uint64_t cycle = 1; cycle <= 500; cycle++)
+    {
+        encoder.update(static_cast<std::int32_t>(5 * 10 * cycle), cycle);
+    }
+
+    ASSERT_NEAR(encoder.querySpeed(), 5.0, 1e-6);
+    ASSERT_NEAR(encoder.queryAcceleration(), 0.0, 1e-6);
+
+    // speed reported by the drive
+    encoder.updateSpeed(2.0, 501); // ignored
+    ASSERT_NEAR(encoder.querySpeed(), 5.0, 1e-6);
+
+    ASSERT_TRUE(encoder.configure(EncoderRead::estimator::DRIVE, 0, 0.0, 0.0, 0.0));
+    encoder.updateSpeed(2.0, 501);
+    encoder.update(2000, 501);
+    encoder.updateSpeed(3.0, 502);
+    encoder.update(2030, 502);
+    ASSERT_EQ(encoder.queryPosition(), 2030);
+    ASSERT_NEAR(encoder.querySpeed(), 3.0, 1e-9);
+    ASSERT_NEAR(encoder.queryAcceleration(), 0.1, 1e-9);
+
+    encoder.reset(0);
+    ASSERT_EQ(encoder.queryPosition(), 0);
+    ASSERT_EQ(encoder.querySpeed(), 0.0);
+    ASSERT_EQ(encoder.queryAcceleration(), 0.0);
+}
+
+TEST_F(TechnosoftIposTest, SpscRing)
+{
+    SpscRing<int> ring(5);
+    ASSERT_EQ(ring.capacity(), 8u); // rounded up
+    ASSERT_TRUE(ring.empty());
+
+    for (int i = 0; i < 8; i++)
+    {
+        ASSERT_TRUE(ring.push(i));
+    }
+
+    ASSERT_FALSE(ring.push(8)); // full
+    ASSERT_EQ(ring.size(), 8u);
+    ASSERT_EQ(ring.peek(), 0);
+    ASSERT_EQ(ring.peek(7), 7);
+
+    ring.pop();
+    ASSERT_TRUE(ring.push(8)); // wraps around
+    ASSERT_EQ(ring.peek(), 1);
+    ASSERT_EQ(ring.peek(7), 8);
+
+    ring.clear();
+    ASSERT_TRUE(ring.empty());
+}
+
+TEST_F(TechnosoftIposTest, InterpolatedPositionBufferTimedSetpoints)
+{
+    StateVariables vars;
+    vars.tr = 100.0;
+    vars.encoderPulses = 360; // one degree is 100 counts
+    vars.samplingPeriod = 0.001;
+    vars.updateConversionFactors();
+
+    // variable period, points are timed relative to the initial position
+    PtBuffer pt(vars, 0);
+    pt.setInitial(0.0, 100.0);
+    ASSERT_TRUE(pt.addSetpoint(1.0, 100.05));
+    ASSERT_TRUE(pt.addSetpoint(2.0, 100.08));
+    ASSERT_EQ(pt.getQueueSize(), 2u);
+
+    const auto & ptBatch = pt.popBatch(true);
+    ASSERT_EQ(ptBatch.size(), 2u);
+
+    std::int32_t position;
+    std::uint16_t samples;
+
+    std::memcpy(&position, &ptBatch[0], sizeof(position));
+    std::memcpy(&samples, reinterpret_cast<const char *>(&ptBatch[0]) + 4, sizeof(samples));
+    ASSERT_EQ(position, 100);
+    ASSERT_EQ(samples, 50);
+
+    std::memcpy(&position, &ptBatch[1], sizeof(position));
+    std::memcpy(&samples, reinterpret_cast<const char *>(&ptBatch[1]) + 4, sizeof(samples));
+    ASSERT_EQ(position, 200);
+    ASSERT_EQ(samples, 30);
+    ASSERT_EQ(pt.getPrevTarget(), 2.0);
+
+    // velocities given by the client take precedence over estimated ones
+    PvtBuffer pvt(vars, 50);
+    pvt.setInitial(0.0, 100.0);
+    ASSERT_TRUE(pvt.addSetpoint(1.0, 10.0, 100.05)); // 1 count/sample
+    ASSERT_TRUE(pvt.addSetpoint(2.0, 100.1));
+
+    const auto & pvtBatch = pvt.popBatch(true);
+    ASSERT_EQ(pvtBatch.size(), 1u); // PVT keeps one point for the next batch
+
+    std::int16_t velocity;
+    std::memcpy(&velocity, reinterpret_cast<const char *>(&pvtBatch[0]) + 4, sizeof(velocity));
+    ASSERT_EQ(velocity, 1);
+}
+
+TEST_F(TechnosoftIposTest, InterpolatedPositionBufferStress)
+{
+    constexpr int DRIVES = 30;
+    constexpr int POINTS = 500; // streamed at 1 kHz
+
+    StateVariables vars;
+    vars.tr = 1.0;
+    vars.encoderPulses = 360; // internal units are degrees
+    vars.samplingPeriod = 0.001;
+    vars.updateConversionFactors();
+
+    std::vector<std::unique_ptr<InterpolatedPositionBuffer>> buffers;
+
+    for (int i = 0; i < DRIVES; i++)
+    {
+        buffers.emplace_back(new PtBuffer(vars, 1));
+    }
+
+    std::atomic<int> producersDone {0};
+    std::vector<std::thread> producers;
+
+    for (int i = 0; i < DRIVES; i++)
+    {
+        producers.emplace_back([&buffers, &producersDone, i]
+            {
+                auto next = std::chrono::steady_clock::now();
+
+                for (int p = 1; p <= POINTS; p++)
+                {
+                    while (!buffers[i]->addSetpoint(p))
+                    {
+                        std::this_thread::yield(); // consumer fell behind by a whole queue
+                    }
+
+                    next += std::chrono::milliseconds(1);
+                    std::this_thread::sleep_until(next);
+                }
+
+                producersDone++;
+            });
+    }
+
+    // single consumer per CAN bus, as the reader thread
+    std::vector<int> received(DRIVES, 0);
+    std::vector<const std::uint64_t *> batchStorage(DRIVES, nullptr);
+    bool inOrder = true;
+    bool reallocated = false;
+
+    auto consume = [&](int i)
+        {
+            const auto & batch = buffers[i]->popBatch(false);
+
+            if (!batch.empty())
+            {
+                reallocated |= batchStorage[i] != nullptr && batchStorage[i] != batch.data();
+                batchStorage[i] = batch.data();
+            }
+
+            for (auto record : batch)
+            {
+                std::int32_t position;
+                std::memcpy(&position, &record, sizeof(position));
+                inOrder &= position == ++received[i];
+            }
+        };
+
+    while (producersDone < DRIVES)
+    {
+        for (int i = 0; i < DRIVES; i++)
+        {
+            if (!buffers[i]->isQueueEmpty())
+            {
+                consume(i);
+            }
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(2)); // buffer-low signals
+
+    }
+
+    for (auto & t : producers)
+    {
+        t.join();
+    }
+
+    for (int i = 0; i < DRIVES; i++)
+    {
+        while (!buffers[i]->isQueueEmpty())
+        {
+            consume(i);
+        }
+    }
+
+    ASSERT_TRUE(inOrder);
+    ASSERT_FALSE(reallocated);
+
+    for (int i = 0; i < DRIVES; i++)
+    {
+        ASSERT_EQ(received[i], POINTS);
+        ASSERT_EQ(buffers[i]->getPrevTarget(), POINTS);
+    }
+}
+
+} // namespace test
+} // namespace roboticslab
@@ -1,12 +1,15 @@
 #include "gtest/gtest.h"
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <chrono>
 #include <memory>
 #include <numeric>
 #include <set>
 #include <string>
 #include <thread>
+#include <utility>
 #include <vector>
 
 #include <yarp/dev/IPositionDirect.h>
@@ -233,6 +236,232 @@ TEST_F(YarpDeviceMapperTest, ParallelTask)
     ASSERT_NEAR(ref3, joint, EPSILON);
 }
 
+TEST_F(YarpDeviceMapperTest, DeferredCallback)
+{
+    int calls = 0;
+
+    DeferredCallback small([&calls](int id) { calls++; return id == 1; });
+    ASSERT_TRUE(small(1));
+    ASSERT_FALSE(small(0));
+    ASSERT_EQ(calls, 2);
+
+    std::array<double, 32> big {}; // exceeds inline storage
+    big[31] = 1.0;
+
+    DeferredCallback heap([big](int) { return big[31] == 1.0; });
+    ASSERT_TRUE(heap(0));
+
+    DeferredCallback moved(std::move(heap));
+    ASSERT_TRUE(moved(0));
+
+    std::vector<DeferredCallback> vec;
+
+    for (int i = 0; i < 100; i++) // force reallocations
+    {
+        vec.emplace_back([i](int) { return i % 2 == 0; });
+    }
+
+    for (int i = 0; i < 100; i++)
+    {
+        ASSERT_EQ(vec[i](0), i % 2 == 0);
+    }
+}
+
+TEST_F(YarpDeviceMapperTest, ForkJoinTask)
+{
+    const int joint = 4;
+
+    auto taskFactory = std::make_unique<ForkJoinTaskFactory>(3);
+    auto task = taskFactory->createTask();
+    ASSERT_EQ(task->size(), 0);
+    ASSERT_TRUE(task->dispatch());
+
+    double refs[16] = {0.0};
+
+    for (auto & ref : refs)
+    {
+        task->add(getDummy(), &yarp::dev::IPositionDirectRaw::getRefPositionRaw, joint, &ref);
+    }
+
+    ASSERT_EQ(task->size(), 16);
+    ASSERT_NEAR(refs[0], 0.0, EPSILON); // not dispatched yet
+    ASSERT_TRUE(task->dispatch());
+
+    for (auto ref : refs)
+    {
+        ASSERT_NEAR(ref, joint, EPSILON);
+    }
+
+    // joint result, all callbacks are executed anyway
+    std::atomic<int> count {0};
+    task->clear();
+
+    for (int i = 0; i < 16; i++)
+    {
+        task->add([&count, i] { count++; return i != 7; });
+    }
+
+    ASSERT_FALSE(task->dispatch());
+    ASSERT_EQ(count, 16);
+
+    // reuse, each callback runs once per dispatch
+    for (int i = 0; i < 1000; i++)
+    {
+        ASSERT_FALSE(task->dispatch());
+    }
+
+    ASSERT_EQ(count, 16 * 1001);
+
+    // nested dispatch falls back to sequential execution
+    auto inner = taskFactory->createTask();
+    inner->add([&count] { count++; return true; });
+    inner->add([&count] { count++; return true; });
+
+    auto outer = taskFactory->createTask();
+    outer->add([&inner] { return inner->dispatch(); });
+    outer->add([] { return true; });
+    ASSERT_TRUE(outer->dispatch());
+    ASSERT_EQ(count, 16 * 1001 + 2);
+
+    // concurrent dispatches
+    auto other = taskFactory->createTask();
+    std::atomic<int> otherCount {0};
+
+    for (int i = 0; i < 8; i++)
+    {
+        other->add([&otherCount] { otherCount++; return true; });
+    }
+
+    std::thread thread([&other] { for (int i = 0; i < 1000; i++) other->dispatch(); });
+
+    for (int i = 0; i < 1000; i++)
+    {
+        inner->dispatch();
+    }
+
+    thread.join();
+
+    ASSERT_EQ(count, 16 * 1001 + 2 + 2 * 1000);
+    ASSERT_EQ(otherCount, 8 * 1000);
+}
+
+TEST_F(YarpDeviceMapperTest, AffineTask)
+{
+    struct ThreadRecorder
+    {
+        bool record()
+        { id = std::this_thread::get_id(); return true; }
+
+        bool fail()
+        { return false; }
+
+        std::thread::id id;
+    };
+
+    auto taskFactory = std::make_unique<AffineTaskFactory>(3);
+    auto task = taskFactory->createTask();
+    ASSERT_EQ(task->size(), 0);
+    ASSERT_TRUE(task->dispatch());
+
+    // groups 0 and 3 share a worker
+    const int groups[] = {0, 1, 2, 0, 1, 2, 3, FutureTask::NO_AFFINITY};
+    ThreadRecorder recorders[8];
+
+    for (int i = 0; i < 8; i++)
+    {
+        task->addAffine(groups[i], &recorders[i], &ThreadRecorder::record);
+    }
+
+    ASSERT_EQ(task->size(), 8);
+
+    for (int i = 0; i < 100; i++)
+    {
+        ASSERT_TRUE(task->dispatch());
+        ASSERT_EQ(recorders[0].id, recorders[3].id);
+        ASSERT_EQ(recorders[0].id, recorders[6].id);
+        ASSERT_EQ(recorders[1].id, recorders[4].id);
+        ASSERT_EQ(recorders[2].id, recorders[5].id);
+        ASSERT_NE(recorders[0].id, recorders[1].id);
+        ASSERT_NE(recorders[0].id, recorders[2].id);
+        ASSERT_NE(recorders[1].id, recorders[2].id);
+        ASSERT_NE(recorders[0].id, std::this_thread::get_id());
+        ASSERT_EQ(recorders[7].id, std::this_thread::get_id()); // not bound to any group
+    }
+
+    // plain callbacks are not bound to any group
+    std::atomic<int> count {0};
+    task->clear();
+    task->add([&count] { count++; return true; });
+    task->addAffine(1, &recorders[0], &ThreadRecorder::fail);
+    task->add([&count] { count++; return true; });
+    ASSERT_FALSE(task->dispatch());
+    ASSERT_EQ(count, 2);
+
+    // free functions may be bound to a group, too
+    std::thread::id lambdaId;
+    task->clear();
+    task->addAffine(0, &recorders[0], &ThreadRecorder::record);
+    task->addAffine(3, [&lambdaId] { lambdaId = std::this_thread::get_id(); return true; });
+    ASSERT_TRUE(task->dispatch());
+    ASSERT_EQ(lambdaId, recorders[0].id);
+
+    // nested dispatch falls back to sequential execution
+    auto inner = taskFactory->createTask();
+    inner->addAffine(0, &recorders[0], &ThreadRecorder::record);
+
+    auto outer = taskFactory->createTask();
+    outer->addAffine(1, inner.get(), &FutureTask::dispatch);
+    ASSERT_TRUE(outer->dispatch());
+
+    // concurrent dispatches
+    auto other = taskFactory->createTask();
+    ThreadRecorder otherRecorders[6];
+
+    for (int i = 0; i < 6; i++)
+    {
+        other->addAffine(i, &otherRecorders[i], &ThreadRecorder::record);
+    }
+
+    std::thread thread([&other] { for (int i = 0; i < 1000; i++) ASSERT_TRUE(other->dispatch()); });
+
+    for (int i = 0; i < 1000; i++)
+    {
+        ASSERT_TRUE(inner->dispatch());
+    }
+
+    thread.join();
+}
+
+TEST_F(YarpDeviceMapperTest, FutureTaskDispatch)
+{
+    SequentialTaskFactory sequential;
+    ParallelTaskFactory parallel(4);
+    ForkJoinTaskFactory forkJoin(4);
+
+    for (int n : {1, 2, 4, 8, 16, 32, 64})
+    {
+        std::vector<double> refs(n, 0.0);
+
+        for (auto * factory : std::vector<FutureTaskFactory *>{&sequential, &parallel, &forkJoin})
+        {
+            auto task = factory->createTask();
+
+            for (int i = 0; i < n; i++)
+            {
+                task->add(getDummy(), &yarp::dev::IPositionDirectRaw::getRefPositionRaw, i, &refs[i]);
+            }
+
+            // tasks may be dispatched more than once
+            for (int i = 0; i < 3; i++)
+            {
+                std::fill(refs.begin(), refs.end(), -1.0);
+                ASSERT_TRUE(task->dispatch());
+                ASSERT_EQ(refs.back(), n - 1);
+            }
+        }
+    }
+}
+
 TEST_F(YarpDeviceMapperTest, RawDevice)
 {
     RawDevice rd(getDriver<JointDriver<1>>());
@@ -409,6 +638,9 @@ TEST_F(YarpDeviceMapperTest, DeviceMapper)
     ASSERT_EQ(std::get<2>(devices[1]), 1);
     ASSERT_EQ(std::get<2>(devices[2]), 3);
 
+    auto cached = mapper.getDevices(globalAxesCount, globalAxes);
+    ASSERT_EQ(&cached[0], &devices[0]); // same plan
+
     // DeviceMapper::createTask
 
     auto task = mapper.createTask();
@@ -433,6 +665,136 @@ TEST_F(YarpDeviceMapperTest, DeviceMapper)
     double ref_group[jointCount];
     ASSERT_TRUE(mapper.mapJointGroup(&yarp::dev::IPositionDirectRaw::getRefPositionsRaw, jointCount, joints, ref_group));
     ASSERT_EQ(std::vector<double>(ref_group, ref_group + jointCount), (std::vector<double>{0, 0, 2, 1, 3})); // parens intentional
+
+    // inlined variants
+
+    std::fill_n(ref_full, 10, -1.0);
+    ASSERT_TRUE(mapper.mapAllJoints(DeviceMapper::inlined, &yarp::dev::IPositionDirectRaw::getRefPositionsRaw, ref_full));
+    ASSERT_EQ(std::vector<double>(ref_full, ref_full + 10), (std::vector<double>{0, 0, 1, 0, 1, 2, 0, 1, 2, 3})); // parens intentional
+
+    std::fill_n(ref_group, jointCount, -1.0);
+    ASSERT_TRUE(mapper.mapJointGroup(DeviceMapper::inlined, &yarp::dev::IPositionDirectRaw::getRefPositionsRaw, jointCount, joints, ref_group));
+    ASSERT_EQ(std::vector<double>(ref_group, ref_group + jointCount), (std::vector<double>{0, 0, 2, 1, 3})); // parens intentional
+
+    const double refs[10] = {0.0};
+    ASSERT_FALSE(mapper.mapAllJoints(DeviceMapper::inlined, &yarp::dev::IPositionDirectRaw::setPositionsRaw, refs)); // all devices fail
+}
+
+TEST_F(YarpDeviceMapperTest, DeviceMapperInlineDispatch)
+{
+    const int devices = 40;
+
+    DeviceMapper mapper;
+    mapper.enableParallelization(4);
+
+    for (int i = 0; i < devices; i++)
+    {
+        ASSERT_TRUE(mapper.registerDevice(getDriver<JointDriver<1>>()));
+    }
+
+    std::vector<double> pooled(devices, -1.0);
+    std::vector<double> inlined(devices, -1.0);
+
+    ASSERT_TRUE(mapper.mapAllJoints(&yarp::dev::IPositionDirectRaw::getRefPositionsRaw, pooled.data()));
+    ASSERT_TRUE(mapper.mapAllJoints(DeviceMapper::inlined, &yarp::dev::IPositionDirectRaw::getRefPositionsRaw, inlined.data()));
+
+    ASSERT_EQ(pooled, std::vector<double>(devices, 0.0));
+    ASSERT_EQ(inlined, pooled);
+}
+
+TEST_F(YarpDeviceMapperTest, DeviceMapperGroupPlanCache)
+{
+    DeviceMapper mapper;
+
+    for (int i = 0; i < 10; i++)
+    {
+        ASSERT_TRUE(mapper.registerDevice(getDriver<JointDriver<2>>()));
+    }
+
+    // more distinct groups than cached plans
+    std::vector<std::vector<int>> groups;
+
+    for (int i = 0; i < 20; i++)
+    {
+        groups.push_back({i, (i + 7) % 20, (i + 8) % 20});
+    }
+
+    auto held = mapper.getDevices(groups[0].size(), groups[0].data());
+    const auto * heldAddress = &held[0];
+
+    for (int round = 0; round < 3; round++)
+    {
+        for (const auto & joints : groups)
+        {
+            auto devices = mapper.getDevices(joints.size(), joints.data());
+            int previous = -1;
+
+            for (const auto & t : devices)
+            {
+                for (auto localIndex : std::get<1>(t))
+                {
+                    const int joint = joints[++previous];
+                    ASSERT_EQ(std::get<0>(t), std::get<0>(mapper.getDevice(joint)));
+                    ASSERT_EQ(localIndex, std::get<1>(mapper.getDevice(joint)));
+                }
+            }
+
+            ASSERT_EQ(previous, static_cast<int>(joints.size()) - 1);
+        }
+    }
+
+    // evicted plans are kept alive by their holders
+    ASSERT_EQ(&held[0], heldAddress);
+    ASSERT_EQ(std::get<1>(held[0]), (std::vector<int>{0})); // parens intentional
+    ASSERT_EQ(std::get<2>(held[1]), 1);
+
+    // the same joint list in a different order is a different plan
+    const int joints[] = {3, 2, 5};
+    const int reversed[] = {5, 2, 3};
+    auto a = mapper.getDevices(3, joints);
+    auto b = mapper.getDevices(3, reversed);
+    ASSERT_EQ(a.size(), 2);
+    ASSERT_EQ(b.size(), 2);
+    ASSERT_EQ(std::get<1>(a[0]), (std::vector<int>{1, 0})); // parens intentional
+    ASSERT_EQ(std::get<1>(b[1]), (std::vector<int>{0, 1}));
+
+    // plans are dropped on new registrations
+    ASSERT_TRUE(mapper.registerDevice(getDriver<JointDriver<1>>()));
+    ASSERT_NE(&mapper.getDevices(3, joints)[0], &a[0]);
+
+    double refs[3];
+    ASSERT_TRUE(mapper.mapJointGroup(DeviceMapper::inlined, &yarp::dev::IPositionDirectRaw::getRefPositionsRaw, 3, joints, refs));
+    ASSERT_EQ(std::vector<double>(refs, refs + 3), (std::vector<double>{1, 0, 1})); // parens intentional
+}
+
+TEST_F(YarpDeviceMapperTest, DeviceMapperAffinity)
+{
+    DeviceMapper mapper;
+    mapper.enableAffinity(2);
+
+    ASSERT_TRUE(mapper.registerDevice(getDriver<JointDriver<1>>(), 0));
+    ASSERT_TRUE(mapper.registerDevice(getDriver<JointDriver<2>>(), 1));
+    ASSERT_TRUE(mapper.registerDevice(getDriver<JointDriver<3>>(), 0));
+    ASSERT_TRUE(mapper.registerDevice(getDriver<JointDriver<4>>())); // no affinity
+
+    ASSERT_EQ(std::get<0>(mapper.getDevicesWithOffsets()[0])->getAffinity(), 0);
+    ASSERT_EQ(std::get<0>(mapper.getDevicesWithOffsets()[1])->getAffinity(), 1);
+    ASSERT_EQ(std::get<0>(mapper.getDevicesWithOffsets()[3])->getAffinity(), FutureTask::NO_AFFINITY);
+
+    double refs[10];
+    std::fill_n(refs, 10, -1.0);
+    ASSERT_TRUE(mapper.mapAllJoints(&yarp::dev::IPositionDirectRaw::getRefPositionsRaw, refs));
+    ASSERT_EQ(std::vector<double>(refs, refs + 10), (std::vector<double>{0, 0, 1, 0, 1, 2, 0, 1, 2, 3})); // parens intentional
+
+    const int jointCount = 5;
+    const int joints[jointCount] = {0, 2, 5, 7, 9};
+    double ref_group[jointCount];
+    std::fill_n(ref_group, jointCount, -1.0);
+    ASSERT_TRUE(mapper.mapJointGroup(&yarp::dev::IPositionDirectRaw::getRefPositionsRaw, jointCount, joints, ref_group));
+    ASSERT_EQ(std::vector<double>(ref_group, ref_group + jointCount), (std::vector<double>{0, 1, 2, 1, 3})); // parens intentional
+
+    const double setRefs[10] = {0.0};
+    ASSERT_FALSE(mapper.mapAllJoints(&yarp::dev::IPositionDirectRaw::setPositionsRaw, setRefs)); // all devices fail
 }
 
 } // namespace test